@@ -767,3 +767,20 @@ error:
     *pred = &in[offset];
     return ret;
 }
+
+uint32_t
+ly_mt_thread_count(void)
+{
+    long count = 0;
+
+#ifdef _SC_NPROCESSORS_ONLN
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (count < 2) {
+        count = 2;
+    } else if (count > LY_MT_THREADS_MAX) {
+        count = LY_MT_THREADS_MAX;
+    }
+
+    return count;
+}
@@ -111,6 +111,33 @@ void ly_log_location(const struct lysc_node *scnode, const struct lyd_node *dnod
  */
 void ly_log_location_revert(uint32_t scnode_steps, uint32_t dnode_steps, uint32_t path_steps, uint32_t in_steps);
 
+/**
+ * @brief Start capturing all the errors and warnings of this thread.
+ *
+ * Captured messages are neither printed nor stored in the context error list, they are collected until
+ * ::ly_log_capture_stop() so that messages generated concurrently by several threads can be logged later in
+ * a deterministic order. The error list of the thread is kept aside and restored when the capture stops.
+ *
+ * @param[in] ctx Context of the captured messages.
+ */
+void ly_log_capture_start(const struct ly_ctx *ctx);
+
+/**
+ * @brief Stop capturing messages of this thread.
+ *
+ * @param[in] ctx Context of the captured messages.
+ * @return List of the captured messages, NULL if there were none.
+ */
+struct ly_err_item *ly_log_capture_stop(const struct ly_ctx *ctx);
+
+/**
+ * @brief Log captured messages as if they were generated now by this thread and free them.
+ *
+ * @param[in] ctx Context of the captured messages.
+ * @param[in] captured List of the captured messages, is freed.
+ */
+void ly_log_replay(const struct ly_ctx *ctx, struct ly_err_item *captured);
+
 /**
  * @brief Initiate location data for logger, all arguments are set as provided (even NULLs) - overrides the current values.
  *
@@ -327,11 +354,26 @@ struct ly_ctx {
     uint16_t change_count;            /**< count of changes of the context, on some changes it could be incremented
                                            more times */
     uint16_t flags;                   /**< context settings, see @ref contextoptions */
+    uint32_t ident_count;             /**< number of identity indexes assigned, see ::lysc_ident.index */
 
     ly_ext_data_clb ext_clb;          /**< optional callback for providing extension-specific run-time data for extensions */
     void *ext_clb_data;               /**< optional private data for ::ly_ctx.ext_clb */
     pthread_key_t errlist_key;        /**< key for the thread-specific list of errors related to the context */
     pthread_mutex_t lyb_hash_lock;    /**< lock for storing LYB schema hashes in schema nodes */
+    pthread_mutex_t index_lock;       /**< lock for declaring secondary data indexes in schema nodes */
+    uint32_t index_gen;               /**< number of secondary data indexes declared, data indexes built before
+                                           the last one was declared are incomplete */
+    pthread_mutex_t xp_cache_lock;    /**< lock for the cache of parsed XPath expressions */
+    struct lyxp_cache *xp_cache;      /**< optional cache of parsed XPath expressions, see ::ly_ctx_set_xpath_cache() */
+    pthread_mutex_t val_stats_lock;   /**< lock for the validation statistics */
+    struct lyd_val_stats *val_stats;  /**< optional validation statistics, see ::lyd_val_stats_enable() */
+    ATOMIC_T val_stats_enabled;       /**< whether @p val_stats are collected, can be read without the lock */
+    pthread_mutex_t journals_lock;    /**< lock for the registry of the change journals */
+    struct hash_table *journals;      /**< change journals of data trees (see ::lyd_journal_new()) by the top-level
+                                           nodes of the trees */
+    pthread_mutex_t val_graph_lock;   /**< lock for the schema dependency graph */
+    struct lyd_val_graph *val_graph;  /**< schema dependency graph of the incremental validation (see
+                                           ::lyd_validate_diff()), built when needed and freed on every compilation */
 };
 
 /**
@@ -631,6 +673,20 @@ LY_ERR ly_munmap(void *addr, size_t length);
  */
 LY_ERR ly_strcat(char **dest, const char *format, ...);
 
+/**
+ * @brief Maximum number of worker threads of multi-threaded processing.
+ */
+#define LY_MT_THREADS_MAX 16
+
+/**
+ * @brief Get the number of worker threads of multi-threaded processing.
+ *
+ * At least 2 workers are always used so that the processing behaves the same on any machine.
+ *
+ * @return Number of worker threads.
+ */
+uint32_t ly_mt_thread_count(void);
+
 #ifndef _WIN32
 # define PATH_SEPARATOR ":"
 #else
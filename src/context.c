@@ -46,6 +46,8 @@
 #include "tree_data_internal.h"
 #include "tree_schema.h"
 #include "tree_schema_internal.h"
+#include "validation.h"
+#include "xpath.h"
 
 #include "../models/ietf-datastores@2018-02-14.h"
 #include "../models/ietf-inet-types@2013-07-15.h"
@@ -254,6 +256,21 @@ ly_ctx_new(const char *search_dir, uint16_t options, struct ly_ctx **new_ctx)
     /* init LYB hash lock */
     pthread_mutex_init(&ctx->lyb_hash_lock, NULL);
 
+    /* init schema index lock */
+    pthread_mutex_init(&ctx->index_lock, NULL);
+
+    /* init XPath cache lock */
+    pthread_mutex_init(&ctx->xp_cache_lock, NULL);
+
+    /* init validation statistics lock */
+    pthread_mutex_init(&ctx->val_stats_lock, NULL);
+
+    /* init change journals lock */
+    pthread_mutex_init(&ctx->journals_lock, NULL);
+
+    /* init schema dependency graph lock */
+    pthread_mutex_init(&ctx->val_graph_lock, NULL);
+
     /* models list */
     ctx->flags = options;
     if (search_dir) {
@@ -695,6 +712,14 @@ ly_ctx_set_ext_data_clb(struct ly_ctx *ctx, ly_ext_data_clb clb, void *user_data
     return prev;
 }
 
+LIBYANG_API_DEF LY_ERR
+ly_ctx_set_xpath_cache(struct ly_ctx *ctx, uint32_t size)
+{
+    LY_CHECK_ARG_RET(ctx, ctx, LY_EINVAL);
+
+    return lyxp_expr_cache_set_size(ctx, size);
+}
+
 LIBYANG_API_DEF struct lys_module *
 ly_ctx_get_module_iter(const struct ly_ctx *ctx, uint32_t *index)
 {
@@ -1261,6 +1286,22 @@ ly_ctx_destroy(struct ly_ctx *ctx)
     /* leftover unres */
     lys_unres_glob_erase(&ctx->unres);
 
+    /* XPath cache */
+    lyxp_expr_cache_set_size(ctx, 0);
+    pthread_mutex_destroy(&ctx->xp_cache_lock);
+
+    /* validation statistics */
+    lyd_val_stats_enable(ctx, 0);
+    pthread_mutex_destroy(&ctx->val_stats_lock);
+
+    /* change journals, all must have been freed just like the data trees */
+    lyht_free(ctx->journals);
+    pthread_mutex_destroy(&ctx->journals_lock);
+
+    /* schema dependency graph */
+    lyd_val_incr_graph_free(ctx);
+    pthread_mutex_destroy(&ctx->val_graph_lock);
+
     /* clean the error list */
     ly_err_clean(ctx, 0);
     pthread_key_delete(ctx->errlist_key);
@@ -1271,6 +1312,9 @@ ly_ctx_destroy(struct ly_ctx *ctx)
     /* LYB hash lock */
     pthread_mutex_destroy(&ctx->lyb_hash_lock);
 
+    /* schema index lock */
+    pthread_mutex_destroy(&ctx->index_lock);
+
     /* plugins - will be removed only if this is the last context */
     lyplg_clean();
 
@@ -109,6 +109,8 @@ struct lys_module;
  * - ::ly_ctx_set_module_imp_clb()
  * - ::ly_ctx_get_module_imp_clb()
  *
+ * - ::ly_ctx_set_xpath_cache()
+ *
  * - ::ly_ctx_load_module()
  * - ::ly_ctx_get_module_iter()
  * - ::ly_ctx_get_module()
@@ -446,6 +448,22 @@ typedef LY_ERR (*ly_ext_data_clb)(const struct lysc_ext_instance *ext, void *use
  */
 LIBYANG_API_DECL ly_ext_data_clb ly_ctx_set_ext_data_clb(struct ly_ctx *ctx, ly_ext_data_clb clb, void *user_data);
 
+/**
+ * @brief Set the size of the context cache of parsed XPath expressions.
+ *
+ * The cache is disabled by default. When enabled, the data XPath functions taking an expression string
+ * (::lyd_find_xpath4(), ::lyd_eval_xpath2(), and their variants) reuse the parsed expressions and the
+ * least recently used ones are evicted once there are more than @p size of them. Expressions do not depend
+ * on the prefixes used in them so they are cached only by the expression string. The cache can be safely
+ * used by several threads but this function must not be called while any other thread is evaluating
+ * an XPath expression in the context.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] size Maximum number of cached expressions, 0 to disable the cache and free all the expressions.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR ly_ctx_set_xpath_cache(struct ly_ctx *ctx, uint32_t size);
+
 /**
  * @brief Get YANG module of the given name and revision.
  *
@@ -16,6 +16,7 @@
 #include "diff.h"
 
 #include <assert.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -25,6 +26,8 @@
 #include "common.h"
 #include "compat.h"
 #include "context.h"
+#include "dict.h"
+#include "hash_table.h"
 #include "log.h"
 #include "plugins_exts.h"
 #include "plugins_types.h"
@@ -106,13 +109,15 @@ lyd_diff_str2op(const char *str)
 }
 
 /**
- * @brief Create diff metadata for a nested user-ordered node with the effective operation "create".
+ * @brief Create diff metadata for a nested user-ordered node with the effective operation "create", or the original
+ * anchor metadata for a nested node with the effective operation "delete".
  *
  * @param[in] node User-rodered node to update.
+ * @param[in] orig Whether to create the original anchor metadata.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_diff_add_create_nested_userord(struct lyd_node *node)
+lyd_diff_add_nested_userord(struct lyd_node *node, ly_bool orig)
 {
     LY_ERR rc = LY_SUCCESS;
     const char *meta_name, *meta_val;
@@ -124,7 +129,7 @@ lyd_diff_add_create_nested_userord(struct lyd_node *node)
 
     /* get correct metadata name and value */
     if (lysc_is_dup_inst_list(node->schema)) {
-        meta_name = "yang:position";
+        meta_name = orig ? "yang:orig-position" : "yang:position";
 
         pos = lyd_list_pos(node);
         if (asprintf(&dyn, "%" PRIu32, pos) == -1) {
@@ -134,7 +139,7 @@ lyd_diff_add_create_nested_userord(struct lyd_node *node)
         }
         meta_val = dyn;
     } else if (node->schema->nodetype == LYS_LIST) {
-        meta_name = "yang:key";
+        meta_name = orig ? "yang:orig-key" : "yang:key";
 
         if (node->prev->next && (node->prev->schema == node->schema)) {
             LY_CHECK_GOTO(rc = lyd_path_list_predicate(node->prev, &dyn, &buflen, &bufused, 0), cleanup);
@@ -143,7 +148,7 @@ lyd_diff_add_create_nested_userord(struct lyd_node *node)
             meta_val = "";
         }
     } else {
-        meta_name = "yang:value";
+        meta_name = orig ? "yang:orig-value" : "yang:value";
 
         if (node->prev->next && (node->prev->schema == node->schema)) {
             meta_val = lyd_get_value(node->prev);
@@ -223,8 +228,9 @@ lyd_diff_add(const struct lyd_node *node, enum lyd_diff_op op, const char *orig_
             diff_parent = lyd_parent(diff_parent);
         }
     } else {
+        /* climb up to the first parent not found in the diff, there may be several missing */
         diff_parent = dup;
-        while (diff_parent->parent && (diff_parent->parent->schema == parent->schema)) {
+        while (diff_parent->schema != parent->schema) {
             diff_parent = lyd_parent(diff_parent);
         }
     }
@@ -253,7 +259,7 @@ lyd_diff_add(const struct lyd_node *node, enum lyd_diff_op op, const char *orig_
         /* all nested user-ordered (leaf-)lists need special metadata for create op */
         LYD_TREE_DFS_BEGIN(dup, elem) {
             if ((elem != dup) && lysc_is_userordered(elem->schema)) {
-                LY_CHECK_RET(lyd_diff_add_create_nested_userord(elem));
+                LY_CHECK_RET(lyd_diff_add_nested_userord(elem, 0));
             }
             LYD_TREE_DFS_END(dup, elem);
         }
@@ -297,6 +303,98 @@ lyd_diff_add(const struct lyd_node *node, enum lyd_diff_op op, const char *orig_
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Index of a user-ordered instance stored in a userord item hash table.
+ */
+struct lyd_diff_userord_rec {
+    const struct lyd_node *node;    /**< instance */
+    uint32_t idx;                   /**< index of the instance in the original order */
+};
+
+/**
+ * @brief Hash table value equal callback for userord instance indices.
+ */
+static ly_bool
+lyd_diff_userord_rec_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_diff_userord_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return rec1->node == rec2->node;
+}
+
+/**
+ * @brief Get the hash of a user-ordered instance in a userord item hash table.
+ *
+ * @param[in] node Instance.
+ * @return Hash of @p node.
+ */
+static uint32_t
+lyd_diff_userord_hash(const struct lyd_node *node)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&node, sizeof node);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Count the remaining instances of a userord item preceding an instance in the original order.
+ *
+ * @param[in] item Userord item.
+ * @param[in] idx Index of the instance in the original order.
+ * @return Number of the remaining instances before @p idx.
+ */
+static uint32_t
+lyd_diff_userord_rem_before(const struct lyd_diff_userord *item, uint32_t idx)
+{
+    uint32_t count = 0;
+
+    for ( ; idx; idx &= idx - 1) {
+        count += item->rem[idx - 1];
+    }
+    return count;
+}
+
+/**
+ * @brief Find a remaining instance of a userord item by its position among the remaining instances.
+ *
+ * @param[in] item Userord item.
+ * @param[in] n Position of the instance among the remaining instances, it must exist.
+ * @return Index of the instance in the original order.
+ */
+static uint32_t
+lyd_diff_userord_rem_find(const struct lyd_diff_userord *item, uint32_t n)
+{
+    uint32_t count = LY_ARRAY_COUNT(item->inst), idx = 0, step;
+
+    assert(n < lyd_diff_userord_rem_before(item, count));
+
+    for (step = 1; step <= count / 2; step <<= 1) {}
+    for ( ; step; step >>= 1) {
+        if ((idx + step <= count) && (item->rem[idx + step - 1] <= n)) {
+            idx += step;
+            n -= item->rem[idx - 1];
+        }
+    }
+    return idx;
+}
+
+/**
+ * @brief Remove an instance from the remaining instances of a userord item.
+ *
+ * @param[in] item Userord item.
+ * @param[in] idx Index of the instance in the original order.
+ */
+static void
+lyd_diff_userord_rem_del(struct lyd_diff_userord *item, uint32_t idx)
+{
+    uint32_t count = LY_ARRAY_COUNT(item->inst);
+
+    for (++idx; idx <= count; idx += idx & -idx) {
+        --item->rem[idx - 1];
+    }
+}
+
 /**
  * @brief Get a userord entry for a specific user-ordered list/leaf-list. Create if does not exist yet.
  *
@@ -309,9 +407,11 @@ static struct lyd_diff_userord *
 lyd_diff_userord_get(const struct lyd_node *first, const struct lysc_node *schema, struct lyd_diff_userord **userord)
 {
     struct lyd_diff_userord *item;
+    struct lyd_diff_userord_rec rec;
     struct lyd_node *iter;
     const struct lyd_node **node;
     LY_ARRAY_COUNT_TYPE u;
+    uint32_t i, count;
 
     LY_ARRAY_FOR(*userord, u) {
         if ((*userord)[u].schema == schema) {
@@ -325,6 +425,9 @@ lyd_diff_userord_get(const struct lyd_node *first, const struct lysc_node *schem
     item->schema = schema;
     item->pos = 0;
     item->inst = NULL;
+    item->rem = NULL;
+    item->inst_ht = NULL;
+    item->last = NULL;
 
     /* store all the instance pointers in the current order */
     if (first) {
@@ -334,11 +437,27 @@ lyd_diff_userord_get(const struct lyd_node *first, const struct lysc_node *schem
         }
     }
 
+    /* all the instances remain, each Fenwick tree node counts all the instances it covers */
+    count = LY_ARRAY_COUNT(item->inst);
+    if (count) {
+        item->rem = malloc(count * sizeof *item->rem);
+        LY_CHECK_RET(!item->rem, NULL);
+        item->inst_ht = lyht_new(LYHT_MIN_SIZE, sizeof rec, lyd_diff_userord_rec_equal_cb, NULL, 1);
+        LY_CHECK_RET(!item->inst_ht, NULL);
+    }
+    for (i = 0; i < count; ++i) {
+        item->rem[i] = (i + 1) & -(i + 1);
+
+        rec.node = item->inst[i];
+        rec.idx = i;
+        LY_CHECK_RET(lyht_insert(item->inst_ht, &rec, lyd_diff_userord_hash(rec.node), NULL), NULL);
+    }
+
     return item;
 }
 
 /**
- * @brief Get all the metadata to be stored in a diff for the 2 nodes. Can be used only for user-ordered
+ * @brief Learn the operation for the 2 nodes and update the current instance order. Can be used only for user-ordered
  * lists/leaf-lists.
  *
  * @param[in] first Node from the first tree, can be NULL (on create).
@@ -346,54 +465,49 @@ lyd_diff_userord_get(const struct lyd_node *first, const struct lysc_node *schem
  * @param[in] options Diff options.
  * @param[in] userord_item Userord item of @p first and/or @p second node.
  * @param[out] op Operation.
- * @param[out] orig_default Original default metadata.
- * @param[out] value Value metadata.
- * @param[out] orig_value Original value metadata
- * @param[out] key Key metadata.
- * @param[out] orig_key Original key metadata.
- * @param[out] position Position metadata.
- * @param[out] orig_position Original position metadata.
+ * @param[out] first_pos Original position of @p first, 0 for the first instance or no @p first.
+ * @param[out] second_pos New position of @p second, 0 for the first instance or no @p second.
+ * @param[out] orig_prev Instance preceding the original position of @p first, if @p first_pos is set.
+ * @param[out] prev Instance preceding the new position of @p second, if @p second_pos is set.
  * @return LY_SUCCESS on success,
  * @return LY_ENOT if there is no change to be added into diff,
  * @return LY_ERR value on other errors.
  */
 static LY_ERR
-lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
-        struct lyd_diff_userord *userord_item, enum lyd_diff_op *op, const char **orig_default, char **value,
-        char **orig_value, char **key, char **orig_key, char **position, char **orig_position)
+lyd_diff_userord_op(const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
+        struct lyd_diff_userord *userord_item, enum lyd_diff_op *op, uint32_t *first_pos, uint32_t *second_pos,
+        const struct lyd_node **orig_prev, const struct lyd_node **prev)
 {
-    LY_ERR rc = LY_SUCCESS;
     const struct lysc_node *schema;
-    size_t buflen, bufused;
-    uint32_t first_pos, second_pos;
+    struct lyd_diff_userord_rec rec, *match;
+    uint32_t idx = 0, head_idx = 0, rem_before;
 
     assert(first || second);
 
-    *orig_default = NULL;
-    *value = NULL;
-    *orig_value = NULL;
-    *key = NULL;
-    *orig_key = NULL;
-    *position = NULL;
-    *orig_position = NULL;
-
     schema = first ? first->schema : second->schema;
     assert(lysc_is_userordered(schema));
 
-    /* find user-ordered first position */
+    /* find user-ordered first position, after all the instances at their final position */
+    *orig_prev = NULL;
     if (first) {
-        for (first_pos = 0; first_pos < LY_ARRAY_COUNT(userord_item->inst); ++first_pos) {
-            if (userord_item->inst[first_pos] == first) {
-                break;
-            }
+        rec.node = first;
+        if (lyht_find(userord_item->inst_ht, &rec, lyd_diff_userord_hash(first), (void **)&match)) {
+            LOGINT_RET(schema->module->ctx);
         }
-        assert(first_pos < LY_ARRAY_COUNT(userord_item->inst));
+        idx = match->idx;
+        rem_before = lyd_diff_userord_rem_before(userord_item, idx);
+        *first_pos = userord_item->pos + rem_before;
+
+        /* instance preceding the first position */
+        *orig_prev = rem_before ? userord_item->inst[lyd_diff_userord_rem_find(userord_item, rem_before - 1)] :
+                userord_item->last;
     } else {
-        first_pos = 0;
+        *first_pos = 0;
     }
 
-    /* prepare position of the next instance */
-    second_pos = userord_item->pos++;
+    /* prepare position of the next instance, preceded by the last instance at its final position */
+    *second_pos = second ? userord_item->pos++ : 0;
+    *prev = userord_item->last;
 
     /* learn operation first */
     if (!second) {
@@ -401,24 +515,91 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
     } else if (!first) {
         *op = LYD_DIFF_OP_CREATE;
     } else {
-        if (lyd_compare_single(second, userord_item->inst[second_pos], 0)) {
+        /* the first remaining instance is on the second position */
+        head_idx = lyd_diff_userord_rem_find(userord_item, 0);
+        if (lyd_compare_single(second, userord_item->inst[head_idx], 0)) {
             /* in first, there is a different instance on the second position, we are going to move 'first' node */
             *op = LYD_DIFF_OP_REPLACE;
         } else if ((options & LYD_DIFF_DEFAULTS) && ((first->flags & LYD_DEFAULT) != (second->flags & LYD_DEFAULT))) {
             /* default flag change */
             *op = LYD_DIFF_OP_NONE;
         } else {
-            /* no changes */
+            /* no changes, the instance is at its final position */
+            lyd_diff_userord_rem_del(userord_item, head_idx);
+            userord_item->last = userord_item->inst[head_idx];
             return LY_ENOT;
         }
     }
 
     /*
-     * set each attribute correctly based on the operation and node type
+     * update our instances - apply the change
      */
+    if (*op == LYD_DIFF_OP_CREATE) {
+        /* insert the instance */
+        userord_item->last = second;
+
+    } else if (*op == LYD_DIFF_OP_DELETE) {
+        /* remove the instance */
+        lyd_diff_userord_rem_del(userord_item, idx);
+
+    } else if (*op == LYD_DIFF_OP_REPLACE) {
+        /* move the instance */
+        lyd_diff_userord_rem_del(userord_item, idx);
+        userord_item->last = first;
+
+    } else {
+        /* the instance is at its final position */
+        lyd_diff_userord_rem_del(userord_item, head_idx);
+        userord_item->last = userord_item->inst[head_idx];
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Get all the metadata to be stored in a diff for a change learned by ::lyd_diff_userord_op(). Can be used
+ * only for user-ordered lists/leaf-lists.
+ *
+ * @param[in] first Node from the first tree, can be NULL (on create).
+ * @param[in] second Node from the second tree, can be NULL (on delete).
+ * @param[in] op Operation.
+ * @param[in] first_pos Original position of @p first.
+ * @param[in] second_pos New position of @p second.
+ * @param[in] orig_prev Instance preceding the original position of @p first.
+ * @param[in] prev Instance preceding the new position of @p second.
+ * @param[out] orig_default Original default metadata.
+ * @param[out] value Value metadata.
+ * @param[out] orig_value Original value metadata
+ * @param[out] key Key metadata.
+ * @param[out] orig_key Original key metadata.
+ * @param[out] position Position metadata.
+ * @param[out] orig_position Original position metadata.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *second, enum lyd_diff_op op,
+        uint32_t first_pos, uint32_t second_pos, const struct lyd_node *orig_prev, const struct lyd_node *prev,
+        const char **orig_default, char **value, char **orig_value, char **key, char **orig_key, char **position,
+        char **orig_position)
+{
+    LY_ERR rc = LY_SUCCESS;
+    const struct lysc_node *schema;
+    size_t buflen, bufused;
+
+    assert(first || second);
+
+    *orig_default = NULL;
+    *value = NULL;
+    *orig_value = NULL;
+    *key = NULL;
+    *orig_key = NULL;
+    *position = NULL;
+    *orig_position = NULL;
+
+    schema = first ? first->schema : second->schema;
 
     /* orig-default */
-    if ((schema->nodetype == LYS_LEAFLIST) && ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_NONE))) {
+    if ((schema->nodetype == LYS_LEAFLIST) && ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_NONE))) {
         if (first->flags & LYD_DEFAULT) {
             *orig_default = "true";
         } else {
@@ -428,9 +609,9 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
 
     /* value */
     if ((schema->nodetype == LYS_LEAFLIST) && !lysc_is_dup_inst_list(schema) &&
-            ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_CREATE))) {
+            ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_CREATE))) {
         if (second_pos) {
-            *value = strdup(lyd_get_value(userord_item->inst[second_pos - 1]));
+            *value = strdup(lyd_get_value(prev));
             LY_CHECK_ERR_GOTO(!*value, LOGMEM(schema->module->ctx); rc = LY_EMEM, cleanup);
         } else {
             *value = strdup("");
@@ -440,9 +621,9 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
 
     /* orig-value */
     if ((schema->nodetype == LYS_LEAFLIST) && !lysc_is_dup_inst_list(schema) &&
-            ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_DELETE))) {
+            ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_DELETE))) {
         if (first_pos) {
-            *orig_value = strdup(lyd_get_value(userord_item->inst[first_pos - 1]));
+            *orig_value = strdup(lyd_get_value(orig_prev));
             LY_CHECK_ERR_GOTO(!*orig_value, LOGMEM(schema->module->ctx); rc = LY_EMEM, cleanup);
         } else {
             *orig_value = strdup("");
@@ -452,10 +633,10 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
 
     /* key */
     if ((schema->nodetype == LYS_LIST) && !lysc_is_dup_inst_list(schema) &&
-            ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_CREATE))) {
+            ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_CREATE))) {
         if (second_pos) {
             buflen = bufused = 0;
-            LY_CHECK_GOTO(rc = lyd_path_list_predicate(userord_item->inst[second_pos - 1], key, &buflen, &bufused, 0), cleanup);
+            LY_CHECK_GOTO(rc = lyd_path_list_predicate(prev, key, &buflen, &bufused, 0), cleanup);
         } else {
             *key = strdup("");
             LY_CHECK_ERR_GOTO(!*key, LOGMEM(schema->module->ctx); rc = LY_EMEM, cleanup);
@@ -464,10 +645,10 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
 
     /* orig-key */
     if ((schema->nodetype == LYS_LIST) && !lysc_is_dup_inst_list(schema) &&
-            ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_DELETE))) {
+            ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_DELETE))) {
         if (first_pos) {
             buflen = bufused = 0;
-            LY_CHECK_GOTO(rc = lyd_path_list_predicate(userord_item->inst[first_pos - 1], orig_key, &buflen, &bufused, 0), cleanup);
+            LY_CHECK_GOTO(rc = lyd_path_list_predicate(orig_prev, orig_key, &buflen, &bufused, 0), cleanup);
         } else {
             *orig_key = strdup("");
             LY_CHECK_ERR_GOTO(!*orig_key, LOGMEM(schema->module->ctx); rc = LY_EMEM, cleanup);
@@ -475,7 +656,7 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
     }
 
     /* position */
-    if (lysc_is_dup_inst_list(schema) && ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_CREATE))) {
+    if (lysc_is_dup_inst_list(schema) && ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_CREATE))) {
         if (second_pos) {
             if (asprintf(position, "%" PRIu32, second_pos) == -1) {
                 LOGMEM(schema->module->ctx);
@@ -489,7 +670,7 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
     }
 
     /* orig-position */
-    if (lysc_is_dup_inst_list(schema) && ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_DELETE))) {
+    if (lysc_is_dup_inst_list(schema) && ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_DELETE))) {
         if (first_pos) {
             if (asprintf(orig_position, "%" PRIu32, first_pos) == -1) {
                 LOGMEM(schema->module->ctx);
@@ -502,34 +683,6 @@ lyd_diff_userord_attrs(const struct lyd_node *first, const struct lyd_node *seco
         }
     }
 
-    /*
-     * update our instances - apply the change
-     */
-    if (*op == LYD_DIFF_OP_CREATE) {
-        /* insert the instance */
-        LY_ARRAY_CREATE_GOTO(schema->module->ctx, userord_item->inst, 1, rc, cleanup);
-        if (second_pos < LY_ARRAY_COUNT(userord_item->inst)) {
-            memmove(userord_item->inst + second_pos + 1, userord_item->inst + second_pos,
-                    (LY_ARRAY_COUNT(userord_item->inst) - second_pos) * sizeof *userord_item->inst);
-        }
-        LY_ARRAY_INCREMENT(userord_item->inst);
-        userord_item->inst[second_pos] = second;
-
-    } else if (*op == LYD_DIFF_OP_DELETE) {
-        /* remove the instance */
-        if (first_pos + 1 < LY_ARRAY_COUNT(userord_item->inst)) {
-            memmove(userord_item->inst + first_pos, userord_item->inst + first_pos + 1,
-                    (LY_ARRAY_COUNT(userord_item->inst) - first_pos - 1) * sizeof *userord_item->inst);
-        }
-        LY_ARRAY_DECREMENT(userord_item->inst);
-
-    } else if (*op == LYD_DIFF_OP_REPLACE) {
-        /* move the instances */
-        memmove(userord_item->inst + second_pos + 1, userord_item->inst + second_pos,
-                (first_pos - second_pos) * sizeof *userord_item->inst);
-        userord_item->inst[second_pos] = first;
-    }
-
 cleanup:
     if (rc) {
         free(*value);
@@ -549,35 +702,26 @@ cleanup:
 }
 
 /**
- * @brief Get all the metadata to be stored in a diff for the 2 nodes. Cannot be used for user-ordered
- * lists/leaf-lists.
+ * @brief Learn the operation for the 2 nodes. Cannot be used for user-ordered lists/leaf-lists.
  *
  * @param[in] first Node from the first tree, can be NULL (on create).
  * @param[in] second Node from the second tree, can be NULL (on delete).
  * @param[in] options Diff options.
  * @param[out] op Operation.
- * @param[out] orig_default Original default metadata.
- * @param[out] orig_value Original value metadata.
  * @return LY_SUCCESS on success,
  * @return LY_ENOT if there is no change to be added into diff,
  * @return LY_ERR value on other errors.
  */
 static LY_ERR
-lyd_diff_attrs(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, enum lyd_diff_op *op,
-        const char **orig_default, char **orig_value)
+lyd_diff_learn_op(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, enum lyd_diff_op *op)
 {
     const struct lysc_node *schema;
-    const char *str_val;
 
     assert(first || second);
 
-    *orig_default = NULL;
-    *orig_value = NULL;
-
     schema = first ? first->schema : second->schema;
     assert(!lysc_is_userordered(schema));
 
-    /* learn operation first */
     if (!second) {
         *op = LYD_DIFF_OP_DELETE;
     } else if (!first) {
@@ -619,12 +763,36 @@ lyd_diff_attrs(const struct lyd_node *first, const struct lyd_node *second, uint
         }
     }
 
-    /*
-     * set each attribute correctly based on the operation and node type
-     */
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Get all the metadata to be stored in a diff for a change learned by ::lyd_diff_learn_op(). Cannot be used
+ * for user-ordered lists/leaf-lists.
+ *
+ * @param[in] first Node from the first tree, can be NULL (on create).
+ * @param[in] second Node from the second tree, can be NULL (on delete).
+ * @param[in] op Operation.
+ * @param[out] orig_default Original default metadata.
+ * @param[out] orig_value Original value metadata.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_attrs(const struct lyd_node *first, const struct lyd_node *second, enum lyd_diff_op op,
+        const char **orig_default, char **orig_value)
+{
+    const struct lysc_node *schema;
+    const char *str_val;
+
+    assert(first || second);
+
+    *orig_default = NULL;
+    *orig_value = NULL;
+
+    schema = first ? first->schema : second->schema;
 
     /* orig-default */
-    if ((schema->nodetype & LYD_NODE_TERM) && ((*op == LYD_DIFF_OP_REPLACE) || (*op == LYD_DIFF_OP_NONE))) {
+    if ((schema->nodetype & LYD_NODE_TERM) && ((op == LYD_DIFF_OP_REPLACE) || (op == LYD_DIFF_OP_NONE))) {
         if (first->flags & LYD_DEFAULT) {
             *orig_default = "true";
         } else {
@@ -633,7 +801,7 @@ lyd_diff_attrs(const struct lyd_node *first, const struct lyd_node *second, uint
     }
 
     /* orig-value */
-    if ((schema->nodetype & (LYS_LEAF | LYS_ANYDATA)) && (*op == LYD_DIFF_OP_REPLACE)) {
+    if ((schema->nodetype & (LYS_LEAF | LYS_ANYDATA)) && (op == LYD_DIFF_OP_REPLACE)) {
         if (schema->nodetype == LYS_LEAF) {
             str_val = lyd_get_value(first);
             *orig_value = strdup(str_val ? str_val : "");
@@ -678,6 +846,148 @@ lyd_diff_find_match(const struct lyd_node *siblings, const struct lyd_node *targ
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Report a change of 2 nodes or append it to a diff. Cannot be used for user-ordered lists/leaf-lists.
+ *
+ * @param[in] first Node from the first tree, can be NULL (on create).
+ * @param[in] second Node from the second tree, can be NULL (on delete).
+ * @param[in] op Operation.
+ * @param[in] change_cb Optional callback to report the change to instead of appending it to @p diff.
+ * @param[in] cb_data User data for @p change_cb.
+ * @param[in,out] diff Diff to append to.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_report(const struct lyd_node *first, const struct lyd_node *second, enum lyd_diff_op op,
+        lyd_diff_change_cb change_cb, void *cb_data, struct lyd_node **diff)
+{
+    LY_ERR ret;
+    const char *orig_default;
+    char *orig_value;
+
+    if (change_cb) {
+        return change_cb(op, first, second, NULL, cb_data);
+    }
+
+    /* get all the attributes */
+    LY_CHECK_RET(lyd_diff_attrs(first, second, op, &orig_default, &orig_value));
+
+    ret = lyd_diff_add(second ? second : first, op, orig_default, orig_value, NULL, NULL, NULL, NULL, NULL, diff);
+    free(orig_value);
+    return ret;
+}
+
+/**
+ * @brief Report a change of 2 nodes or append it to a diff. Can be used only for user-ordered lists/leaf-lists.
+ *
+ * @param[in] first Node from the first tree, can be NULL (on create).
+ * @param[in] second Node from the second tree, can be NULL (on delete).
+ * @param[in] op Operation.
+ * @param[in] first_pos Original position of @p first.
+ * @param[in] second_pos New position of @p second.
+ * @param[in] orig_prev Instance preceding the original position of @p first.
+ * @param[in] prev Instance preceding the new position of @p second.
+ * @param[in] change_cb Optional callback to report the change to instead of appending it to @p diff.
+ * @param[in] cb_data User data for @p change_cb.
+ * @param[in,out] diff Diff to append to.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_userord_report(const struct lyd_node *first, const struct lyd_node *second, enum lyd_diff_op op,
+        uint32_t first_pos, uint32_t second_pos, const struct lyd_node *orig_prev, const struct lyd_node *prev,
+        lyd_diff_change_cb change_cb, void *cb_data, struct lyd_node **diff)
+{
+    LY_ERR ret;
+    const char *orig_default;
+    char *orig_value, *key, *value, *position, *orig_key, *orig_position;
+
+    if (change_cb) {
+        /* all the preceding instances are at their final position so the anchor is the previous instance in second */
+        if (second_pos && ((op == LYD_DIFF_OP_CREATE) || (op == LYD_DIFF_OP_REPLACE))) {
+            assert(second->prev->next && (second->prev->schema == second->schema));
+            prev = second->prev;
+        } else {
+            prev = NULL;
+        }
+        return change_cb(op, first, second, prev, cb_data);
+    }
+
+    /* get all the attributes */
+    LY_CHECK_RET(lyd_diff_userord_attrs(first, second, op, first_pos, second_pos, orig_prev, prev, &orig_default,
+            &value, &orig_value, &key, &orig_key, &position, &orig_position));
+
+    ret = lyd_diff_add(second ? second : first, op, orig_default, orig_value, key, value, position, orig_key,
+            orig_position, diff);
+
+    free(orig_value);
+    free(key);
+    free(value);
+    free(position);
+    free(orig_key);
+    free(orig_position);
+    return ret;
+}
+
+/**
+ * @brief Multi-threaded diff work unit, changes of a single sibling from the first tree or of all the siblings
+ * from the second tree.
+ */
+struct lyd_diff_mt_unit {
+    const struct lyd_node *first;   /**< node from the first tree whose descendants are yet to be compared, if any */
+    const struct lyd_node *second;  /**< matching node from the second tree */
+    uint32_t depth;                 /**< number of data parents of the sibling(s) */
+    ly_bool serial;                 /**< whether the descendants must be compared directly into the final diff */
+
+    struct lyd_node *diff;          /**< partial diff of the unit */
+    LY_ERR ret;                     /**< result of comparing the descendants */
+    struct ly_err_item *log;        /**< captured messages of comparing the descendants */
+};
+
+/**
+ * @brief Multi-threaded diff context.
+ *
+ * Units are stored in the order a serial diff would generate their changes in so that the partial diffs can be
+ * joined into a diff equal to the serial one.
+ */
+struct lyd_diff_mt {
+    const struct ly_ctx *ctx;       /**< context */
+    uint16_t options;               /**< diff options */
+    struct lyd_diff_mt_unit *units; /**< work units */
+    uint32_t count;                 /**< number of work units */
+    uint32_t size;                  /**< allocated size of work units */
+
+    ATOMIC_T next;                  /**< index of the next unit to process */
+};
+
+/**
+ * @brief Add a new multi-threaded diff work unit.
+ *
+ * @param[in] mt Multi-threaded diff context.
+ * @param[in] node Sibling of the unit.
+ * @param[out] unit Added unit, valid until another unit is added.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_mt_unit_new(struct lyd_diff_mt *mt, const struct lyd_node *node, struct lyd_diff_mt_unit **unit)
+{
+    void *mem;
+
+    if (mt->count == mt->size) {
+        mem = realloc(mt->units, (mt->size ? mt->size * 2 : 32) * sizeof *mt->units);
+        LY_CHECK_ERR_RET(!mem, LOGMEM(mt->ctx), LY_EMEM);
+        mt->units = mem;
+        mt->size = mt->size ? mt->size * 2 : 32;
+    }
+
+    *unit = &mt->units[mt->count++];
+    memset(*unit, 0, sizeof **unit);
+    for (node = lyd_parent(node); node; node = lyd_parent(node)) {
+        ++(*unit)->depth;
+    }
+
+    return LY_SUCCESS;
+}
+
 /**
  * @brief Perform diff for all siblings at certain depth, recursively.
  *
@@ -716,22 +1026,26 @@ lyd_diff_find_match(const struct lyd_node *siblings, const struct lyd_node *targ
  * @param[in] second Second tree first sibling.
  * @param[in] options Diff options.
  * @param[in] nosiblings Whether to skip following siblings.
+ * @param[in] change_cb Optional callback to report the changes to instead of appending them to @p diff.
+ * @param[in] cb_data User data for @p change_cb.
+ * @param[in] mt Optional multi-threaded diff context, the changes are then collected into its work units and
+ * the descendants of the siblings are only prepared to be compared by ::lyd_diff_mt_run().
  * @param[in,out] diff Diff to append to.
  * @return LY_ERR value.
  */
 static LY_ERR
 lyd_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, ly_bool nosiblings,
-        struct lyd_node **diff)
+        lyd_diff_change_cb change_cb, void *cb_data, struct lyd_diff_mt *mt, struct lyd_node **diff)
 {
     LY_ERR ret = LY_SUCCESS;
-    const struct lyd_node *iter_first, *iter_second;
-    struct lyd_node *match_second, *match_first;
+    const struct lyd_node *iter_first, *iter_second, *prev, *orig_prev;
+    struct lyd_node *match_second, *match_first, **part = diff;
+    struct lyd_diff_mt_unit *unit;
     struct lyd_diff_userord *userord = NULL, *userord_item;
     struct lyd_dup_inst *dup_inst_first = NULL, *dup_inst_second = NULL;
     LY_ARRAY_COUNT_TYPE u;
     enum lyd_diff_op op;
-    const char *orig_default;
-    char *orig_value, *key, *value, *position, *orig_key, *orig_position;
+    uint32_t first_pos, second_pos;
 
     /* compare first tree to the second tree - delete, replace, none */
     LY_LIST_FOR(first, iter_first) {
@@ -745,6 +1059,12 @@ lyd_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second,
             continue;
         }
 
+        if (mt) {
+            /* collect the changes of this sibling separately */
+            LY_CHECK_GOTO(ret = lyd_diff_mt_unit_new(mt, iter_first, &unit), cleanup);
+            part = &unit->diff;
+        }
+
         /* find a match in the second tree */
         LY_CHECK_GOTO(ret = lyd_diff_find_match(second, iter_first, options & LYD_DIFF_DEFAULTS, &dup_inst_second,
                 &match_second), cleanup);
@@ -756,38 +1076,22 @@ lyd_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second,
 
             /* we are handling only user-ordered node delete now */
             if (!match_second) {
-                /* get all the attributes */
-                LY_CHECK_GOTO(ret = lyd_diff_userord_attrs(iter_first, match_second, options, userord_item, &op,
-                        &orig_default, &value, &orig_value, &key, &orig_key, &position, &orig_position), cleanup);
+                /* learn the operation */
+                LY_CHECK_GOTO(ret = lyd_diff_userord_op(iter_first, match_second, options, userord_item, &op,
+                        &first_pos, &second_pos, &orig_prev, &prev), cleanup);
 
                 /* there must be changes, it is deleted */
                 assert(op == LYD_DIFF_OP_DELETE);
-                ret = lyd_diff_add(iter_first, op, orig_default, orig_value, key, value, position, orig_key,
-                        orig_position, diff);
-
-                free(orig_value);
-                free(key);
-                free(value);
-                free(position);
-                free(orig_key);
-                free(orig_position);
-                LY_CHECK_GOTO(ret, cleanup);
+                LY_CHECK_GOTO(ret = lyd_diff_userord_report(iter_first, match_second, op, first_pos, second_pos,
+                        orig_prev, prev, change_cb, cb_data, part), cleanup);
             }
         } else {
-            /* get all the attributes */
-            ret = lyd_diff_attrs(iter_first, match_second, options, &op, &orig_default, &orig_value);
+            /* learn the operation */
+            ret = lyd_diff_learn_op(iter_first, match_second, options, &op);
 
             /* add into diff if there are any changes */
             if (!ret) {
-                if (op == LYD_DIFF_OP_DELETE) {
-                    ret = lyd_diff_add(iter_first, op, orig_default, orig_value, NULL, NULL, NULL, NULL, NULL, diff);
-                } else {
-                    assert(match_second);
-                    ret = lyd_diff_add(match_second, op, orig_default, orig_value, NULL, NULL, NULL, NULL, NULL, diff);
-                }
-
-                free(orig_value);
-                LY_CHECK_GOTO(ret, cleanup);
+                LY_CHECK_GOTO(ret = lyd_diff_report(iter_first, match_second, op, change_cb, cb_data, part), cleanup);
             } else if (ret == LY_ENOT) {
                 ret = LY_SUCCESS;
             } else {
@@ -795,10 +1099,19 @@ lyd_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second,
             }
         }
 
-        /* check descendants, if any, recursively */
-        if (match_second) {
-            LY_CHECK_GOTO(ret = lyd_diff_siblings_r(lyd_child_no_keys(iter_first), lyd_child_no_keys(match_second),
-                    options, 0, diff), cleanup);
+        /* check descendants, if any, recursively, unless they are known to be equal */
+        if (match_second && !((options & LYD_DIFF_SUBTREE_HASH) && (iter_first->schema->nodetype & LYD_NODE_INNER) &&
+                (lyd_hash_subtree(iter_first) == lyd_hash_subtree(match_second)))) {
+            if (mt && (iter_first->schema->nodetype != LYS_CONTAINER)) {
+                /* compare the descendants later, in parallel */
+                unit->first = iter_first;
+                unit->second = match_second;
+                unit->serial = lysc_is_dup_inst_list(iter_first->schema);
+            } else {
+                /* in parallel mode, the children of a container are split into units, too */
+                LY_CHECK_GOTO(ret = lyd_diff_siblings_r(lyd_child_no_keys(iter_first), lyd_child_no_keys(match_second),
+                        options, 0, change_cb, cb_data, mt, diff), cleanup);
+            }
         }
 
         if (nosiblings) {
@@ -811,6 +1124,12 @@ lyd_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second,
         userord[u].pos = 0;
     }
 
+    if (mt && second) {
+        /* collect the changes of all the siblings separately */
+        LY_CHECK_GOTO(ret = lyd_diff_mt_unit_new(mt, second, &unit), cleanup);
+        part = &unit->diff;
+    }
+
     /* compare second tree to the first tree - create, user-ordered move */
     LY_LIST_FOR(second, iter_second) {
         if (!iter_second->schema) {
@@ -832,37 +1151,26 @@ lyd_diff_siblings_r(const struct lyd_node *first, const struct lyd_node *second,
             userord_item = lyd_diff_userord_get(NULL, iter_second->schema, &userord);
             LY_CHECK_ERR_GOTO(!userord_item, LOGMEM(LYD_CTX(iter_second)); ret = LY_EMEM, cleanup);
 
-            /* get all the attributes */
-            ret = lyd_diff_userord_attrs(match_first, iter_second, options, userord_item, &op, &orig_default,
-                    &value, &orig_value, &key, &orig_key, &position, &orig_position);
+            /* learn the operation */
+            ret = lyd_diff_userord_op(match_first, iter_second, options, userord_item, &op, &first_pos, &second_pos,
+                    &orig_prev, &prev);
 
             /* add into diff if there are any changes */
             if (!ret) {
-                ret = lyd_diff_add(iter_second, op, orig_default, orig_value, key, value, position, orig_key,
-                        orig_position, diff);
-
-                free(orig_value);
-                free(key);
-                free(value);
-                free(position);
-                free(orig_key);
-                free(orig_position);
-                LY_CHECK_GOTO(ret, cleanup);
+                LY_CHECK_GOTO(ret = lyd_diff_userord_report(match_first, iter_second, op, first_pos, second_pos,
+                        orig_prev, prev, change_cb, cb_data, part), cleanup);
             } else if (ret == LY_ENOT) {
                 ret = LY_SUCCESS;
             } else {
                 goto cleanup;
             }
         } else if (!match_first) {
-            /* get all the attributes */
-            LY_CHECK_GOTO(ret = lyd_diff_attrs(match_first, iter_second, options, &op, &orig_default, &orig_value), cleanup);
+            /* learn the operation */
+            LY_CHECK_GOTO(ret = lyd_diff_learn_op(match_first, iter_second, options, &op), cleanup);
 
             /* there must be changes, it is created */
             assert(op == LYD_DIFF_OP_CREATE);
-            ret = lyd_diff_add(iter_second, op, orig_default, orig_value, NULL, NULL, NULL, NULL, NULL, diff);
-
-            free(orig_value);
-            LY_CHECK_GOTO(ret, cleanup);
+            LY_CHECK_GOTO(ret = lyd_diff_report(match_first, iter_second, op, change_cb, cb_data, part), cleanup);
         } /* else was handled */
 
         if (nosiblings) {
@@ -875,47 +1183,268 @@ cleanup:
     lyd_dup_inst_free(dup_inst_second);
     LY_ARRAY_FOR(userord, u) {
         LY_ARRAY_FREE(userord[u].inst);
+        free(userord[u].rem);
+        lyht_free(userord[u].inst_ht);
     }
     LY_ARRAY_FREE(userord);
     return ret;
 }
 
-static LY_ERR
-lyd_diff(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, ly_bool nosiblings,
-        struct lyd_node **diff)
+/**
+ * @brief Multi-threaded diff worker thread, compares the descendants of the units.
+ *
+ * @param[in] arg Multi-threaded diff context.
+ * @return NULL.
+ */
+static void *
+lyd_diff_mt_worker(void *arg)
 {
-    const struct ly_ctx *ctx;
+    struct lyd_diff_mt *mt = arg;
+    struct lyd_diff_mt_unit *unit;
+    uint32_t u;
 
-    LY_CHECK_ARG_RET(NULL, diff, LY_EINVAL);
+    while ((u = ATOMIC_INC_RELAXED(mt->next)) < mt->count) {
+        unit = &mt->units[u];
+        if (!unit->first || unit->serial) {
+            continue;
+        }
 
-    if (first) {
-        ctx = LYD_CTX(first);
-    } else if (second) {
-        ctx = LYD_CTX(second);
-    } else {
-        ctx = NULL;
+        ly_log_capture_start(mt->ctx);
+        unit->ret = lyd_diff_siblings_r(lyd_child_no_keys(unit->first), lyd_child_no_keys(unit->second), mt->options,
+                0, NULL, NULL, NULL, &unit->diff);
+        unit->log = ly_log_capture_stop(mt->ctx);
     }
 
-    if (first && second && (lysc_data_parent(first->schema) != lysc_data_parent(second->schema))) {
+    return NULL;
+}
+
+/**
+ * @brief Move a partial diff of a unit into the diff.
+ *
+ * The parents of the unit siblings are merged with the ones already in the diff the same way ::lyd_diff_add() finds
+ * them so the result is the same as if the changes were appended directly to the diff.
+ *
+ * @param[in] parent Diff parent to move @p part into, NULL for top-level.
+ * @param[in,out] diff Diff to move into.
+ * @param[in] part Partial diff siblings to move, are consumed.
+ * @param[in] depth Depth of the unit siblings relative to @p part.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_mt_join(struct lyd_node *parent, struct lyd_node **diff, struct lyd_node *part, uint32_t depth)
+{
+    struct lyd_node *iter, *next, *match;
+    struct lyd_meta *meta;
+    const struct lys_module *yang_mod;
+
+    LY_LIST_FOR_SAFE(part, next, iter) {
+        if (depth && !lyd_find_sibling_first(parent ? lyd_child_no_keys(parent) : *diff, iter, &match)) {
+            /* parent already in the diff, join its children */
+            LY_CHECK_RET(lyd_diff_mt_join(match, diff, lyd_child_no_keys(iter), depth - 1));
+            lyd_free_tree(iter);
+            continue;
+        }
+
+        /* move the subtree */
+        lyd_unlink_tree(iter);
+        if (parent) {
+            LY_CHECK_RET(lyd_insert_child(parent, iter));
+        } else {
+            LY_CHECK_RET(lyd_insert_sibling(*diff, iter, diff));
+        }
+
+        /* a nested parent did not have the operation because its own parent was created in the partial diff */
+        yang_mod = LYD_CTX(iter)->list.objs[1];
+        meta = lyd_find_meta(iter->meta, yang_mod, "operation");
+        if (!meta) {
+            LY_CHECK_RET(lyd_new_meta(LYD_CTX(iter), iter, yang_mod, "operation", "none", 0, NULL));
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Compare the descendants of all the units by worker threads and join the partial diffs in the serial order.
+ *
+ * @param[in] mt Multi-threaded diff context with the units.
+ * @param[in,out] diff Diff to append to.
+ * @return LY_ERR value of the first failed unit.
+ */
+static LY_ERR
+lyd_diff_mt_run(struct lyd_diff_mt *mt, struct lyd_node **diff)
+{
+    LY_ERR rc = LY_SUCCESS;
+    pthread_t threads[LY_MT_THREADS_MAX];
+    struct lyd_diff_mt_unit *unit;
+    uint32_t u, thread_count, work_count = 0;
+
+    for (u = 0; u < mt->count; ++u) {
+        if (mt->units[u].first && !mt->units[u].serial) {
+            ++work_count;
+        }
+    }
+
+    /* compare the descendants */
+    ATOMIC_STORE_RELAXED(mt->next, 0);
+    thread_count = ly_mt_thread_count();
+    if (thread_count > work_count) {
+        thread_count = work_count;
+    }
+    for (u = 0; (thread_count > 1) && (u < thread_count); ++u) {
+        if (pthread_create(&threads[u], NULL, lyd_diff_mt_worker, mt)) {
+            break;
+        }
+    }
+    thread_count = u;
+    if (!thread_count) {
+        /* not worth it or no thread could be created */
+        lyd_diff_mt_worker(mt);
+    }
+    for (u = 0; u < thread_count; ++u) {
+        pthread_join(threads[u], NULL);
+    }
+
+    /* join the partial diffs and log the messages of the units up to the first failed one */
+    for (u = 0; u < mt->count; ++u) {
+        unit = &mt->units[u];
+        if (!rc) {
+            ly_log_replay(mt->ctx, unit->log);
+            rc = unit->ret;
+        } else {
+            ly_err_free(unit->log);
+        }
+        unit->log = NULL;
+
+        if (!rc) {
+            rc = lyd_diff_mt_join(NULL, diff, unit->diff, unit->depth);
+            unit->diff = NULL;
+        }
+        if (!rc && unit->serial) {
+            /* duplicate instances could be matched with the parents of other units, compare them directly */
+            rc = lyd_diff_siblings_r(lyd_child_no_keys(unit->first), lyd_child_no_keys(unit->second), mt->options, 0,
+                    NULL, NULL, NULL, diff);
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Learn the differences between 2 data trees by several worker threads.
+ *
+ * @param[in] ctx Context for logging.
+ * @param[in] first First tree first sibling.
+ * @param[in] second Second tree first sibling.
+ * @param[in] options Diff options.
+ * @param[in] nosiblings Whether to skip following siblings.
+ * @param[in,out] diff Diff to append to.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_mt(const struct ly_ctx *ctx, const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
+        ly_bool nosiblings, struct lyd_node **diff)
+{
+    LY_ERR rc;
+    struct lyd_diff_mt mt = {0};
+    const struct lyd_node *parent, *key;
+    uint32_t u;
+
+    mt.ctx = ctx;
+    mt.options = options;
+
+    /* the trees are only read by the workers, the parents are duplicated into all the partial diffs */
+    lyd_mt_prepare(first ? lyd_first_sibling(first) : NULL, 0);
+    lyd_mt_prepare(second ? lyd_first_sibling(second) : NULL, 0);
+    for (parent = first ? lyd_parent(first) : NULL; parent; parent = lyd_parent(parent)) {
+        for (key = lyd_child(parent); key && lysc_is_key(key->schema); key = key->next) {
+            lyd_get_value(key);
+        }
+    }
+    for (parent = second ? lyd_parent(second) : NULL; parent; parent = lyd_parent(parent)) {
+        for (key = lyd_child(parent); key && lysc_is_key(key->schema); key = key->next) {
+            lyd_get_value(key);
+        }
+    }
+
+    /* generate the changes of the siblings and prepare the units */
+    rc = lyd_diff_siblings_r(first, second, options, nosiblings, NULL, NULL, &mt, diff);
+
+    if (!rc) {
+        /* compare the descendants */
+        rc = lyd_diff_mt_run(&mt, diff);
+    }
+
+    for (u = 0; u < mt.count; ++u) {
+        ly_err_free(mt.units[u].log);
+        lyd_free_siblings(mt.units[u].diff);
+    }
+    free(mt.units);
+    return rc;
+}
+
+static LY_ERR
+lyd_diff(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, ly_bool nosiblings,
+        lyd_diff_change_cb change_cb, void *cb_data, struct lyd_node **diff)
+{
+    const struct ly_ctx *ctx;
+
+    if (first) {
+        ctx = LYD_CTX(first);
+    } else if (second) {
+        ctx = LYD_CTX(second);
+    } else {
+        ctx = NULL;
+    }
+
+    if (first && second && (lysc_data_parent(first->schema) != lysc_data_parent(second->schema))) {
         LOGERR(ctx, LY_EINVAL, "Invalid arguments - cannot create diff for unrelated data (%s()).", __func__);
         return LY_EINVAL;
     }
 
-    *diff = NULL;
+    if (diff) {
+        *diff = NULL;
+    }
+
+    if ((options & LYD_DIFF_MULTI_THREADED) && !change_cb) {
+        return lyd_diff_mt(ctx, first, second, options, nosiblings, diff);
+    }
 
-    return lyd_diff_siblings_r(first, second, options, nosiblings, diff);
+    return lyd_diff_siblings_r(first, second, options, nosiblings, change_cb, cb_data, NULL, diff);
 }
 
 LIBYANG_API_DEF LY_ERR
 lyd_diff_tree(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, struct lyd_node **diff)
 {
-    return lyd_diff(first, second, options, 1, diff);
+    LY_CHECK_ARG_RET(NULL, diff, LY_EINVAL);
+
+    return lyd_diff(first, second, options, 1, NULL, NULL, diff);
 }
 
 LIBYANG_API_DEF LY_ERR
 lyd_diff_siblings(const struct lyd_node *first, const struct lyd_node *second, uint16_t options, struct lyd_node **diff)
 {
-    return lyd_diff(first, second, options, 0, diff);
+    LY_CHECK_ARG_RET(NULL, diff, LY_EINVAL);
+
+    return lyd_diff(first, second, options, 0, NULL, NULL, diff);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_diff_tree_cb(const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
+        lyd_diff_change_cb change_cb, void *cb_data)
+{
+    LY_CHECK_ARG_RET(NULL, change_cb, LY_EINVAL);
+
+    return lyd_diff(first, second, options, 1, change_cb, cb_data, NULL);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_diff_siblings_cb(const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
+        lyd_diff_change_cb change_cb, void *cb_data)
+{
+    LY_CHECK_ARG_RET(NULL, change_cb, LY_EINVAL);
+
+    return lyd_diff(first, second, options, 0, change_cb, cb_data, NULL);
 }
 
 /**
@@ -960,6 +1489,187 @@ lyd_diff_get_op(const struct lyd_node *diff_node, enum lyd_diff_op *op)
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Record of an applied user-ordered instance in the anchor cache.
+ */
+struct lyd_diff_anchor_rec {
+    const struct lysc_node *schema; /**< schema node of the instance */
+    const char *anchor;             /**< anchor string to find, set only when searching */
+    struct lyd_node *node;          /**< data instance, set only when stored */
+};
+
+/**
+ * @brief Cache of user-ordered instances usable as anchors, for one level of data siblings.
+ *
+ * Anchors of consecutively applied instances (mostly the previous instance) are found by the hash of their
+ * canonical anchor string so that it does not need to be parsed and stored as a value.
+ */
+struct lyd_diff_anchors {
+    struct hash_table *ht;  /**< hash table of struct lyd_diff_anchor_rec */
+    char *buf;              /**< buffer for printing list instance anchors */
+    size_t buflen;          /**< allocated length of @p buf */
+};
+
+/**
+ * @brief Get the anchor string of a user-ordered instance, as used in the diff metadata.
+ *
+ * @param[in] anchors Anchor cache with the buffer to use.
+ * @param[in] node User-ordered (leaf-)list instance.
+ * @param[out] anchor Anchor string, valid until the next call.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_anchors_str(struct lyd_diff_anchors *anchors, const struct lyd_node *node, const char **anchor)
+{
+    size_t bufused = 0;
+
+    if (node->schema->nodetype == LYS_LEAFLIST) {
+        *anchor = lyd_get_value(node);
+        return LY_SUCCESS;
+    }
+
+    LY_CHECK_RET(lyd_path_list_predicate(node, &anchors->buf, &anchors->buflen, &bufused, 0));
+    *anchor = bufused ? anchors->buf : "";
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Get the hash of an anchor.
+ *
+ * @param[in] schema Schema node of the instance.
+ * @param[in] anchor Anchor string.
+ * @return Anchor hash.
+ */
+static uint32_t
+lyd_diff_anchors_hash(const struct lysc_node *schema, const char *anchor)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, schema->name, strlen(schema->name));
+    hash = dict_hash_multi(hash, anchor, strlen(anchor));
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Hash table equal callback for anchor cache records.
+ *
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_diff_anchors_val_equal(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *cb_data)
+{
+    struct lyd_diff_anchor_rec *rec1 = val1_p, *rec2 = val2_p;
+    struct lyd_diff_anchors *anchors = cb_data;
+    const char *anchor;
+
+    if (rec1->node) {
+        /* inserting or removing a specific instance */
+        return rec1->node == rec2->node;
+    }
+
+    /* searching for an anchor */
+    if ((rec1->schema != rec2->schema) || lyd_diff_anchors_str(anchors, rec2->node, &anchor)) {
+        return 0;
+    }
+    return strcmp(rec1->anchor, anchor) ? 0 : 1;
+}
+
+/**
+ * @brief Add an applied user-ordered instance into the anchor cache.
+ *
+ * @param[in] anchors Anchor cache.
+ * @param[in] node Applied user-ordered (leaf-)list instance.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_anchors_add(struct lyd_diff_anchors *anchors, struct lyd_node *node)
+{
+    struct lyd_diff_anchor_rec rec = {0};
+    const char *anchor;
+    LY_ERR r;
+
+    assert(lysc_is_userordered(node->schema) && !lysc_is_dup_inst_list(node->schema));
+
+    if (!anchors->ht) {
+        anchors->ht = lyht_new(1, sizeof rec, lyd_diff_anchors_val_equal, anchors, 1);
+        LY_CHECK_ERR_RET(!anchors->ht, LOGMEM(LYD_CTX(node)), LY_EMEM);
+    }
+
+    rec.schema = node->schema;
+    rec.node = node;
+    LY_CHECK_RET(lyd_diff_anchors_str(anchors, node, &anchor));
+    r = lyht_insert(anchors->ht, &rec, lyd_diff_anchors_hash(node->schema, anchor), NULL);
+    if (r && (r != LY_EEXIST)) {
+        return r;
+    }
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Remove a user-ordered instance that is going to be freed from the anchor cache, if there.
+ *
+ * @param[in] anchors Anchor cache.
+ * @param[in] node User-ordered (leaf-)list instance.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_anchors_remove(struct lyd_diff_anchors *anchors, struct lyd_node *node)
+{
+    struct lyd_diff_anchor_rec rec = {0};
+    const char *anchor;
+    uint32_t hash;
+
+    if (!anchors->ht || !lysc_is_userordered(node->schema) || lysc_is_dup_inst_list(node->schema)) {
+        return LY_SUCCESS;
+    }
+
+    rec.schema = node->schema;
+    rec.node = node;
+    LY_CHECK_RET(lyd_diff_anchors_str(anchors, node, &anchor));
+    hash = lyd_diff_anchors_hash(node->schema, anchor);
+    if (!lyht_find(anchors->ht, &rec, hash, NULL)) {
+        LY_CHECK_RET(lyht_remove(anchors->ht, &rec, hash));
+    }
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Find an anchor in the anchor cache.
+ *
+ * @param[in] anchors Anchor cache.
+ * @param[in] schema Schema node of the anchor instance.
+ * @param[in] anchor Anchor string.
+ * @return Found anchor instance, NULL if not cached.
+ */
+static struct lyd_node *
+lyd_diff_anchors_find(struct lyd_diff_anchors *anchors, const struct lysc_node *schema, const char *anchor)
+{
+    struct lyd_diff_anchor_rec rec = {0}, *match;
+
+    if (!anchors->ht) {
+        return NULL;
+    }
+
+    rec.schema = schema;
+    rec.anchor = anchor;
+    if (lyht_find(anchors->ht, &rec, lyd_diff_anchors_hash(schema, anchor), (void **)&match)) {
+        return NULL;
+    }
+    return match->node;
+}
+
+/**
+ * @brief Free the anchor cache.
+ *
+ * @param[in] anchors Anchor cache to free.
+ */
+static void
+lyd_diff_anchors_free(struct lyd_diff_anchors *anchors)
+{
+    lyht_free(anchors->ht);
+    free(anchors->buf);
+}
+
 /**
  * @brief Insert a diff node into a data tree.
  *
@@ -968,11 +1678,12 @@ lyd_diff_get_op(const struct lyd_node *diff_node, enum lyd_diff_op *op)
  * @param[in] new_node Node to insert.
  * @param[in] userord_anchor Optional anchor (key, value, or position) of relative (leaf-)list instance. If not set,
  * the user-ordered instance will be inserted at the first position.
+ * @param[in,out] anchors Anchor cache of @p first_node siblings.
  * @return err_info, NULL on success.
  */
 static LY_ERR
 lyd_diff_insert(struct lyd_node **first_node, struct lyd_node *parent_node, struct lyd_node *new_node,
-        const char *userord_anchor)
+        const char *userord_anchor, struct lyd_diff_anchors *anchors)
 {
     LY_ERR ret;
     struct lyd_node *anchor;
@@ -1027,7 +1738,8 @@ lyd_diff_insert(struct lyd_node **first_node, struct lyd_node *parent_node, stru
                         new_node->schema->name);
                 return LY_EINVAL;
             }
-        } else {
+        } else if (!(anchor = lyd_diff_anchors_find(anchors, new_node->schema, userord_anchor))) {
+            /* not applied yet, parse the anchor */
             ret = lyd_find_sibling_val(*first_node, new_node->schema, userord_anchor, 0, &anchor);
             if (ret == LY_ENOTFOUND) {
                 LOGERR(LYD_CTX(new_node), LY_EINVAL, "Node \"%s\" instance to insert next to not found.",
@@ -1036,6 +1748,7 @@ lyd_diff_insert(struct lyd_node **first_node, struct lyd_node *parent_node, stru
             } else if (ret) {
                 return ret;
             }
+            LY_CHECK_RET(lyd_diff_anchors_add(anchors, anchor));
         }
 
         /* insert after */
@@ -1049,7 +1762,9 @@ lyd_diff_insert(struct lyd_node **first_node, struct lyd_node *parent_node, stru
         ret = lyd_find_sibling_val(*first_node, new_node->schema, NULL, 0, &anchor);
         LY_CHECK_RET(ret && (ret != LY_ENOTFOUND), ret);
 
-        if (anchor) {
+        if (anchor == new_node) {
+            /* already the first instance */
+        } else if (anchor) {
             /* insert before the first instance */
             LY_CHECK_RET(lyd_insert_before(anchor, new_node));
             if ((*first_node)->prev->next) {
@@ -1065,6 +1780,9 @@ lyd_diff_insert(struct lyd_node **first_node, struct lyd_node *parent_node, stru
     return LY_SUCCESS;
 }
 
+static LY_ERR lyd_diff_apply_siblings(struct lyd_node **first_node, struct lyd_node *parent_node,
+        const struct lyd_node *diff_first, const struct lys_module *mod, lyd_diff_cb diff_cb, void *cb_data);
+
 /**
  * @brief Apply diff subtree on data tree nodes, recursively.
  *
@@ -1074,18 +1792,20 @@ lyd_diff_insert(struct lyd_node **first_node, struct lyd_node *parent_node, stru
  * @param[in] diff_cb Optional diff callback.
  * @param[in] cb_data User data for @p diff_cb.
  * @param[in,out] dup_inst Duplicate instance cache for all @p diff_node siblings.
+ * @param[in,out] anchors Anchor cache for all @p diff_node siblings.
  * @return LY_ERR value.
  */
 static LY_ERR
 lyd_diff_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, const struct lyd_node *diff_node,
-        lyd_diff_cb diff_cb, void *cb_data, struct lyd_dup_inst **dup_inst)
+        lyd_diff_cb diff_cb, void *cb_data, struct lyd_dup_inst **dup_inst, struct lyd_diff_anchors *anchors)
 {
     LY_ERR ret;
-    struct lyd_node *match, *diff_child;
+    struct lyd_node *match;
     const char *str_val, *meta_str;
     enum lyd_diff_op op;
     struct lyd_meta *meta;
-    struct lyd_dup_inst *child_dup_inst = NULL;
+    struct lyd_journal *journal;
+    ly_bool orig_dflt;
     const struct ly_ctx *ctx = LYD_CTX(diff_node);
 
     /* read all the valid attributes */
@@ -1116,9 +1836,9 @@ lyd_diff_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, con
 
         /* insert/move the node */
         if (str_val[0]) {
-            ret = lyd_diff_insert(first_node, parent_node, match, str_val);
+            ret = lyd_diff_insert(first_node, parent_node, match, str_val, anchors);
         } else {
-            ret = lyd_diff_insert(first_node, parent_node, match, NULL);
+            ret = lyd_diff_insert(first_node, parent_node, match, NULL, anchors);
         }
         if (ret) {
             if (op == LYD_DIFF_OP_CREATE) {
@@ -1127,6 +1847,11 @@ lyd_diff_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, con
             return ret;
         }
 
+        /* it is likely the anchor of the next instance */
+        if (!lysc_is_dup_inst_list(match->schema)) {
+            LY_CHECK_RET(lyd_diff_anchors_add(anchors, match));
+        }
+
         goto next_iter_r;
     }
 
@@ -1139,11 +1864,17 @@ lyd_diff_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, con
 
         if (match->schema->nodetype & LYD_NODE_TERM) {
             /* special case of only dflt flag change */
+            orig_dflt = (match->flags & LYD_DEFAULT) ? 1 : 0;
             if (diff_node->flags & LYD_DEFAULT) {
                 match->flags |= LYD_DEFAULT;
             } else {
                 match->flags &= ~LYD_DEFAULT;
             }
+            lyd_hash_subtree_invalidate(match);
+
+            if ((orig_dflt != ((match->flags & LYD_DEFAULT) ? 1 : 0)) && (journal = lyd_journal_get(match))) {
+                lyd_journal_replace(journal, match, NULL, orig_dflt);
+            }
         } else {
             /* none operation on nodes without children is redundant and hence forbidden */
             if (!lyd_child_no_keys(diff_node)) {
@@ -1180,6 +1911,7 @@ lyd_diff_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, con
         LY_CHECK_ERR_RET(!match, LOGERR_NOINST(ctx, diff_node), LY_EINVAL);
 
         /* remove it */
+        LY_CHECK_RET(lyd_diff_anchors_remove(anchors, match));
         if ((match == *first_node) && !match->parent) {
             assert(!parent_node);
             /* we have removed the top-level node */
@@ -1210,7 +1942,13 @@ lyd_diff_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, con
         }
 
         /* with flags */
-        match->flags = diff_node->flags;
+        orig_dflt = (match->flags & LYD_DEFAULT) ? 1 : 0;
+        match->flags = (match->flags & LYD_JOURNALED) | (diff_node->flags & ~LYD_JOURNALED);
+        lyd_hash_subtree_invalidate(match);
+
+        if ((orig_dflt != ((match->flags & LYD_DEFAULT) ? 1 : 0)) && (journal = lyd_journal_get(match))) {
+            lyd_journal_replace(journal, match, NULL, orig_dflt);
+        }
         break;
     default:
         LOGINT_RET(ctx);
@@ -1223,57 +1961,163 @@ next_iter_r:
     }
 
     /* apply diff recursively */
-    ret = LY_SUCCESS;
-    LY_LIST_FOR(lyd_child_no_keys(diff_node), diff_child) {
-        ret = lyd_diff_apply_r(lyd_node_child_p(match), match, diff_child, diff_cb, cb_data, &child_dup_inst);
-        if (ret) {
-            break;
-        }
+    return lyd_diff_apply_siblings(lyd_node_child_p(match), match, lyd_child_no_keys(diff_node), NULL, diff_cb,
+            cb_data);
+}
+
+/**
+ * @brief Learn whether a diff node can be created in a run with its preceding sibling.
+ *
+ * @param[in] diff_node Diff node.
+ * @param[in] schema Schema node of the run.
+ * @return Whether @p diff_node is a simple create operation of @p schema.
+ */
+static ly_bool
+lyd_diff_apply_is_run_create(const struct lyd_node *diff_node, const struct lysc_node *schema)
+{
+    enum lyd_diff_op op;
+
+    if (!diff_node || (diff_node->schema != schema) || lysc_is_userordered(schema) || (diff_node->flags & LYD_EXT)) {
+        return 0;
     }
 
-    lyd_dup_inst_free(child_dup_inst);
-    return ret;
+    return !lyd_diff_get_op(diff_node, &op) && (op == LYD_DIFF_OP_CREATE);
 }
 
-LIBYANG_API_DEF LY_ERR
-lyd_diff_apply_module(struct lyd_node **data, const struct lyd_node *diff, const struct lys_module *mod,
-        lyd_diff_cb diff_cb, void *cb_data)
+/**
+ * @brief Apply a run of consecutive create operations of the same schema node on data tree siblings.
+ *
+ * All the nodes are inserted at once and only then their descendants are applied.
+ *
+ * @param[in,out] first_node First sibling of the data tree.
+ * @param[in] parent_node Parent of the first sibling.
+ * @param[in] diff_first First diff node of the run.
+ * @param[in] count Number of diff nodes in the run.
+ * @param[in] diff_cb Optional diff callback.
+ * @param[in] cb_data User data for @p diff_cb.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_apply_create_run(struct lyd_node **first_node, struct lyd_node *parent_node, const struct lyd_node *diff_first,
+        uint32_t count, lyd_diff_cb diff_cb, void *cb_data)
 {
-    const struct lyd_node *root;
-    struct lyd_dup_inst *dup_inst = NULL;
     LY_ERR ret = LY_SUCCESS;
+    struct lyd_node **nodes;
+    const struct lyd_node *diff_node;
+    uint32_t i, dup_count = 0;
 
-    LY_LIST_FOR(diff, root) {
-        if (mod && (lyd_owner_module(root) != mod)) {
-            /* skip data nodes from different modules */
-            continue;
-        }
+    nodes = malloc(count * sizeof *nodes);
+    LY_CHECK_ERR_RET(!nodes, LOGMEM(LYD_CTX(diff_first)), LY_EMEM);
 
-        /* apply relevant nodes from the diff datatree */
-        ret = lyd_diff_apply_r(data, NULL, root, diff_cb, cb_data, &dup_inst);
-        if (ret) {
-            break;
+    /* duplicate all the nodes */
+    for (diff_node = diff_first; dup_count < count; diff_node = diff_node->next) {
+        LY_CHECK_GOTO(ret = lyd_dup_single(diff_node, NULL, LYD_DUP_NO_META, &nodes[dup_count]), cleanup);
+        ++dup_count;
+    }
+
+    /* insert them at once */
+    LY_CHECK_GOTO(ret = lyd_insert_node_run(parent_node, first_node, nodes, count, 0), cleanup);
+    dup_count = 0;
+
+    for (i = 0, diff_node = diff_first; i < count; ++i, diff_node = diff_node->next) {
+        if (diff_cb) {
+            /* call callback */
+            LY_CHECK_GOTO(ret = diff_cb(diff_node, nodes[i], cb_data), cleanup);
         }
+
+        /* apply diff recursively */
+        LY_CHECK_GOTO(ret = lyd_diff_apply_siblings(lyd_node_child_p(nodes[i]), nodes[i], lyd_child_no_keys(diff_node),
+                NULL, diff_cb, cb_data), cleanup);
     }
 
-    lyd_dup_inst_free(dup_inst);
+cleanup:
+    for (i = 0; i < dup_count; ++i) {
+        lyd_free_tree(nodes[i]);
+    }
+    free(nodes);
     return ret;
 }
 
-LIBYANG_API_DEF LY_ERR
-lyd_diff_apply_all(struct lyd_node **data, const struct lyd_node *diff)
-{
-    return lyd_diff_apply_module(data, diff, NULL, NULL, NULL);
-}
-
 /**
- * @brief Update operations on a diff node when the new operation is NONE.
+ * @brief Apply diff siblings on data tree siblings.
  *
- * @param[in] diff_match Node from the diff.
- * @param[in] cur_op Current operation of @p diff_match.
- * @param[in] src_diff Current source diff node.
- * @return LY_ERR value.
- */
+ * Runs of consecutive create operations of the same schema node are inserted at once and anchors of user-ordered
+ * instances are cached.
+ *
+ * @param[in,out] first_node First sibling of the data tree.
+ * @param[in] parent_node Parent of the first sibling.
+ * @param[in] diff_first First diff sibling.
+ * @param[in] mod Module of the diff nodes to apply, NULL for all.
+ * @param[in] diff_cb Optional diff callback.
+ * @param[in] cb_data User data for @p diff_cb.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_apply_siblings(struct lyd_node **first_node, struct lyd_node *parent_node, const struct lyd_node *diff_first,
+        const struct lys_module *mod, lyd_diff_cb diff_cb, void *cb_data)
+{
+    LY_ERR ret = LY_SUCCESS;
+    const struct lyd_node *diff_node, *diff_last;
+    struct lyd_dup_inst *dup_inst = NULL;
+    struct lyd_diff_anchors anchors = {0};
+    uint32_t count;
+
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (mod && (lyd_owner_module(diff_node) != mod)) {
+            /* skip data nodes from different modules */
+            continue;
+        }
+
+        /* learn whether there is a run of creates */
+        count = 0;
+        if (lyd_diff_apply_is_run_create(diff_node, diff_node->schema)) {
+            count = 1;
+            diff_last = diff_node;
+            while (lyd_diff_apply_is_run_create(diff_last->next, diff_node->schema)) {
+                diff_last = diff_last->next;
+                ++count;
+            }
+        }
+
+        if (count > 1) {
+            /* apply all the creates at once */
+            ret = lyd_diff_apply_create_run(first_node, parent_node, diff_node, count, diff_cb, cb_data);
+            diff_node = diff_last;
+        } else {
+            /* apply relevant nodes from the diff datatree */
+            ret = lyd_diff_apply_r(first_node, parent_node, diff_node, diff_cb, cb_data, &dup_inst, &anchors);
+        }
+        if (ret) {
+            break;
+        }
+    }
+
+    lyd_dup_inst_free(dup_inst);
+    lyd_diff_anchors_free(&anchors);
+    return ret;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_diff_apply_module(struct lyd_node **data, const struct lyd_node *diff, const struct lys_module *mod,
+        lyd_diff_cb diff_cb, void *cb_data)
+{
+    return lyd_diff_apply_siblings(data, NULL, diff, mod, diff_cb, cb_data);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_diff_apply_all(struct lyd_node **data, const struct lyd_node *diff)
+{
+    return lyd_diff_apply_module(data, diff, NULL, NULL, NULL);
+}
+
+/**
+ * @brief Update operations on a diff node when the new operation is NONE.
+ *
+ * @param[in] diff_match Node from the diff.
+ * @param[in] cur_op Current operation of @p diff_match.
+ * @param[in] src_diff Current source diff node.
+ * @return LY_ERR value.
+ */
 static LY_ERR
 lyd_diff_merge_none(struct lyd_node *diff_match, enum lyd_diff_op cur_op, const struct lyd_node *src_diff)
 {
@@ -1285,6 +2129,7 @@ lyd_diff_merge_none(struct lyd_node *diff_match, enum lyd_diff_op cur_op, const
             /* NONE on a term means only its dflt flag was changed */
             diff_match->flags &= ~LYD_DEFAULT;
             diff_match->flags |= src_diff->flags & LYD_DEFAULT;
+            lyd_hash_subtree_invalidate(diff_match);
         }
         break;
     default:
@@ -1351,8 +2196,9 @@ lyd_diff_change_op(struct lyd_node *node, enum lyd_diff_op op)
 static LY_ERR
 lyd_diff_merge_replace(struct lyd_node *diff_match, enum lyd_diff_op cur_op, const struct lyd_node *src_diff)
 {
-    LY_ERR ret;
+    LY_ERR ret = LY_SUCCESS;
     const char *str_val, *meta_name, *orig_meta_name;
+    char *any_str;
     struct lyd_meta *meta;
     const struct lys_module *mod;
     const struct lyd_node_any *any;
@@ -1412,6 +2258,7 @@ lyd_diff_merge_replace(struct lyd_node *diff_match, enum lyd_diff_op cur_op, con
             /* modify the default flag */
             diff_match->flags &= ~LYD_DEFAULT;
             diff_match->flags |= src_diff->flags & LYD_DEFAULT;
+            lyd_hash_subtree_invalidate(diff_match);
             break;
         case LYS_ANYXML:
         case LYS_ANYDATA:
@@ -1423,25 +2270,63 @@ lyd_diff_merge_replace(struct lyd_node *diff_match, enum lyd_diff_op cur_op, con
             /* modify the node value */
             any = (struct lyd_node_any *)src_diff;
             LY_CHECK_RET(lyd_any_copy_value(diff_match, &any->value, any->value_type));
+
+            if (cur_op == LYD_DIFF_OP_REPLACE) {
+                /* compare values whether there is any change at all */
+                meta = lyd_find_meta(diff_match->meta, mod, "orig-value");
+                LY_CHECK_ERR_RET(!meta, LOGERR_META(ctx, "orig-value", diff_match), LY_EINVAL);
+                LY_CHECK_RET(lyd_any_value_str(diff_match, &any_str));
+                if (!strcmp(any_str, lyd_get_meta_value(meta))) {
+                    /* values are the same, remove orig-value meta and set oper to NONE */
+                    lyd_free_meta_single(meta);
+                    ret = lyd_diff_change_op(diff_match, LYD_DIFF_OP_NONE);
+                }
+                free(any_str);
+                LY_CHECK_RET(ret);
+            }
             break;
         default:
             LOGINT_RET(LYD_CTX(src_diff));
         }
         break;
     case LYD_DIFF_OP_NONE:
-        /* it is moved now */
-        assert(lysc_is_userordered(diff_match->schema) && (diff_match->schema->nodetype == LYS_LIST));
-
         /* change the operation */
         LY_CHECK_RET(lyd_diff_change_op(diff_match, LYD_DIFF_OP_REPLACE));
 
+        if (diff_match->schema->nodetype & (LYS_LEAF | LYS_ANYDATA)) {
+            /* only its default flag was changed, now its value is changed, as well */
+            meta = lyd_find_meta(src_diff->meta, mod, "orig-value");
+            LY_CHECK_ERR_RET(!meta, LOGERR_META(ctx, "orig-value", src_diff), LY_EINVAL);
+            LY_CHECK_RET(lyd_dup_meta_single(meta, diff_match, NULL));
+
+            /* modify the node value and the default flag */
+            if (diff_match->schema->nodetype == LYS_LEAF) {
+                if (lyd_change_term(diff_match, lyd_get_value(src_diff))) {
+                    LOGINT_RET(LYD_CTX(src_diff));
+                }
+                diff_match->flags &= ~LYD_DEFAULT;
+                diff_match->flags |= src_diff->flags & LYD_DEFAULT;
+                lyd_hash_subtree_invalidate(diff_match);
+            } else {
+                any = (struct lyd_node_any *)src_diff;
+                LY_CHECK_RET(lyd_any_copy_value(diff_match, &any->value, any->value_type));
+            }
+            break;
+        }
+
+        /* it is moved now */
+        assert(lysc_is_userordered(diff_match->schema));
+
         /* set orig-meta and meta */
         if (lysc_is_dup_inst_list(diff_match->schema)) {
             meta_name = "position";
             orig_meta_name = "orig-position";
-        } else {
+        } else if (diff_match->schema->nodetype == LYS_LIST) {
             meta_name = "key";
             orig_meta_name = "orig-key";
+        } else {
+            meta_name = "value";
+            orig_meta_name = "orig-value";
         }
 
         meta = lyd_find_meta(src_diff->meta, mod, orig_meta_name);
@@ -1477,8 +2362,10 @@ lyd_diff_merge_create(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
     const struct lysc_node_leaf *sleaf = NULL;
     uint32_t trg_flags;
     const char *meta_name, *orig_meta_name;
+    char *any_str;
     struct lyd_meta *meta, *orig_meta;
     const struct ly_ctx *ctx = LYD_CTX(diff_match);
+    LY_ERR ret;
 
     switch (cur_op) {
     case LYD_DIFF_OP_DELETE:
@@ -1500,6 +2387,11 @@ lyd_diff_merge_create(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
             meta = lyd_find_meta(src_diff->meta, NULL, meta_name);
             LY_CHECK_ERR_RET(!meta, LOGERR_META(ctx, meta_name, src_diff), LY_EINVAL);
             orig_meta = lyd_find_meta(diff_match->meta, NULL, orig_meta_name);
+            if (!orig_meta) {
+                /* deleted with its parent, the original anchor is its preceding instance in the deleted subtree */
+                LY_CHECK_RET(lyd_diff_add_nested_userord(diff_match, 1));
+                orig_meta = lyd_find_meta(diff_match->meta, NULL, orig_meta_name);
+            }
             LY_CHECK_ERR_RET(!orig_meta, LOGERR_META(ctx, orig_meta_name, diff_match), LY_EINVAL);
 
             /* the (incorrect) assumption made here is that there are no previous diff nodes that would affect
@@ -1523,8 +2415,8 @@ lyd_diff_merge_create(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
                 sleaf = (struct lysc_node_leaf *)diff_match->schema;
             }
 
-            if (sleaf && sleaf->dflt && !sleaf->dflt->realtype->plugin->compare(sleaf->dflt,
-                    &((struct lyd_node_term *)src_diff)->value)) {
+            if (sleaf && sleaf->dflt && (trg_flags & LYD_DEFAULT) &&
+                    !sleaf->dflt->realtype->plugin->compare(sleaf->dflt, &((struct lyd_node_term *)src_diff)->value)) {
                 /* we deleted it, so a default value was in-use, and it matches the created value -> operation NONE */
                 LY_CHECK_RET(lyd_diff_change_op(diff_match, LYD_DIFF_OP_NONE));
             } else if (!lyd_compare_single(diff_match, src_diff, 0)) {
@@ -1541,6 +2433,19 @@ lyd_diff_merge_create(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
                 /* update the value itself */
                 LY_CHECK_RET(lyd_change_term(diff_match, lyd_get_value(src_diff)));
             }
+        } else if ((diff_match->schema->nodetype & LYS_ANYDATA) && lyd_compare_single(diff_match, src_diff, 0)) {
+            /* we deleted it, but it was created with a different value -> operation REPLACE */
+            LY_CHECK_RET(lyd_diff_change_op(diff_match, LYD_DIFF_OP_REPLACE));
+
+            /* current value is the previous one (meta) */
+            LY_CHECK_RET(lyd_any_value_str(diff_match, &any_str));
+            ret = lyd_new_meta(LYD_CTX(src_diff), diff_match, NULL, "yang:orig-value", any_str, 0, NULL);
+            free(any_str);
+            LY_CHECK_RET(ret);
+
+            /* update the value itself */
+            LY_CHECK_RET(lyd_any_copy_value(diff_match, &((struct lyd_node_any *)src_diff)->value,
+                    ((struct lyd_node_any *)src_diff)->value_type));
         } else {
             /* deleted + created -> operation NONE */
             LY_CHECK_RET(lyd_diff_change_op(diff_match, LYD_DIFF_OP_NONE));
@@ -1554,6 +2459,7 @@ lyd_diff_merge_create(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
             /* update dflt flag itself */
             diff_match->flags &= ~LYD_DEFAULT;
             diff_match->flags |= src_diff->flags & LYD_DEFAULT;
+            lyd_hash_subtree_invalidate(diff_match);
         }
 
         /* but the operation of its children should remain DELETE */
@@ -1583,6 +2489,7 @@ lyd_diff_merge_delete(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
 {
     struct lyd_node *child;
     struct lyd_meta *meta;
+    union lyd_any_value anyval;
     const char *meta_name;
     const struct ly_ctx *ctx = LYD_CTX(diff_match);
 
@@ -1615,6 +2522,14 @@ lyd_diff_merge_delete(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
             } else {
                 meta_name = "value";
             }
+        } else if (diff_match->schema->nodetype & LYS_ANYDATA) {
+            /* switch value for the original one */
+            meta = lyd_find_meta(diff_match->meta, NULL, "yang:orig-value");
+            LY_CHECK_ERR_RET(!meta, LOGERR_META(ctx, "yang:orig-value", diff_match), LY_EINVAL);
+            anyval.str = lyd_get_meta_value(meta);
+            LY_CHECK_RET(lyd_any_copy_value(diff_match, &anyval, LYD_ANYDATA_STRING));
+
+            meta_name = "orig-value";
         } else {
             assert(diff_match->schema->nodetype == LYS_LEAF);
 
@@ -1633,6 +2548,7 @@ lyd_diff_merge_delete(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
             if (meta->value.boolean) {
                 diff_match->flags |= LYD_DEFAULT;
             }
+            lyd_hash_subtree_invalidate(diff_match);
             lyd_free_meta_single(meta);
 
             meta_name = "orig-value";
@@ -1643,6 +2559,39 @@ lyd_diff_merge_delete(struct lyd_node *diff_match, enum lyd_diff_op cur_op, cons
         LY_CHECK_RET(lyd_diff_change_op(diff_match, LYD_DIFF_OP_DELETE));
         break;
     case LYD_DIFF_OP_NONE:
+        if (lysc_is_userordered(diff_match->schema)) {
+            /* the original anchor is kept by the source */
+            if (lysc_is_dup_inst_list(diff_match->schema)) {
+                meta_name = "yang:orig-position";
+            } else if (diff_match->schema->nodetype == LYS_LIST) {
+                meta_name = "yang:orig-key";
+            } else {
+                meta_name = "yang:orig-value";
+            }
+            meta = lyd_find_meta(src_diff->meta, NULL, meta_name);
+            if (meta && !lyd_find_meta(diff_match->meta, NULL, meta_name)) {
+                LY_CHECK_RET(lyd_dup_meta_single(meta, diff_match, NULL));
+            }
+        }
+
+        if ((diff_match->schema->nodetype & LYD_NODE_TERM) &&
+                (meta = lyd_find_meta(diff_match->meta, NULL, "yang:orig-default"))) {
+            /* only the default flag may have been changed, the original node is deleted */
+            diff_match->flags &= ~LYD_DEFAULT;
+            if (meta->value.boolean) {
+                diff_match->flags |= LYD_DEFAULT;
+            }
+            lyd_hash_subtree_invalidate(diff_match);
+            lyd_free_meta_single(meta);
+        }
+
+        /* descendants inheriting the operation keep it, they are merged separately */
+        LY_LIST_FOR(lyd_child_no_keys(diff_match), child) {
+            if (!lyd_find_meta(child->meta, NULL, "yang:operation")) {
+                LY_CHECK_RET(lyd_diff_change_op(child, LYD_DIFF_OP_NONE));
+            }
+        }
+
         /* it was not modified, but should be deleted -> set DELETE operation */
         LY_CHECK_RET(lyd_diff_change_op(diff_match, LYD_DIFF_OP_DELETE));
         break;
@@ -1973,6 +2922,7 @@ lyd_diff_reverse_default(struct lyd_node *node, const struct lys_module *mod)
     /* switch defaults */
     node->flags &= ~LYD_DEFAULT;
     node->flags |= flag1;
+    lyd_hash_subtree_invalidate(node);
     LY_CHECK_RET(lyd_change_meta(meta, flag2 ? "true" : "false"));
 
     return LY_SUCCESS;
@@ -1994,6 +2944,10 @@ lyd_diff_reverse_meta(struct lyd_node *node, const struct lys_module *mod, const
 
     /* value1 */
     val1 = lyd_get_meta_value(meta1);
+    if (!strcmp(val1, lyd_get_meta_value(meta2))) {
+        /* same values, nothing to switch */
+        return LY_SUCCESS;
+    }
 
     /* value2 */
     val2 = strdup(lyd_get_meta_value(meta2));
@@ -2007,6 +2961,48 @@ cleanup:
     return ret;
 }
 
+/**
+ * @brief Switch the anchor metadata of created or deleted user-ordered instances in a subtree.
+ *
+ * @param[in] diff Diff subtree to process.
+ * @param[in] mod Metadata module.
+ * @param[in] orig Whether to switch the original anchors to new ones (delete to create) or vice versa.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_diff_reverse_anchor_r(struct lyd_node *diff, const struct lys_module *mod, ly_bool orig)
+{
+    struct lyd_node *elem;
+    struct lyd_meta *meta;
+    const char *name, *orig_name;
+
+    LYD_TREE_DFS_BEGIN(diff, elem) {
+        if (lysc_is_userordered(elem->schema)) {
+            if (lysc_is_dup_inst_list(elem->schema)) {
+                name = "position";
+                orig_name = "orig-position";
+            } else if (elem->schema->nodetype == LYS_LIST) {
+                name = "key";
+                orig_name = "orig-key";
+            } else {
+                name = "value";
+                orig_name = "orig-value";
+            }
+
+            meta = lyd_find_meta(elem->meta, mod, orig ? orig_name : name);
+            if (meta) {
+                LY_CHECK_RET(lyd_new_meta(LYD_CTX(elem), elem, mod, orig ? name : orig_name, lyd_get_meta_value(meta),
+                        0, NULL));
+                lyd_free_meta_single(meta);
+            }
+        }
+
+        LYD_TREE_DFS_END(diff, elem);
+    }
+
+    return LY_SUCCESS;
+}
+
 /**
  * @brief Remove specific operation from all the nodes in a subtree.
  *
@@ -2072,6 +3068,9 @@ lyd_diff_reverse_all(const struct lyd_node *src_diff, struct lyd_node **diff)
                         lyd_diff_reverse_remove_op_r(iter, LYD_DIFF_OP_CREATE);
                     }
 
+                    /* the instances are deleted from where they were created */
+                    LY_CHECK_GOTO(ret = lyd_diff_reverse_anchor_r(elem, mod, 0), cleanup);
+
                     LYD_TREE_DFS_continue = 1;
                     break;
                 case LYD_DIFF_OP_DELETE:
@@ -2083,6 +3082,9 @@ lyd_diff_reverse_all(const struct lyd_node *src_diff, struct lyd_node **diff)
                         lyd_diff_reverse_remove_op_r(iter, LYD_DIFF_OP_DELETE);
                     }
 
+                    /* the instances are created where they were deleted from */
+                    LY_CHECK_GOTO(ret = lyd_diff_reverse_anchor_r(elem, mod, 1), cleanup);
+
                     LYD_TREE_DFS_continue = 1;
                     break;
                 case LYD_DIFF_OP_REPLACE:
@@ -2146,3 +3148,1123 @@ cleanup:
     }
     return ret;
 }
+
+/**
+ * @brief Original order of user-ordered (leaf-)list instances in a journaled tree.
+ */
+struct lyd_journal_order {
+    char *parent_path;              /**< path of the parent of the instances, NULL for top-level instances */
+    const struct lysc_node *schema; /**< schema node of the instances */
+    char **anchors;                 /**< key predicates or values of the instances in their original order */
+    uint32_t count;                 /**< number of instances */
+};
+
+/**
+ * @brief Original metadata of a node in a journaled tree.
+ */
+struct lyd_journal_meta {
+    char *path;                 /**< path of the node */
+    struct lyd_node *holder;    /**< duplicated node holding the original metadata, NULL if there were none */
+};
+
+/**
+ * @brief Change journal of a data tree.
+ */
+struct lyd_journal {
+    struct ly_ctx *ctx;         /**< context the journal is registered in */
+    struct lyd_node **tree;     /**< pointer to the first sibling of the journaled data tree */
+    struct lyd_node *diff;      /**< diff of all the changes recorded so far */
+    LY_ERR err;                 /**< first error that occurred when recording a change */
+
+    struct lyd_journal_order *orders;   /**< original orders of all the changed user-ordered (leaf-)lists */
+    uint32_t order_count;               /**< number of orders */
+
+    struct lyd_journal_meta *metas;     /**< original metadata of all the nodes with changed metadata */
+    uint32_t meta_count;                /**< number of metas */
+    struct hash_table *meta_ht;         /**< hash table of indexes into metas by the paths */
+};
+
+/**
+ * @brief Flag set while a change is being recorded, the journal diff is modified by then.
+ */
+static THREAD_LOCAL ly_bool journal_recording;
+
+/**
+ * @brief Remember the original order of user-ordered (leaf-)list instances, if not already.
+ *
+ * @param[in] journal Journal to use.
+ * @param[in] inst Any instance of the (leaf-)list.
+ * @param[in] skip Instance not to remember, for a just created one.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_journal_order_save(struct lyd_journal *journal, const struct lyd_node *inst, const struct lyd_node *skip)
+{
+    LY_ERR rc = LY_SUCCESS;
+    const struct lyd_node *parent;
+    struct lyd_node *iter;
+    struct lyd_journal_order *order;
+    char *parent_path = NULL, *buf = NULL;
+    size_t buflen = 0, bufused;
+    uint32_t i;
+    void *mem;
+
+    parent = lyd_parent(inst);
+    if (parent) {
+        parent_path = lyd_path(parent, LYD_PATH_STD, NULL, 0);
+        LY_CHECK_ERR_RET(!parent_path, LOGMEM(LYD_CTX(inst)), LY_EMEM);
+    }
+
+    for (i = 0; i < journal->order_count; ++i) {
+        order = &journal->orders[i];
+        if ((order->schema == inst->schema) && ((!order->parent_path && !parent_path) ||
+                (order->parent_path && parent_path && !strcmp(order->parent_path, parent_path)))) {
+            /* already remembered */
+            free(parent_path);
+            return LY_SUCCESS;
+        }
+    }
+
+    mem = realloc(journal->orders, (journal->order_count + 1) * sizeof *journal->orders);
+    LY_CHECK_ERR_GOTO(!mem, LOGMEM(LYD_CTX(inst)); rc = LY_EMEM, cleanup);
+    journal->orders = mem;
+    order = &journal->orders[journal->order_count];
+    memset(order, 0, sizeof *order);
+    ++journal->order_count;
+    order->parent_path = parent_path;
+    parent_path = NULL;
+    order->schema = inst->schema;
+
+    /* remember the instances in their current order */
+    LYD_LIST_FOR_INST(parent ? lyd_child(parent) : lyd_first_sibling(inst), inst->schema, iter) {
+        if (iter == skip) {
+            continue;
+        }
+
+        mem = realloc(order->anchors, (order->count + 1) * sizeof *order->anchors);
+        LY_CHECK_ERR_GOTO(!mem, LOGMEM(LYD_CTX(inst)); rc = LY_EMEM, cleanup);
+        order->anchors = mem;
+        if (iter->schema->nodetype == LYS_LIST) {
+            bufused = 0;
+            LY_CHECK_GOTO(rc = lyd_path_list_predicate(iter, &buf, &buflen, &bufused, 0), cleanup);
+            order->anchors[order->count] = strdup(buf);
+        } else {
+            order->anchors[order->count] = strdup(lyd_get_value(iter));
+        }
+        LY_CHECK_ERR_GOTO(!order->anchors[order->count], LOGMEM(LYD_CTX(inst)); rc = LY_EMEM, cleanup);
+        ++order->count;
+    }
+
+cleanup:
+    free(parent_path);
+    free(buf);
+    return rc;
+}
+
+/**
+ * @brief Restore the original order of user-ordered (leaf-)list instances.
+ *
+ * @param[in] journal Journal to use.
+ * @param[in] order Original order to restore.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_journal_order_restore(struct lyd_journal *journal, const struct lyd_journal_order *order)
+{
+    LY_ERR rc;
+    struct lyd_node *parent = NULL, *first, *node, *prev = NULL;
+    uint32_t i;
+
+    if (order->parent_path) {
+        rc = lyd_find_path(*journal->tree, order->parent_path, 0, &parent);
+        if ((rc == LY_ENOTFOUND) || (rc == LY_EINCOMPLETE)) {
+            /* the parent was created, there are no original instances */
+            return LY_SUCCESS;
+        }
+        LY_CHECK_RET(rc);
+    }
+
+    for (i = 0; i < order->count; ++i) {
+        first = parent ? lyd_child(parent) : *journal->tree;
+        if (lyd_find_sibling_val(first, order->schema, order->anchors[i], 0, &node)) {
+            continue;
+        }
+
+        if (!prev) {
+            /* move it before the first instance */
+            lyd_find_sibling_val(first, order->schema, NULL, 0, &prev);
+            if (prev != node) {
+                LY_CHECK_RET(lyd_insert_before(prev, node));
+            }
+        } else if (node->prev != prev) {
+            LY_CHECK_RET(lyd_insert_after(prev, node));
+        }
+        prev = node;
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free original orders of user-ordered (leaf-)lists.
+ *
+ * @param[in] orders Orders to free.
+ * @param[in] order_count Number of @p orders.
+ */
+static void
+lyd_journal_orders_free(struct lyd_journal_order *orders, uint32_t order_count)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < order_count; ++i) {
+        free(orders[i].parent_path);
+        for (j = 0; j < orders[i].count; ++j) {
+            free(orders[i].anchors[j]);
+        }
+        free(orders[i].anchors);
+    }
+    free(orders);
+}
+
+/**
+ * @brief Hash table equal callback for journal metadata indexes.
+ */
+static ly_bool
+lyd_journal_meta_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *cb_data)
+{
+    struct lyd_journal *journal = cb_data;
+
+    return !strcmp(journal->metas[*(uint32_t *)val1_p].path, journal->metas[*(uint32_t *)val2_p].path);
+}
+
+/**
+ * @brief Remember the original metadata of a node, if not already.
+ *
+ * @param[in] journal Journal to use.
+ * @param[in] node Node with the metadata.
+ * @param[in] created Whether @p node was created, it then had no original metadata.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_journal_meta_save(struct lyd_journal *journal, const struct lyd_node *node, ly_bool created)
+{
+    LY_ERR rc = LY_SUCCESS;
+    struct lyd_journal_meta *jmeta;
+    uint32_t hash, idx;
+    void *mem;
+
+    if (!journal->meta_ht) {
+        journal->meta_ht = lyht_new(LYHT_MIN_SIZE, sizeof(uint32_t), lyd_journal_meta_equal_cb, journal, 1);
+        LY_CHECK_ERR_RET(!journal->meta_ht, LOGMEM(journal->ctx), LY_EMEM);
+    }
+
+    /* prepare a new record to search with */
+    mem = realloc(journal->metas, (journal->meta_count + 1) * sizeof *journal->metas);
+    LY_CHECK_ERR_RET(!mem, LOGMEM(journal->ctx), LY_EMEM);
+    journal->metas = mem;
+    idx = journal->meta_count;
+    jmeta = &journal->metas[idx];
+    memset(jmeta, 0, sizeof *jmeta);
+    jmeta->path = lyd_path(node, LYD_PATH_STD, NULL, 0);
+    LY_CHECK_ERR_RET(!jmeta->path, LOGMEM(journal->ctx), LY_EMEM);
+    hash = dict_hash(jmeta->path, strlen(jmeta->path));
+
+    if (!lyht_find(journal->meta_ht, &idx, hash, NULL)) {
+        /* already remembered */
+        goto cleanup;
+    }
+
+    if (!created && node->meta) {
+        /* the node holds a copy of the metadata */
+        LY_CHECK_GOTO(rc = lyd_dup_single(node, NULL, 0, &jmeta->holder), cleanup);
+    }
+    if ((rc = lyht_insert(journal->meta_ht, &idx, hash, NULL))) {
+        lyd_free_tree(jmeta->holder);
+        goto cleanup;
+    }
+    ++journal->meta_count;
+    return LY_SUCCESS;
+
+cleanup:
+    free(jmeta->path);
+    return rc;
+}
+
+/**
+ * @brief Restore the original metadata of a node.
+ *
+ * @param[in] journal Journal to use.
+ * @param[in] jmeta Original metadata to restore.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_journal_meta_restore(struct lyd_journal *journal, const struct lyd_journal_meta *jmeta)
+{
+    LY_ERR rc;
+    struct lyd_node *node;
+    const struct lyd_meta *meta;
+
+    if (!*journal->tree) {
+        return LY_SUCCESS;
+    }
+
+    rc = lyd_find_path(*journal->tree, jmeta->path, 0, &node);
+    if ((rc == LY_ENOTFOUND) || (rc == LY_EINCOMPLETE)) {
+        /* the node was created */
+        return LY_SUCCESS;
+    }
+    LY_CHECK_RET(rc);
+
+    lyd_free_meta_siblings(node->meta);
+    LY_LIST_FOR(jmeta->holder ? jmeta->holder->meta : NULL, meta) {
+        LY_CHECK_RET(lyd_dup_meta_single(meta, node, NULL));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free original metadata of nodes.
+ *
+ * @param[in] metas Metadata to free.
+ * @param[in] meta_count Number of @p metas.
+ * @param[in] meta_ht Hash table of the metadata.
+ */
+static void
+lyd_journal_metas_free(struct lyd_journal_meta *metas, uint32_t meta_count, struct hash_table *meta_ht)
+{
+    uint32_t i;
+
+    for (i = 0; i < meta_count; ++i) {
+        free(metas[i].path);
+        lyd_free_tree(metas[i].holder);
+    }
+    free(metas);
+    lyht_free(meta_ht);
+}
+
+/**
+ * @brief Record of the journal registry, journal of a top-level node of a journaled data tree.
+ */
+struct lyd_journal_rec {
+    const struct lyd_node *top;     /**< top-level node */
+    struct lyd_journal *journal;    /**< journal of its tree */
+};
+
+/**
+ * @brief Callback for comparing journal registry records.
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_journal_rec_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_journal_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return rec1->top == rec2->top;
+}
+
+/**
+ * @brief Get the hash of a journal registry record.
+ *
+ * @param[in] top Top-level node of the record.
+ * @return Record hash.
+ */
+static uint32_t
+lyd_journal_rec_hash(const struct lyd_node *top)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&top, sizeof top);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Register a top-level node of a journaled data tree.
+ *
+ * @param[in] journal Journal of the tree.
+ * @param[in] top Top-level node to register.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_journal_top_add(struct lyd_journal *journal, const struct lyd_node *top)
+{
+    LY_ERR rc = LY_SUCCESS;
+    struct ly_ctx *ctx = journal->ctx;
+    struct lyd_journal_rec rec, *match;
+
+    rec.top = top;
+    rec.journal = journal;
+
+    /* LOCK */
+    pthread_mutex_lock(&ctx->journals_lock);
+
+    if (!ctx->journals) {
+        ctx->journals = lyht_new(LYHT_MIN_SIZE, sizeof rec, lyd_journal_rec_equal_cb, NULL, 1);
+        LY_CHECK_ERR_GOTO(!ctx->journals, LOGMEM(ctx); rc = LY_EMEM, cleanup);
+    }
+
+    rc = lyht_insert(ctx->journals, &rec, lyd_journal_rec_hash(top), (void **)&match);
+    if (rc == LY_EEXIST) {
+        /* a stale record of a freed node */
+        match->journal = journal;
+        rc = LY_SUCCESS;
+    }
+    LY_CHECK_GOTO(rc, cleanup);
+    ((struct lyd_node *)top)->flags |= LYD_JOURNALED;
+
+cleanup:
+    /* UNLOCK */
+    pthread_mutex_unlock(&ctx->journals_lock);
+    return rc;
+}
+
+/**
+ * @brief Unregister a top-level node of a journaled data tree.
+ *
+ * @param[in] ctx Context of the node.
+ * @param[in] top Top-level node to unregister, nothing is done if it is not registered.
+ */
+static void
+lyd_journal_top_rm(struct ly_ctx *ctx, const struct lyd_node *top)
+{
+    struct lyd_journal_rec rec = {0};
+
+    if (!(top->flags & LYD_JOURNALED)) {
+        return;
+    }
+    rec.top = top;
+
+    /* LOCK */
+    pthread_mutex_lock(&ctx->journals_lock);
+
+    lyht_remove(ctx->journals, &rec, lyd_journal_rec_hash(top));
+    ((struct lyd_node *)top)->flags &= ~LYD_JOURNALED;
+
+    /* UNLOCK */
+    pthread_mutex_unlock(&ctx->journals_lock);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_journal_new(struct lyd_node **tree, struct lyd_journal **journal)
+{
+    struct ly_ctx *ctx;
+    const struct lyd_node *iter, *iter2;
+
+    LY_CHECK_ARG_RET(NULL, tree, *tree, !(*tree)->parent, journal, LY_EINVAL);
+
+    ctx = (struct ly_ctx *)LYD_CTX(*tree);
+    *journal = calloc(1, sizeof **journal);
+    LY_CHECK_ERR_RET(!*journal, LOGMEM(ctx), LY_EMEM);
+    (*journal)->ctx = ctx;
+    (*journal)->tree = tree;
+    *tree = lyd_first_sibling(*tree);
+
+    /* register all the top-level nodes */
+    LY_LIST_FOR(*tree, iter) {
+        if (lyd_journal_top_add(*journal, iter)) {
+            for (iter2 = *tree; iter2 != iter; iter2 = iter2->next) {
+                lyd_journal_top_rm(ctx, iter2);
+            }
+            free(*journal);
+            *journal = NULL;
+            return LY_EMEM;
+        }
+    }
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Instance of a created or moved user-ordered (leaf-)list in a journal diff.
+ */
+struct lyd_journal_userord {
+    struct lyd_node *diff_node;     /**< diff node of the instance */
+    const struct lyd_node *node;    /**< the instance in the journaled tree */
+};
+
+/**
+ * @brief Compare user-ordered instances by their schema node and then by their order in the journaled tree.
+ */
+static int
+lyd_journal_userord_cmp(const void *ptr1, const void *ptr2)
+{
+    const struct lyd_journal_userord *inst1 = ptr1, *inst2 = ptr2;
+
+    if (inst1->node->schema != inst2->node->schema) {
+        return ((uintptr_t)inst1->node->schema < (uintptr_t)inst2->node->schema) ? -1 : 1;
+    }
+
+    return (inst1->node->order < inst2->node->order) ? -1 : (inst1->node->order > inst2->node->order);
+}
+
+/**
+ * @brief Anchor the created and moved user-ordered instances of a journal diff to their preceding instances in
+ * the journaled tree and order them accordingly, recursively.
+ *
+ * The anchors recorded with every change are valid only for the tree at the time of the change. Once an anchor
+ * instance is moved or deleted by a later change, the diff could not be applied. Instead, the instances placed
+ * in their final order after their final preceding instances can always be applied.
+ *
+ * @param[in] diff_first First diff sibling.
+ * @param[in] first First sibling of the journaled tree matching @p diff_first.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_journal_diff_userord_r(struct lyd_node *diff_first, const struct lyd_node *first)
+{
+    LY_ERR rc = LY_SUCCESS;
+    struct lyd_node *diff_node, *diff_inst;
+    struct lyd_node *match;
+    struct lyd_journal_userord *insts = NULL, *inst;
+    struct lyd_meta *meta;
+    enum lyd_diff_op op;
+    const char *meta_name, *anchor;
+    char *buf = NULL;
+    size_t buflen = 0, bufused;
+    uint32_t count = 0, i;
+    void *mem;
+
+    /* collect all the created and moved user-ordered instances, recursively process the others */
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (lysc_is_dup_inst_list(diff_node->schema)) {
+            /* instances and all their descendants are identified by position, which is kept */
+            continue;
+        }
+
+        lyd_find_sibling_first(first, diff_node, &match);
+        if (!match) {
+            /* deleted */
+            continue;
+        }
+
+        LY_CHECK_GOTO(rc = lyd_diff_get_op(diff_node, &op), cleanup);
+        if (lysc_is_userordered(diff_node->schema) && ((op == LYD_DIFF_OP_CREATE) || (op == LYD_DIFF_OP_REPLACE))) {
+            mem = realloc(insts, (count + 1) * sizeof *insts);
+            LY_CHECK_ERR_GOTO(!mem, LOGMEM(LYD_CTX(diff_node)); rc = LY_EMEM, cleanup);
+            insts = mem;
+            insts[count].diff_node = diff_node;
+            insts[count].node = match;
+            ++count;
+        }
+
+        LY_CHECK_GOTO(rc = lyd_journal_diff_userord_r(lyd_child_no_keys(diff_node), lyd_child(match)), cleanup);
+    }
+
+    if (!count) {
+        goto cleanup;
+    }
+    qsort(insts, count, sizeof *insts, lyd_journal_userord_cmp);
+
+    for (i = 0; i < count; ++i) {
+        inst = &insts[i];
+
+        /* update the anchor */
+        if (inst->node->prev->next && (inst->node->prev->schema == inst->node->schema)) {
+            if (inst->node->schema->nodetype == LYS_LIST) {
+                bufused = 0;
+                LY_CHECK_GOTO(rc = lyd_path_list_predicate(inst->node->prev, &buf, &buflen, &bufused, 0), cleanup);
+                anchor = buf;
+            } else {
+                anchor = lyd_get_value(inst->node->prev);
+            }
+        } else {
+            anchor = "";
+        }
+        meta_name = (inst->node->schema->nodetype == LYS_LIST) ? "yang:key" : "yang:value";
+        meta = lyd_find_meta(inst->diff_node->meta, NULL, meta_name);
+        if (meta) {
+            rc = lyd_change_meta(meta, anchor);
+            LY_CHECK_GOTO(rc && (rc != LY_EEXIST) && (rc != LY_ENOT), cleanup);
+            rc = LY_SUCCESS;
+        } else {
+            LY_CHECK_GOTO(rc = lyd_new_meta(NULL, inst->diff_node, NULL, meta_name, anchor, 0, NULL), cleanup);
+        }
+
+        /* order the instances */
+        if (!i || (inst->node->schema != insts[i - 1].node->schema)) {
+            /* the first instance of the schema node in the diff */
+            lyd_find_sibling_val(inst->diff_node, inst->diff_node->schema, NULL, 0, &diff_inst);
+            if (diff_inst != inst->diff_node) {
+                LY_CHECK_GOTO(rc = lyd_insert_before(diff_inst, inst->diff_node), cleanup);
+            }
+        } else if (inst->diff_node->prev != insts[i - 1].diff_node) {
+            LY_CHECK_GOTO(rc = lyd_insert_after(insts[i - 1].diff_node, inst->diff_node), cleanup);
+        }
+    }
+
+cleanup:
+    free(insts);
+    free(buf);
+    return rc;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_journal_diff(const struct lyd_journal *journal, struct lyd_node **diff)
+{
+    LY_ERR rc;
+
+    LY_CHECK_ARG_RET(NULL, journal, diff, LY_EINVAL);
+
+    *diff = NULL;
+    if (journal->err) {
+        LOGERR(NULL, journal->err, "Recording a change in the journal failed, the journal is incomplete.");
+        return journal->err;
+    }
+
+    if (!journal->diff) {
+        return LY_SUCCESS;
+    }
+    LY_CHECK_RET(lyd_dup_siblings(journal->diff, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, diff));
+
+    /* anchor the user-ordered instances in the current tree */
+    rc = lyd_journal_diff_userord_r(*diff, *journal->tree);
+    *diff = lyd_first_sibling(*diff);
+    if (rc) {
+        lyd_free_siblings(*diff);
+        *diff = NULL;
+    }
+    return rc;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_journal_rollback(struct lyd_journal *journal)
+{
+    LY_ERR rc;
+    struct lyd_node *diff = NULL, *rev_diff = NULL, *root, *elem;
+    struct lyd_meta *meta;
+    struct lyd_journal_order *orders;
+    struct lyd_journal_meta *metas;
+    struct hash_table *meta_ht;
+    enum lyd_diff_op op;
+    const char *meta_name;
+    uint32_t i, order_count, meta_count;
+
+    LY_CHECK_ARG_RET(NULL, journal, LY_EINVAL);
+
+    /* get the recorded changes */
+    LY_CHECK_RET(lyd_journal_diff(journal, &diff));
+    if (!diff && !journal->meta_count) {
+        return LY_SUCCESS;
+    }
+
+    /* undo them, the journal records the reverted changes as well so it stays consistent with the tree on failure */
+    LY_CHECK_GOTO(rc = lyd_diff_reverse_all(diff, &rev_diff), cleanup);
+    LY_LIST_FOR(rev_diff, root) {
+        LYD_TREE_DFS_BEGIN(root, elem) {
+            if (lysc_is_userordered(elem->schema) && !lysc_is_dup_inst_list(elem->schema)) {
+                LY_CHECK_GOTO(rc = lyd_diff_get_op(elem, &op), cleanup);
+                if ((op == LYD_DIFF_OP_CREATE) || (op == LYD_DIFF_OP_REPLACE)) {
+                    /* the anchors may not exist yet, insert the instances first and restore their order afterwards */
+                    meta_name = (elem->schema->nodetype == LYS_LIST) ? "yang:key" : "yang:value";
+                    meta = lyd_find_meta(elem->meta, NULL, meta_name);
+                    if (meta) {
+                        rc = lyd_change_meta(meta, "");
+                        LY_CHECK_GOTO(rc && (rc != LY_ENOT), cleanup);
+                    } else {
+                        LY_CHECK_GOTO(rc = lyd_new_meta(NULL, elem, NULL, meta_name, "", 0, NULL), cleanup);
+                    }
+                }
+            }
+            LYD_TREE_DFS_END(root, elem);
+        }
+    }
+    if (rev_diff) {
+        LY_CHECK_GOTO(rc = lyd_diff_apply_all(journal->tree, rev_diff), cleanup);
+    }
+
+    /* detach the original orders and metadata, restoring them is recorded and may remember new ones */
+    orders = journal->orders;
+    order_count = journal->order_count;
+    journal->orders = NULL;
+    journal->order_count = 0;
+    metas = journal->metas;
+    meta_count = journal->meta_count;
+    meta_ht = journal->meta_ht;
+    journal->metas = NULL;
+    journal->meta_count = 0;
+    journal->meta_ht = NULL;
+
+    /* restore the original order of all the user-ordered instances */
+    for (i = 0; i < order_count; ++i) {
+        if ((rc = lyd_journal_order_restore(journal, &orders[i]))) {
+            break;
+        }
+    }
+
+    /* restore the original metadata of all the nodes */
+    for (i = 0; !rc && (i < meta_count); ++i) {
+        rc = lyd_journal_meta_restore(journal, &metas[i]);
+    }
+
+    if (rc) {
+        /* the original orders and metadata are still those from the journal creation or reset */
+        lyd_journal_orders_free(journal->orders, journal->order_count);
+        journal->orders = orders;
+        journal->order_count = order_count;
+        lyd_journal_metas_free(journal->metas, journal->meta_count, journal->meta_ht);
+        journal->metas = metas;
+        journal->meta_count = meta_count;
+        journal->meta_ht = meta_ht;
+        lyht_set_cb_data(meta_ht, journal);
+    } else {
+        /* the tree is in the state when the journal was created or reset */
+        lyd_journal_reset(journal);
+        lyd_journal_orders_free(orders, order_count);
+        lyd_journal_metas_free(metas, meta_count, meta_ht);
+    }
+
+cleanup:
+    lyd_free_siblings(diff);
+    lyd_free_siblings(rev_diff);
+    return rc;
+}
+
+LIBYANG_API_DEF void
+lyd_journal_reset(struct lyd_journal *journal)
+{
+    if (!journal) {
+        return;
+    }
+
+    lyd_free_siblings(journal->diff);
+    journal->diff = NULL;
+    journal->err = LY_SUCCESS;
+    lyd_journal_orders_free(journal->orders, journal->order_count);
+    journal->orders = NULL;
+    journal->order_count = 0;
+    lyd_journal_metas_free(journal->metas, journal->meta_count, journal->meta_ht);
+    journal->metas = NULL;
+    journal->meta_count = 0;
+    journal->meta_ht = NULL;
+}
+
+LIBYANG_API_DEF void
+lyd_journal_free(struct lyd_journal *journal)
+{
+    const struct lyd_node *iter;
+
+    if (!journal) {
+        return;
+    }
+
+    /* unregister the journaled tree */
+    LY_LIST_FOR(*journal->tree, iter) {
+        lyd_journal_top_rm(journal->ctx, iter);
+    }
+
+    lyd_free_siblings(journal->diff);
+    lyd_journal_orders_free(journal->orders, journal->order_count);
+    lyd_journal_metas_free(journal->metas, journal->meta_count, journal->meta_ht);
+    free(journal);
+}
+
+/**
+ * @brief Copy of a data tree shared by its snapshots.
+ */
+struct lyd_snapshot_copy {
+    struct lyd_node *tree;      /**< copy of the data tree */
+    uint32_t refs;              /**< number of snapshots of the copy in use */
+};
+
+struct lyd_snapshots {
+    struct lyd_journal *journal;        /**< changes of the data tree since the current copy was made */
+    struct lyd_snapshot_copy *current;  /**< copy of the data tree, equal to it if the journal is empty */
+    struct ly_set old;                  /**< outdated copies with snapshots still in use */
+    pthread_mutex_t lock;               /**< lock for accessing the copies */
+};
+
+LIBYANG_API_DEF LY_ERR
+lyd_snapshots_new(struct lyd_node **tree, struct lyd_snapshots **snapshots)
+{
+    LY_ERR rc;
+
+    LY_CHECK_ARG_RET(NULL, tree, *tree, snapshots, LY_EINVAL);
+
+    *snapshots = calloc(1, sizeof **snapshots);
+    LY_CHECK_ERR_RET(!*snapshots, LOGMEM(LYD_CTX(*tree)), LY_EMEM);
+
+    /* journal the tree to learn about its changes */
+    rc = lyd_journal_new(tree, &(*snapshots)->journal);
+    if (rc) {
+        free(*snapshots);
+        *snapshots = NULL;
+        return rc;
+    }
+    pthread_mutex_init(&(*snapshots)->lock, NULL);
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free a copy of a data tree.
+ *
+ * @param[in] copy Copy to free.
+ */
+static void
+lyd_snapshot_copy_free(void *copy)
+{
+    struct lyd_snapshot_copy *c = copy;
+
+    lyd_free_siblings(c->tree);
+    free(c);
+}
+
+/**
+ * @brief Generate all the lazily generated data of a copy so that its snapshots can be read by several threads.
+ *
+ * @param[in] copy Copy to prepare.
+ */
+static void
+lyd_snapshot_copy_prepare(struct lyd_snapshot_copy *copy)
+{
+    const struct lyd_node *iter;
+
+    lyd_mt_prepare(copy->tree, 1);
+
+    /* subtree hashes for diffs with LYD_DIFF_SUBTREE_HASH */
+    LY_LIST_FOR(copy->tree, iter) {
+        lyd_hash_subtree(iter);
+    }
+}
+
+/**
+ * @brief Make sure the current copy of snapshots is equal to the data tree.
+ *
+ * @param[in] snapshots Snapshots to update, their lock is held.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_snapshots_update(struct lyd_snapshots *snapshots)
+{
+    LY_ERR rc;
+    struct lyd_node *diff = NULL;
+    struct lyd_snapshot_copy *current = snapshots->current;
+
+    /* get the changes since the current copy was made, consider the tree completely changed on error, changes of
+     * an empty tree cannot be journaled and metadata changes are not in the diff */
+    if (!lyd_journal_diff(snapshots->journal, &diff) && current && !diff && !snapshots->journal->meta_count &&
+            (current->tree || !*snapshots->journal->tree)) {
+        /* up-to-date */
+        return LY_SUCCESS;
+    }
+
+    if (current && !current->refs && diff && !snapshots->journal->meta_count) {
+        /* nobody reads the current copy, just apply the changes */
+        rc = lyd_diff_apply_all(&current->tree, diff);
+        lyd_free_siblings(diff);
+        if (!rc) {
+            lyd_snapshot_copy_prepare(current);
+            lyd_journal_reset(snapshots->journal);
+            return LY_SUCCESS;
+        }
+
+        /* copy the whole tree again */
+        lyd_snapshot_copy_free(current);
+    } else if (current && !current->refs) {
+        lyd_free_siblings(diff);
+        lyd_snapshot_copy_free(current);
+    } else if (current) {
+        /* keep the current copy for its snapshots */
+        lyd_free_siblings(diff);
+        LY_CHECK_RET(ly_set_add(&snapshots->old, current, 1, NULL));
+    }
+    snapshots->current = NULL;
+
+    /* copy the whole tree, if any */
+    current = calloc(1, sizeof *current);
+    LY_CHECK_ERR_RET(!current, LOGMEM(snapshots->journal->ctx), LY_EMEM);
+    if (*snapshots->journal->tree) {
+        rc = lyd_dup_siblings(*snapshots->journal->tree, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &current->tree);
+        if (rc) {
+            free(current);
+            return rc;
+        }
+        lyd_snapshot_copy_prepare(current);
+    }
+    snapshots->current = current;
+    lyd_journal_reset(snapshots->journal);
+
+    return LY_SUCCESS;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_snapshot_get(struct lyd_snapshots *snapshots, const struct lyd_node **snapshot)
+{
+    LY_ERR rc;
+
+    LY_CHECK_ARG_RET(NULL, snapshots, snapshot, LY_EINVAL);
+
+    *snapshot = NULL;
+
+    /* LOCK */
+    pthread_mutex_lock(&snapshots->lock);
+
+    rc = lyd_snapshots_update(snapshots);
+    if (!rc) {
+        ++snapshots->current->refs;
+        *snapshot = snapshots->current->tree;
+    }
+
+    /* UNLOCK */
+    pthread_mutex_unlock(&snapshots->lock);
+
+    return rc;
+}
+
+LIBYANG_API_DEF void
+lyd_snapshot_release(struct lyd_snapshots *snapshots, const struct lyd_node *snapshot)
+{
+    struct lyd_snapshot_copy *copy;
+    uint32_t i;
+
+    if (!snapshots) {
+        return;
+    }
+
+    /* LOCK */
+    pthread_mutex_lock(&snapshots->lock);
+
+    if (snapshots->current && (snapshots->current->tree == snapshot) && snapshots->current->refs) {
+        --snapshots->current->refs;
+    } else {
+        for (i = 0; i < snapshots->old.count; ++i) {
+            copy = snapshots->old.objs[i];
+            if (copy->tree == snapshot) {
+                if (!--copy->refs) {
+                    /* last snapshot of an outdated copy */
+                    ly_set_rm_index(&snapshots->old, i, lyd_snapshot_copy_free);
+                }
+                break;
+            }
+        }
+    }
+
+    /* UNLOCK */
+    pthread_mutex_unlock(&snapshots->lock);
+}
+
+LIBYANG_API_DEF void
+lyd_snapshots_free(struct lyd_snapshots *snapshots)
+{
+    if (!snapshots) {
+        return;
+    }
+
+    lyd_journal_free(snapshots->journal);
+    if (snapshots->current) {
+        lyd_snapshot_copy_free(snapshots->current);
+    }
+    ly_set_erase(&snapshots->old, lyd_snapshot_copy_free);
+    pthread_mutex_destroy(&snapshots->lock);
+    free(snapshots);
+}
+
+struct lyd_journal *
+lyd_journal_get(const struct lyd_node *node)
+{
+    struct ly_ctx *ctx;
+    const struct lyd_node *top;
+    struct lyd_journal_rec rec = {0}, *match;
+    struct lyd_journal *journal = NULL;
+
+    if (journal_recording) {
+        return NULL;
+    }
+
+    /* opaque nodes and extension data are never journaled */
+    for (top = node; top->parent; top = lyd_parent(top)) {
+        if (!top->schema || (top->flags & LYD_EXT)) {
+            return NULL;
+        }
+    }
+    if (!top->schema || (top->flags & LYD_EXT)) {
+        return NULL;
+    }
+
+    if (!(top->flags & LYD_JOURNALED)) {
+        /* a just inserted top-level node is not registered yet but its sibling is */
+        if ((top->prev == top) || !(top->prev->flags & LYD_JOURNALED)) {
+            return NULL;
+        }
+        top = top->prev;
+    }
+
+    ctx = (struct ly_ctx *)LYD_CTX(node);
+    rec.top = top;
+
+    /* LOCK */
+    pthread_mutex_lock(&ctx->journals_lock);
+
+    if (!lyht_find(ctx->journals, &rec, lyd_journal_rec_hash(top), (void **)&match)) {
+        journal = match->journal;
+    }
+
+    /* UNLOCK */
+    pthread_mutex_unlock(&ctx->journals_lock);
+
+    return journal;
+}
+
+/**
+ * @brief Record a change into a journal.
+ *
+ * @param[in] journal Journal to record into.
+ * @param[in] node Changed node, with its current value.
+ * @param[in] op Operation of the change.
+ * @param[in] orig_default Original default metadata of a replaced term node.
+ * @param[in] orig_value Original value metadata of a replaced node.
+ */
+static void
+lyd_journal_add(struct lyd_journal *journal, const struct lyd_node *node, enum lyd_diff_op op, const char *orig_default,
+        const char *orig_value)
+{
+    LY_ERR rc = LY_SUCCESS;
+    const struct lyd_node *prev = NULL;
+    struct lyd_node *diff = NULL, *root, *elem;
+    enum lyd_diff_op elem_op;
+    const char *dflt;
+    char *value = NULL, *uo_orig_value = NULL, *key = NULL, *orig_key = NULL, *position = NULL, *orig_position = NULL;
+    uint32_t pos = 0;
+
+    if (journal->err) {
+        /* the journal is incomplete anyway */
+        return;
+    }
+
+    journal_recording = 1;
+
+    if (lysc_is_userordered(node->schema) && ((op == LYD_DIFF_OP_CREATE) || (op == LYD_DIFF_OP_DELETE))) {
+        /* the instance is anchored to the one preceding it */
+        if (node->prev->next && (node->prev->schema == node->schema)) {
+            prev = node->prev;
+            pos = lysc_is_dup_inst_list(node->schema) ? lyd_list_pos(node) - 1 : 1;
+        }
+        rc = lyd_diff_userord_attrs((op == LYD_DIFF_OP_DELETE) ? node : NULL, (op == LYD_DIFF_OP_CREATE) ? node : NULL,
+                op, pos, pos, prev, prev, &dflt, &value, &uo_orig_value, &key, &orig_key, &position, &orig_position);
+        LY_CHECK_GOTO(rc, cleanup);
+        orig_value = uo_orig_value;
+    }
+
+    /* create the diff of the change */
+    LY_CHECK_GOTO(rc = lyd_diff_add(node, op, orig_default, orig_value, key, value, position, orig_key, orig_position,
+            &diff), cleanup);
+    if (op == LYD_DIFF_OP_DELETE) {
+        /* nested user-ordered instances keep their original anchors in case they are created again */
+        LY_LIST_FOR(diff, root) {
+            LYD_TREE_DFS_BEGIN(root, elem) {
+                if (lysc_is_userordered(elem->schema) && !lyd_find_meta(elem->meta, NULL, "yang:operation")) {
+                    LY_CHECK_GOTO(rc = lyd_diff_get_op(elem, &elem_op), cleanup);
+                    if (elem_op == LYD_DIFF_OP_DELETE) {
+                        LY_CHECK_GOTO(rc = lyd_diff_add_nested_userord(elem, 1), cleanup);
+                    }
+                }
+                LYD_TREE_DFS_END(root, elem);
+            }
+        }
+    }
+
+    /* merge it into the journal */
+    rc = lyd_diff_merge_all(&journal->diff, diff, LYD_DIFF_MERGE_DEFAULTS);
+
+cleanup:
+    lyd_free_siblings(diff);
+    journal_recording = 0;
+    free(value);
+    free(uo_orig_value);
+    free(key);
+    free(orig_key);
+    free(position);
+    free(orig_position);
+    journal->err = rc;
+}
+
+void
+lyd_journal_create(struct lyd_journal *journal, const struct lyd_node *node)
+{
+    LY_ERR rc;
+    const struct lyd_node *elem;
+
+    if (lysc_is_key(node->schema)) {
+        /* keys are recorded with their list */
+        return;
+    }
+
+    if (!node->parent) {
+        if (!node->prev->next) {
+            /* new first sibling of the tree */
+            *journal->tree = (struct lyd_node *)node;
+        }
+
+        /* new top-level node of the tree, keep tracking the tree even if the journal is incomplete */
+        rc = lyd_journal_top_add(journal, node);
+        if (!journal->err) {
+            journal->err = rc;
+        }
+    }
+
+    if (!journal->err && lysc_is_userordered(node->schema) && !lysc_is_dup_inst_list(node->schema)) {
+        /* remember the original order of the instances */
+        journal->err = lyd_journal_order_save(journal, node, node);
+    }
+
+    /* the created nodes had no metadata */
+    LYD_TREE_DFS_BEGIN(node, elem) {
+        if (!journal->err && elem->meta) {
+            journal->err = lyd_journal_meta_save(journal, elem, 1);
+        }
+        LYD_TREE_DFS_END(node, elem);
+    }
+
+    lyd_journal_add(journal, node, LYD_DIFF_OP_CREATE, NULL, NULL);
+}
+
+void
+lyd_journal_delete(struct lyd_journal *journal, const struct lyd_node *node)
+{
+    const struct lyd_node *elem;
+
+    if (lysc_is_key(node->schema)) {
+        return;
+    }
+
+    /* remember the original order of the instances and the original metadata, also of all the nested ones */
+    LYD_TREE_DFS_BEGIN(node, elem) {
+        if (!journal->err && lysc_is_userordered(elem->schema) && !lysc_is_dup_inst_list(elem->schema) &&
+                ((elem == node) || !elem->prev->next || (elem->prev->schema != elem->schema))) {
+            journal->err = lyd_journal_order_save(journal, elem, NULL);
+        }
+        if (!journal->err && elem->meta) {
+            journal->err = lyd_journal_meta_save(journal, elem, 0);
+        }
+        LYD_TREE_DFS_END(node, elem);
+    }
+
+    lyd_journal_add(journal, node, LYD_DIFF_OP_DELETE, NULL, NULL);
+
+    if (node == *journal->tree) {
+        /* the first sibling is being removed */
+        *journal->tree = node->next;
+    }
+    if (!node->parent) {
+        lyd_journal_top_rm(journal->ctx, node);
+    }
+}
+
+void
+lyd_journal_meta(struct lyd_journal *journal, const struct lyd_node *node)
+{
+    if (!journal->err) {
+        journal->err = lyd_journal_meta_save(journal, node, 0);
+    }
+}
+
+void
+lyd_journal_replace(struct lyd_journal *journal, const struct lyd_node *node, const char *orig_value,
+        ly_bool orig_default)
+{
+    const char *dflt = NULL;
+
+    if (node->schema->nodetype & LYD_NODE_TERM) {
+        dflt = orig_default ? "true" : "false";
+    }
+    lyd_journal_add(journal, node, orig_value ? LYD_DIFF_OP_REPLACE : LYD_DIFF_OP_NONE, dflt, orig_value);
+}
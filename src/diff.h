@@ -18,26 +18,27 @@
 #include <stdint.h>
 
 #include "log.h"
+#include "tree_data.h"
 
 struct lyd_node;
 
+struct hash_table;
+
 /**
  * @brief Internal structure for storing current (virtual) user-ordered instances order.
+ *
+ * The current order is formed by the @p pos instances already at their final position, the last of them being
+ * @p last, followed by the remaining instances of @p inst that were neither deleted nor moved, in their original
+ * order. These remaining instances are counted by a Fenwick tree so that the position of any instance is found
+ * in logarithmic time.
  */
 struct lyd_diff_userord {
     const struct lysc_node *schema; /**< User-ordered list/leaf-list schema node. */
     uint64_t pos;                   /**< Current position in the second tree. */
-    const struct lyd_node **inst;   /**< Sized array of current instance order. */
-};
-
-/**
- * @brief Diff operations.
- */
-enum lyd_diff_op {
-    LYD_DIFF_OP_CREATE,    /**< Subtree created. */
-    LYD_DIFF_OP_DELETE,    /**< Subtree deleted. */
-    LYD_DIFF_OP_REPLACE,   /**< Node value changed or (leaf-)list instance moved. */
-    LYD_DIFF_OP_NONE       /**< No change of an existing inner node or default flag change of a term node. */
+    const struct lyd_node **inst;   /**< Sized array of the instances in the original order. */
+    uint32_t *rem;                  /**< Fenwick tree of the remaining instances of @p inst. */
+    struct hash_table *inst_ht;     /**< Hash table of the indices of the instances in @p inst. */
+    const struct lyd_node *last;    /**< Last instance at its final position. */
 };
 
 /**
@@ -59,4 +60,49 @@ LIBYANG_API_DECL LY_ERR lyd_diff_add(const struct lyd_node *node, enum lyd_diff_
         const char *key, const char *value, const char *position, const char *orig_key, const char *orig_position,
         struct lyd_node **diff);
 
+/**
+ * @brief Get the change journal of the tree a node belongs to.
+ *
+ * Finds the top-level node and the journal registered for it in constant time (*O(1)*) if it has ::LYD_JOURNALED.
+ *
+ * @param[in] node Data node.
+ * @return Journal recording the changes of the tree, NULL if there is none or a change is just being recorded.
+ */
+struct lyd_journal *lyd_journal_get(const struct lyd_node *node);
+
+/**
+ * @brief Record a created node in a journal, call after it was inserted.
+ *
+ * @param[in] journal Journal to record into.
+ * @param[in] node Created node (subtree).
+ */
+void lyd_journal_create(struct lyd_journal *journal, const struct lyd_node *node);
+
+/**
+ * @brief Record a deleted node in a journal, call before it is unlinked.
+ *
+ * @param[in] journal Journal to record into.
+ * @param[in] node Deleted node (subtree).
+ */
+void lyd_journal_delete(struct lyd_journal *journal, const struct lyd_node *node);
+
+/**
+ * @brief Record the metadata of a node in a journal, call before they are changed.
+ *
+ * @param[in] journal Journal to record into.
+ * @param[in] node Node with the metadata.
+ */
+void lyd_journal_meta(struct lyd_journal *journal, const struct lyd_node *node);
+
+/**
+ * @brief Record a changed value or default flag of a node in a journal, call after the change.
+ *
+ * @param[in] journal Journal to record into.
+ * @param[in] node Changed leaf or any node.
+ * @param[in] orig_value Original canonical value of the node, NULL if only the default flag was cleared.
+ * @param[in] orig_default Whether the node was a default node.
+ */
+void lyd_journal_replace(struct lyd_journal *journal, const struct lyd_node *node, const char *orig_value,
+        ly_bool orig_default);
+
 #endif /* LY_DIFF_H_ */
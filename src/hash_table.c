@@ -390,30 +390,25 @@ lyht_free(struct hash_table *ht)
 }
 
 /**
- * @brief Resize a hash table.
+ * @brief Rehash all the records of a hash table into a new records array.
  *
- * @param[in] ht Hash table to resize.
- * @param[in] operation Operation to perform. 1 to enlarge, -1 to shrink, 0 to only rehash all records.
+ * @param[in] ht Hash table to rehash.
+ * @param[in] size New size of the hash table, power of 2.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyht_resize(struct hash_table *ht, int operation)
+lyht_rehash(struct hash_table *ht, uint32_t size)
 {
     struct ht_rec *rec;
     unsigned char *old_recs;
     uint32_t i, old_size;
 
+    assert(size && !(size & (size - 1)));
+
     old_recs = ht->recs;
     old_size = ht->size;
 
-    if (operation > 0) {
-        /* double the size */
-        ht->size <<= 1;
-    } else if (operation < 0) {
-        /* half the size */
-        ht->size >>= 1;
-    }
-
+    ht->size = size;
     ht->recs = calloc(ht->size, ht->rec_size);
     LY_CHECK_ERR_RET(!ht->recs, LOGMEM(NULL); ht->recs = old_recs; ht->size = old_size, LY_EMEM);
 
@@ -436,6 +431,56 @@ lyht_resize(struct hash_table *ht, int operation)
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Resize a hash table.
+ *
+ * @param[in] ht Hash table to resize.
+ * @param[in] operation Operation to perform. 1 to enlarge, -1 to shrink, 0 to only rehash all records.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyht_resize(struct hash_table *ht, int operation)
+{
+    uint32_t size = ht->size;
+
+    if (operation > 0) {
+        /* double the size */
+        size <<= 1;
+    } else if (operation < 0) {
+        /* half the size */
+        size >>= 1;
+    }
+
+    return lyht_rehash(ht, size);
+}
+
+LY_ERR
+lyht_reserve(struct hash_table *ht, uint32_t count)
+{
+    uint32_t size = ht->size;
+
+    if (!ht->resize) {
+        /* fixed size */
+        return LY_SUCCESS;
+    }
+
+    /* find the size that will not need to be enlarged after inserting all the values */
+    while (((uint64_t)ht->used + count) * LYHT_HUNDRED_PERCENTAGE / size >= LYHT_ENLARGE_PERCENTAGE) {
+        if (size & 0x80000000) {
+            /* cannot grow any more */
+            break;
+        }
+        size <<= 1;
+    }
+
+    if (size == ht->size) {
+        /* big enough */
+        return LY_SUCCESS;
+    }
+
+    return lyht_rehash(ht, size);
+}
+
 /**
  * @brief Search for the first match.
  *
@@ -226,6 +226,16 @@ LY_ERR lyht_insert(struct hash_table *ht, void *val_p, uint32_t hash, void **mat
 LY_ERR lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, lyht_value_equal_cb resize_val_equal,
         void **match_p);
 
+/**
+ * @brief Enlarge a hash table so that a number of values can be inserted into it without any more resizing.
+ *
+ * @param[in] ht Hash table to enlarge.
+ * @param[in] count Number of values that are going to be inserted.
+ * @return LY_SUCCESS on success,
+ * @return LY_EMEM in case of memory allocation failure.
+ */
+LY_ERR lyht_reserve(struct hash_table *ht, uint32_t count);
+
 /**
  * @brief Remove a value from a hash table.
  *
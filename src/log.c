@@ -43,6 +43,16 @@ ATOMIC_T ly_ldbg_groups = 0;
 
 THREAD_LOCAL struct ly_log_location_s log_location = {0};
 
+/**
+ * @brief Whether the messages of this thread are being captured, see ::ly_log_capture_start().
+ */
+static THREAD_LOCAL ly_bool log_capture;
+
+/**
+ * @brief Error list of this thread stashed while capturing messages.
+ */
+static THREAD_LOCAL struct ly_err_item *log_capture_stash;
+
 /* how many bytes add when enlarging buffers */
 #define LY_BUF_STEP 128
 
@@ -371,7 +381,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
         } while (eitem->prev->next);
         /* last error was not found */
         assert(0);
-    } else if ((ATOMIC_LOAD_RELAXED(ly_log_opts) & LY_LOSTORE_LAST) == LY_LOSTORE_LAST) {
+    } else if (!log_capture && ((ATOMIC_LOAD_RELAXED(ly_log_opts) & LY_LOSTORE_LAST) == LY_LOSTORE_LAST)) {
         /* overwrite last message */
         free(eitem->msg);
         free(eitem->path);
@@ -436,8 +446,9 @@ log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE v
         return;
     }
 
-    /* store the error/warning (if we need to store errors internally, it does not matter what are the user log options) */
-    if ((level < LY_LLVRB) && ctx && (ATOMIC_LOAD_RELAXED(ly_log_opts) & LY_LOSTORE)) {
+    /* store the error/warning (if we need to store errors internally, it does not matter what are the user log
+     * options), captured messages are always stored */
+    if ((level < LY_LLVRB) && ctx && (log_capture || (ATOMIC_LOAD_RELAXED(ly_log_opts) & LY_LOSTORE))) {
         assert(format);
         if (vasprintf(&msg, format, args) == -1) {
             LOGMEM(ctx);
@@ -461,8 +472,8 @@ log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE v
         free_strs = 1;
     }
 
-    /* if we are only storing errors internally, never print the message (yet) */
-    if (ATOMIC_LOAD_RELAXED(ly_log_opts) & LY_LOLOG) {
+    /* if we are only storing errors internally, never print the message (yet), captured ones are printed on replay */
+    if ((ATOMIC_LOAD_RELAXED(ly_log_opts) & LY_LOLOG) && (free_strs || !log_capture)) {
         if (log_clb) {
             log_clb(level, msg, path);
         } else {
@@ -655,3 +666,41 @@ ly_err_print(const struct ly_ctx *ctx, struct ly_err_item *eitem)
     /* String ::ly_err_item.msg cannot be used directly because it may contain the % character */
     _ly_err_print(ctx, eitem, "%s", eitem->msg);
 }
+
+void
+ly_log_capture_start(const struct ly_ctx *ctx)
+{
+    assert(!log_capture);
+
+    /* stash the current errors, the captured ones are stored instead */
+    log_capture_stash = pthread_getspecific(ctx->errlist_key);
+    pthread_setspecific(ctx->errlist_key, NULL);
+    log_capture = 1;
+}
+
+struct ly_err_item *
+ly_log_capture_stop(const struct ly_ctx *ctx)
+{
+    struct ly_err_item *captured;
+
+    assert(log_capture);
+
+    /* restore the stashed errors */
+    captured = pthread_getspecific(ctx->errlist_key);
+    pthread_setspecific(ctx->errlist_key, log_capture_stash);
+    log_capture_stash = NULL;
+    log_capture = 0;
+
+    return captured;
+}
+
+void
+ly_log_replay(const struct ly_ctx *ctx, struct ly_err_item *captured)
+{
+    struct ly_err_item *eitem;
+
+    for (eitem = captured; eitem; eitem = eitem->next) {
+        _ly_err_print(ctx, eitem, "%s", eitem->msg);
+    }
+    ly_err_free(captured);
+}
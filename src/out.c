@@ -39,6 +39,44 @@
 #define REALLOC_CHUNK(NEW_SIZE) \
     NEW_SIZE + (1024 - (NEW_SIZE % 1024))
 
+/**
+ * @brief Make sure the memory output buffer can hold @p count more bytes followed by the terminating zero.
+ *
+ * The buffer grows at least twice its current size so that printing large data requires only a logarithmic
+ * number of reallocations (and copies) of the buffer.
+ *
+ * @param[in] out Memory output handler.
+ * @param[in] count Number of bytes to be added into the buffer.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+ly_out_mem_reserve(struct ly_out *out, size_t count)
+{
+    size_t new_size;
+
+    new_size = out->method.mem.len + count + 1;
+    if (new_size <= out->method.mem.size) {
+        /* enough space */
+        return LY_SUCCESS;
+    }
+
+    new_size = REALLOC_CHUNK(new_size);
+    if (new_size < 2 * out->method.mem.size) {
+        new_size = 2 * out->method.mem.size;
+    }
+
+    *out->method.mem.buf = ly_realloc(*out->method.mem.buf, new_size);
+    if (!*out->method.mem.buf) {
+        out->method.mem.len = 0;
+        out->method.mem.size = 0;
+        LOGMEM(NULL);
+        return LY_EMEM;
+    }
+    out->method.mem.size = new_size;
+
+    return LY_SUCCESS;
+}
+
 LIBYANG_API_DEF ly_bool
 lyd_node_should_print(const struct lyd_node *node, uint32_t options)
 {
@@ -417,7 +455,8 @@ ly_vprint_(struct ly_out *out, const char *format, va_list ap)
 {
     LY_ERR ret;
     int written = 0;
-    char *msg = NULL, *aux;
+    char *msg = NULL;
+    va_list ap_copy;
 
     switch (out->type) {
     case LY_OUT_FD:
@@ -429,27 +468,26 @@ ly_vprint_(struct ly_out *out, const char *format, va_list ap)
         written = vfprintf(out->method.f, format, ap);
         break;
     case LY_OUT_MEMORY:
-        if ((written = vasprintf(&msg, format, ap)) < 0) {
-            break;
+        /* try to print directly into the remaining space of the buffer */
+        va_copy(ap_copy, ap);
+        if (out->method.mem.size > out->method.mem.len) {
+            written = vsnprintf(&(*out->method.mem.buf)[out->method.mem.len], out->method.mem.size - out->method.mem.len,
+                    format, ap);
+        } else {
+            written = vsnprintf(NULL, 0, format, ap);
         }
-        if (out->method.mem.len + written + 1 > out->method.mem.size) {
-            aux = ly_realloc(*out->method.mem.buf, out->method.mem.len + written + 1);
-            if (!aux) {
-                out->method.mem.buf = NULL;
-                out->method.mem.len = 0;
-                out->method.mem.size = 0;
-                LOGMEM(NULL);
+        if ((written >= 0) && (out->method.mem.len + written + 1 > out->method.mem.size)) {
+            /* not enough space, enlarge the buffer and print again */
+            if (ly_out_mem_reserve(out, written)) {
+                va_end(ap_copy);
                 return LY_EMEM;
             }
-            *out->method.mem.buf = aux;
-            out->method.mem.size = out->method.mem.len + written + 1;
+            vsnprintf(&(*out->method.mem.buf)[out->method.mem.len], written + 1, format, ap_copy);
         }
-        if (written) {
-            memcpy(&(*out->method.mem.buf)[out->method.mem.len], msg, written);
+        va_end(ap_copy);
+        if (written > 0) {
+            out->method.mem.len += written;
         }
-        out->method.mem.len += written;
-        (*out->method.mem.buf)[out->method.mem.len] = '\0';
-        free(msg);
         break;
     case LY_OUT_CALLBACK:
         if ((written = vasprintf(&msg, format, ap)) < 0) {
@@ -540,7 +578,7 @@ LY_ERR
 ly_write_(struct ly_out *out, const char *buf, size_t len)
 {
     LY_ERR ret = LY_SUCCESS;
-    size_t written = 0, new_mem_size;
+    size_t written = 0;
 
     if (out->hole_count) {
         /* we are buffering data after a hole */
@@ -568,18 +606,7 @@ ly_write_(struct ly_out *out, const char *buf, size_t len)
 repeat:
     switch (out->type) {
     case LY_OUT_MEMORY:
-        new_mem_size = out->method.mem.len + len + 1;
-        if (new_mem_size > out->method.mem.size) {
-            new_mem_size = REALLOC_CHUNK(new_mem_size);
-            *out->method.mem.buf = ly_realloc(*out->method.mem.buf, new_mem_size);
-            if (!*out->method.mem.buf) {
-                out->method.mem.len = 0;
-                out->method.mem.size = 0;
-                LOGMEM(NULL);
-                return LY_EMEM;
-            }
-            out->method.mem.size = new_mem_size;
-        }
+        LY_CHECK_RET(ly_out_mem_reserve(out, len));
         if (len) {
             memcpy(&(*out->method.mem.buf)[out->method.mem.len], buf, len);
         }
@@ -664,16 +691,7 @@ ly_write_skip(struct ly_out *out, size_t count, size_t *position)
 {
     switch (out->type) {
     case LY_OUT_MEMORY:
-        if (out->method.mem.len + count > out->method.mem.size) {
-            *out->method.mem.buf = ly_realloc(*out->method.mem.buf, out->method.mem.len + count);
-            if (!(*out->method.mem.buf)) {
-                out->method.mem.len = 0;
-                out->method.mem.size = 0;
-                LOGMEM(NULL);
-                return LY_EMEM;
-            }
-            out->method.mem.size = out->method.mem.len + count;
-        }
+        LY_CHECK_RET(ly_out_mem_reserve(out, count));
 
         /* save the current position */
         *position = out->method.mem.len;
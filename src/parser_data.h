@@ -92,7 +92,10 @@ struct ly_in;
  * to modify the validation process by @ref datavalidationoptions. This way the state data can be prohibited
  * (::LYD_VALIDATE_NO_STATE) and checking for mandatory nodes can be limited to the YANG modules with already present data
  * instances (::LYD_VALIDATE_PRESENT). Validation of the standard data tree can be also limited with ::lyd_validate_module()
- * function, which scopes only to a specified single YANG module.
+ * function, which scopes only to a specified single YANG module. A valid data tree changed by a known set of changes
+ * can be validated incrementally by ::lyd_validate_diff(), which checks only the data that the changes can affect.
+ * To learn which constraints are the most expensive to validate, the context can collect validation statistics
+ * (::lyd_val_stats_enable()).
  *
  * Since the operation data trees (RPCs, Actions or Notifications) can reference (leafref, instance-identifier, when/must
  * expressions) data from a datastore tree, ::lyd_validate_op() may require additional data tree to be provided. This is a
@@ -103,7 +106,12 @@ struct ly_in;
  * --------------
  * - ::lyd_validate_all()
  * - ::lyd_validate_module()
+ * - ::lyd_validate_diff()
  * - ::lyd_validate_op()
+ *
+ * - ::lyd_val_stats_enable()
+ * - ::lyd_val_stats_get()
+ * - ::lyd_val_stats_print()
  */
 
 /**
@@ -190,6 +198,12 @@ struct ly_in;
 #define LYD_VALIDATE_NO_STATE   0x0001      /**< Consider state data not allowed and raise an error if they are found.
                                                  Also, no implicit state data are added. */
 #define LYD_VALIDATE_PRESENT    0x0002      /**< Validate only modules whose data actually exist. */
+#define LYD_VALIDATE_MULTI_THREADED 0x0004 /**< Perform the checks that do not modify the data tree (must, unique,
+                                                 min/max-elements, mandatory, leafref and other type restrictions) by
+                                                 several worker threads. The data tree (defaults, case auto-delete,
+                                                 validation diff) is still modified only by the calling thread and the
+                                                 logged messages and the returned error do not depend on the thread
+                                                 scheduling. */
 
 #define LYD_VALIDATE_OPTS_MASK  0x0000FFFF  /**< Mask for all the LYD_VALIDATE_* options. */
 
@@ -431,6 +445,31 @@ LIBYANG_API_DECL LY_ERR lyd_validate_all(struct lyd_node **tree, const struct ly
 LIBYANG_API_DECL LY_ERR lyd_validate_module(struct lyd_node **tree, const struct lys_module *module, uint32_t val_opts,
         struct lyd_node **diff);
 
+/**
+ * @brief Validate a data tree incrementally, only the data that may be affected by changes from a diff.
+ *
+ * The data tree must have been valid before the changes in @p diff were applied to it. Changed (created or
+ * replaced) subtrees are validated fully, their siblings are checked for mandatory nodes, min/max-elements,
+ * and unique, the uniques of all their ancestor lists that include them are checked, and the when, must, leafref,
+ * and instance-identifier restrictions are evaluated only on the instances of schema nodes whose expressions
+ * reference a changed schema node. The schema dependencies are derived from the atoms of all the expressions
+ * (see ::lys_find_expr_atoms()) of the implemented modules once and kept in the context until a module is compiled.
+ *
+ * The data tree is modified in-place. As a result of the validation, some data might be removed
+ * from the tree. In that case, the removed items are freed, not just unlinked.
+ *
+ * @param[in,out] tree Data tree to validate. May be changed by validation, might become NULL.
+ * @param[in] diff Diff with all the changes of @p tree since it was last valid, as generated by lyd_diff_*()
+ * functions or by previous validation.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions), ::LYD_VALIDATE_PRESENT is implied because
+ * only the modules with changed data are validated.
+ * @param[out] val_diff Optional diff with any changes made by the validation.
+ * @return LY_SUCCESS on success.
+ * @return LY_ERR error on error.
+ */
+LIBYANG_API_DECL LY_ERR lyd_validate_diff(struct lyd_node **tree, const struct lyd_node *diff, uint32_t val_opts,
+        struct lyd_node **val_diff);
+
 /**
  * @brief Validate an RPC/action request, reply, or notification. Only the operation data tree (input/output/notif)
  * is validate, any parents are ignored.
@@ -446,6 +485,71 @@ LIBYANG_API_DECL LY_ERR lyd_validate_module(struct lyd_node **tree, const struct
 LIBYANG_API_DECL LY_ERR lyd_validate_op(struct lyd_node *op_tree, const struct lyd_node *dep_tree, enum lyd_type data_type,
         struct lyd_node **diff);
 
+/**
+ * @brief Kinds of validation constraints measured by validation statistics.
+ */
+enum lyd_val_stat_kind {
+    LYD_VAL_STAT_WHEN = 0,      /**< when condition evaluation */
+    LYD_VAL_STAT_MUST,          /**< must condition evaluation */
+    LYD_VAL_STAT_UNIQUE,        /**< unique check of a list */
+    LYD_VAL_STAT_LEAFREF,       /**< leafref resolution */
+    LYD_VAL_STAT_TYPE           /**< validate callback of any other type */
+};
+
+/**
+ * @brief Validation statistics of a single constraint.
+ */
+struct lyd_val_stat {
+    const struct lysc_node *schema; /**< schema node with the constraint */
+    enum lyd_val_stat_kind kind;    /**< kind of the constraint */
+    uint64_t count;                 /**< number of evaluations */
+    uint64_t time_ns;               /**< total time of the evaluations in nanoseconds */
+};
+
+/**
+ * @brief Start or stop collecting validation statistics in a context.
+ *
+ * When enabled, all the data validation, including the validation performed by the data parsers, measures
+ * every evaluation of when and must conditions, unique checks, leafref resolutions, and type validate callbacks
+ * (such as of instance-identifiers and unions) of the individual schema nodes. Enabling the statistics discards
+ * any previously collected ones and so does compiling any module in the context because the measured schema nodes
+ * may change. Every validation collects its statistics separately, also in every worker thread of a multi-threaded
+ * validation, and adds them to the statistics of the context when finished. Neither this function nor getting
+ * or printing the statistics must be called while any other thread is validating data in the context.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] enable Whether to start or stop collecting the statistics, stopping frees them.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_val_stats_enable(struct ly_ctx *ctx, ly_bool enable);
+
+/**
+ * @brief Get the collected validation statistics.
+ *
+ * @param[in] ctx Context with the statistics enabled by ::lyd_val_stats_enable().
+ * @param[out] stats Array of the statistics of all the measured constraints sorted by their total time,
+ * the most expensive first. It is NULL if there are none. Free it with free().
+ * @param[out] count Number of items in @p stats.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL if the statistics are not enabled.
+ * @return LY_ERR value on other errors.
+ */
+LIBYANG_API_DECL LY_ERR lyd_val_stats_get(const struct ly_ctx *ctx, struct lyd_val_stat **stats, uint32_t *count);
+
+/**
+ * @brief Print the collected validation statistics.
+ *
+ * The printed report has a line for every measured constraint with the number of its evaluations, their total
+ * time, the kind of the constraint, and the path of its schema node, sorted the same as by ::lyd_val_stats_get().
+ *
+ * @param[in] ctx Context with the statistics enabled by ::lyd_val_stats_enable().
+ * @param[out] report Printed statistics.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL if the statistics are not enabled.
+ * @return LY_ERR value on other errors.
+ */
+LIBYANG_API_DECL LY_ERR lyd_val_stats_print(const struct ly_ctx *ctx, char **report);
+
 /** @} datatree */
 
 #ifdef __cplusplus
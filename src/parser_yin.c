@@ -184,7 +184,7 @@ yin_match_keyword(struct lys_yin_parser_ctx *ctx, const char *name, size_t name_
         return LY_STMT_NONE;
     }
 
-    ns = lyxml_ns_get(&ctx->xmlctx->ns, prefix, prefix_len);
+    ns = lyxml_ns_scope_get(&ctx->xmlctx->ns_scope, prefix, prefix_len);
     if (ns) {
         if (!IS_YIN_NS(ns->uri)) {
             return LY_STMT_EXTENSION_INSTANCE;
@@ -3073,7 +3073,7 @@ yin_parse_element_generic(struct lys_yin_parser_ctx *ctx, enum ly_stmt parent, s
 
         /* store prefix data for the statement */
         LY_CHECK_GOTO(ret = ly_store_prefix_data(ctx->xmlctx->ctx, (*element)->stmt, strlen((*element)->stmt), LY_VALUE_XML,
-                &ctx->xmlctx->ns, &(*element)->format, &(*element)->prefix_data), cleanup);
+                &ctx->xmlctx->ns_scope.ns, &(*element)->format, &(*element)->prefix_data), cleanup);
     } else {
         LY_CHECK_GOTO(ret = lydict_insert(ctx->xmlctx->ctx, ctx->xmlctx->name, ctx->xmlctx->name_len, &(*element)->stmt), cleanup);
     }
@@ -3148,7 +3148,7 @@ yin_parse_element_generic(struct lys_yin_parser_ctx *ctx, enum ly_stmt parent, s
 
             /* store prefix data for the argument as well */
             LY_CHECK_GOTO(ret = ly_store_prefix_data(ctx->xmlctx->ctx, (*element)->arg, strlen((*element)->arg), LY_VALUE_XML,
-                    &ctx->xmlctx->ns, &(*element)->format, &(*element)->prefix_data), cleanup);
+                    &ctx->xmlctx->ns_scope.ns, &(*element)->format, &(*element)->prefix_data), cleanup);
         }
 
         /* read closing tag */
@@ -3197,7 +3197,7 @@ yin_parse_extension_instance(struct lys_yin_parser_ctx *ctx, enum ly_stmt subele
     LY_CHECK_RET(lydict_insert_zc(ctx->xmlctx->ctx, ext_name, &e->name));
 
     /* store prefix data for the name */
-    LY_CHECK_RET(ly_store_prefix_data(ctx->xmlctx->ctx, e->name, strlen(e->name), LY_VALUE_XML, &ctx->xmlctx->ns,
+    LY_CHECK_RET(ly_store_prefix_data(ctx->xmlctx->ctx, e->name, strlen(e->name), LY_VALUE_XML, &ctx->xmlctx->ns_scope.ns,
             &e->format, &e->prefix_data));
 
     e->parent_stmt = subelem;
@@ -3254,7 +3254,7 @@ yin_parse_extension_instance(struct lys_yin_parser_ctx *ctx, enum ly_stmt subele
 
         /* store prefix data for the argument as well */
         LY_CHECK_RET(ly_store_prefix_data(ctx->xmlctx->ctx, e->argument, strlen(e->argument), LY_VALUE_XML,
-                &ctx->xmlctx->ns, &e->format, &e->prefix_data));
+                &ctx->xmlctx->ns_scope.ns, &e->format, &e->prefix_data));
 
         /* parser next */
         LY_CHECK_RET(lyxml_ctx_next(ctx->xmlctx));
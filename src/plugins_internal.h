@@ -72,4 +72,26 @@ void lyplg_clean(void);
  */
 void *lyplg_find(enum LYPLG type, const char *module, const char *revision, const char *name);
 
+/**
+ * @brief Cache of leafref targets, see ::lyplg_type_leafref_cache_start().
+ */
+struct lyplg_lref_cache;
+
+/**
+ * @brief Start caching the leafref targets found by ::lyplg_type_resolve_leafref() in this thread.
+ *
+ * The targets of a leafref path that selects the same nodes for all the leafref instances are found only once
+ * and hashed by their value. No data tree may be modified until ::lyplg_type_leafref_cache_stop() is called.
+ *
+ * @return Previous cache of the thread to restore, caches can be nested.
+ */
+struct lyplg_lref_cache *lyplg_type_leafref_cache_start(void);
+
+/**
+ * @brief Stop caching leafref targets, free the cache of the thread, and restore the previous one.
+ *
+ * @param[in] prev Previous cache returned by ::lyplg_type_leafref_cache_start().
+ */
+void lyplg_type_leafref_cache_stop(struct lyplg_lref_cache *prev);
+
 #endif /* LY_PLUGINS_INTERNAL_H_ */
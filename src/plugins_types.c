@@ -27,7 +27,9 @@
 #include "compat.h"
 #include "context.h"
 #include "dict.h"
+#include "hash_table.h"
 #include "path.h"
+#include "plugins_internal.h"
 #include "schema_compile.h"
 #include "set.h"
 #include "tree.h"
@@ -849,19 +851,324 @@ lyplg_type_make_implemented(struct lys_module *mod, const char **features, struc
 LIBYANG_API_DEF LY_ERR
 lyplg_type_identity_isderived(const struct lysc_ident *base, const struct lysc_ident *der)
 {
-    LY_ARRAY_COUNT_TYPE u;
-
     assert(base->module->ctx == der->module->ctx);
 
-    LY_ARRAY_FOR(base->derived, u) {
-        if (der == base->derived[u]) {
-            return LY_SUCCESS;
+    /* the derivation closure is precomputed */
+    if ((base->index / 32 < LY_ARRAY_COUNT(der->bases_closure)) &&
+            (der->bases_closure[base->index / 32] & (1U << (base->index % 32)))) {
+        return LY_SUCCESS;
+    }
+    return LY_ENOTFOUND;
+}
+
+/**
+ * @brief Try to find a leafref target instance using an index of the target leaf.
+ *
+ * Possible only for simple paths without predicates that target an indexed list leaf. The path without the list
+ * and the leaf is evaluated and the list instances are found using the index of the resulting nodes.
+ *
+ * @param[in] lref Leafref type.
+ * @param[in] node Context node.
+ * @param[in] value Target value.
+ * @param[in] tree Full data tree.
+ * @param[out] target Found target instance.
+ * @return LY_SUCCESS if the target was found.
+ * @return LY_ENOT if the index cannot be used or the target was not found.
+ * @return LY_ERR value on error.
+ */
+static LY_ERR
+lyplg_type_resolve_leafref_index(const struct lysc_type_leafref *lref, const struct lyd_node *node,
+        const struct lyd_value *value, const struct lyd_node *tree, struct lyd_node **target)
+{
+    LY_ERR ret = LY_ENOT;
+    const struct lyxp_expr *exp = lref->path;
+    struct lyxp_set set = {0};
+    struct ly_set found = {0};
+    const struct lysc_node *schema;
+    const struct lys_module *mod;
+    struct lyd_node *leaf = NULL;
+    const char *name, *ptr;
+    size_t name_len;
+    uint32_t i;
+
+    /* "<parent-path>/list/leaf", parsed parent path prepared during compilation */
+    if (!lref->parent_path) {
+        return LY_ENOT;
+    }
+
+    /* learn the target schema node, the path must be simple */
+    schema = (exp->tokens[0] == LYXP_TOKEN_OPER_PATH) ? NULL : node->schema;
+    for (i = 0; i < exp->used; ++i) {
+        switch (exp->tokens[i]) {
+        case LYXP_TOKEN_OPER_PATH:
+        case LYXP_TOKEN_DOT:
+            break;
+        case LYXP_TOKEN_DDOT:
+            if (!schema) {
+                return LY_ENOT;
+            }
+            schema = lysc_data_parent(schema);
+            break;
+        case LYXP_TOKEN_NAMETEST:
+            name = &exp->expr[exp->tok_pos[i]];
+            name_len = exp->tok_len[i];
+            if ((ptr = ly_strnchr(name, ':', name_len))) {
+                mod = ly_resolve_prefix(LYD_CTX(node), name, ptr - name, LY_VALUE_SCHEMA_RESOLVED, lref->prefixes);
+                name_len -= ptr - name + 1;
+                name = ptr + 1;
+            } else {
+                mod = node->schema->module;
+            }
+            schema = mod ? lys_find_child(schema, mod, name, name_len, 0, 0) : NULL;
+            if (!schema) {
+                return LY_ENOT;
+            }
+            break;
+        default:
+            /* predicates, functions, ... */
+            return LY_ENOT;
+        }
+    }
+    if (!(schema->flags & LYS_INDEXED) || (schema->nodetype != LYS_LEAF)) {
+        return LY_ENOT;
+    }
+
+    /* evaluate the path to the list parents */
+    LY_CHECK_GOTO(ret = lyxp_eval(LYD_CTX(node), lref->parent_path, node->schema->module, LY_VALUE_SCHEMA_RESOLVED,
+            lref->prefixes, node, tree, NULL, &set, LYXP_IGNORE_WHEN), cleanup);
+    if (set.type != LYXP_SET_NODE_SET) {
+        ret = LY_ENOT;
+        goto cleanup;
+    }
+
+    /* find the target instance using the index of each parent */
+    LY_CHECK_GOTO(ret = lyd_create_term2(schema, value, &leaf), cleanup);
+    ret = LY_ENOT;
+    for (i = 0; i < set.used; ++i) {
+        if (set.val.nodes[i].type != LYXP_NODE_ELEM) {
+            continue;
+        }
+
+        if (!lyd_find_index(lyd_child(set.val.nodes[i].node), leaf, 1, &found)) {
+            lyd_find_sibling_val(lyd_child(found.dnodes[0]), schema, NULL, 0, target);
+            ret = LY_SUCCESS;
+            break;
         }
-        if (!lyplg_type_identity_isderived(base->derived[u], der)) {
-            return LY_SUCCESS;
+    }
+
+cleanup:
+    lyxp_set_free_content(&set);
+    ly_set_erase(&found, NULL);
+    lyd_free_tree(leaf);
+    return ret;
+}
+
+/**
+ * @brief Leafref target instance hashed by its value.
+ */
+struct lyplg_lref_rec {
+    const char *value;          /**< canonical value of the target */
+    struct lyd_node *node;      /**< target instance */
+};
+
+/**
+ * @brief All the targets of a leafref path that selects the same nodes for all the leafref instances.
+ */
+struct lyplg_lref_map {
+    const struct lyxp_expr *path;       /**< leafref path */
+    const struct lys_module *cur_mod;   /**< current module of the path evaluation */
+    const struct lyd_node *tree;        /**< first top-level sibling of the data tree the path was evaluated on */
+    uint32_t count;                     /**< number of the nodes selected by the path */
+    struct hash_table *ht;              /**< hash table of the targets (struct lyplg_lref_rec) */
+};
+
+struct lyplg_lref_cache {
+    struct ly_set maps;                 /**< set of the cached paths (struct lyplg_lref_map *) */
+};
+
+/**
+ * @brief Leafref target cache of the thread, used only if set.
+ */
+static THREAD_LOCAL struct lyplg_lref_cache *lref_cache;
+
+struct lyplg_lref_cache *
+lyplg_type_leafref_cache_start(void)
+{
+    struct lyplg_lref_cache *prev = lref_cache;
+
+    /* no caching if the allocation fails */
+    lref_cache = calloc(1, sizeof *lref_cache);
+    return prev;
+}
+
+void
+lyplg_type_leafref_cache_stop(struct lyplg_lref_cache *prev)
+{
+    struct lyplg_lref_map *map;
+    uint32_t i;
+
+    if (lref_cache) {
+        for (i = 0; i < lref_cache->maps.count; ++i) {
+            map = lref_cache->maps.objs[i];
+            lyht_free(map->ht);
+            free(map);
         }
+        ly_set_erase(&lref_cache->maps, NULL);
+        free(lref_cache);
     }
-    return LY_ENOTFOUND;
+    lref_cache = prev;
+}
+
+/**
+ * @brief Hash table value equal callback for leafref targets.
+ */
+static ly_bool
+lyplg_lref_rec_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyplg_lref_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return !strcmp(rec1->value, rec2->value);
+}
+
+/**
+ * @brief Check whether a leafref path selects the same nodes regardless of the leafref instance.
+ *
+ * It is so for simple absolute paths and relative paths that first go up to the root.
+ *
+ * @param[in] lref Leafref type.
+ * @param[in] node Leafref instance.
+ * @return Whether the path is independent of @p node.
+ */
+static ly_bool
+lyplg_type_leafref_path_is_static(const struct lysc_type_leafref *lref, const struct lyd_node *node)
+{
+    const struct lyxp_expr *exp = lref->path;
+    const struct lyd_node *parent = node;
+    ly_bool root;
+    uint32_t i;
+
+    if (node->schema->flags & (LYS_IS_INPUT | LYS_IS_OUTPUT | LYS_IS_NOTIF)) {
+        /* the accessible nodes depend on the operation */
+        return 0;
+    }
+
+    root = (exp->tokens[0] == LYXP_TOKEN_OPER_PATH) ? 1 : 0;
+    for (i = 0; i < exp->used; ++i) {
+        switch (exp->tokens[i]) {
+        case LYXP_TOKEN_OPER_PATH:
+        case LYXP_TOKEN_DOT:
+            break;
+        case LYXP_TOKEN_DDOT:
+            if (root) {
+                return 0;
+            }
+            parent = lyd_parent(parent);
+            if (!parent) {
+                root = 1;
+            }
+            break;
+        case LYXP_TOKEN_NAMETEST:
+            if (!root) {
+                /* relative to the leafref instance */
+                return 0;
+            }
+            break;
+        default:
+            /* predicates, functions, ... */
+            return 0;
+        }
+    }
+
+    return root;
+}
+
+/**
+ * @brief Find a leafref target instance in the cached targets of its path.
+ *
+ * All the targets are found and hashed when the path is used for the first time on a data tree.
+ *
+ * @param[in] lref Leafref type with a path that satisfies ::lyplg_type_leafref_path_is_static().
+ * @param[in] node Context node.
+ * @param[in] value Target value.
+ * @param[in] tree Full data tree.
+ * @param[out] target Found target instance.
+ * @param[out] count Number of the nodes selected by the path.
+ * @return LY_SUCCESS if the target was found.
+ * @return LY_ENOTFOUND if there is no such target.
+ * @return LY_ERR value on error.
+ */
+static LY_ERR
+lyplg_type_resolve_leafref_cache(const struct lysc_type_leafref *lref, const struct lyd_node *node,
+        const struct lyd_value *value, const struct lyd_node *tree, struct lyd_node **target, uint32_t *count)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyplg_lref_map *map = NULL;
+    struct lyplg_lref_rec rec, *match;
+    struct lyxp_set set = {0};
+    uint32_t i;
+
+    /* the data tree is identified by its first top-level sibling */
+    if (tree) {
+        while (tree->parent) {
+            tree = lyd_parent(tree);
+        }
+        tree = lyd_first_sibling(tree);
+    }
+
+    for (i = 0; i < lref_cache->maps.count; ++i) {
+        map = lref_cache->maps.objs[i];
+        if ((map->path == lref->path) && (map->cur_mod == node->schema->module) && (map->tree == tree)) {
+            break;
+        }
+    }
+    if (i == lref_cache->maps.count) {
+        /* find all the targets */
+        map = NULL;
+        ret = lyxp_eval(LYD_CTX(node), lref->path, node->schema->module, LY_VALUE_SCHEMA_RESOLVED, lref->prefixes,
+                node, tree, NULL, &set, LYXP_IGNORE_WHEN);
+        LY_CHECK_GOTO(ret, cleanup);
+
+        /* hash them, the first instance of each value is the target */
+        map = calloc(1, sizeof *map);
+        LY_CHECK_ERR_GOTO(!map, LOGMEM(LYD_CTX(node)); ret = LY_EMEM, cleanup);
+        map->path = lref->path;
+        map->cur_mod = node->schema->module;
+        map->tree = tree;
+        map->count = set.used;
+        map->ht = lyht_new(LYHT_MIN_SIZE, sizeof rec, lyplg_lref_rec_equal_cb, NULL, 1);
+        LY_CHECK_ERR_GOTO(!map->ht, LOGMEM(LYD_CTX(node)); ret = LY_EMEM, cleanup);
+        for (i = 0; i < set.used; ++i) {
+            if ((set.val.nodes[i].type != LYXP_NODE_ELEM) || !(set.val.nodes[i].node->schema->nodetype & LYD_NODE_TERM)) {
+                continue;
+            }
+
+            rec.value = lyd_get_value(set.val.nodes[i].node);
+            rec.node = set.val.nodes[i].node;
+            ret = lyht_insert(map->ht, &rec, dict_hash(rec.value, strlen(rec.value)), NULL);
+            LY_CHECK_ERR_GOTO(ret && (ret != LY_EEXIST), LOGMEM(LYD_CTX(node)), cleanup);
+            ret = LY_SUCCESS;
+        }
+
+        LY_CHECK_GOTO(ret = ly_set_add(&lref_cache->maps, map, 1, NULL), cleanup);
+        lyxp_set_free_content(&set);
+    }
+
+    /* find the target */
+    *count = map->count;
+    rec.value = lyd_value_get_canonical(LYD_CTX(node), value);
+    if (lyht_find(map->ht, &rec, dict_hash(rec.value, strlen(rec.value)), (void **)&match)) {
+        return LY_ENOTFOUND;
+    }
+    *target = match->node;
+    return LY_SUCCESS;
+
+cleanup:
+    lyxp_set_free_content(&set);
+    if (map) {
+        lyht_free(map->ht);
+        free(map);
+    }
+    return ret;
 }
 
 LIBYANG_API_DEF LY_ERR
@@ -870,33 +1177,37 @@ lyplg_type_resolve_leafref(const struct lysc_type_leafref *lref, const struct ly
 {
     LY_ERR ret;
     struct lyxp_set set = {0};
+    struct lyd_node *t = NULL;
     const char *val_str, *xp_err_msg;
-    uint32_t i;
+    uint32_t i, count;
     int rc;
 
     LY_CHECK_ARG_RET(NULL, lref, node, value, errmsg, LY_EINVAL);
 
+    if (lref_cache && (lref->realtype->basetype != LY_TYPE_UNION) && lyplg_type_leafref_path_is_static(lref, node)) {
+        /* use the cached targets, union values of the targets may still change */
+        ret = lyplg_type_resolve_leafref_cache(lref, node, value, tree, &t, &count);
+        if (ret == LY_ENOTFOUND) {
+            goto not_found;
+        } else if (ret) {
+            goto eval_error;
+        }
+        goto found;
+    }
+
+    /* try to find the target using an index */
+    ret = lyplg_type_resolve_leafref_index(lref, node, value, tree, &t);
+    if (!ret) {
+        goto found;
+    } else if (ret != LY_ENOT) {
+        return ret;
+    }
+
     /* find all target data instances */
     ret = lyxp_eval(LYD_CTX(node), lref->path, node->schema->module, LY_VALUE_SCHEMA_RESOLVED, lref->prefixes,
             node, tree, NULL, &set, LYXP_IGNORE_WHEN);
     if (ret) {
-        if (ly_errcode(LYD_CTX(node)) == ret) {
-            xp_err_msg = ly_errmsg(LYD_CTX(node));
-        } else {
-            xp_err_msg = NULL;
-        }
-
-        val_str = lref->plugin->print(LYD_CTX(node), value, LY_VALUE_CANON, NULL, NULL, NULL);
-        if (xp_err_msg) {
-            rc = asprintf(errmsg, "Invalid leafref value \"%s\" - XPath evaluation error (%s).", val_str, xp_err_msg);
-        } else {
-            rc = asprintf(errmsg, "Invalid leafref value \"%s\" - XPath evaluation error.", val_str);
-        }
-        if (rc == -1) {
-            *errmsg = NULL;
-            ret = LY_EMEM;
-        }
-        goto error;
+        goto eval_error;
     }
 
     /* check whether any matches */
@@ -910,27 +1221,51 @@ lyplg_type_resolve_leafref(const struct lysc_type_leafref *lref, const struct ly
         }
     }
     if (i == set.used) {
-        ret = LY_ENOTFOUND;
-        val_str = lref->plugin->print(LYD_CTX(node), value, LY_VALUE_CANON, NULL, NULL, NULL);
-        if (set.used) {
-            rc = asprintf(errmsg, LY_ERRMSG_NOLREF_VAL, val_str, lref->path->expr);
-        } else {
-            rc = asprintf(errmsg, LY_ERRMSG_NOLREF_INST, val_str, lref->path->expr);
-        }
-        if (rc == -1) {
-            *errmsg = NULL;
-            ret = LY_EMEM;
-        }
-        goto error;
+        count = set.used;
+        goto not_found;
     }
+    t = set.val.nodes[i].node;
 
+found:
     if (target) {
-        *target = set.val.nodes[i].node;
+        *target = t;
     }
 
     lyxp_set_free_content(&set);
     return LY_SUCCESS;
 
+eval_error:
+    if (ly_errcode(LYD_CTX(node)) == ret) {
+        xp_err_msg = ly_errmsg(LYD_CTX(node));
+    } else {
+        xp_err_msg = NULL;
+    }
+
+    val_str = lref->plugin->print(LYD_CTX(node), value, LY_VALUE_CANON, NULL, NULL, NULL);
+    if (xp_err_msg) {
+        rc = asprintf(errmsg, "Invalid leafref value \"%s\" - XPath evaluation error (%s).", val_str, xp_err_msg);
+    } else {
+        rc = asprintf(errmsg, "Invalid leafref value \"%s\" - XPath evaluation error.", val_str);
+    }
+    if (rc == -1) {
+        *errmsg = NULL;
+        ret = LY_EMEM;
+    }
+    goto error;
+
+not_found:
+    ret = LY_ENOTFOUND;
+    val_str = lref->plugin->print(LYD_CTX(node), value, LY_VALUE_CANON, NULL, NULL, NULL);
+    if (count) {
+        rc = asprintf(errmsg, LY_ERRMSG_NOLREF_VAL, val_str, lref->path->expr);
+    } else {
+        rc = asprintf(errmsg, LY_ERRMSG_NOLREF_INST, val_str, lref->path->expr);
+    }
+    if (rc == -1) {
+        *errmsg = NULL;
+        ret = LY_EMEM;
+    }
+
 error:
     lyxp_set_free_content(&set);
     return ret;
@@ -85,6 +85,36 @@ lyd_print_tree(struct ly_out *out, const struct lyd_node *root, LYD_FORMAT forma
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Write callback for ::lyd_print_size() only counting the bytes.
+ *
+ * @param[in] user_data Pointer to the size_t counter.
+ * @param[in] buf Printed data, not used.
+ * @param[in] count Number of printed bytes.
+ * @return Number of "printed" bytes.
+ */
+static ssize_t
+lyd_print_size_clb(void *user_data, const void *UNUSED(buf), size_t count)
+{
+    *(size_t *)user_data += count;
+    return count;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_print_size(const struct lyd_node *root, LYD_FORMAT format, uint32_t options, size_t *size)
+{
+    LY_ERR ret;
+    struct ly_out *out;
+
+    LY_CHECK_ARG_RET(NULL, size, LY_EINVAL);
+
+    *size = 0;
+    LY_CHECK_RET(ly_out_new_clb(lyd_print_size_clb, size, &out));
+    ret = lyd_print_(out, root, format, options);
+    ly_out_free(out, NULL, 0);
+    return ret;
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_print_mem(char **strp, const struct lyd_node *root, LYD_FORMAT format, uint32_t options)
 {
@@ -55,6 +55,8 @@ struct ly_out;
  * accept ::LYD_PRINT_WITHSIBLINGS [printer option](@ref dataprinterflags)) since this flag differentiate the functions
  * themselves.
  *
+ * The exact size of the printed data can be learned in advance, without printing anything, by ::lyd_print_size().
+ *
  * Functions List
  * --------------
  * - ::lyd_print_all()
@@ -64,6 +66,7 @@ struct ly_out;
  * - ::lyd_print_file()
  * - ::lyd_print_path()
  * - ::lyd_print_clb()
+ * - ::lyd_print_size()
  */
 
 /**
@@ -179,6 +182,21 @@ LIBYANG_API_DECL LY_ERR lyd_print_path(const char *path, const struct lyd_node *
 LIBYANG_API_DECL LY_ERR lyd_print_clb(ly_write_clb writeclb, void *user_data, const struct lyd_node *root,
         LYD_FORMAT format, uint32_t options);
 
+/**
+ * @brief Learn the exact size of the data tree printed in the specified format without printing it.
+ *
+ * The size can be used to allocate the whole buffer at once and print the data into it using
+ * ::ly_out_new_memory() (the buffer must be 1 byte larger for the terminating zero) or to prepare
+ * a frame of the correct size for sending the data.
+ *
+ * @param[in] root The root element of the (sub)tree to print.
+ * @param[in] format Output format.
+ * @param[in] options [Data printer flags](@ref dataprinterflags).
+ * @param[out] size Number of bytes the printed data would consist of, without any terminating zero.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_print_size(const struct lyd_node *root, LYD_FORMAT format, uint32_t options, size_t *size);
+
 /**
  * @brief Check whether the node should be printed based on the printing options.
  *
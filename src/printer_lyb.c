@@ -127,6 +127,7 @@ lyb_hash_siblings(struct lysc_node *sibling, struct hash_table **ht_p)
     const struct lys_module *mod;
     LYB_HASH i;
     uint32_t getnext_opts;
+    LY_ARRAY_COUNT_TYPE idx = 0;
 
     ht = lyht_new(1, sizeof(struct lysc_node *), lyb_hash_equal_cb, NULL, 1);
     LY_CHECK_ERR_RET(!ht, LOGMEM(sibling->module->ctx), LY_EMEM);
@@ -140,7 +141,7 @@ lyb_hash_siblings(struct lysc_node *sibling, struct hash_table **ht_p)
     mod = sibling->module;
 
     sibling = NULL;
-    while ((sibling = (struct lysc_node *)lys_getnext(sibling, parent, mod->compiled, getnext_opts))) {
+    while ((sibling = (struct lysc_node *)lys_getnext_idx(sibling, parent, mod->compiled, getnext_opts, &idx))) {
         /* find the first non-colliding hash (or specifically non-colliding hash sequence) */
         for (i = 0; i < LYB_HASH_BITS; ++i) {
             /* check that we are not colliding with nodes inserted with a lower collision ID than ours */
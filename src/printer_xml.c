@@ -42,8 +42,7 @@ struct xmlpr_ctx {
     uint16_t level;           /**< current indentation level: 0 - no formatting, >= 1 indentation levels */
     uint32_t options;         /**< [Data printer flags](@ref dataprinterflags) */
     const struct ly_ctx *ctx; /**< libyang context */
-    struct ly_set prefix;     /**< printed namespace prefixes */
-    struct ly_set ns;         /**< printed namespaces */
+    struct lyxml_ns_scope ns; /**< printed namespaces */
 };
 
 #define LYXML_PREFIX_REQUIRED 0x01  /**< The prefix is not just a suggestion but a requirement. */
@@ -54,38 +53,28 @@ struct xmlpr_ctx {
  *
  * @param[in] ctx XML printer context.
  * @param[in] ns Namespace to print, expected to be in dictionary.
- * @param[in] new_prefix Suggested new prefix, NULL for a default namespace without prefix. Stored in the dictionary.
+ * @param[in] new_prefix Suggested new prefix, NULL for a default namespace without prefix.
  * @param[in] prefix_opts Prefix options changing the meaning of parameters.
  * @return Printed prefix of the namespace to use.
  */
 static const char *
 xml_print_ns(struct xmlpr_ctx *pctx, const char *ns, const char *new_prefix, uint32_t prefix_opts)
 {
-    uint32_t i;
-
-    for (i = pctx->ns.count; i > 0; --i) {
-        if (!new_prefix) {
-            /* find default namespace */
-            if (!pctx->prefix.objs[i - 1]) {
-                if (!strcmp(pctx->ns.objs[i - 1], ns)) {
-                    /* matching default namespace */
-                    return pctx->prefix.objs[i - 1];
-                }
-                /* not matching default namespace */
-                break;
-            }
-        } else {
-            /* find prefixed namespace */
-            if (!strcmp(pctx->ns.objs[i - 1], ns)) {
-                if (!pctx->prefix.objs[i - 1]) {
-                    /* default namespace is not interesting */
-                    continue;
-                }
-
-                if (!strcmp(pctx->prefix.objs[i - 1], new_prefix) || !(prefix_opts & LYXML_PREFIX_REQUIRED)) {
-                    /* the same prefix or can be any */
-                    return pctx->prefix.objs[i - 1];
-                }
+    const struct lyxml_ns *rec;
+
+    if (!new_prefix) {
+        /* find default namespace */
+        rec = lyxml_ns_scope_get(&pctx->ns, NULL, 0);
+        if (rec && !strcmp(rec->uri, ns)) {
+            /* matching default namespace */
+            return rec->prefix;
+        }
+    } else {
+        /* find prefixed namespace, default namespace is not interesting */
+        for (rec = lyxml_ns_scope_get_uri(&pctx->ns, ns); rec; rec = rec->prev_uri) {
+            if (!strcmp(rec->prefix, new_prefix) || !(prefix_opts & LYXML_PREFIX_REQUIRED)) {
+                /* the same prefix or can be any */
+                return rec->prefix;
             }
         }
     }
@@ -94,14 +83,12 @@ xml_print_ns(struct xmlpr_ctx *pctx, const char *ns, const char *new_prefix, uin
     ly_print_(pctx->out, " xmlns%s%s=\"%s\"", new_prefix ? ":" : "", new_prefix ? new_prefix : "", ns);
 
     /* and added into namespaces */
-    if (new_prefix) {
-        LY_CHECK_RET(lydict_insert(pctx->ctx, new_prefix, 0, &new_prefix), NULL);
-    }
-    LY_CHECK_RET(ly_set_add(&pctx->prefix, (void *)new_prefix, 1, NULL), NULL);
-    LY_CHECK_RET(ly_set_add(&pctx->ns, (void *)ns, 1, &i), NULL);
+    LY_CHECK_RET(lyxml_ns_scope_push(pctx->ctx, &pctx->ns, new_prefix, new_prefix ? strlen(new_prefix) : 0, ns,
+            strlen(ns), NULL, 0), NULL);
 
     /* return it */
-    return pctx->prefix.objs[i];
+    rec = pctx->ns.ns.objs[pctx->ns.ns.count - 1];
+    return rec->prefix;
 }
 
 static const char *
@@ -520,7 +507,7 @@ xml_print_node(struct xmlpr_ctx *pctx, const struct lyd_node *node)
     }
 
     /* remember namespace definition count on this level */
-    ns_count = pctx->ns.count;
+    ns_count = pctx->ns.ns.count;
 
     if (!node->schema) {
         ret = xml_print_opaq(pctx, (const struct lyd_node_opaq *)node);
@@ -549,10 +536,8 @@ xml_print_node(struct xmlpr_ctx *pctx, const struct lyd_node *node)
     }
 
     /* remove all added namespaces */
-    while (ns_count < pctx->ns.count) {
-        lydict_remove(pctx->ctx, pctx->prefix.objs[pctx->prefix.count - 1]);
-        ly_set_rm_index(&pctx->prefix, pctx->prefix.count - 1, NULL);
-        ly_set_rm_index(&pctx->ns, pctx->ns.count - 1, NULL);
+    while (ns_count < pctx->ns.ns.count) {
+        lyxml_ns_scope_pop(pctx->ctx, &pctx->ns);
     }
 
     return ret;
@@ -585,9 +570,8 @@ xml_print_data(struct ly_out *out, const struct lyd_node *root, uint32_t options
     }
 
 finish:
-    assert(!pctx.prefix.count && !pctx.ns.count);
-    ly_set_erase(&pctx.prefix, NULL);
-    ly_set_erase(&pctx.ns, NULL);
+    assert(!pctx.ns.ns.count);
+    lyxml_ns_scope_erase(pctx.ctx, &pctx.ns);
     ly_print_flush(out);
     return LY_SUCCESS;
 }
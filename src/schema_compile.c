@@ -45,6 +45,7 @@
 #include "tree_data.h"
 #include "tree_schema.h"
 #include "tree_schema_internal.h"
+#include "validation.h"
 #include "xpath.h"
 
 /**
@@ -316,6 +317,7 @@ lys_identity_precompile(struct lysc_ctx *ctx_sc, struct ly_ctx *ctx, struct lysp
         DUP_STRING_GOTO(ctx_sc->ctx, identities_p[u].dsc, ident->dsc, ret, done);
         DUP_STRING_GOTO(ctx_sc->ctx, identities_p[u].ref, ident->ref, ret, done);
         ident->module = ctx_sc->cur_mod;
+        ident->index = ctx_sc->ctx->ident_count++;
         /* backlinks (derived) can be added no sooner than when all the identities in the current module are present */
         COMPILE_EXTS_GOTO(ctx_sc, identities_p[u].exts, ident->exts, ident, ret, done);
         ident->flags = identities_p[u].flags;
@@ -385,6 +387,78 @@ cleanup:
     return ret;
 }
 
+/**
+ * @brief Add a base identity and all its bases into the derivation closure of an identity.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in,out] ident Identity to update.
+ * @param[in] base Base identity of @p ident.
+ * @param[out] changed Whether the closure of @p ident was changed.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lys_compile_identity_closure_add(const struct ly_ctx *ctx, struct lysc_ident *ident, const struct lysc_ident *base,
+        ly_bool *changed)
+{
+    LY_ARRAY_COUNT_TYPE u, count;
+    uint32_t word;
+
+    /* make sure the bitset is large enough */
+    count = LY_ARRAY_COUNT(base->bases_closure);
+    if (count < base->index / 32 + 1) {
+        count = base->index / 32 + 1;
+    }
+    if (LY_ARRAY_COUNT(ident->bases_closure) < count) {
+        u = LY_ARRAY_COUNT(ident->bases_closure);
+        LY_ARRAY_CREATE_RET(ctx, ident->bases_closure, count - u, LY_EMEM);
+        for ( ; u < count; ++u) {
+            ident->bases_closure[u] = 0;
+            LY_ARRAY_INCREMENT(ident->bases_closure);
+        }
+    }
+
+    /* the base itself */
+    *changed = 0;
+    if (!(ident->bases_closure[base->index / 32] & (1U << (base->index % 32)))) {
+        ident->bases_closure[base->index / 32] |= 1U << (base->index % 32);
+        *changed = 1;
+    }
+
+    /* all its bases */
+    LY_ARRAY_FOR(base->bases_closure, u) {
+        word = ident->bases_closure[u] | base->bases_closure[u];
+        if (word != ident->bases_closure[u]) {
+            ident->bases_closure[u] = word;
+            *changed = 1;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Propagate the derivation closure of an identity to all the identities derived from it.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in] base Identity with an updated closure.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lys_compile_identity_closure_propagate(const struct ly_ctx *ctx, const struct lysc_ident *base)
+{
+    LY_ARRAY_COUNT_TYPE u;
+    ly_bool changed;
+
+    LY_ARRAY_FOR(base->derived, u) {
+        LY_CHECK_RET(lys_compile_identity_closure_add(ctx, base->derived[u], base, &changed));
+        if (changed) {
+            LY_CHECK_RET(lys_compile_identity_closure_propagate(ctx, base->derived[u]));
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
 LY_ERR
 lys_compile_identity_bases(struct lysc_ctx *ctx, const struct lysp_module *base_pmod, const char **bases_p,
         struct lysc_ident *ident, struct lysc_ident ***bases)
@@ -393,6 +467,7 @@ lys_compile_identity_bases(struct lysc_ctx *ctx, const struct lysp_module *base_
     const char *s, *name;
     const struct lys_module *mod;
     struct lysc_ident **idref;
+    ly_bool changed;
 
     assert(ident || bases);
 
@@ -436,6 +511,12 @@ lys_compile_identity_bases(struct lysc_ctx *ctx, const struct lysp_module *base_
                     /* we have match! store the backlink */
                     LY_ARRAY_NEW_RET(ctx->ctx, mod->identities[v].derived, idref, LY_EMEM);
                     *idref = ident;
+
+                    /* update the derivation closure of the identity and of all the identities derived from it */
+                    LY_CHECK_RET(lys_compile_identity_closure_add(ctx->ctx, ident, &mod->identities[v], &changed));
+                    if (changed) {
+                        LY_CHECK_RET(lys_compile_identity_closure_propagate(ctx->ctx, ident));
+                    }
                 } else {
                     /* we have match! store the found identity */
                     LY_ARRAY_NEW_RET(ctx->ctx, *bases, idref, LY_EMEM);
@@ -1625,9 +1706,12 @@ lys_compile_depset_r(struct ly_ctx *ctx, struct ly_set *dep_set, struct lys_glob
         goto cleanup;
     }
 
-    /* success, unset the flags of all the modules in the dep set */
+    /* success, create the children indexes and unset the flags of all the modules in the dep set */
     for (i = 0; i < dep_set->count; ++i) {
         mod = dep_set->objs[i];
+        if (mod->to_compile && mod->compiled) {
+            LY_CHECK_GOTO(ret = lysc_module_children_index_create(mod->compiled), cleanup);
+        }
         mod->to_compile = 0;
     }
 
@@ -1791,6 +1875,8 @@ lys_compile(struct lys_module *mod, struct lys_depset_unres *unres)
     ctx.unres = unres;
 
     ++mod->ctx->change_count;
+    lyd_val_incr_graph_free(mod->ctx);
+    lyd_val_stats_clear(mod->ctx);
     mod->compiled = mod_c = calloc(1, sizeof *mod_c);
     LY_CHECK_ERR_RET(!mod_c, LOGMEM(mod->ctx), LY_EMEM);
     mod_c->mod = mod;
@@ -1545,6 +1545,29 @@ done:
     return ret;
 }
 
+/**
+ * @brief Parse the parent path of a simple leafref path ("<parent-path>/list/leaf") so that it does not need to be
+ * parsed for every instance when looking up its target by an index.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] lref Leafref type with the path set.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lys_compile_type_leafref_parent_path(struct ly_ctx *ctx, struct lysc_type_leafref *lref)
+{
+    const struct lyxp_expr *exp = lref->path;
+
+    if ((exp->used < 5) || (exp->tokens[exp->used - 1] != LYXP_TOKEN_NAMETEST) ||
+            (exp->tokens[exp->used - 2] != LYXP_TOKEN_OPER_PATH) || (exp->tokens[exp->used - 3] != LYXP_TOKEN_NAMETEST) ||
+            (exp->tokens[exp->used - 4] != LYXP_TOKEN_OPER_PATH)) {
+        /* not usable */
+        return LY_SUCCESS;
+    }
+
+    return lyxp_expr_parse(ctx, exp->expr, exp->tok_pos[exp->used - 4], 1, &lref->parent_path);
+}
+
 static LY_ERR
 lys_compile_type_union(struct lysc_ctx *ctx, struct lysp_type *ptypes, struct lysp_node *context_pnode, uint16_t context_flags,
         const char *context_name, struct lysc_type ***utypes_p)
@@ -1577,6 +1600,9 @@ lys_compile_type_union(struct lysc_ctx *ctx, struct lysp_type *ptypes, struct ly
                     lref->basetype = LY_TYPE_LEAFREF;
                     ret = lyxp_expr_dup(ctx->ctx, ((struct lysc_type_leafref *)un_aux->types[v])->path, &lref->path);
                     LY_CHECK_GOTO(ret, error);
+                    ret = lyxp_expr_dup(ctx->ctx, ((struct lysc_type_leafref *)un_aux->types[v])->parent_path,
+                            &lref->parent_path);
+                    LY_CHECK_GOTO(ret, error);
                     lref->refcount = 1;
                     lref->require_instance = ((struct lysc_type_leafref *)un_aux->types[v])->require_instance;
                     ret = lyplg_type_prefix_data_dup(ctx->ctx, LY_VALUE_SCHEMA_RESOLVED,
@@ -1842,6 +1868,7 @@ lys_compile_type_(struct lysc_ctx *ctx, struct lysp_node *context_pnode, uint16_
             LOGVAL(ctx->ctx, LY_VCODE_MISSCHILDSTMT, "path", "leafref type", "");
             return LY_EVALID;
         }
+        LY_CHECK_RET(lys_compile_type_leafref_parent_path(ctx->ctx, lref));
         break;
     case LY_TYPE_INST:
         /* RFC 7950 9.9.3 - require-instance */
@@ -46,11 +46,30 @@ extern "C" {
  *   - note that non-data nodes/schema-only node (choice, case, uses, input, output) are skipped and _MUST_ not be
  *     included in the path.
  *
+ * An XPath expression evaluated repeatedly on data can be compiled only once by ::lyd_xpath_compile() and then
+ * evaluated by ::lyd_find_xpath_compiled() or ::lyd_eval_xpath_compiled() with the variable values supplied
+ * on every evaluation. Alternatively, a cache of compiled expressions can be enabled in the context by
+ * ::ly_ctx_set_xpath_cache() so that the functions taking the expression string reuse them automatically.
+ * To find out why an expression is slow, its evaluation plan can be printed by ::lyd_xpath_explain() and
+ * the time and node-set sizes of all its steps and predicates measured by ::lyd_xpath_profile(). The expressions
+ * evaluated by the data validation, such as must and when conditions, are profiled between
+ * ::lyd_xpath_profile_start() and ::lyd_xpath_profile_stop().
+ *
  * Functions List
  * --------------
  * - ::lyd_find_xpath()
  * - ::lys_find_xpath()
  *
+ * - ::lyd_xpath_compile()
+ * - ::lyd_xpath_free()
+ * - ::lyd_find_xpath_compiled()
+ * - ::lyd_eval_xpath_compiled()
+ * - ::lyd_xpath_explain()
+ * - ::lyd_xpath_profile()
+ * - ::lyd_xpath_profile_start()
+ * - ::lyd_xpath_profile_stop()
+ * - ::ly_ctx_set_xpath_cache()
+ *
  * Path
  * ====
  *
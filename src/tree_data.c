@@ -406,6 +406,7 @@ lyd_insert_get_next_anchor(const struct lyd_node *first_sibling, const struct ly
     struct lyd_node *match = NULL;
     ly_bool found;
     uint32_t getnext_opts;
+    LY_ARRAY_COUNT_TYPE sidx = 0;
 
     assert(new_node);
 
@@ -422,7 +423,7 @@ lyd_insert_get_next_anchor(const struct lyd_node *first_sibling, const struct ly
     if (first_sibling->parent && first_sibling->parent->schema && first_sibling->parent->children_ht) {
         /* find the anchor using hashes */
         sparent = first_sibling->parent->schema;
-        schema = lys_getnext(new_node->schema, sparent, NULL, getnext_opts);
+        schema = lys_getnext_idx(new_node->schema, sparent, NULL, getnext_opts, &sidx);
         while (schema) {
             /* keep trying to find the first existing instance of the closest following schema sibling,
              * otherwise return NULL - inserting at the end */
@@ -430,7 +431,7 @@ lyd_insert_get_next_anchor(const struct lyd_node *first_sibling, const struct ly
                 break;
             }
 
-            schema = lys_getnext(schema, sparent, NULL, getnext_opts);
+            schema = lys_getnext_idx(schema, sparent, NULL, getnext_opts, &sidx);
         }
     } else {
         /* find the anchor without hashes */
@@ -446,7 +447,7 @@ lyd_insert_get_next_anchor(const struct lyd_node *first_sibling, const struct ly
         }
 
         /* get the first schema sibling */
-        schema = lys_getnext(NULL, sparent, new_node->schema->module->compiled, getnext_opts);
+        schema = lys_getnext_idx(NULL, sparent, new_node->schema->module->compiled, getnext_opts, &sidx);
 
         found = 0;
         LY_LIST_FOR(match, match) {
@@ -469,7 +470,7 @@ lyd_insert_get_next_anchor(const struct lyd_node *first_sibling, const struct ly
                     /* current node (match) is a data node still before the new node, continue search in data */
                     break;
                 }
-                schema = lys_getnext(schema, sparent, new_node->schema->module->compiled, getnext_opts);
+                schema = lys_getnext_idx(schema, sparent, new_node->schema->module->compiled, getnext_opts, &sidx);
                 assert(schema);
             }
 
@@ -496,6 +497,7 @@ lyd_insert_after_node(struct lyd_node *sibling, struct lyd_node *node)
     if (node->next) {
         /* sibling had a succeeding node */
         node->next->prev = node;
+        node->parent = sibling->parent;
     } else {
         /* sibling was last, find first sibling and change its prev */
         if (sibling->parent) {
@@ -504,8 +506,9 @@ lyd_insert_after_node(struct lyd_node *sibling, struct lyd_node *node)
             for ( ; sibling->prev->next != node; sibling = sibling->prev) {}
         }
         sibling->prev = node;
+        node->parent = sibling->parent;
     }
-    node->parent = sibling->parent;
+    lyd_order_insert(node);
 
     for (par = node->parent; par; par = par->parent) {
         if ((par->flags & LYD_DEFAULT) && !(node->flags & LYD_DEFAULT)) {
@@ -526,6 +529,7 @@ lyd_insert_before_node(struct lyd_node *sibling, struct lyd_node *node)
     /* covers situation of sibling being first */
     node->prev = sibling->prev;
     sibling->prev = node;
+    node->parent = sibling->parent;
     if (node->prev->next) {
         /* sibling had a preceding node */
         node->prev->next = node;
@@ -533,7 +537,7 @@ lyd_insert_before_node(struct lyd_node *sibling, struct lyd_node *node)
         /* sibling was first and we must also change parent child pointer */
         sibling->parent->child = node;
     }
-    node->parent = sibling->parent;
+    lyd_order_insert(node);
 
     for (par = node->parent; par; par = par->parent) {
         if ((par->flags & LYD_DEFAULT) && !(node->flags & LYD_DEFAULT)) {
@@ -563,6 +567,7 @@ lyd_insert_only_child(struct lyd_node *parent, struct lyd_node *node)
 
     par->child = node;
     node->parent = par;
+    node->order = LYD_ORDER_MID;
 
     for ( ; par; par = par->parent) {
         if ((par->flags & LYD_DEFAULT) && !(node->flags & LYD_DEFAULT)) {
@@ -600,6 +605,34 @@ lyd_insert_has_keys(const struct lyd_node *list)
     return 1;
 }
 
+/**
+ * @brief Finish inserting a node, update the hashes and record the change.
+ *
+ * @param[in] parent Parent of the inserted node, if any.
+ * @param[in] node Inserted node.
+ */
+static void
+lyd_insert_node_finish(struct lyd_node *parent, struct lyd_node *node)
+{
+    struct lyd_journal *journal;
+
+    /* insert into parent HT */
+    lyd_insert_hash(node);
+
+    /* finish hashes for our parent, if needed and possible */
+    if (node->schema && (node->schema->flags & LYS_KEY) && parent && lyd_insert_has_keys(parent)) {
+        lyd_hash(parent);
+
+        /* now we can insert even the list into its parent HT */
+        lyd_insert_hash(parent);
+    }
+
+    /* record the change */
+    if ((journal = lyd_journal_get(node))) {
+        lyd_journal_create(journal, node);
+    }
+}
+
 void
 lyd_insert_node(struct lyd_node *parent, struct lyd_node **first_sibling_p, struct lyd_node *node, ly_bool last)
 {
@@ -643,16 +676,7 @@ lyd_insert_node(struct lyd_node *parent, struct lyd_node **first_sibling_p, stru
         *first_sibling_p = node;
     }
 
-    /* insert into parent HT */
-    lyd_insert_hash(node);
-
-    /* finish hashes for our parent, if needed and possible */
-    if (node->schema && (node->schema->flags & LYS_KEY) && parent && lyd_insert_has_keys(parent)) {
-        lyd_hash(parent);
-
-        /* now we can insert even the list into its parent HT */
-        lyd_insert_hash(parent);
-    }
+    lyd_insert_node_finish(parent, node);
 }
 
 /**
@@ -703,10 +727,334 @@ lyd_insert_check_schema(const struct lysc_node *parent, const struct lysc_node *
     return LY_SUCCESS;
 }
 
+LY_ERR
+lyd_insert_node_run(struct lyd_node *parent, struct lyd_node **first_sibling_p, struct lyd_node **nodes, uint32_t count,
+        ly_bool check_dup)
+{
+    struct lyd_node *anchor, *first_sibling, *prev;
+    uint32_t i;
+
+    assert((parent || first_sibling_p) && nodes && count);
+
+    if (!parent && first_sibling_p && (*first_sibling_p) && (*first_sibling_p)->parent) {
+        parent = lyd_parent(*first_sibling_p);
+    }
+
+    /* get first sibling */
+    first_sibling = parent ? lyd_child(parent) : *first_sibling_p;
+
+    /* all the nodes have the same schema so a single check is enough */
+    if (parent) {
+        LY_CHECK_RET(lyd_insert_check_schema(parent->schema, NULL, nodes[0]->schema));
+    } else if (first_sibling) {
+        LY_CHECK_RET(lyd_insert_check_schema(NULL, first_sibling->schema, nodes[0]->schema));
+    }
+
+    /* prepare the parent HT for all the nodes */
+    LY_CHECK_RET(lyd_insert_hash_reserve(parent, count));
+
+    /* find the anchor once, all the nodes are inserted before it */
+    if (first_sibling && (first_sibling->flags & LYD_EXT)) {
+        anchor = NULL;
+    } else {
+        anchor = lyd_insert_get_next_anchor(first_sibling, nodes[0]);
+    }
+    prev = first_sibling ? first_sibling->prev : NULL;
+
+    for (i = 0; i < count; ++i) {
+        assert(nodes[i]->hash && (nodes[i]->schema == nodes[0]->schema));
+
+        if (check_dup && (nodes[i]->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) &&
+                !lysc_is_dup_inst_list(nodes[i]->schema) &&
+                !lyd_find_sibling_first(parent ? lyd_child(parent) : *first_sibling_p, nodes[i], NULL)) {
+            LOGERR(LYD_CTX(nodes[i]), LY_EEXIST, "Duplicate instance of \"%s\".", LYD_NAME(nodes[i]));
+
+            /* unlink all the nodes inserted so far */
+            while (i) {
+                --i;
+                if (!parent && (*first_sibling_p == nodes[i])) {
+                    *first_sibling_p = nodes[i]->next;
+                }
+                lyd_unlink_tree(nodes[i]);
+            }
+            return LY_EEXIST;
+        }
+
+        if (anchor) {
+            /* insert before the anchor */
+            lyd_insert_before_node(anchor, nodes[i]);
+            if (!parent && (*first_sibling_p == anchor)) {
+                /* move first sibling */
+                *first_sibling_p = nodes[i];
+            }
+        } else if (prev) {
+            /* insert after the previous node */
+            lyd_insert_after_node(prev, nodes[i]);
+        } else if (parent) {
+            /* insert as the only child */
+            lyd_insert_only_child(parent, nodes[i]);
+        } else {
+            /* insert as the only sibling */
+            *first_sibling_p = nodes[i];
+        }
+        prev = nodes[i];
+
+        lyd_insert_node_finish(parent, nodes[i]);
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Node being inserted in bulk with its sort keys.
+ */
+struct lyd_insert_bulk_item {
+    struct lyd_node *node;  /**< node to insert */
+    uint32_t sidx;          /**< schema order index of the node schema, opaque nodes are last */
+    uint32_t pos;           /**< original position of the node */
+};
+
+/**
+ * @brief Sort callback for nodes being inserted in bulk, by the schema order keeping the original order of instances.
+ */
+static int
+lyd_insert_bulk_cmp(const void *ptr1, const void *ptr2)
+{
+    const struct lyd_insert_bulk_item *item1 = ptr1, *item2 = ptr2;
+
+    if (item1->sidx != item2->sidx) {
+        return (item1->sidx < item2->sidx) ? -1 : 1;
+    }
+    return (item1->pos < item2->pos) ? -1 : 1;
+}
+
+/**
+ * @brief Get the schema order index of a data node among its schema siblings.
+ *
+ * @param[in] sparent Schema parent.
+ * @param[in] schema Schema node of the data node, NULL for opaque nodes.
+ * @return Schema order index.
+ */
+static uint32_t
+lyd_insert_bulk_sidx(const struct lysc_node *sparent, const struct lysc_node *schema)
+{
+    const struct lysc_node *iter = NULL;
+    uint32_t getnext_opts, sidx = 0;
+    LY_ARRAY_COUNT_TYPE idx;
+
+    if (!schema) {
+        /* opaque nodes are always at the end */
+        return UINT32_MAX;
+    }
+
+    getnext_opts = (schema->flags & LYS_IS_OUTPUT) ? LYS_GETNEXT_OUTPUT : 0;
+    if (!lysc_node_child_idx(sparent, NULL, schema, getnext_opts, &idx)) {
+        /* precomputed index */
+        return (uint32_t)idx;
+    }
+
+    while ((iter = lys_getnext(iter, sparent, NULL, getnext_opts))) {
+        if (iter == schema) {
+            return sidx;
+        }
+        ++sidx;
+    }
+
+    /* invalid place, the insert will fail */
+    return UINT32_MAX - 1;
+}
+
+/**
+ * @brief Callback for comparing nodes being inserted in bulk.
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_insert_bulk_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_node *node1 = *(struct lyd_node **)val1_p, *node2 = *(struct lyd_node **)val2_p;
+
+    return lyd_compare_single(node1, node2, 0) ? 0 : 1;
+}
+
+/**
+ * @brief Check that nodes can be inserted in bulk, before any of them is unlinked.
+ *
+ * @param[in] parent Parent node to insert into.
+ * @param[in] nodes Nodes to insert.
+ * @param[in] count Count of @p nodes.
+ * @param[in] check_dup Whether to check for duplicate list and leaf-list instances.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_insert_bulk_check(struct lyd_node *parent, struct lyd_node **nodes, uint32_t count, ly_bool check_dup)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct hash_table *ht = NULL;
+    struct lyd_node *match;
+    const struct lysc_node *last_schema = NULL;
+    uint32_t i;
+
+    for (i = 0; i < count; ++i) {
+        if (!nodes[i]->schema) {
+            /* opaque nodes can be inserted wherever */
+            continue;
+        }
+
+        if (nodes[i]->schema != last_schema) {
+            LY_CHECK_GOTO(ret = lyd_insert_check_schema(parent->schema, NULL, nodes[i]->schema), cleanup);
+            last_schema = nodes[i]->schema;
+        }
+
+        if (!check_dup || !(nodes[i]->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) ||
+                lysc_is_dup_inst_list(nodes[i]->schema)) {
+            continue;
+        }
+
+        /* equal existing child, the node itself may already be a child */
+        if (!lyd_find_sibling_first(lyd_child(parent), nodes[i], &match) && (match != nodes[i])) {
+            ret = LY_EEXIST;
+        } else {
+            /* equal node being inserted */
+            if (!ht) {
+                ht = lyht_new(LYHT_MIN_SIZE, sizeof nodes[i], lyd_insert_bulk_equal_cb, NULL, 1);
+                LY_CHECK_ERR_GOTO(!ht, LOGMEM(LYD_CTX(parent)); ret = LY_EMEM, cleanup);
+            }
+            ret = lyht_insert(ht, &nodes[i], nodes[i]->hash, NULL);
+        }
+        if (ret == LY_EEXIST) {
+            LOGERR(LYD_CTX(nodes[i]), LY_EEXIST, "Duplicate instance of \"%s\".", LYD_NAME(nodes[i]));
+        }
+        LY_CHECK_GOTO(ret, cleanup);
+    }
+
+cleanup:
+    lyht_free(ht);
+    return ret;
+}
+
+/**
+ * @brief Insert children into a parent at once.
+ *
+ * Nodes are grouped by their schema nodes and every group is inserted as a run with a single anchor search.
+ *
+ * @param[in] parent Parent to insert into.
+ * @param[in] nodes Array of nodes to insert, they are unlinked first if needed.
+ * @param[in] count Count of @p nodes.
+ * @param[in] check_dup Whether to check for duplicate list and leaf-list instances.
+ * @return LY_ERR value, no nodes are inserted on error and they are left unlinked only on a memory allocation
+ * failure.
+ */
+static LY_ERR
+lyd_insert_bulk(struct lyd_node *parent, struct lyd_node **nodes, uint32_t count, ly_bool check_dup)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyd_insert_bulk_item *items = NULL;
+    struct lyd_node **sorted = nodes;
+    const struct lysc_node *last_schema = NULL;
+    uint32_t i, j, done = 0, sidx, last_sidx = 0;
+    ly_bool is_sorted = 1;
+
+    /* check everything first so that the nodes are not unlinked on an error */
+    LY_CHECK_RET(lyd_insert_bulk_check(parent, nodes, count, check_dup));
+
+    /* unlink the nodes and learn whether they are in the schema order */
+    for (i = 0; i < count; ++i) {
+        if (nodes[i]->parent || nodes[i]->prev->next || nodes[i]->next) {
+            lyd_unlink_tree(nodes[i]);
+        }
+
+        if (!parent->schema || (i && (nodes[i]->schema == last_schema))) {
+            continue;
+        }
+        sidx = lyd_insert_bulk_sidx(parent->schema, nodes[i]->schema);
+        if (i && (sidx < last_sidx)) {
+            is_sorted = 0;
+        }
+        last_schema = nodes[i]->schema;
+        last_sidx = sidx;
+    }
+
+    if (!is_sorted) {
+        /* sort the nodes by the schema order, which is stable thanks to the original positions */
+        items = malloc(count * sizeof *items);
+        sorted = malloc(count * sizeof *sorted);
+        LY_CHECK_ERR_GOTO(!items || !sorted, LOGMEM(LYD_CTX(parent)); ret = LY_EMEM, cleanup);
+        for (i = 0; i < count; ++i) {
+            items[i].node = nodes[i];
+            if (i && (nodes[i]->schema == last_schema)) {
+                items[i].sidx = last_sidx;
+            } else {
+                items[i].sidx = lyd_insert_bulk_sidx(parent->schema, nodes[i]->schema);
+            }
+            items[i].pos = i;
+            last_schema = nodes[i]->schema;
+            last_sidx = items[i].sidx;
+        }
+        qsort(items, count, sizeof *items, lyd_insert_bulk_cmp);
+        for (i = 0; i < count; ++i) {
+            sorted[i] = items[i].node;
+        }
+    }
+
+    /* create the parent HT of the final size */
+    LY_CHECK_GOTO(ret = lyd_insert_hash_reserve(parent, count), cleanup);
+
+    /* insert the runs of nodes with the same schema */
+    for (i = 0; i < count; i = j) {
+        if (!sorted[i]->schema) {
+            /* opaque node */
+            lyd_insert_node(parent, NULL, sorted[i], 0);
+            j = i + 1;
+        } else {
+            for (j = i + 1; (j < count) && (sorted[j]->schema == sorted[i]->schema); ++j) {}
+            LY_CHECK_GOTO(ret = lyd_insert_node_run(parent, NULL, &sorted[i], j - i, 0), cleanup);
+        }
+        done = j;
+    }
+
+cleanup:
+    if (ret) {
+        /* unlink all the inserted nodes */
+        while (done) {
+            lyd_unlink_tree(sorted[--done]);
+        }
+    }
+    if (sorted != nodes) {
+        free(sorted);
+    }
+    free(items);
+    return ret;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_insert_child_bulk(struct lyd_node *parent, struct lyd_node **nodes, uint32_t count)
+{
+    uint32_t i;
+
+    LY_CHECK_ARG_RET(NULL, parent, nodes || !count, !parent->schema || (parent->schema->nodetype & LYD_NODE_INNER),
+            LY_EINVAL);
+
+    for (i = 0; i < count; ++i) {
+        LY_CHECK_ARG_RET(NULL, nodes[i], nodes[i] != parent, LY_EINVAL);
+        LY_CHECK_CTX_EQUAL_RET(LYD_CTX(parent), LYD_CTX(nodes[i]), LY_EINVAL);
+        if (nodes[i]->schema && (nodes[i]->schema->flags & LYS_KEY)) {
+            LOGERR(LYD_CTX(parent), LY_EINVAL, "Cannot insert key \"%s\".", nodes[i]->schema->name);
+            return LY_EINVAL;
+        }
+    }
+    if (!count) {
+        return LY_SUCCESS;
+    }
+
+    return lyd_insert_bulk(parent, nodes, count, 1);
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_insert_child(struct lyd_node *parent, struct lyd_node *node)
 {
-    struct lyd_node *iter;
+    LY_ERR ret;
+    struct lyd_node *iter, **nodes;
+    uint32_t i, count;
 
     LY_CHECK_ARG_RET(NULL, parent, node, !parent->schema || (parent->schema->nodetype & LYD_NODE_INNER), LY_EINVAL);
     LY_CHECK_CTX_EQUAL_RET(LYD_CTX(parent), LYD_CTX(node), LY_EINVAL);
@@ -722,13 +1070,23 @@ lyd_insert_child(struct lyd_node *parent, struct lyd_node *node)
         lyd_unlink_tree(node);
     }
 
-    while (node) {
-        iter = node->next;
-        lyd_unlink_tree(node);
+    if (!node->next) {
         lyd_insert_node(parent, NULL, node, 0);
-        node = iter;
+        return LY_SUCCESS;
     }
-    return LY_SUCCESS;
+
+    /* insert all the siblings at once */
+    for (count = 0, iter = node; iter; iter = iter->next) {
+        ++count;
+    }
+    nodes = malloc(count * sizeof *nodes);
+    LY_CHECK_ERR_RET(!nodes, LOGMEM(LYD_CTX(parent)), LY_EMEM);
+    for (i = 0, iter = node; iter; iter = iter->next) {
+        nodes[i++] = iter;
+    }
+    ret = lyd_insert_bulk(parent, nodes, count, 0);
+    free(nodes);
+    return ret;
 }
 
 LIBYANG_API_DEF LY_ERR
@@ -799,6 +1157,8 @@ lyd_insert_sibling(struct lyd_node *sibling, struct lyd_node *node, struct lyd_n
 LIBYANG_API_DEF LY_ERR
 lyd_insert_before(struct lyd_node *sibling, struct lyd_node *node)
 {
+    struct lyd_journal *journal;
+
     LY_CHECK_ARG_RET(NULL, sibling, node, sibling != node, LY_EINVAL);
     LY_CHECK_CTX_EQUAL_RET(LYD_CTX(sibling), LYD_CTX(node), LY_EINVAL);
 
@@ -817,12 +1177,18 @@ lyd_insert_before(struct lyd_node *sibling, struct lyd_node *node)
     lyd_insert_before_node(sibling, node);
     lyd_insert_hash(node);
 
+    if ((journal = lyd_journal_get(node))) {
+        lyd_journal_create(journal, node);
+    }
+
     return LY_SUCCESS;
 }
 
 LIBYANG_API_DEF LY_ERR
 lyd_insert_after(struct lyd_node *sibling, struct lyd_node *node)
 {
+    struct lyd_journal *journal;
+
     LY_CHECK_ARG_RET(NULL, sibling, node, sibling != node, LY_EINVAL);
     LY_CHECK_CTX_EQUAL_RET(LYD_CTX(sibling), LYD_CTX(node), LY_EINVAL);
 
@@ -841,6 +1207,10 @@ lyd_insert_after(struct lyd_node *sibling, struct lyd_node *node)
     lyd_insert_after_node(sibling, node);
     lyd_insert_hash(node);
 
+    if ((journal = lyd_journal_get(node))) {
+        lyd_journal_create(journal, node);
+    }
+
     return LY_SUCCESS;
 }
 
@@ -859,15 +1229,22 @@ LIBYANG_API_DEF void
 lyd_unlink_tree(struct lyd_node *node)
 {
     struct lyd_node *iter;
+    struct lyd_journal *journal;
 
     if (!node) {
         return;
     }
 
+    /* record the change while the node is still linked, also removing the last node of a tree */
+    if ((journal = lyd_journal_get(node))) {
+        lyd_journal_delete(journal, node);
+    }
+
     /* update hashes while still linked into the tree */
     lyd_unlink_hash(node);
 
     /* unlink from siblings */
+    lyd_order_unlink(node);
     if (node->prev->next) {
         node->prev->next = node->next;
     }
@@ -912,12 +1289,14 @@ lyd_unlink_tree(struct lyd_node *node)
 
     node->next = NULL;
     node->prev = node;
+    node->order = 0;
 }
 
 void
 lyd_insert_meta(struct lyd_node *parent, struct lyd_meta *meta, ly_bool clear_dflt)
 {
     struct lyd_meta *last, *iter;
+    struct lyd_journal *journal;
 
     assert(parent);
 
@@ -925,6 +1304,10 @@ lyd_insert_meta(struct lyd_node *parent, struct lyd_meta *meta, ly_bool clear_df
         return;
     }
 
+    if ((journal = lyd_journal_get(parent))) {
+        lyd_journal_meta(journal, parent);
+    }
+
     for (iter = meta; iter; iter = iter->next) {
         iter->parent = parent;
     }
@@ -1168,6 +1551,35 @@ lyd_compare_schema_parents_equal(const struct lyd_node *node1, const struct lyd_
     return 1;
 }
 
+/**
+ * @brief Check whether the cached subtree hashes of 2 nodes prove their subtrees differ.
+ *
+ * @param[in] node1 First node.
+ * @param[in] node2 Second node.
+ * @param[in] options Compare options, see @ref datacompareoptions.
+ * @return Whether the subtrees differ, 0 if unknown.
+ */
+static ly_bool
+lyd_compare_subtree_hash_differ(const struct lyd_node *node1, const struct lyd_node *node2, uint32_t options)
+{
+    uint64_t hash1, hash2;
+
+    if (!(options & LYD_COMPARE_DEFAULTS)) {
+        /* the hashes include the default flags so they can differ for equal subtrees */
+        return 0;
+    }
+
+    if (!node1->schema || !(node1->schema->nodetype & LYD_NODE_INNER) || !node2->schema ||
+            !(node2->schema->nodetype & LYD_NODE_INNER)) {
+        return 0;
+    }
+
+    /* use only already generated hashes */
+    hash1 = ((struct lyd_node_inner *)node1)->subtree_hash;
+    hash2 = ((struct lyd_node_inner *)node2)->subtree_hash;
+    return hash1 && hash2 && (hash1 != hash2);
+}
+
 /**
  * @brief Internal implementation of @ref lyd_compare_single.
  * @copydoc lyd_compare_single
@@ -1309,6 +1721,9 @@ all_children_compare:
                     /* no children, nothing to compare */
                     return LY_SUCCESS;
                 }
+                if (lyd_compare_subtree_hash_differ(node1, node2, options)) {
+                    return LY_ENOT;
+                }
 
                 for ( ; iter1 && iter2; iter1 = iter1->next, iter2 = iter2->next) {
                     if (lyd_compare_single_(iter1, iter2, options | LYD_COMPARE_FULL_RECURSION, parental_schemas_checked)) {
@@ -1583,7 +1998,7 @@ lyd_dup_r(const struct lyd_node *node, const struct ly_ctx *trg_ctx, struct lyd_
     LY_CHECK_ERR_GOTO(!dup, LOGMEM(trg_ctx); ret = LY_EMEM, error);
 
     if (options & LYD_DUP_WITH_FLAGS) {
-        dup->flags = node->flags;
+        dup->flags = node->flags & ~LYD_JOURNALED;
     } else {
         dup->flags = (node->flags & (LYD_DEFAULT | LYD_EXT)) | LYD_NEW;
     }
@@ -1660,6 +2075,10 @@ lyd_dup_r(const struct lyd_node *node, const struct ly_ctx *trg_ctx, struct lyd_
             LY_LIST_FOR(orig->child, child) {
                 LY_CHECK_GOTO(ret = lyd_dup_r(child, trg_ctx, dup, 1, NULL, options, NULL), error);
             }
+            if (!(options & LYD_DUP_NO_EXT)) {
+                /* the same subtree, default flags are always kept */
+                ((struct lyd_node_inner *)dup)->subtree_hash = orig->subtree_hash;
+            }
         } else if ((dup->schema->nodetype == LYS_LIST) && !(dup->schema->flags & LYS_KEYLESS)) {
             /* always duplicate keys of a list */
             for (child = orig->child; child && lysc_is_key(child->schema); child = child->next) {
@@ -1727,16 +2146,22 @@ lyd_dup_get_local_parent(const struct lyd_node *node, const struct ly_ctx *trg_c
         if (!*local_parent) {
             *local_parent = (struct lyd_node_inner *)iter;
         }
-        if (iter->child) {
-            /* 1) list - add after keys
-             * 2) provided parent with some children */
+        if (!repeat && *dup_parent) {
+            /* the provided parent may have other children, insert properly to update its hash table */
+            lyd_insert_node((struct lyd_node *)iter, NULL, *dup_parent, 0);
+        } else if (iter->child) {
+            /* list - add after keys */
             iter->child->prev->next = *dup_parent;
             if (*dup_parent) {
+                (*dup_parent)->order = iter->child->prev->order + 1;
                 (*dup_parent)->prev = iter->child->prev;
                 iter->child->prev = *dup_parent;
             }
         } else {
             ((struct lyd_node_inner *)iter)->child = *dup_parent;
+            if (*dup_parent) {
+                (*dup_parent)->order = LYD_ORDER_MID;
+            }
         }
         if (*dup_parent) {
             (*dup_parent)->parent = (struct lyd_node_inner *)iter;
@@ -1884,9 +2309,14 @@ lyd_dup_meta_single(const struct lyd_meta *meta, struct lyd_node *node, struct l
     LY_ERR ret = LY_SUCCESS;
     const struct ly_ctx *ctx;
     struct lyd_meta *mt, *last;
+    struct lyd_journal *journal;
 
     LY_CHECK_ARG_RET(NULL, meta, node, LY_EINVAL);
 
+    if ((journal = lyd_journal_get(node))) {
+        lyd_journal_meta(journal, node);
+    }
+
     /* log to node context but value must always use the annotation context */
     ctx = meta->annotation->module->ctx;
 
@@ -1937,8 +2367,10 @@ lyd_merge_sibling_r(struct lyd_node **first_trg, struct lyd_node *parent_trg, co
     struct lyd_node_opaq *opaq_trg, *opaq_src;
     struct lysc_type *type;
     struct lyd_dup_inst *child_dup_inst = NULL;
+    struct lyd_journal *journal;
+    char *orig_value = NULL;
     LY_ERR ret;
-    ly_bool first_inst = 0;
+    ly_bool first_inst = 0, orig_dflt = 0;
 
     sibling_src = *sibling_src_p;
     if (!sibling_src->schema) {
@@ -1989,13 +2421,32 @@ lyd_merge_sibling_r(struct lyd_node **first_trg, struct lyd_node *parent_trg, co
 
             /* update value (or only LYD_DEFAULT flag) only if flag set or the source node is not default */
             if ((options & LYD_MERGE_DEFAULTS) || !(sibling_src->flags & LYD_DEFAULT)) {
+                if ((journal = lyd_journal_get(match_trg))) {
+                    /* remember the original value for the journal */
+                    orig_dflt = (match_trg->flags & LYD_DEFAULT) ? 1 : 0;
+                    if (lyd_compare_single(sibling_src, match_trg, 0)) {
+                        orig_value = strdup(lyd_get_value(match_trg));
+                        LY_CHECK_ERR_RET(!orig_value, LOGMEM(LYD_CTX(match_trg)), LY_EMEM);
+                    }
+                }
+
                 type = ((struct lysc_node_leaf *)match_trg->schema)->type;
+                lyd_unlink_index(match_trg);
                 type->plugin->free(LYD_CTX(match_trg), &((struct lyd_node_term *)match_trg)->value);
-                LY_CHECK_RET(type->plugin->duplicate(LYD_CTX(match_trg), &((struct lyd_node_term *)sibling_src)->value,
-                        &((struct lyd_node_term *)match_trg)->value));
+                ret = type->plugin->duplicate(LYD_CTX(match_trg), &((struct lyd_node_term *)sibling_src)->value,
+                        &((struct lyd_node_term *)match_trg)->value);
+                LY_CHECK_ERR_RET(ret, free(orig_value), ret);
+                LY_CHECK_ERR_RET(ret = lyd_insert_index(match_trg), free(orig_value), ret);
 
                 /* copy flags and add LYD_NEW */
-                match_trg->flags = sibling_src->flags | ((options & LYD_MERGE_WITH_FLAGS) ? 0 : LYD_NEW);
+                match_trg->flags = (match_trg->flags & LYD_JOURNALED) | (sibling_src->flags & ~LYD_JOURNALED) |
+                        ((options & LYD_MERGE_WITH_FLAGS) ? 0 : LYD_NEW);
+                lyd_hash_subtree_invalidate(match_trg);
+
+                if (journal) {
+                    lyd_journal_replace(journal, match_trg, orig_value, orig_dflt);
+                    free(orig_value);
+                }
             }
         } else if ((match_trg->schema->nodetype & LYS_ANYDATA) && lyd_compare_single(sibling_src, match_trg, 0)) {
             /* update value */
@@ -2003,7 +2454,8 @@ lyd_merge_sibling_r(struct lyd_node **first_trg, struct lyd_node *parent_trg, co
                     ((struct lyd_node_any *)sibling_src)->value_type));
 
             /* copy flags and add LYD_NEW */
-            match_trg->flags = sibling_src->flags | ((options & LYD_MERGE_WITH_FLAGS) ? 0 : LYD_NEW);
+            match_trg->flags = (match_trg->flags & LYD_JOURNALED) | (sibling_src->flags & ~LYD_JOURNALED) |
+                    ((options & LYD_MERGE_WITH_FLAGS) ? 0 : LYD_NEW);
         }
 
         /* check descendants, recursively */
@@ -2453,6 +2905,59 @@ lyd_find_sibling_first(const struct lyd_node *siblings, const struct lyd_node *t
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Search in the given siblings for the first list instance using an index.
+ *
+ * @param[in] siblings Siblings to search in.
+ * @param[in] schema List schema node with indexed leafs.
+ * @param[in] pred Predicate on an indexed leaf in the form "[leaf='val']".
+ * @param[in] pred_len Length of @p pred.
+ * @param[out] match Optional found list instance.
+ * @return LY_SUCCESS on success.
+ * @return LY_ENOTFOUND if not found.
+ * @return LY_ENOT if the index cannot be used for @p pred.
+ * @return LY_ERR value on error.
+ */
+static LY_ERR
+lyd_find_sibling_val_index(const struct lyd_node *siblings, const struct lysc_node *schema, const char *pred,
+        size_t pred_len, struct lyd_node **match)
+{
+    LY_ERR rc;
+    struct lyxp_expr *exp = NULL;
+    struct lyd_node *leaf = NULL;
+    struct ly_set found = {0};
+    uint16_t tok_idx = 0;
+    uint32_t prev_lo;
+
+    /* parse the predicate */
+    prev_lo = ly_log_options(0);
+    rc = lyxp_expr_parse(schema->module->ctx, pred, pred_len, 0, &exp);
+    ly_log_options(prev_lo);
+    if (rc) {
+        rc = LY_ENOT;
+        goto cleanup;
+    }
+
+    /* it must be a single indexed leaf predicate */
+    if (lyxp_index_predicate(schema->module->ctx, exp, &tok_idx, schema, LY_VALUE_JSON, NULL, &leaf) ||
+            (tok_idx != exp->used)) {
+        rc = LY_ENOT;
+        goto cleanup;
+    }
+
+    /* find it */
+    rc = lyd_find_index(siblings, leaf, 1, &found);
+    if (match) {
+        *match = rc ? NULL : found.dnodes[0];
+    }
+
+cleanup:
+    lyxp_expr_free(schema->module->ctx, exp);
+    lyd_free_tree(leaf);
+    ly_set_erase(&found, NULL);
+    return rc;
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_find_sibling_val(const struct lyd_node *siblings, const struct lysc_node *schema, const char *key_or_value,
         size_t val_len, struct lyd_node **match)
@@ -2488,6 +2993,14 @@ lyd_find_sibling_val(const struct lyd_node *siblings, const struct lysc_node *sc
         val_len = strlen(key_or_value);
     }
 
+    if ((schema->nodetype == LYS_LIST) && (schema->flags & LYS_INDEXED) && key_or_value) {
+        /* try to find the instance by an indexed leaf value */
+        rc = lyd_find_sibling_val_index(siblings, schema, key_or_value, val_len, match);
+        if (rc != LY_ENOT) {
+            return rc;
+        }
+    }
+
     if ((schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) && key_or_value) {
         /* create a data node and find the instance */
         if (schema->nodetype == LYS_LEAFLIST) {
@@ -2599,25 +3112,36 @@ lyd_find_sibling_opaq_next(const struct lyd_node *first, const char *name, struc
     return first ? LY_SUCCESS : LY_ENOTFOUND;
 }
 
-LIBYANG_API_DEF LY_ERR
-lyd_find_xpath4(const struct lyd_node *ctx_node, const struct lyd_node *tree, const char *xpath, LY_VALUE_FORMAT format,
-        void *prefix_data, const struct lyxp_var *vars, struct ly_set **set)
+/**
+ * @brief Search in the given data for instances of nodes matching the provided parsed XPath.
+ *
+ * @param[in] ctx_node XPath context node, NULL for the root node.
+ * @param[in] tree Data tree to evaluate on.
+ * @param[in] exp Parsed XPath.
+ * @param[in] format Format of any prefixes in @p exp.
+ * @param[in] prefix_data Format-specific prefix data.
+ * @param[in] vars Sized array of XPath variables.
+ * @param[out] set Set of found data nodes.
+ * @param[out] report Optional profile of the evaluation to print.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_find_xpath_exp(const struct lyd_node *ctx_node, const struct lyd_node *tree, const struct lyxp_expr *exp,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars, struct ly_set **set, char **report)
 {
     LY_ERR ret = LY_SUCCESS;
     struct lyxp_set xp_set = {0};
-    struct lyxp_expr *exp = NULL;
     uint32_t i;
 
-    LY_CHECK_ARG_RET(NULL, tree, xpath, format, set, LY_EINVAL);
-
     *set = NULL;
 
-    /* parse expression */
-    ret = lyxp_expr_parse((struct ly_ctx *)LYD_CTX(tree), xpath, 0, 1, &exp);
-    LY_CHECK_GOTO(ret, cleanup);
-
     /* evaluate expression */
-    ret = lyxp_eval(LYD_CTX(tree), exp, NULL, format, prefix_data, ctx_node, tree, vars, &xp_set, LYXP_IGNORE_WHEN);
+    if (report) {
+        ret = lyxp_eval_profile(LYD_CTX(tree), exp, NULL, format, prefix_data, ctx_node, tree, vars, &xp_set,
+                LYXP_IGNORE_WHEN, report);
+    } else {
+        ret = lyxp_eval(LYD_CTX(tree), exp, NULL, format, prefix_data, ctx_node, tree, vars, &xp_set, LYXP_IGNORE_WHEN);
+    }
     LY_CHECK_GOTO(ret, cleanup);
 
     /* allocate return set */
@@ -2641,7 +3165,6 @@ lyd_find_xpath4(const struct lyd_node *ctx_node, const struct lyd_node *tree, co
 
 cleanup:
     lyxp_set_free_content(&xp_set);
-    lyxp_expr_free((struct ly_ctx *)LYD_CTX(tree), exp);
     if (ret) {
         ly_set_free(*set, NULL);
         *set = NULL;
@@ -2649,6 +3172,29 @@ cleanup:
     return ret;
 }
 
+LIBYANG_API_DEF LY_ERR
+lyd_find_xpath4(const struct lyd_node *ctx_node, const struct lyd_node *tree, const char *xpath, LY_VALUE_FORMAT format,
+        void *prefix_data, const struct lyxp_var *vars, struct ly_set **set)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyxp_expr *exp = NULL;
+
+    LY_CHECK_ARG_RET(NULL, tree, xpath, format, set, LY_EINVAL);
+
+    *set = NULL;
+
+    /* parse expression, reuse it if cached */
+    ret = lyxp_expr_cache_get(LYD_CTX(tree), xpath, &exp);
+    LY_CHECK_GOTO(ret, cleanup);
+
+    /* evaluate expression */
+    ret = lyd_find_xpath_exp(ctx_node, tree, exp, format, prefix_data, vars, set, NULL);
+
+cleanup:
+    lyxp_expr_cache_put(LYD_CTX(tree), exp);
+    return ret;
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_find_xpath3(const struct lyd_node *ctx_node, const struct lyd_node *tree, const char *xpath,
         const struct lyxp_var *vars, struct ly_set **set)
@@ -2674,21 +3220,28 @@ lyd_find_xpath(const struct lyd_node *ctx_node, const char *xpath, struct ly_set
     return lyd_find_xpath4(ctx_node, ctx_node, xpath, LY_VALUE_JSON, NULL, NULL, set);
 }
 
-LIBYANG_API_DEF LY_ERR
-lyd_eval_xpath2(const struct lyd_node *ctx_node, const char *xpath, const struct lyxp_var *vars, ly_bool *result)
+/**
+ * @brief Evaluate a parsed XPath on data and return the result converted to boolean.
+ *
+ * @param[in] ctx_node XPath context node, NULL for the root node.
+ * @param[in] tree Data tree to evaluate on.
+ * @param[in] exp Parsed XPath.
+ * @param[in] format Format of any prefixes in @p exp.
+ * @param[in] prefix_data Format-specific prefix data.
+ * @param[in] vars Sized array of XPath variables.
+ * @param[out] result Expression result converted to boolean.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_eval_xpath_exp(const struct lyd_node *ctx_node, const struct lyd_node *tree, const struct lyxp_expr *exp,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars, ly_bool *result)
 {
     LY_ERR ret = LY_SUCCESS;
     struct lyxp_set xp_set = {0};
-    struct lyxp_expr *exp = NULL;
 
-    LY_CHECK_ARG_RET(NULL, ctx_node, xpath, result, LY_EINVAL);
-
-    /* compile expression */
-    ret = lyxp_expr_parse((struct ly_ctx *)LYD_CTX(ctx_node), xpath, 0, 1, &exp);
-    LY_CHECK_GOTO(ret, cleanup);
-
-    /* evaluate expression */
-    ret = lyxp_eval(LYD_CTX(ctx_node), exp, NULL, LY_VALUE_JSON, NULL, ctx_node, ctx_node, vars, &xp_set, LYXP_IGNORE_WHEN);
+    /* evaluate expression, only its boolean value is needed */
+    ret = lyxp_eval(LYD_CTX(tree), exp, NULL, format, prefix_data, ctx_node, tree, vars, &xp_set,
+            LYXP_IGNORE_WHEN | LYXP_EVAL_EXISTS);
     LY_CHECK_GOTO(ret, cleanup);
 
     /* transform into boolean */
@@ -2700,7 +3253,26 @@ lyd_eval_xpath2(const struct lyd_node *ctx_node, const char *xpath, const struct
 
 cleanup:
     lyxp_set_free_content(&xp_set);
-    lyxp_expr_free((struct ly_ctx *)LYD_CTX(ctx_node), exp);
+    return ret;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_eval_xpath2(const struct lyd_node *ctx_node, const char *xpath, const struct lyxp_var *vars, ly_bool *result)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyxp_expr *exp = NULL;
+
+    LY_CHECK_ARG_RET(NULL, ctx_node, xpath, result, LY_EINVAL);
+
+    /* compile expression, reuse it if cached */
+    ret = lyxp_expr_cache_get(LYD_CTX(ctx_node), xpath, &exp);
+    LY_CHECK_GOTO(ret, cleanup);
+
+    /* evaluate expression */
+    ret = lyd_eval_xpath_exp(ctx_node, ctx_node, exp, LY_VALUE_JSON, NULL, vars, result);
+
+cleanup:
+    lyxp_expr_cache_put(LYD_CTX(ctx_node), exp);
     return ret;
 }
 
@@ -2710,6 +3282,73 @@ lyd_eval_xpath(const struct lyd_node *ctx_node, const char *xpath, ly_bool *resu
     return lyd_eval_xpath2(ctx_node, xpath, NULL, result);
 }
 
+LIBYANG_API_DEF LY_ERR
+lyd_xpath_compile(const struct ly_ctx *ctx, const char *xpath, struct lyxp_expr **exp)
+{
+    LY_CHECK_ARG_RET(ctx, ctx, xpath, exp, LY_EINVAL);
+
+    return lyxp_expr_cache_get(ctx, xpath, exp);
+}
+
+LIBYANG_API_DEF void
+lyd_xpath_free(const struct ly_ctx *ctx, struct lyxp_expr *exp)
+{
+    if (!ctx || !exp) {
+        return;
+    }
+
+    lyxp_expr_cache_put(ctx, exp);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_find_xpath_compiled(const struct lyd_node *ctx_node, const struct lyd_node *tree, const struct lyxp_expr *exp,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars, struct ly_set **set)
+{
+    LY_CHECK_ARG_RET(NULL, tree, exp, format, set, LY_EINVAL);
+
+    return lyd_find_xpath_exp(ctx_node, tree, exp, format, prefix_data, vars, set, NULL);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_xpath_profile(const struct lyd_node *ctx_node, const struct lyd_node *tree, const struct lyxp_expr *exp,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars, struct ly_set **set, char **report)
+{
+    LY_CHECK_ARG_RET(NULL, tree, exp, format, set, report, LY_EINVAL);
+
+    return lyd_find_xpath_exp(ctx_node, tree, exp, format, prefix_data, vars, set, report);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_xpath_profile_start(const struct ly_ctx *ctx)
+{
+    LY_CHECK_ARG_RET(ctx, ctx, LY_EINVAL);
+
+    return lyxp_profiles_start(ctx);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_xpath_profile_stop(char **report)
+{
+    return lyxp_profiles_stop(report);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_xpath_explain(const struct ly_ctx *ctx, const struct lyxp_expr *exp, char **plan)
+{
+    LY_CHECK_ARG_RET(ctx, ctx, exp, plan, LY_EINVAL);
+
+    return lyxp_explain(ctx, exp, plan);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_eval_xpath_compiled(const struct lyd_node *ctx_node, const struct lyd_node *tree, const struct lyxp_expr *exp,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars, ly_bool *result)
+{
+    LY_CHECK_ARG_RET(NULL, tree, exp, format, result, LY_EINVAL);
+
+    return lyd_eval_xpath_exp(ctx_node, tree, exp, format, prefix_data, vars, result);
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_find_path(const struct lyd_node *ctx_node, const char *path, ly_bool output, struct lyd_node **match)
 {
@@ -2738,6 +3377,46 @@ cleanup:
     return ret;
 }
 
+LIBYANG_API_DEF LY_ERR
+lyd_find_path_handle(const struct lyd_node *ctx_node, const struct lyd_path_handle *handle, const char **keys,
+        struct lyd_node **match)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_path *lypath = NULL;
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_CHECK_ARG_RET(NULL, ctx_node, ctx_node->schema, handle, keys || !handle->bind_count, LY_EINVAL);
+    LY_CHECK_CTX_EQUAL_RET(LYD_CTX(ctx_node), handle->ctx, LY_EINVAL);
+    if (handle->ctx_node && (ctx_node->schema != handle->ctx_node)) {
+        LOGERR(handle->ctx, LY_EINVAL, "Node \"%s\" is not the context node of path \"%s\".", LYD_NAME(ctx_node),
+                handle->str_path);
+        return LY_EINVAL;
+    }
+
+    /* bind the keys */
+    LY_CHECK_RET(lyd_path_handle_bind(handle, keys, &lypath));
+
+    /* all the lists and the target leaf-list must be identified, as with ::lyd_find_path() */
+    LY_ARRAY_FOR(lypath, u) {
+        if ((lypath[u].node->nodetype == LYS_LIST) || ((u == LY_ARRAY_COUNT(lypath) - 1) &&
+                (lypath[u].node->nodetype == LYS_LEAFLIST))) {
+            if (!lypath[u].predicates) {
+                LOGVAL(handle->ctx, LYVE_XPATH, "Predicate missing for %s \"%s\" in path \"%s\".",
+                        lys_nodetype2str(lypath[u].node->nodetype), lypath[u].node->name, handle->str_path);
+                ret = LY_EVALID;
+                goto cleanup;
+            }
+        }
+    }
+
+    /* evaluate the path */
+    ret = ly_path_eval_partial(lypath, ctx_node, NULL, match);
+
+cleanup:
+    lyd_path_handle_unbind(handle, lypath);
+    return ret;
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_find_target(const struct ly_path *path, const struct lyd_node *tree, struct lyd_node **match)
 {
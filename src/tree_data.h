@@ -45,6 +45,7 @@ struct ly_set;
 struct lyd_node;
 struct lyd_node_opaq;
 struct lyd_node_term;
+struct lyd_path_handle;
 struct timespec;
 struct lyxp_var;
 
@@ -108,6 +109,7 @@ struct lyxp_var;
  * - ::lyd_get_meta_value()
  * - ::lyd_find_xpath()
  * - ::lyd_find_path()
+ * - ::lyd_find_path_handle()
  * - ::lyd_find_target()
  * - ::lyd_find_sibling_val()
  * - ::lyd_find_sibling_first()
@@ -238,7 +240,9 @@ struct lyxp_var;
  * the node name and/or its parent (::lyd_new_inner(), ::lyd_new_term(), ::lyd_new_any(), ::lyd_new_list(), ::lyd_new_list2()
  * and ::lyd_new_opaq()) or address the nodes using a [simple XPath addressing](@ref howtoXPath) (::lyd_new_path() and
  * ::lyd_new_path2()). The latter enables to create a whole path of nodes, requires less information
- * about the modified data, and is generally simpler to use. Actually the third way is duplicating the existing data using
+ * about the modified data, and is generally simpler to use. A path used repeatedly with only the list keys changing can
+ * be compiled once into a handle (::lyd_path_handle_new()) and used by ::lyd_new_path_handle() and
+ * ::lyd_find_path_handle(). Actually the third way is duplicating the existing data using
  * ::lyd_dup_single(), ::lyd_dup_siblings() and ::lyd_dup_meta_single().
  *
  * Note, that in case the node is defined in an extension instance, the functions mentioned above do not work until you
@@ -273,7 +277,9 @@ struct lyxp_var;
  * Also remember, that when you are creating/inserting a node, all the objects in that operation must belong to the
  * same context.
  *
- * Modifying the single data tree in multiple threads is not safe.
+ * Modifying the single data tree in multiple threads is not safe. Canonical values of a tree are generated lazily on
+ * the first access, even by the functions only reading the tree, so reading a single data tree in multiple threads is
+ * safe only after calling ::lyd_mt_prepare() on it.
  *
  * Functions List
  * --------------
@@ -293,6 +299,10 @@ struct lyxp_var;
  * - ::lyd_new_meta()
  * - ::lyd_new_path()
  * - ::lyd_new_path2()
+ * - ::lyd_path_handle_new()
+ * - ::lyd_path_handle_bind_count()
+ * - ::lyd_new_path_handle()
+ * - ::lyd_path_handle_free()
  *
  * - ::lyd_new_ext_inner()
  * - ::lyd_new_ext_term()
@@ -305,6 +315,7 @@ struct lyxp_var;
  * - ::lyd_dup_meta_single()
  *
  * - ::lyd_insert_child()
+ * - ::lyd_insert_child_bulk()
  * - ::lyd_insert_sibling()
  * - ::lyd_insert_after()
  * - ::lyd_insert_before()
@@ -329,6 +340,17 @@ struct lyxp_var;
  * - ::lyd_diff_merge_module()
  * - ::lyd_diff_merge_tree()
  *
+ * - ::lyd_journal_new()
+ * - ::lyd_journal_diff()
+ * - ::lyd_journal_rollback()
+ * - ::lyd_journal_reset()
+ * - ::lyd_journal_free()
+ *
+ * - ::lyd_snapshots_new()
+ * - ::lyd_snapshot_get()
+ * - ::lyd_snapshot_release()
+ * - ::lyd_snapshots_free()
+ *
  * - ::lyd_merge_tree()
  * - ::lyd_merge_siblings()
  * - ::lyd_merge_module()
@@ -781,6 +803,8 @@ struct lyd_attr {
  *       3 LYD_NEW          |x|x|x|x|x|x|x|
  *                          +-+-+-+-+-+-+-+
  *       4 LYD_EXT          |x|x|x|x|x|x|x|
+ *                          +-+-+-+-+-+-+-+
+ *       5 LYD_JOURNALED    |x|x|x|x|x|x|x|
  *     ---------------------+-+-+-+-+-+-+-+
  *
  */
@@ -789,6 +813,8 @@ struct lyd_attr {
 #define LYD_WHEN_TRUE   0x02        /**< all when conditions of this node were evaluated to true */
 #define LYD_NEW         0x04        /**< node was created after the last validation, is needed for the next validation */
 #define LYD_EXT         0x08        /**< node is the first sibling parsed as extension instance data */
+#define LYD_JOURNALED   0x10        /**< top-level node of a journaled data tree (see ::lyd_journal_new()), for libyang
+                                         internal use only and never copied to other nodes */
 
 /** @} */
 
@@ -810,6 +836,9 @@ struct lyd_node {
                                           node in the list. */
     struct lyd_meta *meta;           /**< pointer to the list of metadata of this node */
     void *priv;                      /**< private user data, not used by libyang */
+    uint32_t order;                  /**< position among the siblings used as the document order key, consecutive for
+                                          all the siblings and maintained when the tree is modified, for libyang
+                                          internal use only */
 };
 
 /**
@@ -834,12 +863,17 @@ struct lyd_node_inner {
                                                  node in the list. */
             struct lyd_meta *meta;          /**< pointer to the list of metadata of this node */
             void *priv;                     /**< private user data, not used by libyang */
+            uint32_t order;                 /**< position among the siblings, for libyang internal use only */
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
     struct lyd_node *child;          /**< pointer to the first child node. */
     struct hash_table *children_ht;  /**< hash table with all the direct children (except keys for a list, lists without keys) */
 #define LYD_HT_MIN_ITEMS 4           /**< minimal number of children to create ::lyd_node_inner.children_ht hash table. */
+    struct hash_table *index_ht;     /**< hash table with the indexed leafs (see ::lysc_node_set_index()) of the child
+                                          list instances hashed by their values, NULL if there are none */
+    uint64_t subtree_hash;           /**< hash of the whole subtree content computed on demand (see ::LYD_DIFF_SUBTREE_HASH),
+                                          0 if not computed, for libyang internal use only */
 };
 
 /**
@@ -864,6 +898,7 @@ struct lyd_node_term {
                                                  node in the list. */
             struct lyd_meta *meta;          /**< pointer to the list of metadata of this node */
             void *priv;                     /**< private user data, not used by libyang */
+            uint32_t order;                 /**< position among the siblings, for libyang internal use only */
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
@@ -904,6 +939,7 @@ struct lyd_node_any {
                                                  node in the list. */
             struct lyd_meta *meta;          /**< pointer to the list of metadata of this node */
             void *priv;                     /**< private user data, not used by libyang */
+            uint32_t order;                 /**< position among the siblings, for libyang internal use only */
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
@@ -994,6 +1030,7 @@ struct lyd_node_opaq {
                                                  node in the list. */
             struct lyd_meta *meta;          /**< always NULL */
             void *priv;                     /**< private user data, not used by libyang */
+            uint32_t order;                 /**< position among the siblings, for libyang internal use only */
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
@@ -1588,6 +1625,67 @@ LIBYANG_API_DECL LY_ERR lyd_new_path2(struct lyd_node *parent, const struct ly_c
         size_t value_len, LYD_ANYDATA_VALUETYPE value_type, uint32_t options, struct lyd_node **new_parent,
         struct lyd_node **new_node);
 
+/**
+ * @brief Compile a path into a handle for repeated creating and finding of nodes.
+ *
+ * The path is parsed and its schema nodes are resolved only once. Every list with keys that has no predicate in
+ * @p path gets its key values bound on each use of the handle, in the order of the lists in the path and of the keys
+ * in each list. Predicates present in @p path are used unchanged. For example, handle of the path
+ * "/mod:cont/lst/lst2[k='a']/leaf" with "lst" having keys "k1" and "k2" binds 2 values, of "k1" and "k2".
+ *
+ * The handle does not depend on any data tree and can be used concurrently by several threads. It must be freed
+ * before its context is destroyed or changed.
+ *
+ * @param[in] ctx libyang context, must be set if @p ctx_node is NULL.
+ * @param[in] ctx_node Schema context node of a relative path, is ignored for an absolute path.
+ * @param[in] path [Path](@ref howtoXPath) to compile.
+ * @param[in] output Whether the path addresses RPC/action output nodes or input nodes.
+ * @param[out] handle Created path handle.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_path_handle_new(const struct ly_ctx *ctx, const struct lysc_node *ctx_node,
+        const char *path, ly_bool output, struct lyd_path_handle **handle);
+
+/**
+ * @brief Get the number of key values bound on each use of a path handle.
+ *
+ * @param[in] handle Path handle to examine.
+ * @return Number of the key values expected by ::lyd_new_path_handle() and ::lyd_find_path_handle().
+ */
+LIBYANG_API_DECL uint32_t lyd_path_handle_bind_count(const struct lyd_path_handle *handle);
+
+/**
+ * @brief Free a path handle.
+ *
+ * @param[in] handle Path handle to free.
+ */
+LIBYANG_API_DECL void lyd_path_handle_free(struct lyd_path_handle *handle);
+
+/**
+ * @brief Create a new node in the data tree based on a path handle. All node types can be created.
+ *
+ * Works exactly as ::lyd_new_path2() with the path of @p handle and the key values of @p keys in the bound lists,
+ * but only the key values and @p value are stored on each call. ::LYD_NEW_PATH_OUTPUT option is ignored, whether the
+ * output nodes are created was decided when creating @p handle.
+ *
+ * @param[in] parent Data parent to add to/modify, can be NULL only for an absolute path. Its schema node must be
+ * the context node of a relative path.
+ * @param[in] handle Path handle to create.
+ * @param[in] keys Array of key values (const char *) in ::LY_VALUE_JSON format, see ::lyd_path_handle_bind_count().
+ * @param[in] value Value of the new leaf/leaf-list (const char *) in ::LY_VALUE_JSON format. If creating an
+ * anyxml/anydata node, the expected type depends on @p value_type. For other node types, it should be NULL.
+ * @param[in] value_len Length of @p value in bytes. May be 0 if @p value is a zero-terminated string. Ignored when
+ * creating anyxml/anydata nodes.
+ * @param[in] value_type Anyxml/anydata node @p value type.
+ * @param[in] options Bitmask of options, see @ref pathoptions.
+ * @param[out] new_parent Optional first parent node created. If only one node was created, equals to @p new_node.
+ * @param[out] new_node Optional last node created.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_new_path_handle(struct lyd_node *parent, const struct lyd_path_handle *handle,
+        const char **keys, const void *value, size_t value_len, LYD_ANYDATA_VALUETYPE value_type, uint32_t options,
+        struct lyd_node **new_parent, struct lyd_node **new_node);
+
 /**
  * @brief Create a new node defined in the given extension instance. In case of anyxml/anydata nodes, this function expects
  * the @p value as string.
@@ -1730,7 +1828,8 @@ LIBYANG_API_DECL LY_ERR lyd_change_meta(struct lyd_meta *meta, const char *val_s
  * @brief Insert a child into a parent.
  *
  * - if the node is part of some other tree, it is automatically unlinked.
- * - if the node is the first node of a node list (with no parent), all the subsequent nodes are also inserted.
+ * - if the node is the first node of a node list (with no parent), all the subsequent nodes are also inserted,
+ * at once as by ::lyd_insert_child_bulk() but without checking for duplicate instances.
  *
  * @param[in] parent Parent node to insert into.
  * @param[in] node Node to insert.
@@ -1739,6 +1838,27 @@ LIBYANG_API_DECL LY_ERR lyd_change_meta(struct lyd_meta *meta, const char *val_s
  */
 LIBYANG_API_DECL LY_ERR lyd_insert_child(struct lyd_node *parent, struct lyd_node *node);
 
+/**
+ * @brief Insert several children into a parent at once.
+ *
+ * Much faster than inserting the nodes one-by-one when there are many of them. The nodes are grouped by their schema
+ * nodes in the schema order and appended after any existing instances, instances of the same schema node keep
+ * their relative order from @p nodes. The parent children hash table is built only once with its final size.
+ *
+ * - if any node is part of some other tree, it is automatically unlinked.
+ * - instances of lists and leaf-lists, except for state lists without keys and state leaf-lists, must not have
+ * an equal instance among the existing children or the other @p nodes.
+ *
+ * @param[in] parent Parent node to insert into.
+ * @param[in] nodes Array of individual nodes to insert, their siblings are not inserted.
+ * @param[in] count Count of @p nodes.
+ * @return LY_SUCCESS on success.
+ * @return LY_EEXIST if a duplicate list or leaf-list instance was found, no nodes are inserted nor unlinked.
+ * @return LY_ERR error on other errors, no nodes are inserted. They are not unlinked either unless memory allocation
+ * failed.
+ */
+LIBYANG_API_DECL LY_ERR lyd_insert_child_bulk(struct lyd_node *parent, struct lyd_node **nodes, uint32_t count);
+
 /**
  * @brief Insert a node into siblings.
  *
@@ -2132,6 +2252,15 @@ LIBYANG_API_DECL LY_ERR lyd_merge_module(struct lyd_node **target, const struct
 #define LYD_DIFF_DEFAULTS   0x01 /**< Default nodes in the trees are not ignored but treated similarly to explicit
                                       nodes. Also, leaves and leaf-lists are added into diff even in case only their
                                       default flag (state) was changed. */
+#define LYD_DIFF_SUBTREE_HASH 0x02 /**< Do not descend into subtrees with equal content hashes. The hashes of
+                                      the inner nodes are computed when first needed and kept in both trees until they
+                                      are modified so a repeated diff of mostly unchanged trees (snapshots) is
+                                      proportional to the changes. Note that equal subtrees are then not compared
+                                      node-by-node so a (very unlikely) 64-bit hash collision would hide their changes. */
+#define LYD_DIFF_MULTI_THREADED 0x04 /**< Compare the subtrees of the siblings (list instances and the children of
+                                      containers) by several worker threads and join their partial diffs in the document
+                                      order. The resulting diff is the same as the one generated by a single thread.
+                                      Ignored by ::lyd_diff_tree_cb() and ::lyd_diff_siblings_cb(). */
 
 /** @} diffoptions */
 
@@ -2178,6 +2307,67 @@ LIBYANG_API_DECL LY_ERR lyd_diff_tree(const struct lyd_node *first, const struct
 LIBYANG_API_DECL LY_ERR lyd_diff_siblings(const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
         struct lyd_node **diff);
 
+/**
+ * @brief Diff operations.
+ */
+enum lyd_diff_op {
+    LYD_DIFF_OP_CREATE,    /**< Subtree created. */
+    LYD_DIFF_OP_DELETE,    /**< Subtree deleted. */
+    LYD_DIFF_OP_REPLACE,   /**< Node value changed or (leaf-)list instance moved. */
+    LYD_DIFF_OP_NONE       /**< No change of an existing inner node or default flag change of a term node. */
+};
+
+/**
+ * @brief Callback for changes learned by ::lyd_diff_tree_cb() and ::lyd_diff_siblings_cb().
+ *
+ * A created or deleted node is reported once for its whole subtree. Inner nodes with only changed descendants are not
+ * reported, ::LYD_DIFF_OP_NONE is reported only for a default flag change.
+ *
+ * @param[in] op Operation.
+ * @param[in] first Node from the first tree, NULL on ::LYD_DIFF_OP_CREATE.
+ * @param[in] second Node from the second tree, NULL on ::LYD_DIFF_OP_DELETE.
+ * @param[in] anchor Set only for a created or moved user-ordered list/leaf-list instance, its preceding instance in
+ * the second tree, NULL if it is the first instance.
+ * @param[in] cb_data Arbitrary callback data.
+ * @return LY_ERR value, any error stops the diff and is returned.
+ */
+typedef LY_ERR (*lyd_diff_change_cb)(enum lyd_diff_op op, const struct lyd_node *first, const struct lyd_node *second,
+        const struct lyd_node *anchor, void *cb_data);
+
+/**
+ * @brief Learn the differences between 2 data trees and report them using a callback instead of creating a diff tree.
+ *
+ * The changes are reported in the order the nodes would have in the diff tree created by ::lyd_diff_tree() and
+ * they are the same changes, only no diff nodes nor metadata are created.
+ *
+ * @param[in] first First data tree.
+ * @param[in] second Second data tree.
+ * @param[in] options Bitmask of options flags, see @ref diffoptions.
+ * @param[in] change_cb Callback called for every change.
+ * @param[in] cb_data Arbitrary user data for @p change_cb.
+ * @return LY_SUCCESS on success,
+ * @return LY_ERR on error.
+ */
+LIBYANG_API_DECL LY_ERR lyd_diff_tree_cb(const struct lyd_node *first, const struct lyd_node *second, uint16_t options,
+        lyd_diff_change_cb change_cb, void *cb_data);
+
+/**
+ * @brief Learn the differences between 2 data trees including all the following siblings and report them using
+ * a callback.
+ *
+ * Details are mentioned in ::lyd_diff_tree_cb().
+ *
+ * @param[in] first First data tree.
+ * @param[in] second Second data tree.
+ * @param[in] options Bitmask of options flags, see @ref diffoptions.
+ * @param[in] change_cb Callback called for every change.
+ * @param[in] cb_data Arbitrary user data for @p change_cb.
+ * @return LY_SUCCESS on success,
+ * @return LY_ERR on error.
+ */
+LIBYANG_API_DECL LY_ERR lyd_diff_siblings_cb(const struct lyd_node *first, const struct lyd_node *second,
+        uint16_t options, lyd_diff_change_cb change_cb, void *cb_data);
+
 /**
  * @brief Callback for diff nodes.
  *
@@ -2304,6 +2494,135 @@ LIBYANG_API_DECL LY_ERR lyd_diff_merge_all(struct lyd_node **diff, const struct
  */
 LIBYANG_API_DECL LY_ERR lyd_diff_reverse_all(const struct lyd_node *src_diff, struct lyd_node **diff);
 
+/**
+ * @brief Opaque change journal of a data tree, see ::lyd_journal_new().
+ */
+struct lyd_journal;
+
+/**
+ * @brief Start journaling the changes of a data tree.
+ *
+ * Every change of the tree made by the \b lyd_new_*(), \b lyd_insert_*(), \b lyd_unlink_*(), \b lyd_free_*(),
+ * \b lyd_change_term*() and \b lyd_merge_*() functions, including the implicit changes made by validation, is
+ * recorded into a diff as if ::lyd_diff_siblings() with ::LYD_DIFF_DEFAULTS was called on the tree from the moment
+ * the journal was created and the current tree. Recording a change costs about the same as merging a diff of the
+ * single change so the diff is available at any time without comparing the whole trees. Changes of opaque nodes
+ * and extension data are not recorded. Changes of metadata made by the \b lyd_new_meta*(), ::lyd_dup_meta_single(),
+ * ::lyd_change_meta() and \b lyd_free_meta*() functions, as well as the metadata of the deleted nodes, are not part
+ * of the diff but the original metadata are remembered by their node paths for ::lyd_journal_rollback().
+ *
+ * The journal keeps @p tree pointing to the first sibling of the tree. The journal must be freed before
+ * the tree is freed as a whole and before its context is destroyed. It must also not be created or freed while
+ * another thread is changing any data tree of the same context.
+ *
+ * @param[in,out] tree Pointer to the first sibling of the data tree to journal, kept updated by the journal.
+ * @param[out] journal Created journal.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_journal_new(struct lyd_node **tree, struct lyd_journal **journal);
+
+/**
+ * @brief Get the diff of all the changes recorded by a journal.
+ *
+ * @param[in] journal Journal to use.
+ * @param[out] diff Duplicated diff of the recorded changes, NULL if there are none.
+ * @return LY_SUCCESS on success,
+ * @return LY_ERR value if recording a change failed and the journal is incomplete.
+ */
+LIBYANG_API_DECL LY_ERR lyd_journal_diff(const struct lyd_journal *journal, struct lyd_node **diff);
+
+/**
+ * @brief Roll back all the changes recorded by a journal.
+ *
+ * Together with ::lyd_journal_reset() serves as a checkpoint of the tree. The tree is changed to be equal to
+ * what it was when the journal was created or last reset, including the default flags, the metadata, and the order
+ * of user-ordered instances. The cost is proportional to the recorded changes, not to the size of the tree. Note that
+ * the restored nodes are new instances and anydata values are restored as strings. The metadata of key-less list
+ * and state leaf-list instances are restored by the instance positions.
+ *
+ * @param[in] journal Journal with the changes to undo, is reset on success.
+ * @return LY_SUCCESS on success,
+ * @return LY_ERR value on error, the journal then records the changes from the checkpoint to the current tree.
+ */
+LIBYANG_API_DECL LY_ERR lyd_journal_rollback(struct lyd_journal *journal);
+
+/**
+ * @brief Forget all the changes recorded by a journal so far, also clearing any recording error.
+ *
+ * @param[in] journal Journal to reset.
+ */
+LIBYANG_API_DECL void lyd_journal_reset(struct lyd_journal *journal);
+
+/**
+ * @brief Stop journaling and free a journal.
+ *
+ * @param[in] journal Journal to free.
+ */
+LIBYANG_API_DECL void lyd_journal_free(struct lyd_journal *journal);
+
+/**
+ * @brief Generate all the lazily generated data of a data tree so that it can be read by several threads concurrently.
+ *
+ * Generates the canonical values, which are otherwise generated on the first access even by the functions only reading
+ * the tree. Needs to be called again after the tree is modified.
+ *
+ * @param[in] tree Any sibling of the data tree, may be NULL.
+ * @param[in] with_meta Whether to generate the canonical values of metadata, too.
+ */
+LIBYANG_API_DECL void lyd_mt_prepare(const struct lyd_node *tree, ly_bool with_meta);
+
+/**
+ * @brief Opaque provider of read-only snapshots of a data tree, see ::lyd_snapshots_new().
+ */
+struct lyd_snapshots;
+
+/**
+ * @brief Start providing snapshots of a data tree.
+ *
+ * All the snapshots taken while the tree is not modified share a single copy of the tree so taking them costs
+ * only a reference. Once the tree is modified, the next snapshot gets a new copy. If no snapshot of the previous
+ * copy is in use anymore, the copy is updated using the journaled changes (see ::lyd_journal_new()) instead,
+ * at the cost proportional to the changes. The memory used is proportional to the number of different versions of
+ * the tree with snapshots in use, not to the number of the snapshots.
+ *
+ * The snapshots provider journals the tree so it must be freed before the tree is freed as a whole. Once all
+ * the nodes of the tree are removed, the snapshots are NULL and the next tree stored in @p tree is copied as a whole.
+ * The copies are fully prepared for concurrent reading (see ::lyd_mt_prepare()) before any snapshot of them is taken.
+ *
+ * @param[in,out] tree Pointer to the first sibling of the data tree, kept updated.
+ * @param[out] snapshots Created snapshots provider.
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_snapshots_new(struct lyd_node **tree, struct lyd_snapshots **snapshots);
+
+/**
+ * @brief Take a read-only snapshot of a data tree.
+ *
+ * Must not be called while the tree is being modified, but the snapshot can then be read and released by any thread.
+ * It must not be modified in any way.
+ *
+ * @param[in] snapshots Snapshots provider of the tree.
+ * @param[out] snapshot Snapshot of the current tree, NULL for an empty tree. Must be released
+ * using ::lyd_snapshot_release().
+ * @return LY_ERR value.
+ */
+LIBYANG_API_DECL LY_ERR lyd_snapshot_get(struct lyd_snapshots *snapshots, const struct lyd_node **snapshot);
+
+/**
+ * @brief Release a snapshot, it must not be accessed afterwards.
+ *
+ * @param[in] snapshots Snapshots provider the snapshot was taken from.
+ * @param[in] snapshot Snapshot to release.
+ */
+LIBYANG_API_DECL void lyd_snapshot_release(struct lyd_snapshots *snapshots, const struct lyd_node *snapshot);
+
+/**
+ * @brief Stop providing snapshots of a data tree and free the provider.
+ *
+ * @param[in] snapshots Snapshots provider to free, all its snapshots must have been released.
+ */
+LIBYANG_API_DECL void lyd_snapshots_free(struct lyd_snapshots *snapshots);
+
 /**
  * @brief Deprecated, use ::lyd_find_target() instead.
  *
@@ -2376,6 +2695,8 @@ LIBYANG_API_DECL LY_ERR lyd_find_sibling_first(const struct lyd_node *siblings,
  *              LYS_LIST:
  *                  Searched instance key values in the form of "[key1='val1'][key2='val2']...".
  *                  The keys do not have to be ordered but all of them must be set.
+ *                  Alternatively, the value of an indexed leaf (see ::lysc_node_set_index()) in the form
+ *                  of "[leaf='val']" to find the first instance with this value.
  *
  *              Note that any explicit values (leaf-list or list key values) will be canonized first
  *              before comparison. But values that do not have a canonical value are expected to be in the
@@ -2533,6 +2854,136 @@ LIBYANG_API_DECL LY_ERR lyd_eval_xpath(const struct lyd_node *ctx_node, const ch
 LIBYANG_API_DECL LY_ERR lyd_eval_xpath2(const struct lyd_node *ctx_node, const char *xpath,
         const struct lyxp_var *vars, ly_bool *result);
 
+/**
+ * @brief Compile an XPath for repeated evaluation on data.
+ *
+ * If the context XPath cache is enabled (::ly_ctx_set_xpath_cache()), the compiled expression may be shared
+ * with it. The compiled expression does not depend on the prefixes used in it so it can be evaluated
+ * with any prefix format.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] xpath [XPath](@ref howtoXPath) to compile.
+ * @param[out] exp Compiled expression, free with ::lyd_xpath_free().
+ * @return LY_SUCCESS on success, @p exp is returned.
+ * @return LY_ERR value if an error occurred.
+ */
+LIBYANG_API_DECL LY_ERR lyd_xpath_compile(const struct ly_ctx *ctx, const char *xpath, struct lyxp_expr **exp);
+
+/**
+ * @brief Free an XPath compiled by ::lyd_xpath_compile().
+ *
+ * @param[in] ctx Context used for compiling @p exp.
+ * @param[in] exp Compiled expression to free.
+ */
+LIBYANG_API_DECL void lyd_xpath_free(const struct ly_ctx *ctx, struct lyxp_expr *exp);
+
+/**
+ * @brief Search in the given data for instances of nodes matching the provided compiled XPath.
+ *
+ * It is just ::lyd_find_xpath4() with the expression compiled by ::lyd_xpath_compile().
+ *
+ * @param[in] ctx_node XPath context node, NULL for the root node.
+ * @param[in] tree Data tree to evaluate on.
+ * @param[in] exp Compiled XPath with prefixes in @p format.
+ * @param[in] format Format of any prefixes in @p exp.
+ * @param[in] prefix_data Format-specific prefix data.
+ * @param[in] vars [Sized array](@ref sizedarrays) of XPath variables.
+ * @param[out] set Set of found data nodes. In case the result is a number, a string, or a boolean,
+ * the returned set is empty.
+ * @return LY_SUCCESS on success, @p set is returned.
+ * @return LY_ERR value if an error occurred.
+ */
+LIBYANG_API_DECL LY_ERR lyd_find_xpath_compiled(const struct lyd_node *ctx_node, const struct lyd_node *tree,
+        const struct lyxp_expr *exp, LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars,
+        struct ly_set **set);
+
+/**
+ * @brief Evaluate a compiled XPath on data and return the result converted to boolean.
+ *
+ * It is just ::lyd_eval_xpath2() with the expression compiled by ::lyd_xpath_compile() and @p tree, @p format,
+ * and @p prefix_data added.
+ *
+ * @param[in] ctx_node XPath context node, NULL for the root node.
+ * @param[in] tree Data tree to evaluate on.
+ * @param[in] exp Compiled XPath with prefixes in @p format.
+ * @param[in] format Format of any prefixes in @p exp.
+ * @param[in] prefix_data Format-specific prefix data.
+ * @param[in] vars [Sized array](@ref sizedarrays) of XPath variables.
+ * @param[out] result Expression result converted to boolean.
+ * @return LY_SUCCESS on success, @p result is returned.
+ * @return LY_ERR value if an error occurred.
+ */
+LIBYANG_API_DECL LY_ERR lyd_eval_xpath_compiled(const struct lyd_node *ctx_node, const struct lyd_node *tree,
+        const struct lyxp_expr *exp, LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars,
+        ly_bool *result);
+
+/**
+ * @brief Search in the given data for instances of nodes matching the provided compiled XPath
+ * and profile the evaluation.
+ *
+ * It is ::lyd_find_xpath_compiled() that also measures every evaluated location step and predicate
+ * of @p exp. The printed report has a line for each of them with its position in the expression,
+ * the number of evaluations, the total wall time, the total sizes of the input and result node-sets,
+ * and the way the nodes were accessed (`hash` and `index` for the fast paths, `scan` otherwise,
+ * or `predicate` for a predicate evaluated for every node of its input node-set).
+ *
+ * @param[in] ctx_node XPath context node, NULL for the root node.
+ * @param[in] tree Data tree to evaluate on.
+ * @param[in] exp Compiled XPath with prefixes in @p format.
+ * @param[in] format Format of any prefixes in @p exp.
+ * @param[in] prefix_data Format-specific prefix data.
+ * @param[in] vars [Sized array](@ref sizedarrays) of XPath variables.
+ * @param[out] set Set of found data nodes. In case the result is a number, a string, or a boolean,
+ * the returned set is empty.
+ * @param[out] report Printed profile of the evaluation, it is returned also if the evaluation fails.
+ * @return LY_SUCCESS on success, @p set and @p report are returned.
+ * @return LY_ERR value if an error occurred.
+ */
+LIBYANG_API_DECL LY_ERR lyd_xpath_profile(const struct lyd_node *ctx_node, const struct lyd_node *tree,
+        const struct lyxp_expr *exp, LY_VALUE_FORMAT format, void *prefix_data, const struct lyxp_var *vars,
+        struct ly_set **set, char **report);
+
+/**
+ * @brief Start profiling all the XPath expressions evaluated in this thread.
+ *
+ * Profiled are mainly the must and when conditions evaluated by the data validation, including the validation
+ * performed by the data parsers and by worker threads of ::LYD_VALIDATE_MULTI_THREADED, but also any other
+ * expressions evaluated by the functions working with data, such as ::lyd_find_xpath(). The profiles of all
+ * the evaluations of the same expression on context nodes of the same schema node are summed, each has the same
+ * information as the report of ::lyd_xpath_profile().
+ *
+ * @param[in] ctx Context of the expressions to profile.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL if the profiling was already started in this thread.
+ * @return LY_ERR value on other errors.
+ */
+LIBYANG_API_DECL LY_ERR lyd_xpath_profile_start(const struct ly_ctx *ctx);
+
+/**
+ * @brief Stop profiling the XPath expressions evaluated in this thread, started by ::lyd_xpath_profile_start().
+ *
+ * @param[out] report Optional printed profiles of all the evaluated expressions, the most expensive first.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL if the profiling was not started in this thread.
+ * @return LY_ERR value on other errors.
+ */
+LIBYANG_API_DECL LY_ERR lyd_xpath_profile_stop(char **report);
+
+/**
+ * @brief Print the evaluation plan of a compiled XPath.
+ *
+ * The plan lists the location steps of @p exp with their axes and the expected node access, the predicates,
+ * functions, and operators, nested the same as in the expression. The access of a step actually used depends
+ * on the schema and the data and can be learned from ::lyd_xpath_profile().
+ *
+ * @param[in] ctx Context used for compiling @p exp.
+ * @param[in] exp Compiled XPath.
+ * @param[out] plan Printed plan.
+ * @return LY_SUCCESS on success, @p plan is returned.
+ * @return LY_ERR value if an error occurred.
+ */
+LIBYANG_API_DECL LY_ERR lyd_xpath_explain(const struct ly_ctx *ctx, const struct lyxp_expr *exp, char **plan);
+
 /**
  * @brief Search in given data for a node uniquely identified by a path.
  *
@@ -2551,6 +3002,24 @@ LIBYANG_API_DECL LY_ERR lyd_eval_xpath2(const struct lyd_node *ctx_node, const c
 LIBYANG_API_DECL LY_ERR lyd_find_path(const struct lyd_node *ctx_node, const char *path, ly_bool output,
         struct lyd_node **match);
 
+/**
+ * @brief Search in given data for a node uniquely identified by a path handle.
+ *
+ * Works exactly as ::lyd_find_path() with the path of @p handle and the key values of @p keys in the bound lists,
+ * but only the key values are stored on each call.
+ *
+ * @param[in] ctx_node Path context node, its schema node must be the context node of a relative path.
+ * @param[in] handle Path handle to find.
+ * @param[in] keys Array of key values (const char *) in ::LY_VALUE_JSON format, see ::lyd_path_handle_bind_count().
+ * @param[out] match Can be NULL, otherwise the found data node.
+ * @return LY_SUCCESS on success, @p match is set to the found node.
+ * @return LY_EINCOMPLETE if only a parent of the node was found, @p match is set to this parent node.
+ * @return LY_ENOTFOUND if no nodes in the path were found.
+ * @return LY_ERR on other errors.
+ */
+LIBYANG_API_DECL LY_ERR lyd_find_path_handle(const struct lyd_node *ctx_node, const struct lyd_path_handle *handle,
+        const char **keys, struct lyd_node **match);
+
 /**
  * @brief Find the target node of a compiled path (::lyd_value instance-identifier).
  *
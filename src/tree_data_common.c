@@ -25,6 +25,7 @@
 #include "common.h"
 #include "compat.h"
 #include "context.h"
+#include "diff.h"
 #include "dict.h"
 #include "hash_table.h"
 #include "log.h"
@@ -43,6 +44,26 @@
 #include "xml.h"
 #include "xpath.h"
 
+/**
+ * @brief Duplicate instance cache hash table record.
+ */
+struct lyd_dup_inst_rec {
+    const struct lyd_node *first_inst;  /**< first instance of the item */
+    LY_ARRAY_COUNT_TYPE idx;            /**< index of the item in the cache */
+};
+
+/**
+ * @brief Callback for comparing duplicate instance cache records.
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_dup_inst_rec_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_dup_inst_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return rec1->first_inst == rec2->first_inst;
+}
+
 /**
  * @brief Find an entry in duplicate instance cache for an instance. Create it if it does not exist.
  *
@@ -50,20 +71,34 @@
  * @param[in,out] dup_inst_cache Duplicate instance cache.
  * @return Instance cache entry.
  */
-static struct lyd_dup_inst *
+static struct lyd_dup_inst_item *
 lyd_dup_inst_get(const struct lyd_node *first_inst, struct lyd_dup_inst **dup_inst_cache)
 {
-    struct lyd_dup_inst *item;
-    LY_ARRAY_COUNT_TYPE u;
+    struct lyd_dup_inst *cache;
+    struct lyd_dup_inst_item *item;
+    struct lyd_dup_inst_rec rec, *match;
+    uint32_t hash;
 
-    LY_ARRAY_FOR(*dup_inst_cache, u) {
-        if ((*dup_inst_cache)[u].inst_set->dnodes[0] == first_inst) {
-            return &(*dup_inst_cache)[u];
-        }
+    if (!*dup_inst_cache) {
+        /* create the cache */
+        *dup_inst_cache = calloc(1, sizeof **dup_inst_cache);
+        LY_CHECK_RET(!*dup_inst_cache, NULL);
+        (*dup_inst_cache)->ht = lyht_new(LYHT_MIN_SIZE, sizeof rec, lyd_dup_inst_rec_equal_cb, NULL, 1);
+        LY_CHECK_RET(!(*dup_inst_cache)->ht, NULL);
+    }
+    cache = *dup_inst_cache;
+
+    rec.first_inst = first_inst;
+    hash = dict_hash_multi(0, (const char *)&first_inst, sizeof first_inst);
+    hash = dict_hash_multi(hash, NULL, 0);
+    if (!lyht_find(cache->ht, &rec, hash, (void **)&match)) {
+        return &cache->items[match->idx];
     }
 
     /* it was not added yet, add it now */
-    LY_ARRAY_NEW_RET(LYD_CTX(first_inst), *dup_inst_cache, item, NULL);
+    rec.idx = LY_ARRAY_COUNT(cache->items);
+    LY_ARRAY_NEW_RET(LYD_CTX(first_inst), cache->items, item, NULL);
+    LY_CHECK_RET(lyht_insert(cache->ht, &rec, hash, NULL), NULL);
 
     return item;
 }
@@ -71,7 +106,7 @@ lyd_dup_inst_get(const struct lyd_node *first_inst, struct lyd_dup_inst **dup_in
 LY_ERR
 lyd_dup_inst_next(struct lyd_node **inst, const struct lyd_node *siblings, struct lyd_dup_inst **dup_inst_cache)
 {
-    struct lyd_dup_inst *dup_inst;
+    struct lyd_dup_inst_item *dup_inst;
 
     if (!*inst) {
         /* no match, inst is unchanged */
@@ -110,10 +145,16 @@ lyd_dup_inst_free(struct lyd_dup_inst *dup_inst)
 {
     LY_ARRAY_COUNT_TYPE u;
 
-    LY_ARRAY_FOR(dup_inst, u) {
-        ly_set_free(dup_inst[u].inst_set, NULL);
+    if (!dup_inst) {
+        return;
     }
-    LY_ARRAY_FREE(dup_inst);
+
+    LY_ARRAY_FOR(dup_inst->items, u) {
+        ly_set_free(dup_inst->items[u].inst_set, NULL);
+    }
+    LY_ARRAY_FREE(dup_inst->items);
+    lyht_free(dup_inst->ht);
+    free(dup_inst);
 }
 
 struct lyd_node *
@@ -122,6 +163,7 @@ lys_getnext_data(const struct lyd_node *last, const struct lyd_node *sibling, co
 {
     const struct lysc_node *siter = NULL;
     struct lyd_node *match = NULL;
+    LY_ARRAY_COUNT_TYPE sidx = 0;
 
     assert(parent || module);
     assert(!last || (slast && *slast));
@@ -136,7 +178,7 @@ lys_getnext_data(const struct lyd_node *last, const struct lyd_node *sibling, co
     }
 
     /* find next schema node data instance */
-    while ((siter = lys_getnext(siter, parent, module, 0))) {
+    while ((siter = lys_getnext_idx(siter, parent, module, 0, &sidx))) {
         if (!lyd_find_sibling_val(sibling, siter, NULL, 0, &match)) {
             break;
         }
@@ -430,10 +472,16 @@ lyd_value_validate_incomplete(const struct ly_ctx *ctx, const struct lysc_type *
 {
     LY_ERR ret;
     struct ly_err_item *err = NULL;
+    uint64_t start;
 
     assert(type->plugin->validate);
 
+    start = lyd_val_stats_start(ctx);
     ret = type->plugin->validate(ctx, type, ctx_node, tree, val, &err);
+    if (ctx_node && ctx_node->schema) {
+        lyd_val_stats_record(ctx, ctx_node->schema, (type->basetype == LY_TYPE_LEAFREF) ? LYD_VAL_STAT_LEAFREF :
+                LYD_VAL_STAT_TYPE, start);
+    }
     if (ret) {
         if (err) {
             LOGVAL_ERRITEM(ctx, err);
@@ -651,6 +699,12 @@ lyd_list_pos(const struct lyd_node *instance)
         return 0;
     }
 
+    if (instance->parent && instance->parent->children_ht &&
+            !lyd_find_sibling_schema(instance, instance->schema, (struct lyd_node **)&iter)) {
+        /* the first instance is found in the hash table, instances are consecutive siblings */
+        return instance->order - iter->order + 1;
+    }
+
     /* data instances are ordered, so we can stop when we found instance of other schema node */
     for (iter = instance; iter->schema == instance->schema; iter = iter->prev) {
         if (pos && (iter->next == NULL)) {
@@ -663,6 +717,163 @@ lyd_list_pos(const struct lyd_node *instance)
     return pos;
 }
 
+/**
+ * @brief Find out which part of siblings around a position is shorter.
+ *
+ * Both parts are traversed at once so that only the shorter one is walked.
+ *
+ * @param[in] prev Last node of the preceding part.
+ * @param[in] next First node of the following part.
+ * @return Last sibling if the following part is shorter, first sibling otherwise.
+ */
+static const struct lyd_node *
+lyd_order_shorter(const struct lyd_node *prev, const struct lyd_node *next)
+{
+    while (prev->prev->next && next->next) {
+        prev = prev->prev;
+        next = next->next;
+    }
+
+    return next->next ? prev : next;
+}
+
+/**
+ * @brief Shift the positions of siblings.
+ *
+ * @param[in] node First node to shift.
+ * @param[in] forward Whether to shift @p node and all the following siblings or all the preceding siblings.
+ * @param[in] diff Difference to add to the positions.
+ */
+static void
+lyd_order_shift(struct lyd_node *node, ly_bool forward, int32_t diff)
+{
+    while (node) {
+        node->order += diff;
+        if (forward) {
+            node = node->next;
+        } else {
+            node = node->prev->next ? node->prev : NULL;
+        }
+    }
+}
+
+/**
+ * @brief Renumber all the siblings so that their positions are centered around ::LYD_ORDER_MID.
+ *
+ * @param[in] node Any sibling.
+ */
+static void
+lyd_order_renumber(struct lyd_node *node)
+{
+    struct lyd_node *first, *iter;
+    uint32_t count = 0;
+
+    first = lyd_first_sibling(node);
+    LY_LIST_FOR(first, iter) {
+        ++count;
+    }
+
+    count = LYD_ORDER_MID - count / 2;
+    LY_LIST_FOR(first, iter) {
+        iter->order = count++;
+    }
+}
+
+void
+lyd_order_insert(struct lyd_node *node)
+{
+    struct lyd_node *prev, *next;
+    const struct lyd_node *end;
+
+    prev = node->prev->next ? node->prev : NULL;
+    next = node->next;
+
+    if (!prev && !next) {
+        /* only node */
+        node->order = LYD_ORDER_MID;
+    } else if (!next && (prev->order < UINT32_MAX)) {
+        /* appended */
+        node->order = prev->order + 1;
+    } else if (!prev && next->order) {
+        /* prepended */
+        node->order = next->order - 1;
+    } else if (prev && next) {
+        /* make room by shifting the shorter part of the siblings */
+        end = lyd_order_shorter(prev, next);
+        if (!end->next && (end->order < UINT32_MAX)) {
+            lyd_order_shift(next, 1, 1);
+            node->order = prev->order + 1;
+        } else if (end->next && end->order) {
+            lyd_order_shift(prev, 0, -1);
+            node->order = next->order - 1;
+        } else {
+            lyd_order_renumber(node);
+        }
+    } else {
+        /* no room at the edge */
+        lyd_order_renumber(node);
+    }
+}
+
+void
+lyd_order_unlink(struct lyd_node *node)
+{
+    struct lyd_node *prev, *next;
+
+    prev = node->prev->next ? node->prev : NULL;
+    next = node->next;
+    if (!prev || !next) {
+        /* removing the first or the last sibling keeps the positions consecutive */
+        return;
+    }
+
+    /* close the gap by shifting the shorter part of the siblings */
+    if (!lyd_order_shorter(prev, next)->next) {
+        lyd_order_shift(next, 1, -1);
+    } else {
+        lyd_order_shift(prev, 0, 1);
+    }
+}
+
+int
+lyd_order_cmp(const struct lyd_node *node1, const struct lyd_node *node2)
+{
+    const struct lyd_node *iter;
+    uint32_t depth1 = 0, depth2 = 0;
+
+    if (node1 == node2) {
+        return 0;
+    }
+
+    /* get both nodes to the same depth, an ancestor is before its descendants */
+    for (iter = node1; iter->parent; iter = lyd_parent(iter)) {
+        ++depth1;
+    }
+    for (iter = node2; iter->parent; iter = lyd_parent(iter)) {
+        ++depth2;
+    }
+    for ( ; depth1 > depth2; --depth1) {
+        node1 = lyd_parent(node1);
+        if (node1 == node2) {
+            return 1;
+        }
+    }
+    for ( ; depth2 > depth1; --depth2) {
+        node2 = lyd_parent(node2);
+        if (node1 == node2) {
+            return -1;
+        }
+    }
+
+    /* find the siblings with a common parent */
+    while (node1->parent != node2->parent) {
+        node1 = lyd_parent(node1);
+        node2 = lyd_parent(node2);
+    }
+
+    return (node1->order < node2->order) ? -1 : 1;
+}
+
 LIBYANG_API_DEF struct lyd_node *
 lyd_first_sibling(const struct lyd_node *node)
 {
@@ -911,12 +1122,21 @@ cleanup:
 LIBYANG_API_DEF LY_ERR
 lyd_any_copy_value(struct lyd_node *trg, const union lyd_any_value *value, LYD_ANYDATA_VALUETYPE value_type)
 {
+    LY_ERR ret = LY_SUCCESS;
     struct lyd_node_any *t;
+    struct lyd_journal *journal = NULL;
+    char *orig_value = NULL;
 
     LY_CHECK_ARG_RET(NULL, trg, LY_EINVAL);
     LY_CHECK_ARG_RET(NULL, trg->schema, trg->schema->nodetype & LYS_ANYDATA, LY_EINVAL);
 
     t = (struct lyd_node_any *)trg;
+    lyd_hash_subtree_invalidate(trg);
+
+    if (value && (journal = lyd_journal_get(trg))) {
+        /* remember the original value for the journal */
+        LY_CHECK_RET(lyd_any_value_str(trg, &orig_value));
+    }
 
     /* free trg */
     switch (t->value_type) {
@@ -944,28 +1164,35 @@ lyd_any_copy_value(struct lyd_node *trg, const union lyd_any_value *value, LYD_A
     switch (value_type) {
     case LYD_ANYDATA_DATATREE:
         if (value->tree) {
-            LY_CHECK_RET(lyd_dup_siblings(value->tree, NULL, LYD_DUP_RECURSIVE, &t->value.tree));
+            LY_CHECK_GOTO(ret = lyd_dup_siblings(value->tree, NULL, LYD_DUP_RECURSIVE, &t->value.tree), cleanup);
         }
         break;
     case LYD_ANYDATA_STRING:
     case LYD_ANYDATA_XML:
     case LYD_ANYDATA_JSON:
         if (value->str) {
-            LY_CHECK_RET(lydict_insert(LYD_CTX(trg), value->str, 0, &t->value.str));
+            LY_CHECK_GOTO(ret = lydict_insert(LYD_CTX(trg), value->str, 0, &t->value.str), cleanup);
         }
         break;
     case LYD_ANYDATA_LYB:
         if (value->mem) {
             int len = lyd_lyb_data_length(value->mem);
-            LY_CHECK_RET(len == -1, LY_EINVAL);
+            LY_CHECK_ERR_GOTO(len == -1, ret = LY_EINVAL, cleanup);
             t->value.mem = malloc(len);
-            LY_CHECK_ERR_RET(!t->value.mem, LOGMEM(LYD_CTX(trg)), LY_EMEM);
+            LY_CHECK_ERR_GOTO(!t->value.mem, LOGMEM(LYD_CTX(trg)); ret = LY_EMEM, cleanup);
             memcpy(t->value.mem, value->mem, len);
         }
         break;
     }
 
-    return LY_SUCCESS;
+    if (journal) {
+        /* record the change */
+        lyd_journal_replace(journal, trg, orig_value, 0);
+    }
+
+cleanup:
+    free(orig_value);
+    return ret;
 }
 
 const struct lysc_node *
@@ -1575,3 +1802,29 @@ ly_time_ts2str(const struct timespec *ts, char **str)
 
     return ly_time_time2str(ts->tv_sec, ts->tv_nsec ? frac_buf : NULL, str);
 }
+
+LIBYANG_API_DEF void
+lyd_mt_prepare(const struct lyd_node *tree, ly_bool with_meta)
+{
+    const struct lyd_node *first, *iter, *elem;
+    const struct lyd_meta *meta;
+
+    if (!tree) {
+        return;
+    }
+    first = lyd_first_sibling(tree);
+
+    LY_LIST_FOR(first, iter) {
+        LYD_TREE_DFS_BEGIN(iter, elem) {
+            if (elem->schema && (elem->schema->nodetype & LYD_NODE_TERM)) {
+                lyd_get_value(elem);
+            }
+            if (with_meta) {
+                LY_LIST_FOR(elem->meta, meta) {
+                    lyd_get_meta_value(meta);
+                }
+            }
+            LYD_TREE_DFS_END(iter, elem);
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 
 #include "common.h"
+#include "diff.h"
 #include "dict.h"
 #include "hash_table.h"
 #include "log.h"
@@ -70,12 +71,24 @@ lyd_free_meta(struct lyd_meta *meta, ly_bool siblings)
 LIBYANG_API_DEF void
 lyd_free_meta_single(struct lyd_meta *meta)
 {
+    struct lyd_journal *journal;
+
+    if (meta && meta->parent && (journal = lyd_journal_get(meta->parent))) {
+        lyd_journal_meta(journal, meta->parent);
+    }
+
     lyd_free_meta(meta, 0);
 }
 
 LIBYANG_API_DEF void
 lyd_free_meta_siblings(struct lyd_meta *meta)
 {
+    struct lyd_journal *journal;
+
+    if (meta && meta->parent && (journal = lyd_journal_get(meta->parent))) {
+        lyd_journal_meta(journal, meta->parent);
+    }
+
     lyd_free_meta(meta, 1);
 }
 
@@ -150,6 +163,12 @@ lyd_free_subtree(struct lyd_node *node, ly_bool top)
 
     assert(node);
 
+    /* unlink only the nodes from the first level, nodes in subtree are freed all, so no unlink is needed,
+     * unlink first so that the parent hash tables can still access the subtree */
+    if (top) {
+        lyd_unlink_tree(node);
+    }
+
     if (!node->schema) {
         opaq = (struct lyd_node_opaq *)node;
 
@@ -167,6 +186,8 @@ lyd_free_subtree(struct lyd_node *node, ly_bool top)
         /* remove children hash table in case of inner data node */
         lyht_free(((struct lyd_node_inner *)node)->children_ht);
         ((struct lyd_node_inner *)node)->children_ht = NULL;
+        lyht_free(((struct lyd_node_inner *)node)->index_ht);
+        ((struct lyd_node_inner *)node)->index_ht = NULL;
 
         /* free the children */
         LY_LIST_FOR_SAFE(lyd_child(node), next, iter) {
@@ -183,12 +204,7 @@ lyd_free_subtree(struct lyd_node *node, ly_bool top)
         lyd_free_attr_siblings(LYD_CTX(node), opaq->attr);
     } else {
         /* free the node's metadata */
-        lyd_free_meta_siblings(node->meta);
-    }
-
-    /* unlink only the nodes from the first level, nodes in subtree are freed all, so no unlink is needed */
-    if (top) {
-        lyd_unlink_tree(node);
+        lyd_free_meta(node->meta, 1);
     }
 
     free(node);
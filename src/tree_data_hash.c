@@ -22,8 +22,10 @@
 #include "hash_table.h"
 #include "log.h"
 #include "plugins_types.h"
+#include "set.h"
 #include "tree.h"
 #include "tree_data.h"
+#include "tree_data_internal.h"
 #include "tree_schema.h"
 
 LY_ERR
@@ -165,6 +167,12 @@ lyd_insert_hash(struct lyd_node *node)
     struct lyd_node *iter;
     uint32_t u;
 
+    /* the parent subtree hashes are no longer valid */
+    lyd_hash_subtree_invalidate(lyd_parent(node));
+
+    /* insert into the parent index, if any */
+    LY_CHECK_RET(lyd_insert_index(node));
+
     if (!node->parent || !node->schema || !node->parent->schema) {
         /* nothing to do */
         return LY_SUCCESS;
@@ -197,11 +205,58 @@ lyd_insert_hash(struct lyd_node *node)
     return LY_SUCCESS;
 }
 
+LY_ERR
+lyd_insert_hash_reserve(struct lyd_node *parent, uint32_t count)
+{
+    struct lyd_node_inner *par = (struct lyd_node_inner *)parent;
+    struct lyd_node *iter;
+    uint32_t u;
+
+    if (!parent || !parent->schema || !(parent->schema->nodetype & LYD_NODE_INNER)) {
+        /* no hash table */
+        return LY_SUCCESS;
+    }
+
+    if (par->children_ht) {
+        /* the nodes and possibly a first (leaf-)list instance */
+        return lyht_reserve(par->children_ht, count + 1);
+    }
+
+    u = 0;
+    LY_LIST_FOR(par->child, iter) {
+        if (iter->schema) {
+            ++u;
+        }
+    }
+    if (u + count < LYD_HT_MIN_ITEMS) {
+        /* the hash table will not be needed */
+        return LY_SUCCESS;
+    }
+
+    /* create the hash table of the final size, insert all the current children */
+    par->children_ht = lyht_new(1, sizeof(struct lyd_node *), lyd_hash_table_val_equal, NULL, 1);
+    LY_CHECK_ERR_RET(!par->children_ht, LOGMEM(LYD_CTX(parent)), LY_EMEM);
+    LY_CHECK_RET(lyht_reserve(par->children_ht, 2 * u + count + 1));
+    LY_LIST_FOR(par->child, iter) {
+        if (iter->schema) {
+            LY_CHECK_RET(lyd_insert_hash_add(par->children_ht, iter, 1));
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
 void
 lyd_unlink_hash(struct lyd_node *node)
 {
     uint32_t hash;
 
+    /* the parent subtree hashes are no longer valid */
+    lyd_hash_subtree_invalidate(lyd_parent(node));
+
+    /* remove from the parent index, if any */
+    lyd_unlink_index(node);
+
     if (!node->parent || !node->schema || !node->parent->schema || !node->parent->children_ht) {
         /* not in any HT */
         return;
@@ -235,3 +290,453 @@ lyd_unlink_hash(struct lyd_node *node)
         }
     }
 }
+
+/**
+ * @brief Get hash of an indexed leaf in the index, made up from its schema and canonical value.
+ *
+ * @param[in] leaf Indexed leaf.
+ * @return Leaf index hash.
+ */
+static uint32_t
+lyd_index_hash(const struct lyd_node *leaf)
+{
+    const char *value;
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, leaf->schema->module->name, strlen(leaf->schema->module->name));
+    hash = dict_hash_multi(hash, leaf->schema->name, strlen(leaf->schema->name));
+    value = lyd_get_value(leaf);
+    if (value) {
+        hash = dict_hash_multi(hash, value, strlen(value));
+    }
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Compare callback for values in the index hash table.
+ *
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_index_val_equal(void *val1_p, void *val2_p, ly_bool mod, void *UNUSED(cb_data))
+{
+    struct lyd_node *val1, *val2;
+
+    val1 = *((struct lyd_node **)val1_p);
+    val2 = *((struct lyd_node **)val2_p);
+
+    if (mod) {
+        /* exact leaf instance */
+        return val1 == val2;
+    }
+
+    /* leafs with the same value */
+    return !lyd_compare_single(val1, val2, 0);
+}
+
+/**
+ * @brief Get the node with the index an indexed leaf belongs to.
+ *
+ * @param[in] leaf Indexed leaf.
+ * @return Parent of the list instance of @p leaf, NULL if the leaf is not in any index.
+ */
+static struct lyd_node_inner *
+lyd_index_parent(const struct lyd_node *leaf)
+{
+    struct lyd_node_inner *list = leaf->parent;
+
+    if (!list || !list->schema || !list->parent || !list->parent->schema) {
+        return NULL;
+    }
+    return list->parent;
+}
+
+/**
+ * @brief Check whether the index of a node includes all the indexed leafs of its child list instances.
+ *
+ * The index stores the number of indexes declared when it was built as the callback data, an index built before
+ * declaring another one lacks the leafs of the instances created before.
+ *
+ * @param[in] parent Node with the index.
+ * @return Whether the index is complete.
+ */
+static ly_bool
+lyd_index_is_complete(const struct lyd_node_inner *parent)
+{
+    return parent->index_ht && ((uintptr_t)parent->index_ht->cb_data == LYD_CTX(parent)->index_gen);
+}
+
+/**
+ * @brief Add an indexed leaf into an index.
+ *
+ * @param[in] ht Index hash table.
+ * @param[in] leaf Indexed leaf to add.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_index_add(struct hash_table *ht, struct lyd_node *leaf)
+{
+    LY_ERR r;
+
+    /* the leaf may already be there if the list instance is being rehashed */
+    r = lyht_insert(ht, &leaf, lyd_index_hash(leaf), NULL);
+    if (r && (r != LY_EEXIST)) {
+        LOGINT_RET(LYD_CTX(leaf));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Build the index of a node from all the indexed leafs of its child list instances.
+ *
+ * @param[in] parent Node to build the index of, any previous index is replaced.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_index_build(struct lyd_node_inner *parent)
+{
+    struct hash_table *ht;
+    struct lyd_node *inst, *iter;
+
+    ht = lyht_new(1, sizeof(struct lyd_node *), lyd_index_val_equal,
+            (void *)(uintptr_t)LYD_CTX(parent)->index_gen, 1);
+    LY_CHECK_ERR_RET(!ht, LOGMEM(LYD_CTX(parent)), LY_EMEM);
+
+    LY_LIST_FOR(parent->child, inst) {
+        if (!inst->schema || (inst->schema->nodetype != LYS_LIST) || !(inst->schema->flags & LYS_INDEXED)) {
+            continue;
+        }
+        LY_LIST_FOR(lyd_child(inst), iter) {
+            if (iter->schema && (iter->schema->flags & LYS_INDEXED) && lyd_index_add(ht, iter)) {
+                lyht_free(ht);
+                return LY_EINT;
+            }
+        }
+    }
+
+    lyht_free(parent->index_ht);
+    parent->index_ht = ht;
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lyd_insert_index(struct lyd_node *node)
+{
+    struct lyd_node_inner *parent;
+    struct lyd_node *iter;
+
+    if (!node->schema || !(node->schema->flags & LYS_INDEXED)) {
+        /* nothing to index */
+        return LY_SUCCESS;
+    }
+
+    if (node->schema->nodetype == LYS_LEAF) {
+        parent = lyd_index_parent(node);
+    } else {
+        assert(node->schema->nodetype == LYS_LIST);
+        parent = (node->parent && node->parent->schema) ? node->parent : NULL;
+    }
+    if (!parent) {
+        /* not in any index */
+        return LY_SUCCESS;
+    }
+
+    if (!lyd_index_is_complete(parent)) {
+        /* new index or some instances were created before the index was declared, index all of them */
+        return lyd_index_build(parent);
+    }
+
+    if (node->schema->nodetype == LYS_LEAF) {
+        LY_CHECK_RET(lyd_index_add(parent->index_ht, node));
+    } else {
+        /* list instance, add all its indexed leafs */
+        LY_LIST_FOR(lyd_child(node), iter) {
+            if (iter->schema && (iter->schema->flags & LYS_INDEXED)) {
+                LY_CHECK_RET(lyd_index_add(parent->index_ht, iter));
+            }
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+void
+lyd_unlink_index(struct lyd_node *node)
+{
+    struct lyd_node_inner *parent;
+    struct lyd_node *iter;
+
+    if (!node->schema || !(node->schema->flags & LYS_INDEXED)) {
+        /* nothing indexed */
+        return;
+    }
+
+    if (node->schema->nodetype == LYS_LEAF) {
+        parent = lyd_index_parent(node);
+        if (parent && parent->index_ht) {
+            lyht_remove(parent->index_ht, &node, lyd_index_hash(node));
+        }
+    } else if (node->parent && node->parent->schema && node->parent->index_ht) {
+        /* list instance, remove all its indexed leafs */
+        assert(node->schema->nodetype == LYS_LIST);
+        LY_LIST_FOR(lyd_child(node), iter) {
+            if (iter->schema && (iter->schema->flags & LYS_INDEXED)) {
+                lyht_remove(node->parent->index_ht, &iter, lyd_index_hash(iter));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Collect list instances with a specific value of an indexed leaf by going through the instances.
+ *
+ * @param[in] siblings Any sibling of the instances.
+ * @param[in] list List schema node.
+ * @param[in] leaf Indexed leaf with the value to find.
+ * @param[in] count Number of instances to find at most.
+ * @param[in,out] set Set to add the found list instances to.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_index_collect(const struct lyd_node *siblings, const struct lysc_node *list, const struct lyd_node *leaf,
+        uint32_t count, struct ly_set *set)
+{
+    struct lyd_node *iter, *child;
+
+    LYD_LIST_FOR_INST(siblings, list, iter) {
+        if (!count) {
+            break;
+        }
+
+        lyd_find_sibling_val(lyd_child(iter), leaf->schema, NULL, 0, &child);
+        if (child && !lyd_compare_single(child, leaf, 0)) {
+            LY_CHECK_RET(ly_set_add(set, (void *)iter, 1, NULL));
+            --count;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lyd_find_index(const struct lyd_node *siblings, const struct lyd_node *leaf, ly_bool first, struct ly_set *set)
+{
+    const struct lyd_node *parent;
+    struct hash_table *ht;
+    struct lyd_node **match_p, *iter, *inst;
+    const struct lysc_node *list;
+    uint32_t hash, count, prev_count = set->count;
+
+    assert(leaf->schema && (leaf->schema->flags & LYS_INDEXED));
+
+    if (!siblings) {
+        return LY_ENOTFOUND;
+    }
+
+    list = lysc_data_parent(leaf->schema);
+    parent = lyd_parent(siblings);
+    if (!parent || !parent->schema || !lyd_index_is_complete((struct lyd_node_inner *)parent)) {
+        /* no index or some instances may have been created before the index was declared and the index was not
+         * built yet, go through all the instances */
+        LY_CHECK_RET(lyd_index_collect(siblings, list, leaf, first ? 1 : UINT32_MAX, set));
+        return (set->count > prev_count) ? LY_SUCCESS : LY_ENOTFOUND;
+    }
+    ht = ((struct lyd_node_inner *)parent)->index_ht;
+
+    /* find the first matching leaf */
+    hash = lyd_index_hash(leaf);
+    if (lyht_find(ht, (void *)&leaf, hash, (void **)&match_p)) {
+        return LY_ENOTFOUND;
+    }
+
+    /* count all the matching leafs */
+    count = 1;
+    inst = lyd_parent(*match_p);
+    iter = *match_p;
+    while (!lyht_find_next(ht, &iter, hash, (void **)&match_p)) {
+        iter = *match_p;
+        ++count;
+    }
+
+    if (count == 1) {
+        /* the only instance */
+        LY_CHECK_RET(ly_set_add(set, inst, 1, NULL));
+        return LY_SUCCESS;
+    }
+
+    /* several instances, the HT order is random so collect them in the data order starting from the first
+     * list instance, only until all of them are found */
+    LY_CHECK_RET(lyd_index_collect(siblings, list, leaf, first ? 1 : count, set));
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Offset basis of the 64-bit FNV-1a hash used for subtree hashes.
+ */
+#define LYD_HASH_SUBTREE_BASIS 0xcbf29ce484222325ULL
+
+/**
+ * @brief Prime of the 64-bit FNV-1a hash used for subtree hashes.
+ */
+#define LYD_HASH_SUBTREE_PRIME 0x100000001b3ULL
+
+/**
+ * @brief Add data into a subtree hash.
+ *
+ * @param[in] data Data to add.
+ * @param[in] len Length of @p data.
+ * @param[in,out] hash Subtree hash to update.
+ */
+static void
+lyd_hash_subtree_data(const void *data, size_t len, uint64_t *hash)
+{
+    const uint8_t *ptr = data;
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        *hash ^= ptr[i];
+        *hash *= LYD_HASH_SUBTREE_PRIME;
+    }
+}
+
+/**
+ * @brief Add a string including its terminating zero into a subtree hash.
+ *
+ * @param[in] str String to add, NULL is added as an empty string.
+ * @param[in,out] hash Subtree hash to update.
+ */
+static void
+lyd_hash_subtree_str(const char *str, uint64_t *hash)
+{
+    if (!str) {
+        str = "";
+    }
+    lyd_hash_subtree_data(str, strlen(str) + 1, hash);
+}
+
+/**
+ * @brief Finish a subtree hash by mixing all its bits (MurmurHash3 finalizer).
+ *
+ * @param[in] hash Subtree hash.
+ * @return Finished subtree hash.
+ */
+static uint64_t
+lyd_hash_subtree_finish(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief Add subtree hashes of all the siblings, in their order, into a subtree hash.
+ *
+ * @param[in] first First sibling.
+ * @param[in,out] hash Subtree hash to update.
+ */
+static void
+lyd_hash_subtree_siblings(const struct lyd_node *first, uint64_t *hash)
+{
+    const struct lyd_node *iter;
+    uint64_t child_hash;
+
+    LY_LIST_FOR(first, iter) {
+        child_hash = lyd_hash_subtree(iter);
+        lyd_hash_subtree_data(&child_hash, sizeof child_hash, hash);
+    }
+}
+
+uint64_t
+lyd_hash_subtree(const struct lyd_node *node)
+{
+    struct lyd_node_inner *inner = NULL;
+    const struct lyd_node_opaq *opaq;
+    const struct lyd_node_any *any;
+    uint64_t hash = LYD_HASH_SUBTREE_BASIS;
+    char dflt;
+    int len;
+
+    if (node->schema && (node->schema->nodetype & LYD_NODE_INNER)) {
+        inner = (struct lyd_node_inner *)node;
+        if (inner->subtree_hash) {
+            /* cached */
+            return inner->subtree_hash;
+        }
+    }
+
+    if (!node->schema) {
+        opaq = (const struct lyd_node_opaq *)node;
+        lyd_hash_subtree_str(opaq->name.name, &hash);
+        lyd_hash_subtree_str(opaq->name.module_ns, &hash);
+        lyd_hash_subtree_data(&opaq->format, sizeof opaq->format, &hash);
+        if (opaq->format == LY_VALUE_JSON) {
+            /* XML values are compared with resolved prefixes, so they cannot be hashed as strings */
+            lyd_hash_subtree_str(opaq->value, &hash);
+        }
+        lyd_hash_subtree_siblings(opaq->child, &hash);
+    } else {
+        lyd_hash_subtree_str(node->schema->module->name, &hash);
+        lyd_hash_subtree_str(node->schema->name, &hash);
+
+        if (node->schema->nodetype & LYD_NODE_TERM) {
+            lyd_hash_subtree_str(lyd_get_value(node), &hash);
+            dflt = (node->flags & LYD_DEFAULT) ? 1 : 0;
+            lyd_hash_subtree_data(&dflt, 1, &hash);
+        } else if (node->schema->nodetype & LYD_NODE_ANY) {
+            any = (const struct lyd_node_any *)node;
+            lyd_hash_subtree_data(&any->value_type, sizeof any->value_type, &hash);
+            switch (any->value_type) {
+            case LYD_ANYDATA_DATATREE:
+                lyd_hash_subtree_siblings(any->value.tree, &hash);
+                break;
+            case LYD_ANYDATA_STRING:
+            case LYD_ANYDATA_XML:
+            case LYD_ANYDATA_JSON:
+                lyd_hash_subtree_str(any->value.str, &hash);
+                break;
+            case LYD_ANYDATA_LYB:
+                len = any->value.mem ? lyd_lyb_data_length(any->value.mem) : 0;
+                if (len > 0) {
+                    lyd_hash_subtree_data(any->value.mem, len, &hash);
+                }
+                break;
+            }
+        } else {
+            lyd_hash_subtree_siblings(lyd_child(node), &hash);
+        }
+    }
+
+    hash = lyd_hash_subtree_finish(hash);
+    if (!hash) {
+        /* 0 means not cached */
+        hash = 1;
+    }
+
+    if (inner) {
+        inner->subtree_hash = hash;
+    }
+    return hash;
+}
+
+void
+lyd_hash_subtree_invalidate(struct lyd_node *node)
+{
+    struct lyd_node_inner *inner;
+
+    for ( ; node; node = lyd_parent(node)) {
+        if (!node->schema || !(node->schema->nodetype & LYD_NODE_INNER)) {
+            continue;
+        }
+
+        inner = (struct lyd_node_inner *)node;
+        if (!inner->subtree_hash) {
+            /* a hash is always generated for the whole subtree so no parents can have it */
+            break;
+        }
+        inner->subtree_hash = 0;
+    }
+}
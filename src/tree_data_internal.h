@@ -21,6 +21,7 @@
 
 #include <stddef.h>
 
+struct hash_table;
 struct ly_path_predicate;
 struct lyd_ctx;
 struct lysc_module;
@@ -35,11 +36,30 @@ struct lysc_module;
 /**
  * @brief Internal structure for remembering "used" instances of lists with duplicate instances allowed.
  */
-struct lyd_dup_inst {
+struct lyd_dup_inst_item {
     struct ly_set *inst_set;
     uint32_t used;
 };
 
+/**
+ * @brief Duplicate instance cache, items are found by their first instance using a hash table.
+ */
+struct lyd_dup_inst {
+    struct lyd_dup_inst_item *items;    /**< sized array of cached instance sets ([sized array](@ref sizedarrays)) */
+    struct hash_table *ht;              /**< hash table of the item indexes with the first instance as the key */
+};
+
+/**
+ * @brief Compiled path handle, see ::lyd_path_handle_new().
+ */
+struct lyd_path_handle {
+    const struct ly_ctx *ctx;           /**< context of the compiled path */
+    const struct lysc_node *ctx_node;   /**< context node of a relative path, NULL for an absolute path */
+    char *str_path;                     /**< original path, used for logging */
+    struct ly_path *path;               /**< compiled path template, key-predicates of the bound lists are missing */
+    uint32_t bind_count;                /**< number of key values to bind */
+};
+
 /**
  * @brief Update a found inst using a duplicate instance cache. Needs to be called for every "used"
  * (that should not be considered next time) instance.
@@ -353,6 +373,24 @@ LY_ERR lyd_new_implicit_r(struct lyd_node *parent, struct lyd_node **first, cons
         const struct lys_module *mod, struct ly_set *node_when, struct ly_set *node_types, uint32_t impl_opts,
         struct lyd_node **diff);
 
+/**
+ * @brief Create a compiled path from a path handle by binding key values to its lists without predicates.
+ *
+ * @param[in] handle Path handle to use.
+ * @param[in] keys Array of ::lyd_path_handle.bind_count key values in ::LY_VALUE_JSON format.
+ * @param[out] path Compiled path sharing the unbound segments with the handle, free with ::lyd_path_handle_unbind().
+ * @return LY_ERR value.
+ */
+LY_ERR lyd_path_handle_bind(const struct lyd_path_handle *handle, const char **keys, struct ly_path **path);
+
+/**
+ * @brief Free a compiled path created by ::lyd_path_handle_bind().
+ *
+ * @param[in] handle Path handle used for binding.
+ * @param[in] path Compiled path to free.
+ */
+void lyd_path_handle_unbind(const struct lyd_path_handle *handle, struct ly_path *path);
+
 /**
  * @brief Find the next node, before which to insert the new node.
  *
@@ -393,6 +431,58 @@ void lyd_insert_before_node(struct lyd_node *sibling, struct lyd_node *node);
  */
 void lyd_insert_node(struct lyd_node *parent, struct lyd_node **first_sibling, struct lyd_node *node, ly_bool last);
 
+/**
+ * @brief Insert a run of nodes of the same schema into parent/siblings. Order and hashes are fully handled.
+ *
+ * The anchor is found and the parent hash table resized only once for all the nodes, which keep their relative order.
+ *
+ * @param[in] parent Parent to insert into, NULL for top-level sibling.
+ * @param[in,out] first_sibling First sibling, NULL if no top-level sibling exist yet. Can be also NULL if @p parent
+ * is set.
+ * @param[in] nodes Array of individual nodes (without siblings) to insert, all instances of the same schema node.
+ * @param[in] count Count of @p nodes.
+ * @param[in] check_dup Whether to fail if an equal instance of a list or leaf-list (except duplicate-instance ones)
+ * already exists. No nodes are inserted in this case.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL if the nodes cannot be inserted into @p parent.
+ * @return LY_EEXIST if a duplicate instance was found.
+ * @return LY_EMEM on memory allocation failure.
+ */
+LY_ERR lyd_insert_node_run(struct lyd_node *parent, struct lyd_node **first_sibling, struct lyd_node **nodes,
+        uint32_t count, ly_bool check_dup);
+
+/**
+ * @brief Position (::lyd_node.order) of an only node, sibling positions are kept consecutive around it.
+ */
+#define LYD_ORDER_MID 0x80000000
+
+/**
+ * @brief Set the position of a node inserted among its siblings and shift the positions of the siblings, if needed.
+ *
+ * Must be called whenever a node is inserted so that the positions of all the siblings stay consecutive.
+ *
+ * @param[in] node Inserted node, already linked with its siblings.
+ */
+void lyd_order_insert(struct lyd_node *node);
+
+/**
+ * @brief Shift the positions of the siblings of a node being unlinked.
+ *
+ * Must be called whenever a node is unlinked so that the positions of all the siblings stay consecutive.
+ *
+ * @param[in] node Node to be unlinked, still linked with its siblings.
+ */
+void lyd_order_unlink(struct lyd_node *node);
+
+/**
+ * @brief Compare 2 data nodes from the same data tree in respect to their document order.
+ *
+ * @param[in] node1 1st node.
+ * @param[in] node2 2nd node.
+ * @return If 1st > 2nd returns 1, 1st == 2nd returns 0, and 1st < 2nd returns -1.
+ */
+int lyd_order_cmp(const struct lyd_node *node1, const struct lyd_node *node2);
+
 /**
  * @brief Insert a metadata (last) into a parent
  *
@@ -536,6 +626,18 @@ LY_ERR lyd_hash(struct lyd_node *node);
  */
 LY_ERR lyd_insert_hash(struct lyd_node *node);
 
+/**
+ * @brief Prepare the children hash table of a parent for inserting several new children.
+ *
+ * The hash table is created or enlarged at once so that inserting the children using ::lyd_insert_hash()
+ * does not need to resize it.
+ *
+ * @param[in] parent Parent data node, nothing is done for opaque or no parent.
+ * @param[in] count Number of children that are going to be inserted.
+ * @return LY_ERR value.
+ */
+LY_ERR lyd_insert_hash_reserve(struct lyd_node *parent, uint32_t count);
+
 /**
  * @brief Maintain node's parent's children hash table when unlinking the node.
  *
@@ -545,6 +647,61 @@ LY_ERR lyd_insert_hash(struct lyd_node *node);
  */
 void lyd_unlink_hash(struct lyd_node *node);
 
+/**
+ * @brief Get the content hash of a whole subtree, it is cached in inner nodes.
+ *
+ * A 64-bit FNV-1a hash of the schema nodes, canonical values, default flags, and the order of all the nodes in
+ * the subtree with the MurmurHash3 finalizer applied on every node.
+ *
+ * @param[in] node Subtree root.
+ * @return Subtree hash.
+ */
+uint64_t lyd_hash_subtree(const struct lyd_node *node);
+
+/**
+ * @brief Invalidate the cached subtree hashes of a changed node and all its parents.
+ *
+ * Called from ::lyd_insert_hash() and ::lyd_unlink_hash(), needs to be called explicitly after a value or the default
+ * flag of a node in a data tree was changed.
+ *
+ * @param[in] node Changed node.
+ */
+void lyd_hash_subtree_invalidate(struct lyd_node *node);
+
+/**
+ * @brief Insert an indexed leaf or all the indexed leafs of a list instance into the index of the list parent.
+ *
+ * Called from ::lyd_insert_hash(), needs to be called explicitly only after the value of an indexed leaf was changed.
+ *
+ * @param[in] node Indexed leaf or a list instance with indexed leafs, nothing is done for other nodes.
+ * @return LY_ERR value.
+ */
+LY_ERR lyd_insert_index(struct lyd_node *node);
+
+/**
+ * @brief Remove an indexed leaf or all the indexed leafs of a list instance from the index of the list parent.
+ *
+ * Called from ::lyd_unlink_hash(), needs to be called explicitly only before the value of an indexed leaf is changed.
+ *
+ * @param[in] node Indexed leaf or a list instance with indexed leafs, nothing is done for other nodes.
+ */
+void lyd_unlink_index(struct lyd_node *node);
+
+/**
+ * @brief Find list instances with a specific value of an indexed leaf using the index of their parent.
+ *
+ * If the list instances have no parent, they are searched for without an index.
+ *
+ * @param[in] siblings Siblings of the list instances.
+ * @param[in] leaf Indexed leaf with the value to find, does not have to be in a data tree.
+ * @param[in] first Whether to find only the first instance.
+ * @param[in,out] set Set to add the found list instances to, in the data order.
+ * @return LY_SUCCESS if some instances were found.
+ * @return LY_ENOTFOUND if there are no such instances.
+ * @return LY_ERR on error.
+ */
+LY_ERR lyd_find_index(const struct lyd_node *siblings, const struct lyd_node *leaf, ly_bool first, struct ly_set *set);
+
 /** @} datahash */
 
 /**
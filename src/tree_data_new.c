@@ -993,6 +993,9 @@ _lyd_change_term(struct lyd_node *term, const void *value, size_t value_len, LY_
     struct lyd_node_term *t;
     struct lyd_node *parent;
     struct lyd_value val;
+    struct lyd_journal *journal;
+    const struct lyd_node *changed = NULL;
+    char *orig_value = NULL;
     ly_bool dflt_change, val_change;
 
     assert(term && term->schema && (term->schema->nodetype & LYD_NODE_TERM));
@@ -1007,11 +1010,30 @@ _lyd_change_term(struct lyd_node *term, const void *value, size_t value_len, LY_
     LY_CHECK_GOTO(ret, cleanup);
 
     /* compare original and new value */
+    journal = lyd_journal_get(term);
     if (type->plugin->compare(&t->value, &val)) {
-        /* values differ, switch them */
+        if (journal) {
+            /* leaf-list instances and list instances are identified by their values, record them as recreated */
+            if (term->schema->nodetype == LYS_LEAFLIST) {
+                changed = term;
+            } else if ((term->schema->flags & LYS_KEY) && term->parent) {
+                changed = lyd_parent(term);
+            } else {
+                orig_value = strdup(lyd_get_value(term));
+                LY_CHECK_ERR_GOTO(!orig_value, LOGMEM(LYD_CTX(term)); type->plugin->free(LYD_CTX(term), &val);
+                        ret = LY_EMEM, cleanup);
+            }
+            if (changed) {
+                lyd_journal_delete(journal, changed);
+            }
+        }
+
+        /* values differ, switch them, an indexed leaf is hashed by its value */
+        lyd_unlink_index(term);
         type->plugin->free(LYD_CTX(term), &t->value);
         t->value = val;
         val_change = 1;
+        LY_CHECK_GOTO(ret = lyd_insert_index(term), cleanup);
     } else {
         /* same values, free the new stored one */
         type->plugin->free(LYD_CTX(term), &val);
@@ -1031,6 +1053,7 @@ _lyd_change_term(struct lyd_node *term, const void *value, size_t value_len, LY_
     if (val_change || dflt_change) {
         /* make the node non-validated */
         term->flags &= LYD_NEW;
+        lyd_hash_subtree_invalidate(term);
     }
 
     if (val_change) {
@@ -1048,6 +1071,15 @@ _lyd_change_term(struct lyd_node *term, const void *value, size_t value_len, LY_
         } /* else leaf that is not a key, its value is not used for its hash so it does not change */
     }
 
+    if (journal && (val_change || dflt_change)) {
+        /* record the change */
+        if (changed) {
+            lyd_journal_create(journal, changed);
+        } else {
+            lyd_journal_replace(journal, term, orig_value, dflt_change);
+        }
+    }
+
     /* retrun value */
     if (!val_change) {
         if (dflt_change) {
@@ -1060,6 +1092,7 @@ _lyd_change_term(struct lyd_node *term, const void *value, size_t value_len, LY_
     } /* else value changed, LY_SUCCESS */
 
 cleanup:
+    free(orig_value);
     return ret;
 }
 
@@ -1093,6 +1126,7 @@ lyd_change_meta(struct lyd_meta *meta, const char *val_str)
     LY_ERR ret = LY_SUCCESS;
     struct lyd_meta *m2 = NULL;
     struct lyd_value val;
+    struct lyd_journal *journal;
     ly_bool val_change;
 
     LY_CHECK_ARG_RET(NULL, meta, LY_EINVAL);
@@ -1108,6 +1142,10 @@ lyd_change_meta(struct lyd_meta *meta, const char *val_str)
 
     /* compare original and new value */
     if (lyd_compare_meta(meta, m2)) {
+        if (meta->parent && (journal = lyd_journal_get(meta->parent))) {
+            lyd_journal_meta(journal, meta->parent);
+        }
+
         /* values differ, switch them */
         val = meta->value;
         meta->value = m2->value;
@@ -1277,23 +1315,21 @@ lyd_new_path_check_find_lypath(struct ly_path *path, const char *str_path, const
 }
 
 /**
- * @brief Create a new node in the data tree based on a path. All node types can be created.
+ * @brief Create a new node in the data tree based on a compiled path. All node types can be created.
  *
- * If @p path points to a list key, the key value from the predicate is used and @p value is ignored.
- * Also, if a leaf-list is being created and both a predicate is defined in @p path
+ * If @p p points to a list key, the key value from the predicate is used and @p value is ignored.
+ * Also, if a leaf-list is being created and both a predicate is defined in @p p
  * and @p value is set, the predicate is preferred.
  *
  * For key-less lists and state leaf-lists, positional predicates can be used. If no preciate is used for these
  * nodes, they are always created.
  *
  * @param[in] parent Data parent to add to/modify, can be NULL. Note that in case a first top-level sibling is used,
- * it may no longer be first if @p path is absolute and starts with a non-existing top-level node inserted
+ * it may no longer be first if @p p is absolute and starts with a non-existing top-level node inserted
  * before @p parent. Use ::lyd_first_sibling() to adjust @p parent in these cases.
- * @param[in] ctx libyang context, must be set if @p parent is NULL.
- * @param[in] ext Extension instance where the node being created is defined. This argument takes effect only for absolute
- * path or when the relative paths touches document root (top-level). In such cases the present extension instance replaces
- * searching for the appropriate module.
- * @param[in] path [Path](@ref howtoXPath) to create.
+ * @param[in] ctx libyang context.
+ * @param[in] str_path Original path, used for logging.
+ * @param[in] p Compiled path to create, is modified during the call but restored afterwards.
  * @param[in] value Value of the new leaf/leaf-list (const char *) in ::LY_VALUE_JSON format. If creating an
  * anyxml/anydata node, the expected type depends on @p value_type. For other node types, it should be NULL.
  * @param[in] value_len Length of @p value in bytes. May be 0 if @p value is a zero-terminated string. Ignored when
@@ -1305,26 +1341,20 @@ lyd_new_path_check_find_lypath(struct ly_path *path, const char *str_path, const
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_new_path_(struct lyd_node *parent, const struct ly_ctx *ctx, const struct lysc_ext_instance *ext, const char *path,
+lyd_new_path_lypath(struct lyd_node *parent, const struct ly_ctx *ctx, const char *str_path, struct ly_path *p,
         const void *value, size_t value_len, LYD_ANYDATA_VALUETYPE value_type, uint32_t options,
         struct lyd_node **new_parent, struct lyd_node **new_node)
 {
     LY_ERR ret = LY_SUCCESS, r;
-    struct lyxp_expr *exp = NULL;
-    struct ly_path *p = NULL;
     struct lyd_node *nparent = NULL, *nnode = NULL, *node = NULL, *cur_parent;
     const struct lysc_node *schema;
     const struct lyd_value *val = NULL;
     LY_ARRAY_COUNT_TYPE path_idx = 0, orig_count = 0;
     LY_VALUE_FORMAT format;
 
-    assert(parent || ctx);
-    assert(path && ((path[0] == '/') || parent));
+    assert(ctx && p);
     assert(!(options & LYD_NEW_PATH_BIN_VALUE) || !(options & LYD_NEW_PATH_CANON_VALUE));
 
-    if (!ctx) {
-        ctx = LYD_CTX(parent);
-    }
     if (value && !value_len) {
         value_len = strlen(value);
     }
@@ -1336,17 +1366,9 @@ lyd_new_path_(struct lyd_node *parent, const struct ly_ctx *ctx, const struct ly
         format = LY_VALUE_JSON;
     }
 
-    /* parse path */
-    LY_CHECK_GOTO(ret = ly_path_parse(ctx, NULL, path, strlen(path), 0, LY_PATH_BEGIN_EITHER, LY_PATH_PREFIX_OPTIONAL,
-            LY_PATH_PRED_SIMPLE, &exp), cleanup);
-
-    /* compile path */
-    LY_CHECK_GOTO(ret = ly_path_compile(ctx, NULL, lyd_node_schema(parent), ext, exp, options & LYD_NEW_PATH_OUTPUT ?
-            LY_PATH_OPER_OUTPUT : LY_PATH_OPER_INPUT, LY_PATH_TARGET_MANY, 0, LY_VALUE_JSON, NULL, &p), cleanup);
-
     /* check the compiled path before searching existing nodes, it may be shortened */
     orig_count = LY_ARRAY_COUNT(p);
-    LY_CHECK_GOTO(ret = lyd_new_path_check_find_lypath(p, path, value, value_len, format, options), cleanup);
+    LY_CHECK_GOTO(ret = lyd_new_path_check_find_lypath(p, str_path, value, value_len, format, options), cleanup);
 
     /* try to find any existing nodes in the path */
     if (parent) {
@@ -1356,7 +1378,7 @@ lyd_new_path_(struct lyd_node *parent, const struct ly_ctx *ctx, const struct ly
                 /* the node exists, are we supposed to update it or is it just a default? */
                 if (!(options & LYD_NEW_PATH_UPDATE) && !(node->flags & LYD_DEFAULT)) {
                     LOG_LOCSET(NULL, node, NULL, NULL);
-                    LOGVAL(ctx, LYVE_REFERENCE, "Path \"%s\" already exists", path);
+                    LOGVAL(ctx, LYVE_REFERENCE, "Path \"%s\" already exists", str_path);
                     LOG_LOCBACK(0, 1, 0, 0);
                     ret = LY_EEXIST;
                     goto cleanup;
@@ -1501,13 +1523,9 @@ next_iter:
     }
 
 cleanup:
-    lyxp_expr_free(ctx, exp);
-    if (p) {
-        while (orig_count > LY_ARRAY_COUNT(p)) {
-            LY_ARRAY_INCREMENT(p);
-        }
+    while (orig_count > LY_ARRAY_COUNT(p)) {
+        LY_ARRAY_INCREMENT(p);
     }
-    ly_path_free(ctx, p);
     if (!ret) {
         /* set out params only on success */
         if (new_parent) {
@@ -1522,6 +1540,58 @@ cleanup:
     return ret;
 }
 
+/**
+ * @brief Create a new node in the data tree based on a path. All node types can be created.
+ *
+ * Details are mentioned in ::lyd_new_path_lypath().
+ *
+ * @param[in] parent Data parent to add to/modify, can be NULL.
+ * @param[in] ctx libyang context, must be set if @p parent is NULL.
+ * @param[in] ext Extension instance where the node being created is defined. This argument takes effect only for absolute
+ * path or when the relative paths touches document root (top-level). In such cases the present extension instance replaces
+ * searching for the appropriate module.
+ * @param[in] path [Path](@ref howtoXPath) to create.
+ * @param[in] value Value of the new leaf/leaf-list or anyxml/anydata node.
+ * @param[in] value_len Length of @p value in bytes.
+ * @param[in] value_type Anyxml/anydata node @p value type.
+ * @param[in] options Bitmask of options, see @ref pathoptions.
+ * @param[out] new_parent Optional first parent node created. If only one node was created, equals to @p new_node.
+ * @param[out] new_node Optional last node created.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_new_path_(struct lyd_node *parent, const struct ly_ctx *ctx, const struct lysc_ext_instance *ext, const char *path,
+        const void *value, size_t value_len, LYD_ANYDATA_VALUETYPE value_type, uint32_t options,
+        struct lyd_node **new_parent, struct lyd_node **new_node)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyxp_expr *exp = NULL;
+    struct ly_path *p = NULL;
+
+    assert(parent || ctx);
+    assert(path && ((path[0] == '/') || parent));
+
+    if (!ctx) {
+        ctx = LYD_CTX(parent);
+    }
+
+    /* parse path */
+    LY_CHECK_GOTO(ret = ly_path_parse(ctx, NULL, path, strlen(path), 0, LY_PATH_BEGIN_EITHER, LY_PATH_PREFIX_OPTIONAL,
+            LY_PATH_PRED_SIMPLE, &exp), cleanup);
+
+    /* compile path */
+    LY_CHECK_GOTO(ret = ly_path_compile(ctx, NULL, lyd_node_schema(parent), ext, exp, options & LYD_NEW_PATH_OUTPUT ?
+            LY_PATH_OPER_OUTPUT : LY_PATH_OPER_INPUT, LY_PATH_TARGET_MANY, 0, LY_VALUE_JSON, NULL, &p), cleanup);
+
+    /* create the nodes */
+    ret = lyd_new_path_lypath(parent, ctx, path, p, value, value_len, value_type, options, new_parent, new_node);
+
+cleanup:
+    lyxp_expr_free(ctx, exp);
+    ly_path_free(ctx, p);
+    return ret;
+}
+
 LIBYANG_API_DEF LY_ERR
 lyd_new_path(struct lyd_node *parent, const struct ly_ctx *ctx, const char *path, const char *value, uint32_t options,
         struct lyd_node **node)
@@ -1558,6 +1628,191 @@ lyd_new_ext_path(struct lyd_node *parent, const struct lysc_ext_instance *ext, c
     return lyd_new_path_(parent, ctx, ext, path, value, 0, LYD_ANYDATA_STRING, options, node, NULL);
 }
 
+/**
+ * @brief Check whether a compiled path segment is a list with keys bound on every use of a path handle.
+ *
+ * @param[in] segment Compiled path segment.
+ * @return Whether the segment keys are bound.
+ */
+static ly_bool
+lyd_path_handle_is_bound(const struct ly_path *segment)
+{
+    return (segment->node->nodetype == LYS_LIST) && !(segment->node->flags & LYS_KEYLESS) &&
+           (segment->pred_type == LY_PATH_PREDTYPE_NONE);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_path_handle_new(const struct ly_ctx *ctx, const struct lysc_node *ctx_node, const char *path, ly_bool output,
+        struct lyd_path_handle **handle)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyxp_expr *exp = NULL;
+    struct lyd_path_handle *h = NULL;
+    const struct lysc_node *key;
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_CHECK_ARG_RET(ctx, ctx || ctx_node, path, (path[0] == '/') || ctx_node, handle, LY_EINVAL);
+    LY_CHECK_CTX_EQUAL_RET(ctx, ctx_node ? ctx_node->module->ctx : NULL, LY_EINVAL);
+
+    if (!ctx) {
+        ctx = ctx_node->module->ctx;
+    }
+    *handle = NULL;
+
+    h = calloc(1, sizeof *h);
+    LY_CHECK_ERR_GOTO(!h, LOGMEM(ctx); ret = LY_EMEM, cleanup);
+    h->ctx = ctx;
+    if (path[0] != '/') {
+        h->ctx_node = ctx_node;
+    }
+    h->str_path = strdup(path);
+    LY_CHECK_ERR_GOTO(!h->str_path, LOGMEM(ctx); ret = LY_EMEM, cleanup);
+
+    /* parse path */
+    LY_CHECK_GOTO(ret = ly_path_parse(ctx, ctx_node, path, strlen(path), 0, LY_PATH_BEGIN_EITHER,
+            LY_PATH_PREFIX_OPTIONAL, LY_PATH_PRED_SIMPLE, &exp), cleanup);
+
+    /* compile path, lists without predicates are allowed */
+    LY_CHECK_GOTO(ret = ly_path_compile(ctx, NULL, ctx_node, NULL, exp, output ? LY_PATH_OPER_OUTPUT :
+            LY_PATH_OPER_INPUT, LY_PATH_TARGET_MANY, 0, LY_VALUE_JSON, NULL, &h->path), cleanup);
+
+    /* count the key values to bind */
+    LY_ARRAY_FOR(h->path, u) {
+        if (!lyd_path_handle_is_bound(&h->path[u])) {
+            continue;
+        }
+        for (key = lysc_node_child(h->path[u].node); key && (key->flags & LYS_KEY); key = key->next) {
+            ++h->bind_count;
+        }
+    }
+
+    *handle = h;
+    h = NULL;
+
+cleanup:
+    lyxp_expr_free(ctx, exp);
+    lyd_path_handle_free(h);
+    return ret;
+}
+
+LIBYANG_API_DEF uint32_t
+lyd_path_handle_bind_count(const struct lyd_path_handle *handle)
+{
+    return handle ? handle->bind_count : 0;
+}
+
+LIBYANG_API_DEF void
+lyd_path_handle_free(struct lyd_path_handle *handle)
+{
+    if (!handle) {
+        return;
+    }
+
+    ly_path_free(handle->ctx, handle->path);
+    free(handle->str_path);
+    free(handle);
+}
+
+LY_ERR
+lyd_path_handle_bind(const struct lyd_path_handle *handle, const char **keys, struct ly_path **path)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_path *p = NULL;
+    struct ly_path_predicate *pred;
+    const struct lysc_node *key;
+    LY_ARRAY_COUNT_TYPE u;
+    uint32_t k = 0;
+
+    assert(handle && (keys || !handle->bind_count) && path);
+
+    *path = NULL;
+
+    /* share the segments, only the bound predicates are created */
+    LY_ARRAY_CREATE_RET(handle->ctx, p, LY_ARRAY_COUNT(handle->path), LY_EMEM);
+    LY_ARRAY_FOR(handle->path, u) {
+        LY_ARRAY_INCREMENT(p);
+        p[u] = handle->path[u];
+    }
+
+    LY_ARRAY_FOR(p, u) {
+        if (!lyd_path_handle_is_bound(&p[u])) {
+            continue;
+        }
+
+        for (key = lysc_node_child(p[u].node); key && (key->flags & LYS_KEY); key = key->next) {
+            LY_CHECK_ERR_GOTO(!keys[k], LOGARG(handle->ctx, keys); ret = LY_EINVAL, cleanup);
+
+            LY_ARRAY_NEW_GOTO(handle->ctx, p[u].predicates, pred, ret, cleanup);
+            p[u].pred_type = LY_PATH_PREDTYPE_LIST;
+            pred->key = key;
+
+            /* store the value */
+            LOG_LOCSET(key, NULL, NULL, NULL);
+            ret = lyd_value_store(handle->ctx, &pred->value, ((struct lysc_node_leaf *)key)->type, keys[k],
+                    strlen(keys[k]), NULL, LY_VALUE_JSON, NULL, LYD_HINT_DATA, key, NULL);
+            LOG_LOCBACK(1, 0, 0, 0);
+            LY_CHECK_ERR_GOTO(ret, pred->value.realtype = NULL, cleanup);
+            ++k;
+
+            /* "allocate" the type to avoid problems when freeing the value after the type was freed */
+            LY_ATOMIC_INC_BARRIER(((struct lysc_type *)pred->value.realtype)->refcount);
+        }
+    }
+
+    *path = p;
+    p = NULL;
+
+cleanup:
+    lyd_path_handle_unbind(handle, p);
+    return ret;
+}
+
+void
+lyd_path_handle_unbind(const struct lyd_path_handle *handle, struct ly_path *path)
+{
+    LY_ARRAY_COUNT_TYPE u;
+
+    if (!path) {
+        return;
+    }
+
+    /* free only the predicates not shared with the handle, including any added while creating nodes */
+    LY_ARRAY_FOR(handle->path, u) {
+        if (path[u].predicates != handle->path[u].predicates) {
+            ly_path_predicates_free(handle->ctx, path[u].pred_type, path[u].predicates);
+        }
+    }
+    LY_ARRAY_FREE(path);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_new_path_handle(struct lyd_node *parent, const struct lyd_path_handle *handle, const char **keys, const void *value,
+        size_t value_len, LYD_ANYDATA_VALUETYPE value_type, uint32_t options, struct lyd_node **new_parent,
+        struct lyd_node **new_node)
+{
+    LY_ERR ret;
+    struct ly_path *p;
+
+    LY_CHECK_ARG_RET(handle ? handle->ctx : NULL, handle, keys || !handle->bind_count, !handle->ctx_node || parent,
+            !(options & LYD_NEW_PATH_BIN_VALUE) || !(options & LYD_NEW_PATH_CANON_VALUE), LY_EINVAL);
+    LY_CHECK_CTX_EQUAL_RET(parent ? LYD_CTX(parent) : NULL, handle->ctx, LY_EINVAL);
+    if (handle->ctx_node && (lyd_node_schema(parent) != handle->ctx_node)) {
+        LOGERR(handle->ctx, LY_EINVAL, "Parent \"%s\" is not the context node of path \"%s\".", LYD_NAME(parent),
+                handle->str_path);
+        return LY_EINVAL;
+    }
+
+    /* bind the keys */
+    LY_CHECK_RET(lyd_path_handle_bind(handle, keys, &p));
+
+    /* create the nodes */
+    ret = lyd_new_path_lypath(parent, handle->ctx, handle->str_path, p, value, value_len, value_type, options,
+            new_parent, new_node);
+
+    lyd_path_handle_unbind(handle, p);
+    return ret;
+}
+
 LY_ERR
 lyd_new_implicit_r(struct lyd_node *parent, struct lyd_node **first, const struct lysc_node *sparent,
         const struct lys_module *mod, struct ly_set *node_when, struct ly_set *node_types, uint32_t impl_opts,
@@ -1567,7 +1822,7 @@ lyd_new_implicit_r(struct lyd_node *parent, struct lyd_node **first, const struc
     const struct lysc_node *iter = NULL;
     struct lyd_node *node = NULL;
     struct lyd_value **dflts;
-    LY_ARRAY_COUNT_TYPE u;
+    LY_ARRAY_COUNT_TYPE u, idx = 0;
     uint32_t getnext_opts;
 
     assert(first && (parent || sparent || mod));
@@ -1581,7 +1836,7 @@ lyd_new_implicit_r(struct lyd_node *parent, struct lyd_node **first, const struc
         getnext_opts |= LYS_GETNEXT_OUTPUT;
     }
 
-    while ((iter = lys_getnext(iter, sparent, mod ? mod->compiled : NULL, getnext_opts))) {
+    while ((iter = lys_getnext_idx(iter, sparent, mod ? mod->compiled : NULL, getnext_opts, &idx))) {
         if ((impl_opts & LYD_IMPLICIT_NO_STATE) && (iter->flags & LYS_CONFIG_R)) {
             continue;
         } else if ((impl_opts & LYD_IMPLICIT_NO_CONFIG) && (iter->flags & LYS_CONFIG_W)) {
@@ -453,6 +453,11 @@ lys_find_child(const struct lysc_node *parent, const struct lys_module *module,
         nodetype = LYS_NODETYPE_MASK;
     }
 
+    /* try to use the children hash table */
+    if (!lysc_find_child_ht(parent, module, name, name_len, options, &node)) {
+        return (node && (node->nodetype & nodetype)) ? node : NULL;
+    }
+
     while ((node = lys_getnext(node, parent, module->compiled, options))) {
         if (!(node->nodetype & nodetype)) {
             continue;
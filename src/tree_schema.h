@@ -30,6 +30,7 @@
 extern "C" {
 #endif
 
+struct hash_table;
 struct ly_ctx;
 struct ly_path;
 struct ly_set;
@@ -110,6 +111,7 @@ struct lyxp_expr;
  * - ::lysc_node_child()
  * - ::lysc_node_actions()
  * - ::lysc_node_notifs()
+ * - ::lysc_node_set_index()
  *
  * - ::lysp_node_child()
  * - ::lysp_node_actions()
@@ -871,6 +873,8 @@ struct lysp_deviation {
  *      14 LYS_IS_OUTPUT    |x|x|x|x|x|x|x| | | | | | | |
  *                          +-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *      15 LYS_IS_NOTIF     |x|x|x|x|x|x|x| | | | | | | |
+ *                          +-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *      16 LYS_INDEXED      | | |x| |x| | | | | | | | | |
  *     ---------------------+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *
  */
@@ -955,6 +959,9 @@ struct lysp_deviation {
 
 #define LYS_IS_NOTIF     0x4000      /**< flag for nodes that are in the subtree of a notification statement */
 
+#define LYS_INDEXED      0x8000      /**< flag for leafs with a secondary data index and for lists with such leafs,
+                                          set by ::lysc_node_set_index() */
+
 #define LYS_FLAGS_COMPILED_MASK 0xff /**< mask for flags that maps to the compiled structures */
 /** @} snodeflags */
 
@@ -1468,6 +1475,9 @@ struct lysc_ident {
                                           It also contains references to identities located in unimplemented modules. */
     struct lysc_ext_instance *exts;  /**< list of the extension instances ([sized array](@ref sizedarrays)) */
     uint16_t flags;                  /**< [schema node flags](@ref snodeflags) - only LYS_STATUS_ values are allowed */
+    uint32_t *bases_closure;         /**< bitset of the indexes of all the identities this identity is (transitively)
+                                          derived from ([sized array](@ref sizedarrays) of 32b words) */
+    uint32_t index;                  /**< index of the identity in the context, its bit in ::lysc_ident.bases_closure */
 };
 
 /**
@@ -1604,6 +1614,8 @@ struct lysc_type_leafref {
     const struct lys_module *cur_mod;/**< unused, not needed */
     struct lysc_type *realtype;      /**< pointer to the real (first non-leafref in possible leafrefs chain) type. */
     uint8_t require_instance;        /**< require-instance flag */
+    struct lyxp_expr *parent_path;   /**< parsed target path without its last 2 node steps (the list and its leaf)
+                                          for simple paths, used for finding targets by an index */
 };
 
 struct lysc_type_identityref {
@@ -1686,6 +1698,13 @@ struct lysc_node_action_inout {
 
     struct lysc_node *child;         /**< first child node (linked list) */
     struct lysc_must *musts;         /**< list of must restrictions ([sized array](@ref sizedarrays)) */
+    struct hash_table *children_ht;  /**< hash table of the data children (see ::lys_getnext()) by their module and
+                                          name, NULL if there are only a few children */
+    const struct lysc_node **children_flat; /**< data children (see ::lys_getnext()) in the schema order, NULL if
+                                                 there are none ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_choice; /**< data children (see ::lys_getnext()) with choices returned instead
+                                                   of their data (::LYS_GETNEXT_WITHCHOICE), in the schema order,
+                                                   NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 struct lysc_node_action {
@@ -1745,6 +1764,13 @@ struct lysc_node_notif {
     struct lysc_when **when;         /**< list of pointers to when statements ([sized array](@ref sizedarrays)),
                                           the notification nodes do not contain the when statement on their own, but they can
                                           inherit it from the parent's uses. */
+    struct hash_table *children_ht;  /**< hash table of the data children (see ::lys_getnext()) by their module and
+                                          name, NULL if there are only a few children */
+    const struct lysc_node **children_flat; /**< data children (see ::lys_getnext()) in the schema order, NULL if
+                                                 there are none ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_choice; /**< data children (see ::lys_getnext()) with choices returned instead
+                                                   of their data (::LYS_GETNEXT_WITHCHOICE), in the schema order,
+                                                   NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 struct lysc_node_container {
@@ -1774,6 +1800,13 @@ struct lysc_node_container {
     struct lysc_when **when;         /**< list of pointers to when statements ([sized array](@ref sizedarrays)) */
     struct lysc_node_action *actions;/**< first of actions nodes (linked list) */
     struct lysc_node_notif *notifs;  /**< first of notifications nodes (linked list) */
+    struct hash_table *children_ht;  /**< hash table of the data children (see ::lys_getnext()) by their module and
+                                          name, NULL if there are only a few children */
+    const struct lysc_node **children_flat; /**< data children (see ::lys_getnext()) in the schema order, NULL if
+                                                 there are none ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_choice; /**< data children (see ::lys_getnext()) with choices returned instead
+                                                   of their data (::LYS_GETNEXT_WITHCHOICE), in the schema order,
+                                                   NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 struct lysc_node_case {
@@ -1801,6 +1834,11 @@ struct lysc_node_case {
     struct lysc_node *child;         /**< first child node of the case (linked list). Note that all the children of all the sibling cases are linked
                                           each other as siblings with the parent pointer pointing to appropriate case node. */
     struct lysc_when **when;         /**< list of pointers to when statements ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_flat; /**< data children (see ::lys_getnext()) in the schema order, NULL if
+                                                 there are none ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_choice; /**< data children (see ::lys_getnext()) with choices returned instead
+                                                   of their data (::LYS_GETNEXT_WITHCHOICE), in the schema order,
+                                                   NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 struct lysc_node_choice {
@@ -1830,6 +1868,8 @@ struct lysc_node_choice {
                                           case is simple. */
     struct lysc_when **when;         /**< list of pointers to when statements ([sized array](@ref sizedarrays)) */
     struct lysc_node_case *dflt;     /**< default case of the choice, only a pointer into the cases array. */
+    const struct lysc_node **children_flat; /**< data children of all the cases (see ::lys_getnext()) in the schema
+                                                 order, NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 struct lysc_node_leaf {
@@ -1928,6 +1968,13 @@ struct lysc_node_list {
     struct lysc_node_leaf ***uniques;/**< list of sized arrays of pointers to the unique nodes ([sized array](@ref sizedarrays)) */
     uint32_t min;                    /**< min-elements constraint */
     uint32_t max;                    /**< max-elements constraint */
+    struct hash_table *children_ht;  /**< hash table of the data children (see ::lys_getnext()) by their module and
+                                          name, NULL if there are only a few children */
+    const struct lysc_node **children_flat; /**< data children (see ::lys_getnext()) in the schema order, NULL if
+                                                 there are none ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_choice; /**< data children (see ::lys_getnext()) with choices returned instead
+                                                   of their data (::LYS_GETNEXT_WITHCHOICE), in the schema order,
+                                                   NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 struct lysc_node_anydata {
@@ -1969,6 +2016,13 @@ struct lysc_module {
     struct lysc_node_action *rpcs;   /**< first of actions nodes (linked list) */
     struct lysc_node_notif *notifs;  /**< first of notifications nodes (linked list) */
     struct lysc_ext_instance *exts;  /**< list of the extension instances ([sized array](@ref sizedarrays)) */
+    struct hash_table *children_ht;  /**< hash table of the top-level data nodes (see ::lys_getnext()) by their module
+                                          and name, NULL if there are only a few nodes */
+    const struct lysc_node **children_flat; /**< top-level data nodes (see ::lys_getnext()) in the schema order,
+                                                 NULL if there are none ([sized array](@ref sizedarrays)) */
+    const struct lysc_node **children_choice; /**< top-level data nodes (see ::lys_getnext()) with choices returned
+                                                   instead of their data (::LYS_GETNEXT_WITHCHOICE), in the schema
+                                                   order, NULL if there are none ([sized array](@ref sizedarrays)) */
 };
 
 /**
@@ -2128,6 +2182,25 @@ LIBYANG_API_DECL struct lysc_must *lysc_node_musts(const struct lysc_node *node)
  */
 LIBYANG_API_DECL struct lysc_when **lysc_node_when(const struct lysc_node *node);
 
+/**
+ * @brief Declare a secondary data index on a non-key leaf of a list.
+ *
+ * Instances of the list are then hashed also by the value of this leaf in the ::lyd_node_inner.index_ht hash table
+ * of their parent, similarly to the key hashes. Equality predicates on the leaf (`list[leaf='val']`) are then
+ * evaluated in constant (*O(1)*) complexity by XPath, ::lyd_find_sibling_val(), and leafref resolution.
+ *
+ * The index is best declared before creating any data instances of the list. The instances created before are
+ * found by going through all of them until the index is built, which happens when an instance of an indexed list
+ * is created under the same parent. It cannot be removed and it is lost if the context is recompiled. Declaring
+ * indexes is serialized by a context lock but it modifies the compiled schema, so it must not be called while data
+ * of the context are being created or validated by other threads.
+ *
+ * @param[in] node Leaf to index, must be a non-key leaf of a list that is not a top-level node.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL if @p node cannot be indexed.
+ */
+LIBYANG_API_DECL LY_ERR lysc_node_set_index(const struct lysc_node *node);
+
 /**
  * @brief Callback to be called for every schema node in a DFS traversal.
  *
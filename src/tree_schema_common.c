@@ -1827,6 +1827,449 @@ lysc_node_when(const struct lysc_node *node)
     }
 }
 
+LIBYANG_API_DEF LY_ERR
+lysc_node_set_index(const struct lysc_node *node)
+{
+    const struct lysc_node *list;
+
+    LY_CHECK_ARG_RET(NULL, node, LY_EINVAL);
+
+    list = lysc_data_parent(node);
+    if ((node->nodetype != LYS_LEAF) || (node->flags & LYS_KEY) || !list || (list->nodetype != LYS_LIST)) {
+        LOGERR(node->module->ctx, LY_EINVAL, "Only non-key leafs of lists can be indexed (\"%s\").", node->name);
+        return LY_EINVAL;
+    } else if (!lysc_data_parent(list)) {
+        LOGERR(node->module->ctx, LY_EINVAL, "Leafs of top-level lists cannot be indexed (\"%s\").", node->name);
+        return LY_EINVAL;
+    }
+
+    /* compiled schema is shared, serialize its modification */
+    pthread_mutex_lock(&node->module->ctx->index_lock);
+    if (!(node->flags & LYS_INDEXED)) {
+        ((struct lysc_node *)node)->flags |= LYS_INDEXED;
+        ((struct lysc_node *)list)->flags |= LYS_INDEXED;
+
+        /* existing data indexes do not include the leaf */
+        ++node->module->ctx->index_gen;
+    }
+    pthread_mutex_unlock(&node->module->ctx->index_lock);
+
+    return LY_SUCCESS;
+}
+
+struct hash_table **
+lysc_node_children_ht_p(const struct lysc_node *node)
+{
+    assert(node && !(node->nodetype & (LYS_RPC | LYS_ACTION)));
+
+    switch (node->nodetype) {
+    case LYS_CONTAINER:
+        return &((struct lysc_node_container *)node)->children_ht;
+    case LYS_LIST:
+        return &((struct lysc_node_list *)node)->children_ht;
+    case LYS_INPUT:
+    case LYS_OUTPUT:
+        return &((struct lysc_node_action_inout *)node)->children_ht;
+    case LYS_NOTIF:
+        return &((struct lysc_node_notif *)node)->children_ht;
+    default:
+        return NULL;
+    }
+}
+
+const struct lysc_node ***
+lysc_node_children_p(const struct lysc_node *node, uint32_t options)
+{
+    ly_bool wch = (options & LYS_GETNEXT_WITHCHOICE) ? 1 : 0;
+
+    assert(node && !(node->nodetype & (LYS_RPC | LYS_ACTION)) && !(options & ~LYS_GETNEXT_WITHCHOICE));
+
+    switch (node->nodetype) {
+    case LYS_CONTAINER:
+        return wch ? &((struct lysc_node_container *)node)->children_choice :
+               &((struct lysc_node_container *)node)->children_flat;
+    case LYS_LIST:
+        return wch ? &((struct lysc_node_list *)node)->children_choice :
+               &((struct lysc_node_list *)node)->children_flat;
+    case LYS_INPUT:
+    case LYS_OUTPUT:
+        return wch ? &((struct lysc_node_action_inout *)node)->children_choice :
+               &((struct lysc_node_action_inout *)node)->children_flat;
+    case LYS_NOTIF:
+        return wch ? &((struct lysc_node_notif *)node)->children_choice :
+               &((struct lysc_node_notif *)node)->children_flat;
+    case LYS_CASE:
+        return wch ? &((struct lysc_node_case *)node)->children_choice :
+               &((struct lysc_node_case *)node)->children_flat;
+    case LYS_CHOICE:
+        return wch ? NULL : &((struct lysc_node_choice *)node)->children_flat;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Get the precomputed children of a schema node or the top-level nodes of a module.
+ *
+ * @param[in] parent Schema parent, NULL for top-level nodes.
+ * @param[in] module Compiled module of the top-level nodes.
+ * @param[in] options [ORed options](@ref sgetnextflags) of ::lys_getnext().
+ * @return Sized array of the children, NULL if there are none, they were not precomputed, or they cannot be
+ * used with @p options.
+ */
+static const struct lysc_node **
+lysc_children_get(const struct lysc_node *parent, const struct lysc_module *module, uint32_t options)
+{
+    const struct lysc_node ***children_p;
+
+    if (options & ~(LYS_GETNEXT_WITHCHOICE | LYS_GETNEXT_OUTPUT)) {
+        /* the other options change the children */
+        return NULL;
+    }
+
+    if (!parent) {
+        if (!module) {
+            return NULL;
+        }
+        return (options & LYS_GETNEXT_WITHCHOICE) ? module->children_choice : module->children_flat;
+    }
+
+    if (parent->nodetype & (LYS_RPC | LYS_ACTION)) {
+        if (options & LYS_GETNEXT_OUTPUT) {
+            parent = &((struct lysc_node_action *)parent)->output.node;
+        } else {
+            parent = &((struct lysc_node_action *)parent)->input.node;
+        }
+    }
+    children_p = lysc_node_children_p(parent, options & LYS_GETNEXT_WITHCHOICE);
+    return children_p ? *children_p : NULL;
+}
+
+/**
+ * @brief Get the data children hash table of a schema node or of the top-level nodes of a module.
+ *
+ * @param[in] parent Schema parent, NULL for top-level nodes.
+ * @param[in] module Compiled module of the top-level nodes.
+ * @param[in] options [ORed options](@ref sgetnextflags) of ::lys_getnext().
+ * @return Hash table, NULL if there is none or it cannot be used with @p options.
+ */
+static struct hash_table *
+lysc_children_ht_get(const struct lysc_node *parent, const struct lysc_module *module, uint32_t options)
+{
+    struct hash_table **ht_p;
+
+    if (options & ~LYS_GETNEXT_OUTPUT) {
+        /* the other options change the children */
+        return NULL;
+    }
+
+    if (!parent) {
+        return module ? module->children_ht : NULL;
+    } else if (parent->nodetype & (LYS_RPC | LYS_ACTION)) {
+        if (options & LYS_GETNEXT_OUTPUT) {
+            return ((struct lysc_node_action *)parent)->output.children_ht;
+        } else {
+            return ((struct lysc_node_action *)parent)->input.children_ht;
+        }
+    } else if ((ht_p = lysc_node_children_ht_p(parent))) {
+        return *ht_p;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Record of a data children hash table.
+ */
+struct lysc_children_ht_rec {
+    const struct lys_module *mod;   /**< module of the child */
+    const char *name;               /**< name of the child, not necessarily terminated */
+    size_t name_len;                /**< length of the name */
+    const struct lysc_node *node;   /**< the child, NULL when searching */
+    LY_ARRAY_COUNT_TYPE idx;        /**< schema-order index of the child in the flattened children */
+};
+
+/**
+ * @brief Get the hash of a data child in a data children hash table.
+ *
+ * @param[in] mod Module of the child.
+ * @param[in] name Name of the child.
+ * @param[in] name_len Length of @p name.
+ * @return Hash of the child.
+ */
+static uint32_t
+lysc_children_ht_hash(const struct lys_module *mod, const char *name, size_t name_len)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&mod, sizeof mod);
+    hash = dict_hash_multi(hash, name, name_len);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Callback for checking data children hash table records equality.
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lysc_children_ht_val_equal(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lysc_children_ht_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return (rec1->mod == rec2->mod) && (rec1->name_len == rec2->name_len) &&
+           !strncmp(rec1->name, rec2->name, rec1->name_len);
+}
+
+/**
+ * @brief Create the flattened children of a schema node or the top-level nodes of a module.
+ *
+ * @param[in] parent Schema node, NULL for top-level nodes.
+ * @param[in] mod Compiled module of the top-level nodes.
+ * @param[in] options [ORed options](@ref sgetnextflags) of ::lys_getnext() defining the children.
+ * @param[out] children Created sized array of the children, left NULL if there are none.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lysc_children_create(const struct lysc_node *parent, const struct lysc_module *mod, uint32_t options,
+        const struct lysc_node ***children)
+{
+    const struct ly_ctx *ctx = parent ? parent->module->ctx : mod->mod->ctx;
+    const struct lysc_node *iter = NULL;
+    LY_ARRAY_COUNT_TYPE count = 0;
+
+    assert(!*children);
+
+    while ((iter = lys_getnext(iter, parent, mod, options))) {
+        ++count;
+    }
+    if (!count) {
+        return LY_SUCCESS;
+    }
+
+    LY_ARRAY_CREATE_RET(ctx, *children, count, LY_EMEM);
+    while ((iter = lys_getnext(iter, parent, mod, options))) {
+        (*children)[LY_ARRAY_COUNT(*children)] = iter;
+        LY_ARRAY_INCREMENT(*children);
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create a data children hash table of a schema node or of the top-level nodes of a module.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in] children Flattened data children to index.
+ * @param[out] ht Created hash table, left NULL if there are only a few children.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lysc_children_ht_create(const struct ly_ctx *ctx, const struct lysc_node **children, struct hash_table **ht)
+{
+    LY_ERR r;
+    struct lysc_children_ht_rec rec = {0};
+    LY_ARRAY_COUNT_TYPE u;
+
+    assert(!*ht);
+
+    if (LY_ARRAY_COUNT(children) < LYS_CHILDREN_HT_MIN_ITEMS) {
+        return LY_SUCCESS;
+    }
+
+    *ht = lyht_new(LYHT_MIN_SIZE, sizeof rec, lysc_children_ht_val_equal, NULL, 1);
+    LY_CHECK_ERR_RET(!*ht, LOGMEM(ctx), LY_EMEM);
+    LY_CHECK_RET(lyht_reserve(*ht, LY_ARRAY_COUNT(children)));
+
+    LY_ARRAY_FOR(children, u) {
+        rec.mod = children[u]->module;
+        rec.name = children[u]->name;
+        rec.name_len = strlen(children[u]->name);
+        rec.node = children[u];
+        rec.idx = u;
+
+        /* on a duplicate keep the first node, as found by iterating the children */
+        r = lyht_insert(*ht, &rec, lysc_children_ht_hash(rec.mod, rec.name, rec.name_len), NULL);
+        if (r && (r != LY_EEXIST)) {
+            return r;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create the flattened children and the data children hash table of a schema node or of the top-level
+ * nodes of a module.
+ *
+ * @param[in] parent Schema node, NULL for top-level nodes.
+ * @param[in] mod Compiled module of the top-level nodes.
+ * @param[in] children_p Flattened data children to create.
+ * @param[in] choice_p Flattened data children with choices to create, NULL if not stored.
+ * @param[in] ht_p Data children hash table to create, NULL if not stored.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lysc_children_index_create(const struct lysc_node *parent, const struct lysc_module *mod,
+        const struct lysc_node ***children_p, const struct lysc_node ***choice_p, struct hash_table **ht_p)
+{
+    const struct ly_ctx *ctx = parent ? parent->module->ctx : mod->mod->ctx;
+
+    LY_CHECK_RET(lysc_children_create(parent, mod, 0, children_p));
+    if (choice_p) {
+        LY_CHECK_RET(lysc_children_create(parent, mod, LYS_GETNEXT_WITHCHOICE, choice_p));
+    }
+    if (ht_p) {
+        LY_CHECK_RET(lysc_children_ht_create(ctx, *children_p, ht_p));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create the flattened children and the data children hash tables of a schema subtree.
+ *
+ * @param[in] node Root of the subtree.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lysc_children_index_create_r(const struct lysc_node *node)
+{
+    const struct lysc_node *iter, ***children_p;
+
+    if (node->nodetype & (LYS_RPC | LYS_ACTION)) {
+        LY_CHECK_RET(lysc_children_index_create_r(&((struct lysc_node_action *)node)->input.node));
+        return lysc_children_index_create_r(&((struct lysc_node_action *)node)->output.node);
+    }
+
+    children_p = lysc_node_children_p(node, 0);
+    if (children_p) {
+        LY_CHECK_RET(lysc_children_index_create(node, NULL, children_p, lysc_node_children_p(node,
+                LYS_GETNEXT_WITHCHOICE), lysc_node_children_ht_p(node)));
+    }
+
+    LY_LIST_FOR(lysc_node_child(node), iter) {
+        LY_CHECK_RET(lysc_children_index_create_r(iter));
+    }
+    LY_LIST_FOR((const struct lysc_node *)lysc_node_actions(node), iter) {
+        LY_CHECK_RET(lysc_children_index_create_r(iter));
+    }
+    LY_LIST_FOR((const struct lysc_node *)lysc_node_notifs(node), iter) {
+        LY_CHECK_RET(lysc_children_index_create_r(iter));
+    }
+
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lysc_module_children_index_create(struct lysc_module *mod)
+{
+    const struct lysc_node *iter;
+
+    LY_CHECK_RET(lysc_children_index_create(NULL, mod, &mod->children_flat, &mod->children_choice,
+            &mod->children_ht));
+
+    LY_LIST_FOR(mod->data, iter) {
+        LY_CHECK_RET(lysc_children_index_create_r(iter));
+    }
+    LY_LIST_FOR((const struct lysc_node *)mod->rpcs, iter) {
+        LY_CHECK_RET(lysc_children_index_create_r(iter));
+    }
+    LY_LIST_FOR((const struct lysc_node *)mod->notifs, iter) {
+        LY_CHECK_RET(lysc_children_index_create_r(iter));
+    }
+
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lysc_find_child_ht(const struct lysc_node *parent, const struct lys_module *module, const char *name,
+        size_t name_len, uint32_t options, const struct lysc_node **match)
+{
+    struct hash_table *ht;
+    struct lysc_children_ht_rec rec = {0}, *found;
+
+    ht = lysc_children_ht_get(parent, module->compiled, options);
+    if (!ht) {
+        return LY_ENOT;
+    }
+
+    rec.mod = module;
+    rec.name = name;
+    rec.name_len = name_len ? name_len : strlen(name);
+    if (lyht_find(ht, &rec, lysc_children_ht_hash(module, name, rec.name_len), (void **)&found)) {
+        *match = NULL;
+    } else {
+        *match = found->node;
+    }
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lysc_node_child_idx(const struct lysc_node *parent, const struct lysc_module *module, const struct lysc_node *node,
+        uint32_t options, LY_ARRAY_COUNT_TYPE *idx)
+{
+    const struct lysc_node **children;
+    struct hash_table *ht;
+    struct lysc_children_ht_rec rec = {0}, *found;
+    LY_ARRAY_COUNT_TYPE u;
+
+    children = lysc_children_get(parent, module, options);
+    if (!children) {
+        return LY_ENOT;
+    }
+
+    if ((ht = lysc_children_ht_get(parent, module, options))) {
+        /* learn the index from the hash table */
+        rec.mod = node->module;
+        rec.name = node->name;
+        rec.name_len = strlen(node->name);
+        if (!lyht_find(ht, &rec, lysc_children_ht_hash(rec.mod, rec.name, rec.name_len), (void **)&found) &&
+                (found->node == node)) {
+            *idx = found->idx;
+            return LY_SUCCESS;
+        }
+    }
+
+    LY_ARRAY_FOR(children, u) {
+        if (children[u] == node) {
+            *idx = u;
+            return LY_SUCCESS;
+        }
+    }
+    return LY_ENOT;
+}
+
+const struct lysc_node *
+lys_getnext_idx(const struct lysc_node *last, const struct lysc_node *parent, const struct lysc_module *module,
+        uint32_t options, LY_ARRAY_COUNT_TYPE *idx)
+{
+    const struct lysc_node **children;
+    LY_ARRAY_COUNT_TYPE i;
+
+    children = lysc_children_get(parent, module, options);
+    if (!children) {
+        /* not precomputed (or no children at all) */
+        return lys_getnext(last, parent, module, options);
+    }
+
+    if (!last) {
+        i = 0;
+    } else if ((*idx < LY_ARRAY_COUNT(children)) && (children[*idx] == last)) {
+        i = *idx + 1;
+    } else if (!lysc_node_child_idx(parent, module, last, options, &i)) {
+        /* the index was not a valid hint */
+        ++i;
+    } else {
+        /* last is not among the children */
+        return lys_getnext(last, parent, module, options);
+    }
+
+    if (i == LY_ARRAY_COUNT(children)) {
+        return NULL;
+    }
+    *idx = i;
+    return children[i];
+}
+
 struct lys_module *
 lysp_find_module(struct ly_ctx *ctx, const struct lysp_module *mod)
 {
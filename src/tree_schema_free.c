@@ -18,6 +18,7 @@
 #include "common.h"
 #include "compat.h"
 #include "dict.h"
+#include "hash_table.h"
 #include "log.h"
 #include "plugins_exts.h"
 #include "plugins_types.h"
@@ -701,6 +702,7 @@ lysc_ident_free(struct ly_ctx *ctx, struct lysc_ident *ident)
     lydict_remove(ctx, ident->dsc);
     lydict_remove(ctx, ident->ref);
     LY_ARRAY_FREE(ident->derived);
+    LY_ARRAY_FREE(ident->bases_closure);
     FREE_ARRAY(ctx, ident->exts, lysc_ext_instance_free);
 }
 
@@ -788,6 +790,7 @@ lysc_type_free(struct ly_ctx *ctx, struct lysc_type *type)
         break;
     case LY_TYPE_LEAFREF:
         lyxp_expr_free(ctx, ((struct lysc_type_leafref *)type)->path);
+        lyxp_expr_free(ctx, ((struct lysc_type_leafref *)type)->parent_path);
         ly_free_prefix_data(LY_VALUE_SCHEMA_RESOLVED, ((struct lysc_type_leafref *)type)->prefixes);
         lysc_type_free(ctx, ((struct lysc_type_leafref *)type)->realtype);
         break;
@@ -812,6 +815,9 @@ lysc_node_action_inout_free(struct ly_ctx *ctx, struct lysc_node_action_inout *i
     LY_LIST_FOR_SAFE(inout->child, child_next, child) {
         lysc_node_free_(ctx, child);
     }
+    lyht_free(inout->children_ht);
+    LY_ARRAY_FREE(inout->children_flat);
+    LY_ARRAY_FREE(inout->children_choice);
 }
 
 void
@@ -836,6 +842,9 @@ lysc_node_notif_free(struct ly_ctx *ctx, struct lysc_node_notif *notif)
     LY_LIST_FOR_SAFE(notif->child, child_next, child) {
         lysc_node_free_(ctx, child);
     }
+    lyht_free(notif->children_ht);
+    LY_ARRAY_FREE(notif->children_flat);
+    LY_ARRAY_FREE(notif->children_choice);
 }
 
 void
@@ -854,6 +863,9 @@ lysc_node_container_free(struct ly_ctx *ctx, struct lysc_node_container *node)
     }
     FREE_ARRAY(ctx, node->when, lysc_when_free);
     FREE_ARRAY(ctx, node->musts, lysc_must_free);
+    lyht_free(node->children_ht);
+    LY_ARRAY_FREE(node->children_flat);
+    LY_ARRAY_FREE(node->children_choice);
 }
 
 static void
@@ -914,6 +926,9 @@ lysc_node_list_free(struct ly_ctx *ctx, struct lysc_node_list *node)
     LY_LIST_FOR_SAFE((struct lysc_node *)node->notifs, child_next, child) {
         lysc_node_free_(ctx, child);
     }
+    lyht_free(node->children_ht);
+    LY_ARRAY_FREE(node->children_flat);
+    LY_ARRAY_FREE(node->children_choice);
 }
 
 static void
@@ -925,6 +940,7 @@ lysc_node_choice_free(struct ly_ctx *ctx, struct lysc_node_choice *node)
     LY_LIST_FOR_SAFE((struct lysc_node *)node->cases, child_next, child) {
         lysc_node_free_(ctx, child);
     }
+    LY_ARRAY_FREE(node->children_flat);
 }
 
 static void
@@ -936,6 +952,8 @@ lysc_node_case_free(struct ly_ctx *ctx, struct lysc_node_case *node)
     LY_LIST_FOR_SAFE(node->child, child_next, child) {
         lysc_node_free_(ctx, child);
     }
+    LY_ARRAY_FREE(node->children_flat);
+    LY_ARRAY_FREE(node->children_choice);
 }
 
 static void
@@ -1014,6 +1032,12 @@ lysc_node_free(struct ly_ctx *ctx, struct lysc_node *node, ly_bool unlink)
             lysc_node_free_(ctx, iter);
         }
         inout->child = NULL;
+        lyht_free(inout->children_ht);
+        inout->children_ht = NULL;
+        LY_ARRAY_FREE(inout->children_flat);
+        inout->children_flat = NULL;
+        LY_ARRAY_FREE(inout->children_choice);
+        inout->children_choice = NULL;
         return;
     }
 
@@ -1093,6 +1117,9 @@ lysc_module_free(struct lysc_module *module)
         lysc_node_free_(ctx, node);
     }
     FREE_ARRAY(ctx, module->exts, lysc_ext_instance_free);
+    lyht_free(module->children_ht);
+    LY_ARRAY_FREE(module->children_flat);
+    LY_ARRAY_FREE(module->children_choice);
 
     free(module);
 }
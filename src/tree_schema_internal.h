@@ -41,6 +41,12 @@ struct lys_glob_unres;
  */
 #define LY_MAX_BLOCK_DEPTH 500
 
+/**
+ * @brief Minimal number of data children of a schema node (or top-level nodes of a module) to create their
+ * hash table, see ::lysc_node_container.children_ht.
+ */
+#define LYS_CHILDREN_HT_MIN_ITEMS 8
+
 /**
  * @brief Informational structure for YANG statements
  */
@@ -474,6 +480,83 @@ struct lysc_when ***lysc_node_when_p(const struct lysc_node *node);
  */
 struct lysc_must **lysc_node_musts_p(const struct lysc_node *node);
 
+/**
+ * @brief Get address of a node's data children hash table member if any.
+ *
+ * Do not use for RPC and action nodes.
+ *
+ * @param[in] node Node to check.
+ * @return Address of the node's children_ht member if any, NULL otherwise.
+ */
+struct hash_table **lysc_node_children_ht_p(const struct lysc_node *node);
+
+/**
+ * @brief Get address of a node's flattened children member if any.
+ *
+ * Do not use for RPC and action nodes.
+ *
+ * @param[in] node Node to check.
+ * @param[in] options Either 0 or ::LYS_GETNEXT_WITHCHOICE to get the children_flat or the children_choice member.
+ * @return Address of the node's member if any, NULL otherwise.
+ */
+const struct lysc_node ***lysc_node_children_p(const struct lysc_node *node, uint32_t options);
+
+/**
+ * @brief Create the flattened children and the data children hash tables of all the nodes of a compiled module
+ * and of its top-level nodes.
+ *
+ * Must be called only once the compiled module is final, after all the augments and deviations were applied and
+ * the disabled nodes removed.
+ *
+ * @param[in] mod Compiled module.
+ * @return LY_ERR value.
+ */
+LY_ERR lysc_module_children_index_create(struct lysc_module *mod);
+
+/**
+ * @brief Find a data child of a schema node or a top-level node of a module using their hash table.
+ *
+ * @param[in] parent Schema parent of the node, NULL for a top-level node.
+ * @param[in] module Module of the node.
+ * @param[in] name Name of the node.
+ * @param[in] name_len Length of @p name, 0 if it is terminated.
+ * @param[in] options [ORed options](@ref sgetnextflags) of ::lys_find_child().
+ * @param[out] match Found node, NULL if there is none.
+ * @return LY_SUCCESS if the hash table was searched, @p match is set.
+ * @return LY_ENOT if there is no hash table to search or it cannot be used with @p options.
+ */
+LY_ERR lysc_find_child_ht(const struct lysc_node *parent, const struct lys_module *module, const char *name,
+        size_t name_len, uint32_t options, const struct lysc_node **match);
+
+/**
+ * @brief Get the schema-order index of a child in the flattened children of a schema node or of the top-level nodes
+ * of a module, as returned by ::lys_getnext().
+ *
+ * @param[in] parent Schema parent of the node, NULL for a top-level node.
+ * @param[in] module Compiled module of the top-level node.
+ * @param[in] node Child to find.
+ * @param[in] options [ORed options](@ref sgetnextflags) of ::lys_getnext().
+ * @param[out] idx Index of @p node.
+ * @return LY_SUCCESS if the index was found.
+ * @return LY_ENOT if the children were not precomputed for @p options or @p node is not among them.
+ */
+LY_ERR lysc_node_child_idx(const struct lysc_node *parent, const struct lysc_module *module,
+        const struct lysc_node *node, uint32_t options, LY_ARRAY_COUNT_TYPE *idx);
+
+/**
+ * @brief Just like ::lys_getnext() but iterates over the precomputed flattened children, if available.
+ *
+ * @param[in] last Previously returned schema node, NULL for the first call.
+ * @param[in] parent Parent of the iterated children.
+ * @param[in] module Compiled module of the iterated top-level nodes.
+ * @param[in] options [ORed options](@ref sgetnextflags) of ::lys_getnext().
+ * @param[in,out] idx Schema-order index of @p last, set to the index of the returned node. Must be initialized,
+ * if it is not the index of @p last, the index is looked up.
+ * @return Next schema node, NULL if there are no more.
+ */
+const struct lysc_node *lys_getnext_idx(const struct lysc_node *last, const struct lysc_node *parent,
+        const struct lysc_module *module, uint32_t options, LY_ARRAY_COUNT_TYPE *idx);
+
 /**
  * @brief Find parsed extension definition for the given extension instance.
  *
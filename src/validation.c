@@ -16,11 +16,14 @@
 #include "validation.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "common.h"
 #include "compat.h"
@@ -31,6 +34,7 @@
 #include "parser_internal.h"
 #include "plugins_exts.h"
 #include "plugins_exts/metadata.h"
+#include "plugins_internal.h"
 #include "plugins_types.h"
 #include "set.h"
 #include "tree.h"
@@ -110,6 +114,373 @@ cleanup:
     return ret;
 }
 
+/**
+ * @brief Validation statistics of a context or of a thread.
+ */
+struct lyd_val_stats {
+    const struct ly_ctx *ctx;       /**< context of the statistics */
+    struct hash_table *ht;          /**< hash table of indexes into ::lyd_val_stats.stats */
+    struct lyd_val_stat *stats;     /**< statistics of the measured constraints */
+    uint32_t count;                 /**< number of the measured constraints */
+    uint32_t size;                  /**< allocated size of the statistics */
+};
+
+/**
+ * @brief Validation statistics collected by the thread without locking, added to the statistics of the context
+ * when stopped.
+ */
+static THREAD_LOCAL struct lyd_val_stats *thread_val_stats;
+
+/**
+ * @brief Get the current time for the validation statistics.
+ *
+ * @return Monotonic time in nanoseconds, 0 if not supported.
+ */
+static uint64_t
+lyd_val_stats_time(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (!clock_gettime(CLOCK_MONOTONIC, &ts)) {
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Hash table equal callback for validation statistics indexes.
+ */
+static ly_bool
+lyd_val_stats_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *cb_data)
+{
+    struct lyd_val_stats *vstats = cb_data;
+    const struct lyd_val_stat *stat1, *stat2;
+
+    stat1 = &vstats->stats[*(uint32_t *)val1_p];
+    stat2 = &vstats->stats[*(uint32_t *)val2_p];
+
+    return (stat1->schema == stat2->schema) && (stat1->kind == stat2->kind);
+}
+
+/**
+ * @brief Create new empty validation statistics.
+ *
+ * @param[in] ctx Context of the statistics.
+ * @param[out] vstats_p Created statistics.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_stats_new(const struct ly_ctx *ctx, struct lyd_val_stats **vstats_p)
+{
+    struct lyd_val_stats *vstats;
+
+    vstats = calloc(1, sizeof *vstats);
+    LY_CHECK_ERR_RET(!vstats, LOGMEM(ctx), LY_EMEM);
+    vstats->ht = lyht_new(LYHT_MIN_SIZE, sizeof(uint32_t), lyd_val_stats_equal_cb, vstats, 1);
+    LY_CHECK_ERR_RET(!vstats->ht, LOGMEM(ctx); free(vstats), LY_EMEM);
+    vstats->ctx = ctx;
+
+    *vstats_p = vstats;
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free validation statistics.
+ *
+ * @param[in] vstats Statistics to free.
+ */
+static void
+lyd_val_stats_free(struct lyd_val_stats *vstats)
+{
+    if (!vstats) {
+        return;
+    }
+
+    lyht_free(vstats->ht);
+    free(vstats->stats);
+    free(vstats);
+}
+
+/**
+ * @brief Add measured evaluations of a validation constraint into validation statistics.
+ *
+ * @param[in] vstats Statistics to add to.
+ * @param[in] schema Schema node with the constraint.
+ * @param[in] kind Kind of the constraint.
+ * @param[in] count Number of the evaluations.
+ * @param[in] time_ns Total time of the evaluations.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_stats_add(struct lyd_val_stats *vstats, const struct lysc_node *schema, enum lyd_val_stat_kind kind,
+        uint64_t count, uint64_t time_ns)
+{
+    struct lyd_val_stat *stat;
+    uint32_t hash, idx, *match;
+    void *mem;
+
+    /* prepare a new record to search with */
+    if (vstats->count == vstats->size) {
+        mem = realloc(vstats->stats, (vstats->size ? vstats->size * 2 : 32) * sizeof *vstats->stats);
+        LY_CHECK_ERR_RET(!mem, LOGMEM(vstats->ctx), LY_EMEM);
+        vstats->stats = mem;
+        vstats->size = vstats->size ? vstats->size * 2 : 32;
+    }
+    idx = vstats->count;
+    stat = &vstats->stats[idx];
+    memset(stat, 0, sizeof *stat);
+    stat->schema = schema;
+    stat->kind = kind;
+
+    hash = dict_hash_multi(0, (const char *)&schema, sizeof schema);
+    hash = dict_hash_multi(hash, (const char *)&kind, sizeof kind);
+    hash = dict_hash_multi(hash, NULL, 0);
+    if (!lyht_find(vstats->ht, &idx, hash, (void **)&match)) {
+        /* existing record */
+        stat = &vstats->stats[*match];
+    } else {
+        /* new record */
+        LY_CHECK_ERR_RET(lyht_insert(vstats->ht, &idx, hash, NULL), LOGMEM(vstats->ctx), LY_EMEM);
+        ++vstats->count;
+    }
+
+    stat->count += count;
+    stat->time_ns += time_ns;
+    return LY_SUCCESS;
+}
+
+uint64_t
+lyd_val_stats_start(const struct ly_ctx *ctx)
+{
+    if (!ATOMIC_LOAD_RELAXED(((struct ly_ctx *)ctx)->val_stats_enabled)) {
+        return 0;
+    }
+
+    return lyd_val_stats_time();
+}
+
+void
+lyd_val_stats_record(const struct ly_ctx *ctx, const struct lysc_node *schema, enum lyd_val_stat_kind kind,
+        uint64_t start)
+{
+    struct ly_ctx *mctx = (struct ly_ctx *)ctx;
+    uint64_t time_ns;
+
+    if (!start) {
+        return;
+    }
+    time_ns = lyd_val_stats_time() - start;
+
+    if (thread_val_stats && (thread_val_stats->ctx == ctx)) {
+        /* statistics of the thread */
+        lyd_val_stats_add(thread_val_stats, schema, kind, 1, time_ns);
+        return;
+    }
+
+    pthread_mutex_lock(&mctx->val_stats_lock);
+    if (ctx->val_stats) {
+        lyd_val_stats_add(ctx->val_stats, schema, kind, 1, time_ns);
+    }
+    pthread_mutex_unlock(&mctx->val_stats_lock);
+}
+
+/**
+ * @brief Start collecting validation statistics of a context by this thread, if they are enabled.
+ *
+ * @param[in] ctx Context of the statistics.
+ * @return Previous statistics of the thread to pass to ::lyd_val_stats_thread_stop().
+ */
+static struct lyd_val_stats *
+lyd_val_stats_thread_start(const struct ly_ctx *ctx)
+{
+    struct lyd_val_stats *prev = thread_val_stats;
+
+    if (!ATOMIC_LOAD_RELAXED(((struct ly_ctx *)ctx)->val_stats_enabled) || (prev && (prev->ctx == ctx))) {
+        /* not enabled or already collected by this thread */
+        return prev;
+    }
+
+    if (lyd_val_stats_new(ctx, &thread_val_stats)) {
+        /* recorded directly */
+        thread_val_stats = prev;
+    }
+    return prev;
+}
+
+/**
+ * @brief Stop collecting validation statistics by this thread, add them to the statistics of the context.
+ *
+ * @param[in] prev Previous statistics returned by ::lyd_val_stats_thread_start().
+ */
+static void
+lyd_val_stats_thread_stop(struct lyd_val_stats *prev)
+{
+    struct lyd_val_stats *tstats = thread_val_stats;
+    struct ly_ctx *mctx;
+    uint32_t i;
+
+    if (tstats == prev) {
+        return;
+    }
+    thread_val_stats = prev;
+
+    mctx = (struct ly_ctx *)tstats->ctx;
+    pthread_mutex_lock(&mctx->val_stats_lock);
+    for (i = 0; mctx->val_stats && (i < tstats->count); ++i) {
+        if (lyd_val_stats_add(mctx->val_stats, tstats->stats[i].schema, tstats->stats[i].kind, tstats->stats[i].count,
+                tstats->stats[i].time_ns)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mctx->val_stats_lock);
+
+    lyd_val_stats_free(tstats);
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_val_stats_enable(struct ly_ctx *ctx, ly_bool enable)
+{
+    LY_ERR rc = LY_SUCCESS;
+
+    LY_CHECK_ARG_RET(ctx, ctx, LY_EINVAL);
+
+    pthread_mutex_lock(&ctx->val_stats_lock);
+
+    /* discard the previous statistics */
+    ATOMIC_STORE_RELAXED(ctx->val_stats_enabled, 0);
+    lyd_val_stats_free(ctx->val_stats);
+    ctx->val_stats = NULL;
+
+    if (enable) {
+        LY_CHECK_GOTO(rc = lyd_val_stats_new(ctx, &ctx->val_stats), cleanup);
+        ATOMIC_STORE_RELAXED(ctx->val_stats_enabled, 1);
+    }
+
+cleanup:
+    pthread_mutex_unlock(&ctx->val_stats_lock);
+    return rc;
+}
+
+void
+lyd_val_stats_clear(struct ly_ctx *ctx)
+{
+    pthread_mutex_lock(&ctx->val_stats_lock);
+    if (ctx->val_stats && ctx->val_stats->count) {
+        /* the measured schema nodes may be freed, start again */
+        lyd_val_stats_free(ctx->val_stats);
+        ctx->val_stats = NULL;
+        if (lyd_val_stats_new(ctx, &ctx->val_stats)) {
+            ATOMIC_STORE_RELAXED(ctx->val_stats_enabled, 0);
+        }
+    }
+    pthread_mutex_unlock(&ctx->val_stats_lock);
+}
+
+/**
+ * @brief Sort callback for validation statistics, the most expensive first.
+ */
+static int
+lyd_val_stats_sort_cb(const void *ptr1, const void *ptr2)
+{
+    const struct lyd_val_stat *stat1 = ptr1, *stat2 = ptr2;
+    int r;
+
+    if (stat1->time_ns != stat2->time_ns) {
+        return (stat1->time_ns < stat2->time_ns) ? 1 : -1;
+    }
+    if (stat1->count != stat2->count) {
+        return (stat1->count < stat2->count) ? 1 : -1;
+    }
+
+    /* deterministic order of equal statistics */
+    r = strcmp(stat1->schema->module->name, stat2->schema->module->name);
+    if (!r) {
+        r = strcmp(stat1->schema->name, stat2->schema->name);
+    }
+    if (!r) {
+        r = (int)stat1->kind - (int)stat2->kind;
+    }
+    return r;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_val_stats_get(const struct ly_ctx *ctx, struct lyd_val_stat **stats, uint32_t *count)
+{
+    LY_ERR rc = LY_SUCCESS;
+    struct ly_ctx *mctx = (struct ly_ctx *)ctx;
+
+    LY_CHECK_ARG_RET(ctx, ctx, stats, count, LY_EINVAL);
+
+    *stats = NULL;
+    *count = 0;
+
+    pthread_mutex_lock(&mctx->val_stats_lock);
+    if (!ctx->val_stats) {
+        LOGERR(ctx, LY_EINVAL, "Validation statistics are not enabled.");
+        rc = LY_EINVAL;
+        goto cleanup;
+    }
+
+    if (ctx->val_stats->count) {
+        *stats = malloc(ctx->val_stats->count * sizeof **stats);
+        LY_CHECK_ERR_GOTO(!*stats, LOGMEM(ctx); rc = LY_EMEM, cleanup);
+        memcpy(*stats, ctx->val_stats->stats, ctx->val_stats->count * sizeof **stats);
+        *count = ctx->val_stats->count;
+    }
+
+cleanup:
+    pthread_mutex_unlock(&mctx->val_stats_lock);
+    if (*stats) {
+        qsort(*stats, *count, sizeof **stats, lyd_val_stats_sort_cb);
+    }
+    return rc;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_val_stats_print(const struct ly_ctx *ctx, char **report)
+{
+    LY_ERR rc;
+    struct lyd_val_stat *stats = NULL;
+    uint32_t count, i;
+    uint64_t total = 0;
+    char *path;
+    const char *kinds[] = {"when", "must", "unique", "leafref", "type"};
+
+    LY_CHECK_ARG_RET(ctx, ctx, report, LY_EINVAL);
+
+    *report = NULL;
+    LY_CHECK_RET(lyd_val_stats_get(ctx, &stats, &count));
+
+    for (i = 0; i < count; ++i) {
+        total += stats[i].time_ns;
+    }
+    rc = ly_strcat(report, "Validation statistics, %" PRIu32 " constraints, total time %.3f us\n", count,
+            total / 1000.0);
+    LY_CHECK_GOTO(rc, cleanup);
+    rc = ly_strcat(report, "%10s %12s  %-8s %s\n", "count", "time [us]", "kind", "schema node");
+    LY_CHECK_GOTO(rc, cleanup);
+
+    for (i = 0; i < count; ++i) {
+        path = lysc_path(stats[i].schema, LYSC_PATH_LOG, NULL, 0);
+        LY_CHECK_ERR_GOTO(!path, rc = LY_EMEM, cleanup);
+        rc = ly_strcat(report, "%10" PRIu64 " %12.3f  %-8s %s\n", stats[i].count, stats[i].time_ns / 1000.0,
+                kinds[stats[i].kind], path);
+        free(path);
+        LY_CHECK_GOTO(rc, cleanup);
+    }
+
+cleanup:
+    free(stats);
+    if (rc) {
+        LOGMEM(ctx);
+        free(*report);
+        *report = NULL;
+    }
+    return rc;
+}
+
 /**
  * @brief Evaluate all relevant "when" conditions of a node.
  *
@@ -130,6 +501,7 @@ lyd_validate_node_when(const struct lyd_node *tree, const struct lyd_node *node,
     const struct lyd_node *ctx_node;
     struct lyxp_set xp_set;
     LY_ARRAY_COUNT_TYPE u;
+    uint64_t start;
 
     assert(!node->schema || (node->schema == schema));
 
@@ -151,8 +523,10 @@ lyd_validate_node_when(const struct lyd_node *tree, const struct lyd_node *node,
 
             /* evaluate when */
             memset(&xp_set, 0, sizeof xp_set);
+            start = lyd_val_stats_start(LYD_CTX(node));
             ret = lyxp_eval(LYD_CTX(node), when->cond, schema->module, LY_VALUE_SCHEMA_RESOLVED, when->prefixes,
-                    ctx_node, tree, NULL, &xp_set, LYXP_SCHEMA | xpath_options);
+                    ctx_node, tree, NULL, &xp_set, LYXP_SCHEMA | LYXP_EVAL_EXISTS | xpath_options);
+            lyd_val_stats_record(LYD_CTX(node), schema, LYD_VAL_STAT_WHEN, start);
             lyxp_set_cast(&xp_set, LYXP_SET_BOOLEAN);
 
             /* return error or LY_EINCOMPLETE for dependant unresolved when */
@@ -193,11 +567,15 @@ lyd_validate_unres_when(struct lyd_node **tree, const struct lys_module *mod, st
     uint32_t i, idx;
     const struct lysc_when *disabled;
     struct lyd_node *node = NULL, *elem;
+    struct lyxp_result_cache *prev_result_cache;
 
     if (!node_when->count) {
         return LY_SUCCESS;
     }
 
+    /* the same absolute paths are often used by the when of many sibling instances */
+    prev_result_cache = lyxp_result_cache_start();
+
     i = node_when->count;
     do {
         --i;
@@ -228,8 +606,9 @@ lyd_validate_unres_when(struct lyd_node **tree, const struct lys_module *mod, st
                         }
                     }
 
-                    /* free */
+                    /* free, the cached results may include it */
                     lyd_free_tree(node);
+                    lyxp_result_cache_clear();
                 } else {
                     /* invalid data */
                     LOGVAL(LYD_CTX(node), LY_VCODE_NOWHEN, disabled->cond->expr);
@@ -251,19 +630,64 @@ lyd_validate_unres_when(struct lyd_node **tree, const struct lys_module *mod, st
         LOG_LOCBACK(1, 1, 0, 0);
     } while (i);
 
+    lyxp_result_cache_stop(prev_result_cache);
     return LY_SUCCESS;
 
 error:
     LOG_LOCBACK(1, 1, 0, 0);
+    lyxp_result_cache_stop(prev_result_cache);
     return ret;
 }
 
+static LY_ERR lyd_val_mt_types(const struct lyd_node *tree, struct ly_set *node_types);
+
+/**
+ * @brief Finish validation of an incompletely validated terminal value.
+ *
+ * @param[in] node Terminal node with the value.
+ * @param[in] tree Data tree.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_unres_type(struct lyd_node_term *node, const struct lyd_node *tree)
+{
+    LY_ERR ret, r;
+    struct lysc_type *type = ((struct lysc_node_leaf *)node->schema)->type;
+
+    /* resolve the value of the node, an indexed leaf is hashed by its value */
+    lyd_unlink_index(&node->node);
+    LOG_LOCSET(node->schema, &node->node, NULL, NULL);
+    ret = lyd_value_validate_incomplete(LYD_CTX(node), type, &node->value, &node->node, tree);
+    LOG_LOCBACK(node->schema ? 1 : 0, 1, 0, 0);
+    r = lyd_insert_index(&node->node);
+
+    return r ? r : ret;
+}
+
+/**
+ * @brief Check whether the resolution of a value modifies the data tree so it cannot be done by the workers
+ * of multi-threaded validation.
+ *
+ * A union stores the resolved subvalue and an indexed leaf is rehashed in its parent.
+ *
+ * @param[in] node Terminal node with the value.
+ * @return Whether the value must be resolved serially.
+ */
+static ly_bool
+lyd_val_mt_type_serial(const struct lyd_node_term *node)
+{
+    return (((struct lysc_node_leaf *)node->schema)->type->basetype == LY_TYPE_UNION) ||
+           (node->schema->flags & LYS_INDEXED);
+}
+
 LY_ERR
 lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, enum lyd_type data_type, struct ly_set *node_when,
         uint32_t when_xp_opts, struct ly_set *node_types, struct ly_set *meta_types, struct ly_set *ext_val,
         uint32_t val_opts, struct lyd_node **diff)
 {
     LY_ERR ret = LY_SUCCESS;
+    struct lyplg_lref_cache *prev_lref_cache = NULL;
+    ly_bool lref_cache = 0;
     uint32_t i;
 
     if (ext_val && ext_val->count) {
@@ -296,6 +720,12 @@ lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, enum ly
         assert(!node_when->count);
     }
 
+    if ((node_types && node_types->count) || (meta_types && meta_types->count)) {
+        /* the data tree does not change anymore, leafref targets can be cached */
+        prev_lref_cache = lyplg_type_leafref_cache_start();
+        lref_cache = 1;
+    }
+
     if (node_types && node_types->count) {
         /* finish incompletely validated terminal values (traverse from the end for efficient set removal) */
         i = node_types->count;
@@ -303,17 +733,25 @@ lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, enum ly
             --i;
 
             struct lyd_node_term *node = node_types->objs[i];
-            struct lysc_type *type = ((struct lysc_node_leaf *)node->schema)->type;
 
-            /* resolve the value of the node */
-            LOG_LOCSET(node->schema, &node->node, NULL, NULL);
-            ret = lyd_value_validate_incomplete(LYD_CTX(node), type, &node->value, &node->node, *tree);
-            LOG_LOCBACK(node->schema ? 1 : 0, 1, 0, 0);
-            LY_CHECK_RET(ret);
+            if ((val_opts & LYD_VALIDATE_MULTI_THREADED) && !lyd_val_mt_type_serial(node)) {
+                /* resolved by the workers */
+                continue;
+            }
+
+            ret = lyd_validate_unres_type(node, *tree);
+            LY_CHECK_GOTO(ret, cleanup);
 
             /* remove this node from the set */
             ly_set_rm_index(node_types, i, NULL);
         } while (i);
+
+        if (node_types->count) {
+            /* resolve the remaining values in parallel */
+            ret = lyd_val_mt_types(*tree, node_types);
+            LY_CHECK_GOTO(ret, cleanup);
+            ly_set_clean(node_types, NULL);
+        }
     }
 
     if (meta_types && meta_types->count) {
@@ -327,13 +765,17 @@ lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, enum ly
 
             /* validate and store the value of the metadata */
             ret = lyd_value_validate_incomplete(LYD_CTX(meta->parent), type, &meta->value, meta->parent, *tree);
-            LY_CHECK_RET(ret);
+            LY_CHECK_GOTO(ret, cleanup);
 
             /* remove this attr from the set */
             ly_set_rm_index(meta_types, i, NULL);
         } while (i);
     }
 
+cleanup:
+    if (lref_cache) {
+        lyplg_type_leafref_cache_stop(prev_lref_cache);
+    }
     return ret;
 }
 
@@ -632,8 +1074,10 @@ lyd_validate_choice_r(struct lyd_node **first, const struct lysc_node *sparent,
         struct lyd_node **diff)
 {
     const struct lysc_node *snode = NULL;
+    LY_ARRAY_COUNT_TYPE idx = 0;
 
-    while (*first && (snode = lys_getnext(snode, sparent, mod ? mod->compiled : NULL, LYS_GETNEXT_WITHCHOICE))) {
+    while (*first && (snode = lys_getnext_idx(snode, sparent, mod ? mod->compiled : NULL, LYS_GETNEXT_WITHCHOICE,
+            &idx))) {
         /* check case duplicites */
         if (snode->nodetype == LYS_CHOICE) {
             LY_CHECK_RET(lyd_validate_cases(first, mod, (struct lysc_node_choice *)snode, diff));
@@ -701,17 +1145,28 @@ lyd_validate_new(struct lyd_node **first, const struct lysc_node *sparent, const
  * @param[in] first First data sibling of the non-existing node.
  * @param[in] parent Data parent of the non-existing node.
  * @param[in] snode Schema node of the non-existing node.
+ * @param[in] int_opts Internal parser options.
  * @param[out] disabled First when that evaluated false, if any.
  * @return LY_ERR value.
+ * @return LY_EINCOMPLETE if called by a validation worker thread, which cannot create the dummy node.
  */
 static LY_ERR
 lyd_validate_dummy_when(const struct lyd_node *first, const struct lyd_node *parent, const struct lysc_node *snode,
-        const struct lysc_when **disabled)
+        uint32_t int_opts, const struct lysc_when **disabled)
 {
     LY_ERR ret = LY_SUCCESS;
     struct lyd_node *tree, *dummy = NULL;
+    struct lyxp_result_cache *result_cache;
     uint32_t xp_opts;
 
+    if (int_opts & LYD_INTOPT_VAL_MT) {
+        /* the data tree must not be modified */
+        return LY_EINCOMPLETE;
+    }
+
+    /* the cached results do not include the dummy node */
+    result_cache = lyxp_result_cache_suspend();
+
     /* find root */
     if (parent) {
         tree = (struct lyd_node *)parent;
@@ -759,6 +1214,7 @@ lyd_validate_dummy_when(const struct lyd_node *first, const struct lyd_node *par
 
 cleanup:
     lyd_free_tree(dummy);
+    lyxp_result_cache_resume(result_cache);
     return ret;
 }
 
@@ -768,10 +1224,12 @@ cleanup:
  * @param[in] first First sibling to search in.
  * @param[in] parent Data parent.
  * @param[in] snode Schema node to validate.
+ * @param[in] int_opts Internal parser options.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_validate_mandatory(const struct lyd_node *first, const struct lyd_node *parent, const struct lysc_node *snode)
+lyd_validate_mandatory(const struct lyd_node *first, const struct lyd_node *parent, const struct lysc_node *snode,
+        uint32_t int_opts)
 {
     const struct lysc_when *disabled;
 
@@ -792,7 +1250,7 @@ lyd_validate_mandatory(const struct lyd_node *first, const struct lyd_node *pare
     disabled = NULL;
     if (lysc_has_when(snode)) {
         /* if there are any when conditions, they must be true for a validation error */
-        LY_CHECK_RET(lyd_validate_dummy_when(first, parent, snode, &disabled));
+        LY_CHECK_RET(lyd_validate_dummy_when(first, parent, snode, int_opts, &disabled));
     }
 
     if (!disabled) {
@@ -816,11 +1274,12 @@ lyd_validate_mandatory(const struct lyd_node *first, const struct lyd_node *pare
  * @param[in] snode Schema node to validate.
  * @param[in] min Minimum number of elements, 0 for no restriction.
  * @param[in] max Max number of elements, 0 for no restriction.
+ * @param[in] int_opts Internal parser options.
  * @return LY_ERR value.
  */
 static LY_ERR
 lyd_validate_minmax(const struct lyd_node *first, const struct lyd_node *parent, const struct lysc_node *snode,
-        uint32_t min, uint32_t max)
+        uint32_t min, uint32_t max, uint32_t int_opts)
 {
     uint32_t count = 0;
     struct lyd_node *iter;
@@ -854,7 +1313,7 @@ lyd_validate_minmax(const struct lyd_node *first, const struct lyd_node *parent,
         disabled = NULL;
         if (lysc_has_when(snode)) {
             /* if there are any when conditions, they must be true for a validation error */
-            LY_CHECK_RET(lyd_validate_dummy_when(first, parent, snode, &disabled));
+            LY_CHECK_RET(lyd_validate_dummy_when(first, parent, snode, int_opts, &disabled));
         }
 
         if (!disabled) {
@@ -1023,10 +1482,12 @@ uniquecheck:
  * @param[in] first First sibling to search in.
  * @param[in] snode Schema node to validate.
  * @param[in] uniques List unique arrays to validate.
+ * @param[in] uniq_check Optional flags for each of @p uniques whether to validate it, all are validated if not set.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode, const struct lysc_node_leaf ***uniques)
+lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode, const struct lysc_node_leaf ***uniques,
+        const ly_bool *uniq_check)
 {
     const struct lyd_node *diter;
     struct ly_set *set;
@@ -1052,13 +1513,22 @@ lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode,
         }
     }
 
-    if (set->count == 2) {
+    if ((set->count == 2) && !uniq_check) {
         /* simple comparison */
         if (lyd_val_uniq_list_equal(&set->objs[0], &set->objs[1], 0, (void *)0)) {
             /* instance duplication */
             ret = LY_EVALID;
             goto cleanup;
         }
+    } else if ((set->count == 2) && uniq_check) {
+        /* simple comparison of the selected uniques */
+        LY_ARRAY_FOR(uniques, u) {
+            if (uniq_check[u] && lyd_val_uniq_list_equal(&set->objs[0], &set->objs[1], 0, (void *)(uintptr_t)(u + 1))) {
+                /* instance duplication */
+                ret = LY_EVALID;
+                goto cleanup;
+            }
+        }
     } else if (set->count > 2) {
         /* use hashes for comparison */
         /* first, allocate the table, the size depends on number of items in the set,
@@ -1076,10 +1546,13 @@ lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode,
         /* ... and by using it to shift 1 to the left we get the closest sufficient hash table size */
         size = 1 << i;
 
-        uniqtables = malloc(LY_ARRAY_COUNT(uniques) * sizeof *uniqtables);
+        uniqtables = calloc(LY_ARRAY_COUNT(uniques), sizeof *uniqtables);
         LY_CHECK_ERR_GOTO(!uniqtables, LOGMEM(ctx); ret = LY_EMEM, cleanup);
         x = LY_ARRAY_COUNT(uniques);
         for (v = 0; v < x; v++) {
+            if (uniq_check && !uniq_check[v]) {
+                continue;
+            }
             cb_data = (void *)(uintptr_t)(v + 1L);
             uniqtables[v] = lyht_new(size, sizeof(struct lyd_node *), lyd_val_uniq_list_equal, cb_data, 0);
             LY_CHECK_ERR_GOTO(!uniqtables[v], LOGMEM(ctx); ret = LY_EMEM, cleanup);
@@ -1088,6 +1561,10 @@ lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode,
         for (i = 0; i < set->count; i++) {
             /* loop for unique - get the hash for the instances */
             for (u = 0; u < x; u++) {
+                if (!uniqtables[u]) {
+                    /* not validated */
+                    continue;
+                }
                 val = NULL;
                 for (v = hash = 0; v < LY_ARRAY_COUNT(uniques[u]); v++) {
                     diter = lyd_val_uniq_find_leaf(uniques[u][v], set->objs[i]);
@@ -1131,10 +1608,6 @@ lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode,
 cleanup:
     ly_set_free(set, NULL);
     for (v = 0; v < x; v++) {
-        if (!uniqtables[v]) {
-            /* failed when allocating uniquetables[j], following j are not allocated */
-            break;
-        }
         lyht_free(uniqtables[v]);
     }
     free(uniqtables);
@@ -1162,11 +1635,13 @@ lyd_validate_siblings_schema_r(const struct lyd_node *first, const struct lyd_no
     struct lysc_node_list *slist;
     struct lysc_node_leaflist *sllist;
     uint32_t getnext_opts;
+    uint64_t start;
+    LY_ARRAY_COUNT_TYPE idx = 0;
 
     getnext_opts = LYS_GETNEXT_WITHCHOICE | (int_opts & LYD_INTOPT_REPLY ? LYS_GETNEXT_OUTPUT : 0);
 
     /* disabled nodes are skipped by lys_getnext */
-    while ((snode = lys_getnext(snode, sparent, mod, getnext_opts))) {
+    while ((snode = lys_getnext_idx(snode, sparent, mod, getnext_opts, &idx))) {
         if ((val_opts & LYD_VALIDATE_NO_STATE) && (snode->flags & LYS_CONFIG_R)) {
             continue;
         }
@@ -1177,19 +1652,19 @@ lyd_validate_siblings_schema_r(const struct lyd_node *first, const struct lyd_no
         if (snode->nodetype == LYS_LIST) {
             slist = (struct lysc_node_list *)snode;
             if (slist->min || slist->max) {
-                ret = lyd_validate_minmax(first, parent, snode, slist->min, slist->max);
+                ret = lyd_validate_minmax(first, parent, snode, slist->min, slist->max, int_opts);
                 LY_CHECK_GOTO(ret, error);
             }
         } else if (snode->nodetype == LYS_LEAFLIST) {
             sllist = (struct lysc_node_leaflist *)snode;
             if (sllist->min || sllist->max) {
-                ret = lyd_validate_minmax(first, parent, snode, sllist->min, sllist->max);
+                ret = lyd_validate_minmax(first, parent, snode, sllist->min, sllist->max, int_opts);
                 LY_CHECK_GOTO(ret, error);
             }
 
         } else if (snode->flags & LYS_MAND_TRUE) {
             /* check generic mandatory existence */
-            ret = lyd_validate_mandatory(first, parent, snode);
+            ret = lyd_validate_mandatory(first, parent, snode, int_opts);
             LY_CHECK_GOTO(ret, error);
         }
 
@@ -1197,7 +1672,9 @@ lyd_validate_siblings_schema_r(const struct lyd_node *first, const struct lyd_no
         if (snode->nodetype == LYS_LIST) {
             slist = (struct lysc_node_list *)snode;
             if (slist->uniques) {
-                ret = lyd_validate_unique(first, snode, (const struct lysc_node_leaf ***)slist->uniques);
+                start = lyd_val_stats_start(snode->module->ctx);
+                ret = lyd_validate_unique(first, snode, (const struct lysc_node_leaf ***)slist->uniques, NULL);
+                lyd_val_stats_record(snode->module->ctx, snode, LYD_VAL_STAT_UNIQUE, start);
                 LY_CHECK_GOTO(ret, error);
             }
         }
@@ -1263,6 +1740,7 @@ lyd_validate_must(const struct lyd_node *node, uint32_t int_opts, uint32_t xpath
     const struct lysc_node *schema;
     const char *emsg, *eapptag;
     LY_ARRAY_COUNT_TYPE u;
+    uint64_t start;
 
     assert((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_REPLY)) != (LYD_INTOPT_RPC | LYD_INTOPT_REPLY));
     assert((int_opts & (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY)) != (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY));
@@ -1292,8 +1770,10 @@ lyd_validate_must(const struct lyd_node *node, uint32_t int_opts, uint32_t xpath
         memset(&xp_set, 0, sizeof xp_set);
 
         /* evaluate must */
+        start = lyd_val_stats_start(LYD_CTX(node));
         ret = lyxp_eval(LYD_CTX(node), musts[u].cond, node->schema->module, LY_VALUE_SCHEMA_RESOLVED,
-                musts[u].prefixes, node, tree, NULL, &xp_set, LYXP_SCHEMA | xpath_options);
+                musts[u].prefixes, node, tree, NULL, &xp_set, LYXP_SCHEMA | LYXP_EVAL_EXISTS | xpath_options);
+        lyd_val_stats_record(LYD_CTX(node), schema, LYD_VAL_STAT_MUST, start);
         if (ret == LY_EINCOMPLETE) {
             LOGINT_RET(LYD_CTX(node));
         } else if (ret) {
@@ -1318,6 +1798,79 @@ lyd_validate_must(const struct lyd_node *node, uint32_t int_opts, uint32_t xpath
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Perform all remaining validation tasks of a single node, the data tree must be final.
+ *
+ * @param[in] node Node to validate.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[in] int_opts Internal parser options.
+ * @param[in] must_xp_opts Additional XPath options to use for evaluating "must".
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_final_node(const struct lyd_node *node, uint32_t val_opts, uint32_t int_opts, uint32_t must_xp_opts)
+{
+    LY_ERR r = LY_SUCCESS;
+    const char *innode;
+
+    LOG_LOCSET(node->schema, node, NULL, NULL);
+
+    /* no state/input/output/op data */
+    innode = NULL;
+    if ((val_opts & LYD_VALIDATE_NO_STATE) && (node->schema->flags & LYS_CONFIG_R)) {
+        innode = "state";
+    } else if ((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_ACTION)) && (node->schema->flags & LYS_IS_OUTPUT)) {
+        innode = "output";
+    } else if ((int_opts & LYD_INTOPT_REPLY) && (node->schema->flags & LYS_IS_INPUT)) {
+        innode = "input";
+    } else if (!(int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_REPLY)) && (node->schema->nodetype == LYS_RPC)) {
+        innode = "rpc";
+    } else if (!(int_opts & (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY)) && (node->schema->nodetype == LYS_ACTION)) {
+        innode = "action";
+    } else if (!(int_opts & LYD_INTOPT_NOTIF) && (node->schema->nodetype == LYS_NOTIF)) {
+        innode = "notification";
+    }
+    if (innode) {
+        LOGVAL(LYD_CTX(node), LY_VCODE_UNEXPNODE, innode, node->schema->name);
+        r = LY_EVALID;
+        goto cleanup;
+    }
+
+    /* obsolete data */
+    lyd_validate_obsolete(node);
+
+    /* node's musts */
+    r = lyd_validate_must(node, int_opts, must_xp_opts);
+
+    /* node value was checked by plugins */
+
+cleanup:
+    LOG_LOCBACK(1, 1, 0, 0);
+    return r;
+}
+
+/**
+ * @brief Set the default flag of a non-presence container with only default children.
+ *
+ * @param[in] node Node to update.
+ */
+static void
+lyd_validate_cont_dflt(struct lyd_node *node)
+{
+    struct lyd_node *child;
+
+    if (!node->schema || (node->schema->nodetype != LYS_CONTAINER) || (node->schema->flags & LYS_PRESENCE)) {
+        return;
+    }
+
+    LY_LIST_FOR(lyd_child(node), child) {
+        if (!(child->flags & LYD_DEFAULT)) {
+            return;
+        }
+    }
+    node->flags |= LYD_DEFAULT;
+}
+
 /**
  * @brief Perform all remaining validation tasks, the data tree must be final when calling this function.
  *
@@ -1335,7 +1888,6 @@ lyd_validate_final_r(struct lyd_node *first, const struct lyd_node *parent, cons
         const struct lys_module *mod, uint32_t val_opts, uint32_t int_opts, uint32_t must_xp_opts)
 {
     LY_ERR r;
-    const char *innode;
     struct lyd_node *next = NULL, *node;
 
     /* validate all restrictions of nodes themselves */
@@ -1345,10 +1897,9 @@ lyd_validate_final_r(struct lyd_node *first, const struct lyd_node *parent, cons
             continue;
         }
 
-        LOG_LOCSET(node->schema, node, NULL, NULL);
-
         /* opaque data */
         if (!node->schema) {
+            LOG_LOCSET(NULL, node, NULL, NULL);
             r = lyd_parse_opaq_error(node);
             LOG_LOCBACK(0, 1, 0, 0);
             return r;
@@ -1356,74 +1907,474 @@ lyd_validate_final_r(struct lyd_node *first, const struct lyd_node *parent, cons
 
         if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
             /* all top-level data from this module checked */
-            LOG_LOCBACK(1, 1, 0, 0);
             break;
         }
 
-        /* no state/input/output/op data */
-        innode = NULL;
-        if ((val_opts & LYD_VALIDATE_NO_STATE) && (node->schema->flags & LYS_CONFIG_R)) {
-            innode = "state";
-        } else if ((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_ACTION)) && (node->schema->flags & LYS_IS_OUTPUT)) {
-            innode = "output";
-        } else if ((int_opts & LYD_INTOPT_REPLY) && (node->schema->flags & LYS_IS_INPUT)) {
-            innode = "input";
-        } else if (!(int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_REPLY)) && (node->schema->nodetype == LYS_RPC)) {
-            innode = "rpc";
-        } else if (!(int_opts & (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY)) && (node->schema->nodetype == LYS_ACTION)) {
-            innode = "action";
-        } else if (!(int_opts & LYD_INTOPT_NOTIF) && (node->schema->nodetype == LYS_NOTIF)) {
-            innode = "notification";
-        }
-        if (innode) {
-            LOGVAL(LYD_CTX(node), LY_VCODE_UNEXPNODE, innode, node->schema->name);
-            LOG_LOCBACK(1, 1, 0, 0);
-            return LY_EVALID;
-        }
+        LY_CHECK_RET(lyd_validate_final_node(node, val_opts, int_opts, must_xp_opts));
+    }
 
-        /* obsolete data */
-        lyd_validate_obsolete(node);
+    /* validate schema-based restrictions */
+    LY_CHECK_RET(lyd_validate_siblings_schema_r(first, parent, sparent, mod ? mod->compiled : NULL, val_opts, int_opts));
 
-        /* node's musts */
-        if ((r = lyd_validate_must(node, int_opts, must_xp_opts))) {
-            LOG_LOCBACK(1, 1, 0, 0);
-            return r;
-        }
+    LY_LIST_FOR(first, node) {
+        if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
+            /* all top-level data from this module checked */
+            break;
+        }
 
-        /* node value was checked by plugins */
+        /* validate all children recursively */
+        LY_CHECK_RET(lyd_validate_final_r(lyd_child(node), node, node->schema, NULL, val_opts, int_opts, must_xp_opts));
 
-        /* next iter */
-        LOG_LOCBACK(1, 1, 0, 0);
+        if (!(int_opts & LYD_INTOPT_VAL_MT)) {
+            lyd_validate_cont_dflt(node);
+        }
     }
 
-    /* validate schema-based restrictions */
-    LY_CHECK_RET(lyd_validate_siblings_schema_r(first, parent, sparent, mod ? mod->compiled : NULL, val_opts, int_opts));
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Number of nodes processed by a single work unit of multi-threaded validation.
+ */
+#define LYD_VAL_MT_CHUNK 64
+
+/**
+ * @brief Types of multi-threaded validation work units.
+ */
+enum lyd_val_mt_type {
+    LYD_VAL_MT_NODES,       /**< final validation of the nodes themselves */
+    LYD_VAL_MT_SIBLINGS,    /**< schema-based validation of siblings */
+    LYD_VAL_MT_SUBTREES,    /**< final validation of the descendants of the nodes */
+    LYD_VAL_MT_OPAQ,        /**< opaque node error */
+    LYD_VAL_MT_TYPES        /**< resolution of incompletely validated terminal values */
+};
+
+/**
+ * @brief Multi-threaded validation work unit.
+ */
+struct lyd_val_mt_unit {
+    enum lyd_val_mt_type type;      /**< unit type */
+    struct lyd_node *first;         /**< first node of the unit */
+    const struct lyd_node *parent;  /**< data parent of the siblings (::LYD_VAL_MT_SIBLINGS) */
+    const struct lysc_node *sparent;    /**< schema parent of the siblings (::LYD_VAL_MT_SIBLINGS) */
+    const struct lys_module *mod;   /**< module of top-level siblings (::LYD_VAL_MT_SIBLINGS) */
+    uint32_t idx;                   /**< index of the first value in the set (::LYD_VAL_MT_TYPES) */
+    uint32_t count;                 /**< number of the nodes or values of the unit */
+
+    LY_ERR ret;                     /**< result of the unit */
+    struct ly_err_item *log;        /**< captured messages of the unit */
+};
+
+/**
+ * @brief Multi-threaded validation context.
+ *
+ * Units are stored in the order a serial validation would process them and the messages of every unit are captured,
+ * so that the logged messages and the returned error are the same regardless of the order the units are processed in.
+ */
+struct lyd_val_mt {
+    const struct ly_ctx *ctx;       /**< context */
+    struct lyd_val_mt_unit *units;  /**< work units */
+    uint32_t count;                 /**< number of work units */
+    uint32_t size;                  /**< allocated size of work units */
+
+    uint32_t val_opts;              /**< validation options */
+    uint32_t int_opts;              /**< internal options of processing the units */
+    const struct lyd_node *tree;    /**< data tree (::LYD_VAL_MT_TYPES) */
+    struct ly_set *node_types;      /**< set of the values to resolve (::LYD_VAL_MT_TYPES) */
+
+    ATOMIC_T next;                  /**< index of the next unit to process */
+    ATOMIC_T failed;                /**< lowest index of a failed unit, ::lyd_val_mt.count if none */
+    pthread_mutex_t lock;           /**< lock for updating the failed unit */
+    struct lyxp_profiles *profiles; /**< XPath profiles of the calling thread to add the profiles of the workers to */
+};
+
+/**
+ * @brief Add a new work unit.
+ *
+ * @param[in] mt Multi-threaded validation context.
+ * @param[in] type Unit type.
+ * @param[in] first First node of the unit.
+ * @param[in] count Number of the nodes or values of the unit.
+ * @return New unit, NULL on memory allocation error.
+ */
+static struct lyd_val_mt_unit *
+lyd_val_mt_unit_new(struct lyd_val_mt *mt, enum lyd_val_mt_type type, struct lyd_node *first, uint32_t count)
+{
+    struct lyd_val_mt_unit *unit;
+
+    if (mt->count == mt->size) {
+        mt->size = mt->size ? mt->size * 2 : 32;
+        unit = realloc(mt->units, mt->size * sizeof *mt->units);
+        LY_CHECK_ERR_RET(!unit, LOGMEM(mt->ctx), NULL);
+        mt->units = unit;
+    }
+
+    unit = &mt->units[mt->count++];
+    memset(unit, 0, sizeof *unit);
+    unit->type = type;
+    unit->first = first;
+    unit->count = count;
+    return unit;
+}
+
+/**
+ * @brief Add work units of the final validation of siblings, mirrors ::lyd_validate_final_r().
+ *
+ * Children of small sibling sets are split into further units, the descendants of large sibling sets are validated
+ * by units of ::LYD_VAL_MT_CHUNK subtrees.
+ *
+ * @param[in] mt Multi-threaded validation context.
+ * @param[in] first First sibling.
+ * @param[in] parent Data parent.
+ * @param[in] sparent Schema parent of the siblings, NULL for top-level siblings.
+ * @param[in] mod Module of the siblings, NULL for nested siblings.
+ * @param[out] stop Set if the serial validation would always stop at the added units.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_mt_final_units(struct lyd_val_mt *mt, struct lyd_node *first, const struct lyd_node *parent,
+        const struct lysc_node *sparent, const struct lys_module *mod, ly_bool *stop)
+{
+    struct lyd_val_mt_unit *unit;
+    struct lyd_node *node, *chunk = NULL;
+    uint32_t chunk_count = 0, count = 0;
+    ly_bool split;
+
+    /* the nodes themselves */
+    LY_LIST_FOR(first, node) {
+        if (!(node->flags & LYD_EXT)) {
+            if (!node->schema) {
+                /* opaque data, always an error */
+                if (chunk) {
+                    LY_CHECK_RET(!lyd_val_mt_unit_new(mt, LYD_VAL_MT_NODES, chunk, chunk_count), LY_EMEM);
+                }
+                LY_CHECK_RET(!lyd_val_mt_unit_new(mt, LYD_VAL_MT_OPAQ, node, 1), LY_EMEM);
+                *stop = 1;
+                return LY_SUCCESS;
+            }
+
+            if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
+                /* all top-level data from this module added */
+                break;
+            }
+        }
+
+        if (!chunk) {
+            chunk = node;
+        }
+        ++count;
+        if (++chunk_count == LYD_VAL_MT_CHUNK) {
+            LY_CHECK_RET(!lyd_val_mt_unit_new(mt, LYD_VAL_MT_NODES, chunk, chunk_count), LY_EMEM);
+            chunk = NULL;
+            chunk_count = 0;
+        }
+    }
+    if (chunk) {
+        LY_CHECK_RET(!lyd_val_mt_unit_new(mt, LYD_VAL_MT_NODES, chunk, chunk_count), LY_EMEM);
+        chunk = NULL;
+        chunk_count = 0;
+    }
+
+    /* schema-based restrictions */
+    unit = lyd_val_mt_unit_new(mt, LYD_VAL_MT_SIBLINGS, first, 0);
+    LY_CHECK_RET(!unit, LY_EMEM);
+    unit->parent = parent;
+    unit->sparent = sparent;
+    unit->mod = mod;
 
+    /* descendants */
+    split = (count <= LYD_VAL_MT_CHUNK);
     LY_LIST_FOR(first, node) {
         if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
-            /* all top-level data from this module checked */
+            /* all top-level data from this module added */
             break;
         }
 
-        /* validate all children recursively */
-        LY_CHECK_RET(lyd_validate_final_r(lyd_child(node), node, node->schema, NULL, val_opts, int_opts, must_xp_opts));
+        if (split) {
+            if (node->schema->nodetype & LYD_NODE_TERM) {
+                /* no descendants */
+                continue;
+            }
 
-        /* set default for containers */
-        if (node->schema && (node->schema->nodetype == LYS_CONTAINER) && !(node->schema->flags & LYS_PRESENCE)) {
-            LY_LIST_FOR(lyd_child(node), next) {
-                if (!(next->flags & LYD_DEFAULT)) {
-                    break;
-                }
+            LY_CHECK_RET(lyd_val_mt_final_units(mt, lyd_child(node), node, node->schema, NULL, stop));
+            if (*stop) {
+                return LY_SUCCESS;
             }
-            if (!next) {
-                node->flags |= LYD_DEFAULT;
+        } else {
+            if (!chunk) {
+                chunk = node;
+            }
+            if (++chunk_count == LYD_VAL_MT_CHUNK) {
+                LY_CHECK_RET(!lyd_val_mt_unit_new(mt, LYD_VAL_MT_SUBTREES, chunk, chunk_count), LY_EMEM);
+                chunk = NULL;
+                chunk_count = 0;
             }
         }
     }
+    if (chunk) {
+        LY_CHECK_RET(!lyd_val_mt_unit_new(mt, LYD_VAL_MT_SUBTREES, chunk, chunk_count), LY_EMEM);
+    }
 
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Process a single work unit.
+ *
+ * @param[in] mt Multi-threaded validation context.
+ * @param[in] unit Unit to process.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_mt_unit_process(struct lyd_val_mt *mt, struct lyd_val_mt_unit *unit)
+{
+    LY_ERR r = LY_SUCCESS;
+    struct lyd_node *node;
+    uint32_t i;
+
+    switch (unit->type) {
+    case LYD_VAL_MT_NODES:
+        for (node = unit->first, i = 0; i < unit->count; node = node->next, ++i) {
+            if (node->flags & LYD_EXT) {
+                /* ext instance data should have already been validated */
+                continue;
+            }
+            LY_CHECK_RET(lyd_validate_final_node(node, mt->val_opts, mt->int_opts, 0));
+        }
+        break;
+    case LYD_VAL_MT_SIBLINGS:
+        r = lyd_validate_siblings_schema_r(unit->first, unit->parent, unit->sparent,
+                unit->mod ? unit->mod->compiled : NULL, mt->val_opts, mt->int_opts);
+        break;
+    case LYD_VAL_MT_SUBTREES:
+        for (node = unit->first, i = 0; i < unit->count; node = node->next, ++i) {
+            LY_CHECK_RET(lyd_validate_final_r(lyd_child(node), node, node->schema, NULL, mt->val_opts,
+                    mt->int_opts, 0));
+        }
+        break;
+    case LYD_VAL_MT_OPAQ:
+        LOG_LOCSET(NULL, unit->first, NULL, NULL);
+        r = lyd_parse_opaq_error(unit->first);
+        LOG_LOCBACK(0, 1, 0, 0);
+        break;
+    case LYD_VAL_MT_TYPES:
+        /* in the order of the serial resolution */
+        i = unit->idx + unit->count;
+        do {
+            --i;
+            LY_CHECK_RET(lyd_validate_unres_type(mt->node_types->objs[i], mt->tree));
+        } while (i > unit->idx);
+        break;
+    }
+
+    return r;
+}
+
+/**
+ * @brief Worker thread of multi-threaded validation.
+ *
+ * @param[in] arg Multi-threaded validation context.
+ * @return NULL.
+ */
+static void *
+lyd_val_mt_worker(void *arg)
+{
+    struct lyd_val_mt *mt = arg;
+    struct lyd_val_mt_unit *unit;
+    struct lyplg_lref_cache *prev_lref_cache;
+    struct lyxp_profiles *prev_profiles;
+    struct lyd_val_stats *prev_val_stats;
+    uint32_t u;
+
+    /* the data tree does not change, leafref targets can be cached */
+    prev_lref_cache = lyplg_type_leafref_cache_start();
+    prev_profiles = lyxp_profiles_worker_start(mt->profiles);
+    prev_val_stats = lyd_val_stats_thread_start(mt->ctx);
+
+    while ((u = ATOMIC_INC_RELAXED(mt->next)) < mt->count) {
+        if (u > ATOMIC_LOAD_RELAXED(mt->failed)) {
+            /* serial validation would stop on an error before reaching this unit */
+            break;
+        }
+
+        unit = &mt->units[u];
+        ly_log_capture_start(mt->ctx);
+        unit->ret = lyd_val_mt_unit_process(mt, unit);
+        unit->log = ly_log_capture_stop(mt->ctx);
+
+        if (unit->ret && (unit->ret != LY_EINCOMPLETE)) {
+            pthread_mutex_lock(&mt->lock);
+            if (u < ATOMIC_LOAD_RELAXED(mt->failed)) {
+                ATOMIC_STORE_RELAXED(mt->failed, u);
+            }
+            pthread_mutex_unlock(&mt->lock);
+        }
+    }
+
+    lyd_val_stats_thread_stop(prev_val_stats);
+    lyxp_profiles_worker_stop(prev_profiles);
+    lyplg_type_leafref_cache_stop(prev_lref_cache);
+    return NULL;
+}
+
+/**
+ * @brief Process all the work units by worker threads and log their messages in the serial order.
+ *
+ * Units that need to modify the data tree are processed again by the calling thread, in order.
+ *
+ * @param[in] mt Multi-threaded validation context with the units.
+ * @return LY_ERR value of the first failed unit.
+ */
+static LY_ERR
+lyd_val_mt_run(struct lyd_val_mt *mt)
+{
+    LY_ERR rc = LY_SUCCESS;
+    pthread_t threads[LY_MT_THREADS_MAX];
+    uint32_t u, thread_count;
+
+    if (!mt->count) {
+        return LY_SUCCESS;
+    }
+
+    mt->int_opts = LYD_INTOPT_VAL_MT;
+    ATOMIC_STORE_RELAXED(mt->next, 0);
+    ATOMIC_STORE_RELAXED(mt->failed, mt->count);
+    pthread_mutex_init(&mt->lock, NULL);
+    mt->profiles = lyxp_profiles_get();
+
+    /* process the units, the main thread only waits so that all the units are processed with the same log location */
+    thread_count = ly_mt_thread_count();
+    if (thread_count > mt->count) {
+        thread_count = mt->count;
+    }
+    for (u = 0; u < thread_count; ++u) {
+        if (pthread_create(&threads[u], NULL, lyd_val_mt_worker, mt)) {
+            break;
+        }
+    }
+    thread_count = u;
+    if (!thread_count) {
+        /* no thread could be created */
+        lyd_val_mt_worker(mt);
+    }
+    for (u = 0; u < thread_count; ++u) {
+        pthread_join(threads[u], NULL);
+    }
+    pthread_mutex_destroy(&mt->lock);
+
+    /* log the messages of the units up to the first failed one */
+    mt->int_opts = 0;
+    for (u = 0; u < mt->count; ++u) {
+        if (!rc && (mt->units[u].ret == LY_EINCOMPLETE)) {
+            /* the unit needs to modify the data tree, process it again by this thread */
+            ly_err_free(mt->units[u].log);
+            mt->units[u].log = NULL;
+            rc = lyd_val_mt_unit_process(mt, &mt->units[u]);
+        } else if (!rc) {
+            ly_log_replay(mt->ctx, mt->units[u].log);
+            rc = mt->units[u].ret;
+        } else {
+            /* processed after an error, not reached by serial validation */
+            ly_err_free(mt->units[u].log);
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Resolve incompletely validated terminal values by worker threads.
+ *
+ * The values must not be modified by their resolution, see ::lyd_val_mt_type_serial().
+ *
+ * @param[in] tree Data tree.
+ * @param[in] node_types Set with the terminal nodes, processed from the end in serial validation.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_mt_types(const struct lyd_node *tree, struct ly_set *node_types)
+{
+    LY_ERR rc;
+    struct lyd_val_mt mt = {0};
+    struct lyd_val_mt_unit *unit;
+    uint32_t i;
+
+    mt.ctx = LYD_CTX((struct lyd_node *)node_types->objs[0]);
+    mt.tree = tree;
+    mt.node_types = node_types;
+
+    lyd_mt_prepare(lyd_first_sibling(tree), 0);
+
+    /* units from the end of the set */
+    i = node_types->count;
+    do {
+        unit = lyd_val_mt_unit_new(&mt, LYD_VAL_MT_TYPES, NULL, (i < LYD_VAL_MT_CHUNK) ? i : LYD_VAL_MT_CHUNK);
+        LY_CHECK_ERR_GOTO(!unit, rc = LY_EMEM, cleanup);
+        i -= unit->count;
+        unit->idx = i;
+    } while (i);
+
+    rc = lyd_val_mt_run(&mt);
+
+cleanup:
+    free(mt.units);
+    return rc;
+}
+
+/**
+ * @brief Set the default flag of all the non-presence containers with only default descendants in a subtree.
+ *
+ * @param[in] node Subtree root.
+ */
+static void
+lyd_val_mt_cont_dflt_r(struct lyd_node *node)
+{
+    struct lyd_node *child;
+
+    LY_LIST_FOR(lyd_child(node), child) {
+        lyd_val_mt_cont_dflt_r(child);
+    }
+    lyd_validate_cont_dflt(node);
+}
+
+/**
+ * @brief Perform the final validation by worker threads, see ::lyd_validate_final_r().
+ *
+ * @param[in] first First top-level sibling of the module.
+ * @param[in] mod Module of the siblings.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_mt_final(struct lyd_node *first, const struct lys_module *mod, uint32_t val_opts)
+{
+    LY_ERR rc;
+    struct lyd_val_mt mt = {0};
+    struct lyd_node *node;
+    ly_bool stop = 0;
+
+    mt.ctx = mod->ctx;
+    mt.val_opts = val_opts;
+
+    lyd_mt_prepare(first ? lyd_first_sibling(first) : NULL, 1);
+
+    LY_CHECK_GOTO(rc = lyd_val_mt_final_units(&mt, first, NULL, NULL, mod, &stop), cleanup);
+    LY_CHECK_GOTO(rc = lyd_val_mt_run(&mt), cleanup);
+
+    /* the workers do not modify the data tree, set default for containers */
+    LY_LIST_FOR(first, node) {
+        if (lyd_owner_module(node) != mod) {
+            break;
+        }
+
+        lyd_val_mt_cont_dflt_r(node);
+    }
+
+cleanup:
+    free(mt.units);
+    return rc;
+}
+
 /**
  * @brief Validate extension instance data by storing it in its unres set.
  *
@@ -1544,6 +2495,9 @@ lyd_validate(struct lyd_node **tree, const struct lys_module *module, const stru
     struct lyd_node *first, *next, **first2, *iter;
     const struct lys_module *mod;
     struct ly_set node_types = {0}, meta_types = {0}, node_when = {0}, ext_val = {0};
+    struct lyplg_lref_cache *prev_lref_cache;
+    struct lyxp_result_cache *prev_result_cache;
+    struct lyd_val_stats *prev_val_stats;
     uint32_t i = 0;
 
     assert(tree && ctx);
@@ -1556,6 +2510,7 @@ lyd_validate(struct lyd_node **tree, const struct lys_module *module, const stru
         meta_types_p = &meta_types;
         ext_val_p = &ext_val;
     }
+    prev_val_stats = lyd_val_stats_thread_start(ctx);
 
     next = *tree;
     while (1) {
@@ -1611,12 +2566,22 @@ lyd_validate(struct lyd_node **tree, const struct lys_module *module, const stru
                 val_opts, diff);
         LY_CHECK_GOTO(ret, cleanup);
 
-        /* perform final validation that assumes the data tree is final */
-        ret = lyd_validate_final_r(*first2, NULL, NULL, mod, val_opts, 0, 0);
+        /* perform final validation that assumes the data tree is final, deref() may use cached leafref targets
+         * and must conditions cached results of their sub-expressions */
+        if (val_opts & LYD_VALIDATE_MULTI_THREADED) {
+            ret = lyd_val_mt_final(*first2, mod, val_opts);
+        } else {
+            prev_lref_cache = lyplg_type_leafref_cache_start();
+            prev_result_cache = lyxp_result_cache_start();
+            ret = lyd_validate_final_r(*first2, NULL, NULL, mod, val_opts, 0, 0);
+            lyxp_result_cache_stop(prev_result_cache);
+            lyplg_type_leafref_cache_stop(prev_lref_cache);
+        }
         LY_CHECK_GOTO(ret, cleanup);
     }
 
 cleanup:
+    lyd_val_stats_thread_stop(prev_val_stats);
     ly_set_erase(&node_when, NULL);
     ly_set_erase(&node_types, NULL);
     ly_set_erase(&meta_types, NULL);
@@ -1651,6 +2616,1075 @@ lyd_validate_module(struct lyd_node **tree, const struct lys_module *module, uin
     return lyd_validate(tree, module, (*tree) ? LYD_CTX(*tree) : module->ctx, val_opts, 1, NULL, NULL, NULL, NULL, diff);
 }
 
+/**
+ * @brief Record of the schema dependency graph for incremental validation.
+ */
+struct lyd_val_dep {
+    const struct lysc_node *atom;   /**< schema node referenced by the constraints, NULL for any schema node */
+    struct ly_set deps;             /**< schema nodes with "when", "must", or type restrictions referencing @p atom */
+};
+
+/**
+ * @brief Schema dependency graph of all the implemented modules of a context for incremental validation.
+ */
+struct lyd_val_graph {
+    struct hash_table *ht;          /**< atoms with their dependent schema nodes (struct lyd_val_dep *) */
+    struct ly_set recs;             /**< all the records of @p ht to free */
+};
+
+/**
+ * @brief Incremental validation context.
+ */
+struct lyd_val_incr {
+    const struct lyd_val_graph *graph;  /**< dependency graph of the context */
+    struct hash_table *uniques;     /**< revalidated list uniques (struct lyd_val_uniq) */
+    struct hash_table *changed;     /**< schema nodes of changed data (const struct lysc_node *) */
+    struct hash_table *deps;        /**< schema nodes whose instances are revalidated (const struct lysc_node *) */
+    struct hash_table *dep_parents; /**< schema ancestors of @p deps (const struct lysc_node *) */
+    struct ly_set dep_tops;         /**< top-level data schema nodes in @p deps or @p dep_parents */
+    uint32_t dep_count;             /**< number of schema nodes in @p deps */
+    ly_bool any_changed;            /**< whether the schema nodes depending on any change were marked */
+    struct hash_table *subtrees;    /**< fully validated data subtrees (struct lyd_node *) */
+    struct hash_table *siblings;    /**< data parents, or modules for top-level siblings, whose children were
+                                         validated */
+};
+
+/**
+ * @brief Hash table value equal callback for pointers.
+ */
+static ly_bool
+lyd_val_ptr_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    return *(void **)val1_p == *(void **)val2_p;
+}
+
+/**
+ * @brief Revalidated unique of list instances.
+ */
+struct lyd_val_uniq {
+    const struct lyd_node *parent;              /**< data parent of the list instances, NULL for top-level */
+    const struct lysc_node_leaf **unique;       /**< unique of the list */
+};
+
+/**
+ * @brief Hash table value equal callback for revalidated uniques.
+ */
+static ly_bool
+lyd_val_uniq_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_val_uniq *uniq1 = val1_p, *uniq2 = val2_p;
+
+    return (uniq1->parent == uniq2->parent) && (uniq1->unique == uniq2->unique);
+}
+
+/**
+ * @brief Hash table value equal callback for dependency graph records.
+ */
+static ly_bool
+lyd_val_dep_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_val_dep *dep1 = *(struct lyd_val_dep **)val1_p, *dep2 = *(struct lyd_val_dep **)val2_p;
+
+    return dep1->atom == dep2->atom;
+}
+
+/**
+ * @brief Add a pointer into a pointer hash table, if not there already.
+ *
+ * @param[in] ht Hash table.
+ * @param[in] ptr Pointer to add.
+ * @param[out] added Optional flag whether the pointer was added.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_ptr_add(struct hash_table *ht, const void *ptr, ly_bool *added)
+{
+    LY_ERR r;
+
+    r = lyht_insert(ht, &ptr, dict_hash((const char *)&ptr, sizeof ptr), NULL);
+    if (added) {
+        *added = r ? 0 : 1;
+    }
+    return (r == LY_EEXIST) ? LY_SUCCESS : r;
+}
+
+/**
+ * @brief Check whether a pointer is in a pointer hash table.
+ *
+ * @param[in] ht Hash table.
+ * @param[in] ptr Pointer to find.
+ * @return Whether the pointer was found.
+ */
+static ly_bool
+lyd_val_ptr_has(struct hash_table *ht, const void *ptr)
+{
+    return lyht_find(ht, &ptr, dict_hash((const char *)&ptr, sizeof ptr), NULL) ? 0 : 1;
+}
+
+/**
+ * @brief Add an edge into the dependency graph.
+ *
+ * @param[in] graph Dependency graph.
+ * @param[in] atom Referenced schema node, NULL for any schema node.
+ * @param[in] snode Schema node with a constraint referencing @p atom.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_graph_add(struct lyd_val_graph *graph, const struct lysc_node *atom, const struct lysc_node *snode)
+{
+    struct lyd_val_dep dep_key = {.atom = atom}, *dep = &dep_key, **dep_p;
+    uint32_t hash;
+
+    hash = dict_hash((const char *)&atom, sizeof atom);
+    if (!lyht_find(graph->ht, &dep, hash, (void **)&dep_p)) {
+        dep = *dep_p;
+    } else {
+        /* new record */
+        dep = calloc(1, sizeof *dep);
+        LY_CHECK_ERR_RET(!dep, LOGMEM(snode->module->ctx), LY_EMEM);
+        dep->atom = atom;
+        LY_CHECK_ERR_RET(ly_set_add(&graph->recs, dep, 1, NULL), free(dep), LY_EMEM);
+        LY_CHECK_RET(lyht_insert(graph->ht, &dep, hash, NULL));
+    }
+
+    if (!dep->deps.count || (dep->deps.snodes[dep->deps.count - 1] != snode)) {
+        /* a schema node adds all its edges at once */
+        LY_CHECK_RET(ly_set_add(&dep->deps, (void *)snode, 1, NULL));
+    }
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Add the atoms of an expression into the dependency graph.
+ *
+ * @param[in] graph Dependency graph.
+ * @param[in] snode Schema node with the expression.
+ * @param[in] ctx_node Context node of the expression.
+ * @param[in] exp Expression.
+ * @param[in] prefixes Resolved prefixes of @p exp.
+ * @param[in] options XPath atomize options.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_graph_exp(struct lyd_val_graph *graph, const struct lysc_node *snode, const struct lysc_node *ctx_node,
+        const struct lyxp_expr *exp, const struct lysc_prefix *prefixes, uint32_t options)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyxp_set xp_set = {0};
+    uint32_t i;
+
+    LY_CHECK_RET(lyxp_atomize(snode->module->ctx, exp, snode->module, LY_VALUE_SCHEMA_RESOLVED, (void *)prefixes,
+            ctx_node, &xp_set, options));
+
+    for (i = 0; i < xp_set.used; ++i) {
+        if ((xp_set.val.scnodes[i].type == LYXP_NODE_ELEM) &&
+                (xp_set.val.scnodes[i].in_ctx >= LYXP_SET_SCNODE_ATOM_NODE)) {
+            LY_CHECK_GOTO(ret = lyd_val_incr_graph_add(graph, xp_set.val.scnodes[i].scnode, snode), cleanup);
+        }
+    }
+
+cleanup:
+    lyxp_set_free_content(&xp_set);
+    return ret;
+}
+
+/**
+ * @brief Add the references of a type into the dependency graph.
+ *
+ * @param[in] graph Dependency graph.
+ * @param[in] snode Schema node of the type.
+ * @param[in] type Type to inspect.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_graph_type(struct lyd_val_graph *graph, const struct lysc_node *snode, const struct lysc_type *type)
+{
+    const struct lysc_type_leafref *lref;
+    const struct lysc_type_union *uni;
+    LY_ARRAY_COUNT_TYPE u;
+
+    switch (type->basetype) {
+    case LY_TYPE_LEAFREF:
+        lref = (const struct lysc_type_leafref *)type;
+        if (lref->require_instance) {
+            LY_CHECK_RET(lyd_val_incr_graph_exp(graph, snode, snode, lref->path, lref->prefixes, LYXP_SCNODE));
+        }
+        break;
+    case LY_TYPE_INST:
+        if (((const struct lysc_type_instanceid *)type)->require_instance) {
+            /* the target can be any node */
+            LY_CHECK_RET(lyd_val_incr_graph_add(graph, NULL, snode));
+        }
+        break;
+    case LY_TYPE_UNION:
+        uni = (const struct lysc_type_union *)type;
+        LY_ARRAY_FOR(uni->types, u) {
+            LY_CHECK_RET(lyd_val_incr_graph_type(graph, snode, uni->types[u]));
+        }
+        break;
+    default:
+        break;
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief DFS callback adding the constraints of a schema node into the dependency graph.
+ */
+static LY_ERR
+lyd_val_incr_graph_cb(struct lysc_node *snode, void *data, ly_bool *dfs_continue)
+{
+    struct lyd_val_graph *graph = data;
+    struct lysc_when **whens;
+    struct lysc_must *musts;
+    LY_ARRAY_COUNT_TYPE u;
+
+    if (snode->nodetype & (LYS_RPC | LYS_ACTION | LYS_NOTIF)) {
+        /* operations are never part of the validated data tree */
+        *dfs_continue = 1;
+        return LY_SUCCESS;
+    }
+
+    whens = lysc_node_when(snode);
+    LY_ARRAY_FOR(whens, u) {
+        LY_CHECK_RET(lyd_val_incr_graph_exp(graph, snode, whens[u]->context, whens[u]->cond, whens[u]->prefixes,
+                LYXP_SCNODE_SCHEMA));
+    }
+
+    musts = lysc_node_musts(snode);
+    LY_ARRAY_FOR(musts, u) {
+        LY_CHECK_RET(lyd_val_incr_graph_exp(graph, snode, snode, musts[u].cond, musts[u].prefixes, LYXP_SCNODE_SCHEMA));
+    }
+
+    if (snode->nodetype & LYD_NODE_TERM) {
+        LY_CHECK_RET(lyd_val_incr_graph_type(graph, snode, ((struct lysc_node_leaf *)snode)->type));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free a dependency graph.
+ *
+ * @param[in] graph Dependency graph to free.
+ */
+static void
+lyd_val_graph_free(struct lyd_val_graph *graph)
+{
+    struct lyd_val_dep *dep;
+    uint32_t i;
+
+    if (!graph) {
+        return;
+    }
+
+    for (i = 0; i < graph->recs.count; ++i) {
+        dep = graph->recs.objs[i];
+        ly_set_erase(&dep->deps, NULL);
+        free(dep);
+    }
+    ly_set_erase(&graph->recs, NULL);
+    lyht_free(graph->ht);
+    free(graph);
+}
+
+void
+lyd_val_incr_graph_free(struct ly_ctx *ctx)
+{
+    pthread_mutex_lock(&ctx->val_graph_lock);
+    lyd_val_graph_free(ctx->val_graph);
+    ctx->val_graph = NULL;
+    pthread_mutex_unlock(&ctx->val_graph_lock);
+}
+
+/**
+ * @brief Get the dependency graph of all the implemented modules of a context, build it if not yet built.
+ *
+ * @param[in] ctx libyang context.
+ * @param[out] graph_p Dependency graph of @p ctx.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_graph_get(const struct ly_ctx *ctx, const struct lyd_val_graph **graph_p)
+{
+    LY_ERR rc = LY_SUCCESS;
+    struct ly_ctx *mctx = (struct ly_ctx *)ctx;
+    struct lyd_val_graph *graph = NULL;
+    const struct lys_module *mod;
+    uint32_t i;
+
+    pthread_mutex_lock(&mctx->val_graph_lock);
+    if (ctx->val_graph) {
+        /* built since the last compilation */
+        goto cleanup;
+    }
+
+    graph = calloc(1, sizeof *graph);
+    LY_CHECK_ERR_GOTO(!graph, LOGMEM(ctx); rc = LY_EMEM, cleanup);
+    graph->ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyd_val_dep *), lyd_val_dep_equal_cb, NULL, 1);
+    LY_CHECK_ERR_GOTO(!graph->ht, LOGMEM(ctx); rc = LY_EMEM, cleanup);
+
+    for (i = 0; i < ctx->list.count; ++i) {
+        mod = ctx->list.objs[i];
+        if (!mod->implemented || !mod->compiled) {
+            continue;
+        }
+
+        LY_CHECK_GOTO(rc = lysc_module_dfs_full(mod, lyd_val_incr_graph_cb, graph), cleanup);
+    }
+
+    mctx->val_graph = graph;
+    graph = NULL;
+
+cleanup:
+    *graph_p = ctx->val_graph;
+    pthread_mutex_unlock(&mctx->val_graph_lock);
+    lyd_val_graph_free(graph);
+    return rc;
+}
+
+/**
+ * @brief Initialize incremental validation context, get the dependency graph of all the implemented modules.
+ *
+ * @param[in] ctx libyang context.
+ * @param[out] incr Incremental validation context.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_init(const struct ly_ctx *ctx, struct lyd_val_incr *incr)
+{
+    memset(incr, 0, sizeof *incr);
+    incr->uniques = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyd_val_uniq), lyd_val_uniq_equal_cb, NULL, 1);
+    incr->changed = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    incr->deps = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    incr->dep_parents = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    incr->subtrees = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    incr->siblings = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    LY_CHECK_ERR_RET(!incr->uniques || !incr->changed || !incr->deps || !incr->dep_parents || !incr->subtrees ||
+            !incr->siblings, LOGMEM(ctx), LY_EMEM);
+
+    return lyd_val_incr_graph_get(ctx, &incr->graph);
+}
+
+/**
+ * @brief Erase incremental validation context.
+ *
+ * @param[in] incr Incremental validation context.
+ */
+static void
+lyd_val_incr_erase(struct lyd_val_incr *incr)
+{
+    lyht_free(incr->uniques);
+    lyht_free(incr->changed);
+    lyht_free(incr->deps);
+    lyht_free(incr->dep_parents);
+    ly_set_erase(&incr->dep_tops, NULL);
+    lyht_free(incr->subtrees);
+    lyht_free(incr->siblings);
+}
+
+/**
+ * @brief Mark a schema node for revalidation.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] snode Schema node whose instances are to be revalidated.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_dep_add(struct lyd_val_incr *incr, const struct lysc_node *snode)
+{
+    const struct lysc_node *iter, *top;
+    ly_bool added;
+    LY_ARRAY_COUNT_TYPE idx = 0;
+
+    if (snode->nodetype & (LYS_CHOICE | LYS_CASE)) {
+        /* when of choice or case, revalidate all its data nodes */
+        iter = NULL;
+        while ((iter = lys_getnext_idx(iter, snode, NULL, 0, &idx))) {
+            LY_CHECK_RET(lyd_val_incr_dep_add(incr, iter));
+        }
+        return LY_SUCCESS;
+    }
+
+    LY_CHECK_RET(lyd_val_ptr_add(incr->deps, snode, &added));
+    if (!added) {
+        return LY_SUCCESS;
+    }
+    ++incr->dep_count;
+
+    /* make the instances reachable */
+    top = snode;
+    for (iter = snode->parent; iter; iter = iter->parent) {
+        LY_CHECK_RET(lyd_val_ptr_add(incr->dep_parents, iter, NULL));
+        if (!(iter->nodetype & (LYS_CHOICE | LYS_CASE))) {
+            top = iter;
+        }
+    }
+    return ly_set_add(&incr->dep_tops, (void *)top, 0, NULL);
+}
+
+/**
+ * @brief Mark schema nodes depending on an atom for revalidation.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] atom Changed atom, NULL for the schema nodes depending on any change.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_atom_changed(struct lyd_val_incr *incr, const struct lysc_node *atom)
+{
+    struct lyd_val_dep dep_key = {.atom = atom}, *dep = &dep_key, **dep_p;
+    uint32_t i;
+
+    if (lyht_find(incr->graph->ht, &dep, dict_hash((const char *)&atom, sizeof atom), (void **)&dep_p)) {
+        /* no dependencies */
+        return LY_SUCCESS;
+    }
+    dep = *dep_p;
+
+    for (i = 0; i < dep->deps.count; ++i) {
+        LY_CHECK_RET(lyd_val_incr_dep_add(incr, dep->deps.snodes[i]));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Get the operation of a diff node.
+ *
+ * @param[in] diff_node Diff node.
+ * @param[in] parent_op Operation of the parent of @p diff_node.
+ * @return Diff operation.
+ */
+static enum lyd_diff_op
+lyd_val_diff_node_op(const struct lyd_node *diff_node, enum lyd_diff_op parent_op)
+{
+    struct lyd_meta *meta;
+    const char *str;
+
+    meta = lyd_find_meta(diff_node->meta, NULL, "yang:operation");
+    if (!meta) {
+        /* inherited, only created and deleted subtrees are changed as a whole */
+        return ((parent_op == LYD_DIFF_OP_CREATE) || (parent_op == LYD_DIFF_OP_DELETE)) ? parent_op : LYD_DIFF_OP_NONE;
+    }
+
+    str = lyd_get_meta_value(meta);
+    switch (str[0]) {
+    case 'c':
+        return LYD_DIFF_OP_CREATE;
+    case 'd':
+        return LYD_DIFF_OP_DELETE;
+    case 'r':
+        return LYD_DIFF_OP_REPLACE;
+    default:
+        return LYD_DIFF_OP_NONE;
+    }
+}
+
+/**
+ * @brief Collect changed schema nodes from a diff and mark all the schema nodes depending on them.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] diff_first First diff sibling.
+ * @param[in] parent_op Operation of the diff parent.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_changes_r(struct lyd_val_incr *incr, const struct lyd_node *diff_first, enum lyd_diff_op parent_op)
+{
+    const struct lyd_node *diff_node;
+    enum lyd_diff_op op;
+    ly_bool added;
+
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (!diff_node->schema) {
+            continue;
+        }
+
+        op = lyd_val_diff_node_op(diff_node, parent_op);
+        if (op != LYD_DIFF_OP_NONE) {
+            LY_CHECK_RET(lyd_val_ptr_add(incr->changed, diff_node->schema, &added));
+            if (added) {
+                LY_CHECK_RET(lyd_val_incr_atom_changed(incr, diff_node->schema));
+            }
+            if (!incr->any_changed) {
+                /* instance-identifiers depend on any change */
+                LY_CHECK_RET(lyd_val_incr_atom_changed(incr, NULL));
+                incr->any_changed = 1;
+            }
+        }
+
+        LY_CHECK_RET(lyd_val_incr_changes_r(incr, lyd_child(diff_node), op));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Check whether a diff sibling set includes any creations or deletions.
+ *
+ * @param[in] diff_first First diff sibling.
+ * @param[in] parent_op Operation of the diff parent.
+ * @param[in] mod Module of the siblings to check, NULL for all.
+ * @return Whether the data siblings changed.
+ */
+static ly_bool
+lyd_val_incr_siblings_changed(const struct lyd_node *diff_first, enum lyd_diff_op parent_op,
+        const struct lys_module *mod)
+{
+    const struct lyd_node *diff_node;
+    enum lyd_diff_op op;
+
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (!diff_node->schema || (mod && (lyd_owner_module(diff_node) != mod))) {
+            continue;
+        }
+
+        op = lyd_val_diff_node_op(diff_node, parent_op);
+        if ((op == LYD_DIFF_OP_CREATE) || (op == LYD_DIFF_OP_DELETE)) {
+            return 1;
+        } else if ((op == LYD_DIFF_OP_REPLACE) && (diff_node->schema->nodetype & LYD_NODE_TERM)) {
+            /* unique of the list parent */
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Find the data node of a diff node.
+ *
+ * @param[in] first First data sibling to search in.
+ * @param[in] diff_node Diff node to find.
+ * @return Found data node, NULL if there is none.
+ */
+static struct lyd_node *
+lyd_val_incr_find(const struct lyd_node *first, const struct lyd_node *diff_node)
+{
+    struct lyd_node *match = NULL;
+
+    if (first) {
+        lyd_find_sibling_first(first, diff_node, &match);
+    }
+    return match;
+}
+
+/**
+ * @brief Validate new and default nodes of all the data siblings changed by a diff.
+ *
+ * @param[in] parent Data parent of the siblings, NULL for top-level siblings.
+ * @param[in,out] tree Data tree, top-level siblings may change.
+ * @param[in] diff_first First diff sibling.
+ * @param[in] parent_op Operation of the diff parent.
+ * @param[in] impl_opts Implicit options, see @ref implicitoptions.
+ * @param[in,out] node_when Set for nodes with when conditions.
+ * @param[in,out] node_types Set for unres node types.
+ * @param[in,out] diff Validation diff.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_new_r(struct lyd_node *parent, struct lyd_node **tree, const struct lyd_node *diff_first,
+        enum lyd_diff_op parent_op, uint32_t impl_opts, struct ly_set *node_when, struct ly_set *node_types,
+        struct lyd_node **diff)
+{
+    const struct lyd_node *diff_node;
+    struct lyd_node *first, **first2, *match;
+    const struct lys_module *mod;
+    enum lyd_diff_op op;
+
+    if (parent) {
+        if (lyd_val_incr_siblings_changed(diff_first, parent_op, NULL)) {
+            /* new siblings, autodelete, and defaults */
+            LY_CHECK_RET(lyd_validate_new(lyd_node_child_p(parent), parent->schema, NULL, diff));
+            LY_CHECK_RET(lyd_new_implicit_r(parent, lyd_node_child_p(parent), NULL, NULL, node_when, node_types,
+                    impl_opts, diff));
+        }
+    } else {
+        LY_LIST_FOR(diff_first, diff_node) {
+            mod = diff_node->schema ? lyd_owner_module(diff_node) : NULL;
+            if (!mod || (diff_node->prev->next && (lyd_owner_module(diff_node->prev) == mod)) ||
+                    !lyd_val_incr_siblings_changed(diff_first, parent_op, mod)) {
+                /* opaque, module already processed, or no changed siblings */
+                continue;
+            }
+
+            /* top-level siblings of the module */
+            first = *tree;
+            lyd_first_module_sibling(&first, mod);
+            first2 = (!first || (first == *tree)) ? tree : &first;
+
+            LY_CHECK_RET(lyd_validate_new(first2, NULL, mod, diff));
+            LY_CHECK_RET(lyd_new_implicit_r(NULL, first2, NULL, mod, node_when, node_types, impl_opts, diff));
+        }
+    }
+
+    /* unchanged nodes with changed descendants */
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (!diff_node->schema || !lyd_child(diff_node)) {
+            continue;
+        }
+
+        op = lyd_val_diff_node_op(diff_node, parent_op);
+        if ((op != LYD_DIFF_OP_NONE) && (op != LYD_DIFF_OP_REPLACE)) {
+            continue;
+        }
+
+        match = lyd_val_incr_find(parent ? lyd_child(parent) : *tree, diff_node);
+        if (match) {
+            LY_CHECK_RET(lyd_val_incr_new_r(match, tree, lyd_child(diff_node), op, impl_opts, node_when, node_types,
+                    diff));
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Collect all the created and replaced data subtrees of a diff for full validation.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] first First data sibling.
+ * @param[in] diff_first First diff sibling.
+ * @param[in] parent_op Operation of the diff parent.
+ * @param[in] impl_opts Implicit options, see @ref implicitoptions.
+ * @param[in,out] node_when Set for nodes with when conditions.
+ * @param[in,out] node_types Set for unres node types.
+ * @param[in,out] meta_types Set for unres metadata types.
+ * @param[in,out] ext_val Set for parsed extension data to validate.
+ * @param[in,out] diff Validation diff.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_subtrees_r(struct lyd_val_incr *incr, struct lyd_node *first, const struct lyd_node *diff_first,
+        enum lyd_diff_op parent_op, uint32_t impl_opts, struct ly_set *node_when, struct ly_set *node_types,
+        struct ly_set *meta_types, struct ly_set *ext_val, struct lyd_node **diff)
+{
+    const struct lyd_node *diff_node;
+    struct lyd_node *match;
+    enum lyd_diff_op op;
+
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (!diff_node->schema) {
+            continue;
+        }
+
+        op = lyd_val_diff_node_op(diff_node, parent_op);
+        if (op == LYD_DIFF_OP_DELETE) {
+            continue;
+        }
+
+        match = lyd_val_incr_find(first, diff_node);
+        if (!match) {
+            continue;
+        }
+
+        if ((op == LYD_DIFF_OP_CREATE) || ((op == LYD_DIFF_OP_REPLACE) && (match->schema->nodetype & LYD_NODE_TERM))) {
+            /* created or changed data, validate it fully */
+            LY_CHECK_RET(lyd_val_ptr_add(incr->subtrees, match, NULL));
+            LY_CHECK_RET(lyd_validate_subtree(match, node_when, node_types, meta_types, ext_val, impl_opts, diff));
+        } else {
+            LY_CHECK_RET(lyd_val_incr_subtrees_r(incr, lyd_child(match), lyd_child(diff_node), op, impl_opts, node_when,
+                    node_types, meta_types, ext_val, diff));
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Process all the instances of dependent schema nodes in data siblings except the fully validated subtrees.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] first First data sibling.
+ * @param[in] sparent Schema parent of the siblings, NULL for top-level siblings.
+ * @param[in,out] node_when Optional set for nodes with when conditions, the dependent nodes are added into it.
+ * @param[in,out] node_types Set for unres node types, the dependent nodes are added into it. If NULL, the final
+ * validation of the dependent nodes is performed instead.
+ * @param[in] val_opts Validation options, see @ref datavalidationoptions.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_deps_r(struct lyd_val_incr *incr, struct lyd_node *first, const struct lysc_node *sparent,
+        struct ly_set *node_when, struct ly_set *node_types, uint32_t val_opts)
+{
+    const struct lysc_node *snode = NULL;
+    struct lyd_node *node;
+    uint32_t i = 0;
+    LY_ARRAY_COUNT_TYPE idx = 0;
+
+    if (!first) {
+        return LY_SUCCESS;
+    }
+
+    while (1) {
+        /* next schema node whose instances are to be processed */
+        if (sparent) {
+            snode = lys_getnext_idx(snode, sparent, NULL, 0, &idx);
+        } else {
+            snode = (i < incr->dep_tops.count) ? incr->dep_tops.snodes[i++] : NULL;
+        }
+        if (!snode) {
+            break;
+        }
+        if (!lyd_val_ptr_has(incr->deps, snode) && !lyd_val_ptr_has(incr->dep_parents, snode)) {
+            /* no instances to process */
+            continue;
+        }
+
+        LYD_LIST_FOR_INST(first, snode, node) {
+            if ((node->flags & LYD_EXT) || lyd_val_ptr_has(incr->subtrees, node)) {
+                /* validated separately */
+                continue;
+            }
+
+            if (lyd_val_ptr_has(incr->deps, snode)) {
+                if (node_types) {
+                    if (node_when && lysc_has_when(snode)) {
+                        LY_CHECK_RET(ly_set_add(node_when, node, 1, NULL));
+                    }
+                    if ((snode->nodetype & LYD_NODE_TERM) && ((struct lysc_node_leaf *)snode)->type->plugin->validate) {
+                        LY_CHECK_RET(ly_set_add(node_types, node, 1, NULL));
+                    }
+                } else {
+                    LY_CHECK_RET(lyd_validate_final_node(node, val_opts, 0, 0));
+                }
+            }
+
+            if (lyd_val_ptr_has(incr->dep_parents, snode)) {
+                LY_CHECK_RET(lyd_val_incr_deps_r(incr, lyd_child(node), snode, node_when, node_types, val_opts));
+            }
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Validate schema-based restrictions of data siblings, only once for each sibling set.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] parent Data parent of the siblings, NULL for top-level siblings.
+ * @param[in] tree Data tree.
+ * @param[in] mod Module of the top-level siblings.
+ * @param[in] val_opts Validation options, see @ref datavalidationoptions.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_siblings(struct lyd_val_incr *incr, struct lyd_node *parent, struct lyd_node *tree,
+        const struct lys_module *mod, uint32_t val_opts)
+{
+    struct lyd_node *first;
+    ly_bool added;
+
+    LY_CHECK_RET(lyd_val_ptr_add(incr->siblings, parent ? (void *)parent : (void *)mod, &added));
+    if (!added) {
+        /* already validated */
+        return LY_SUCCESS;
+    }
+
+    if (parent) {
+        return lyd_validate_siblings_schema_r(lyd_child(parent), parent, parent->schema, NULL, val_opts, 0);
+    }
+
+    first = tree;
+    lyd_first_module_sibling(&first, mod);
+    return lyd_validate_siblings_schema_r(first, NULL, NULL, mod->compiled, val_opts, 0);
+}
+
+/**
+ * @brief Validate the uniques of all the ancestor lists of a changed node that include the node.
+ *
+ * Each unique of the list instances is validated only once.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] parent Data parent of the changed node.
+ * @param[in] snode Schema node of the changed node.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_uniques(struct lyd_val_incr *incr, const struct lyd_node *parent, const struct lysc_node *snode)
+{
+    LY_ERR rc = LY_SUCCESS;
+    const struct lyd_node *anc;
+    const struct lysc_node_list *slist;
+    const struct lysc_node *siter;
+    struct lyd_val_uniq uniq;
+    ly_bool *uniq_check = NULL, check;
+    LY_ARRAY_COUNT_TYPE u, v;
+    uint32_t hash;
+    uint64_t start;
+
+    for (anc = parent; anc; anc = lyd_parent(anc)) {
+        if (!anc->schema || (anc->schema->nodetype != LYS_LIST) || !((struct lysc_node_list *)anc->schema)->uniques) {
+            continue;
+        }
+        slist = (struct lysc_node_list *)anc->schema;
+
+        uniq_check = calloc(LY_ARRAY_COUNT(slist->uniques), sizeof *uniq_check);
+        LY_CHECK_ERR_RET(!uniq_check, LOGMEM(LYD_CTX(anc)), LY_EMEM);
+
+        check = 0;
+        LY_ARRAY_FOR(slist->uniques, u) {
+            /* is any of the unique leaves the changed node or its descendant */
+            LY_ARRAY_FOR(slist->uniques[u], v) {
+                for (siter = &slist->uniques[u][v]->node; siter && (siter != snode) && (siter != anc->schema);
+                        siter = siter->parent) {}
+                if (siter == snode) {
+                    break;
+                }
+            }
+            if (v == LY_ARRAY_COUNT(slist->uniques[u])) {
+                continue;
+            }
+
+            /* validate each unique of the list instances only once */
+            uniq.parent = lyd_parent(anc);
+            uniq.unique = (const struct lysc_node_leaf **)slist->uniques[u];
+            hash = dict_hash_multi(0, (const char *)&uniq.parent, sizeof uniq.parent);
+            hash = dict_hash_multi(hash, (const char *)&uniq.unique, sizeof uniq.unique);
+            hash = dict_hash_multi(hash, NULL, 0);
+            rc = lyht_insert(incr->uniques, &uniq, hash, NULL);
+            if (rc == LY_EEXIST) {
+                rc = LY_SUCCESS;
+                continue;
+            }
+            LY_CHECK_ERR_GOTO(rc, LOGMEM(LYD_CTX(anc)), cleanup);
+
+            uniq_check[u] = 1;
+            check = 1;
+        }
+
+        if (check) {
+            LOG_LOCSET(anc->schema, NULL, NULL, NULL);
+            start = lyd_val_stats_start(LYD_CTX(anc));
+            rc = lyd_validate_unique(lyd_first_sibling(anc), anc->schema,
+                    (const struct lysc_node_leaf ***)slist->uniques, uniq_check);
+            lyd_val_stats_record(LYD_CTX(anc), anc->schema, LYD_VAL_STAT_UNIQUE, start);
+            LOG_LOCBACK(1, 0, 0, 0);
+            LY_CHECK_GOTO(rc, cleanup);
+        }
+
+        free(uniq_check);
+        uniq_check = NULL;
+    }
+
+cleanup:
+    free(uniq_check);
+    return rc;
+}
+
+/**
+ * @brief Perform the final validation of all the data changed by a diff.
+ *
+ * @param[in] incr Incremental validation context.
+ * @param[in] parent Data parent of the siblings, NULL for top-level siblings.
+ * @param[in] tree Data tree.
+ * @param[in] diff_first First diff sibling.
+ * @param[in] parent_op Operation of the diff parent.
+ * @param[in] val_opts Validation options, see @ref datavalidationoptions.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_incr_final_r(struct lyd_val_incr *incr, struct lyd_node *parent, struct lyd_node *tree,
+        const struct lyd_node *diff_first, enum lyd_diff_op parent_op, uint32_t val_opts)
+{
+    const struct lyd_node *diff_node;
+    struct lyd_node *match, *iter;
+    const struct lys_module *mod;
+    enum lyd_diff_op op;
+    ly_bool added;
+
+    /* schema-based restrictions of the changed siblings */
+    if (parent) {
+        if (lyd_val_incr_siblings_changed(diff_first, parent_op, NULL)) {
+            LY_CHECK_RET(lyd_val_incr_siblings(incr, parent, tree, NULL, val_opts));
+        }
+    } else {
+        LY_LIST_FOR(diff_first, diff_node) {
+            mod = diff_node->schema ? lyd_owner_module(diff_node) : NULL;
+            if (mod && lyd_val_incr_siblings_changed(diff_first, parent_op, mod)) {
+                LY_CHECK_RET(lyd_val_incr_siblings(incr, NULL, tree, mod, val_opts));
+            }
+        }
+    }
+
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (!diff_node->schema) {
+            continue;
+        }
+
+        op = lyd_val_diff_node_op(diff_node, parent_op);
+        if (parent && (op != LYD_DIFF_OP_NONE)) {
+            /* uniques of the ancestor lists, also a deleted node may be replaced by its default value */
+            LY_CHECK_RET(lyd_val_incr_uniques(incr, parent, diff_node->schema));
+        }
+        if (op == LYD_DIFF_OP_DELETE) {
+            continue;
+        }
+
+        match = lyd_val_incr_find(parent ? lyd_child(parent) : tree, diff_node);
+        if (!match || (match->flags & LYD_EXT)) {
+            continue;
+        }
+
+        if ((op == LYD_DIFF_OP_CREATE) || ((op == LYD_DIFF_OP_REPLACE) && (match->schema->nodetype & LYD_NODE_TERM))) {
+            LY_CHECK_RET(lyd_val_ptr_add(incr->subtrees, match, &added));
+            if (!added) {
+                /* already validated */
+                continue;
+            }
+
+            /* validate the subtree fully */
+            LY_CHECK_RET(lyd_validate_final_node(match, val_opts, 0, 0));
+            LY_CHECK_RET(lyd_validate_final_r(lyd_child(match), match, match->schema, NULL, val_opts, 0, 0));
+
+            /* set default for containers */
+            if ((match->schema->nodetype == LYS_CONTAINER) && !(match->schema->flags & LYS_PRESENCE)) {
+                LY_LIST_FOR(lyd_child(match), iter) {
+                    if (!(iter->flags & LYD_DEFAULT)) {
+                        break;
+                    }
+                }
+                if (!iter) {
+                    match->flags |= LYD_DEFAULT;
+                }
+            }
+        } else {
+            LY_CHECK_RET(lyd_val_incr_final_r(incr, match, tree, lyd_child(diff_node), op, val_opts));
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Remove duplicate items from a set, keeping the order of the first occurrences.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in,out] set Set to update.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_set_dedup(const struct ly_ctx *ctx, struct ly_set *set)
+{
+    struct hash_table *ht;
+    ly_bool added;
+    uint32_t i, used = 0;
+
+    if (set->count < 2) {
+        return LY_SUCCESS;
+    }
+
+    ht = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    LY_CHECK_ERR_RET(!ht, LOGMEM(ctx), LY_EMEM);
+    for (i = 0; i < set->count; ++i) {
+        LY_CHECK_ERR_RET(lyd_val_ptr_add(ht, set->objs[i], &added), lyht_free(ht), LY_EMEM);
+        if (added) {
+            set->objs[used++] = set->objs[i];
+        }
+    }
+    set->count = used;
+
+    lyht_free(ht);
+    return LY_SUCCESS;
+}
+
+LIBYANG_API_DEF LY_ERR
+lyd_validate_diff(struct lyd_node **tree, const struct lyd_node *diff, uint32_t val_opts, struct lyd_node **val_diff)
+{
+    LY_ERR ret = LY_SUCCESS;
+    const struct ly_ctx *ctx;
+    struct lyd_val_incr incr = {0};
+    struct ly_set node_when = {0}, node_types = {0}, meta_types = {0}, ext_val = {0};
+    struct lyd_node *vdiff = NULL;
+    struct lyplg_lref_cache *prev_lref_cache;
+    struct lyd_val_stats *prev_val_stats;
+    uint32_t dep_count, impl_opts = (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0;
+
+    LY_CHECK_ARG_RET(NULL, tree, LY_EINVAL);
+    LY_CHECK_CTX_EQUAL_RET(*tree ? LYD_CTX(*tree) : NULL, diff ? LYD_CTX(diff) : NULL, LY_EINVAL);
+    if (val_diff) {
+        *val_diff = NULL;
+    }
+    if (!diff) {
+        /* no changes */
+        return LY_SUCCESS;
+    }
+    ctx = LYD_CTX(diff);
+    diff = lyd_first_sibling(diff);
+    prev_val_stats = lyd_val_stats_thread_start(ctx);
+
+    /* schema dependency graph and the schema nodes depending on the changes */
+    LY_CHECK_GOTO(ret = lyd_val_incr_init(ctx, &incr), cleanup);
+    LY_CHECK_GOTO(ret = lyd_val_incr_changes_r(&incr, diff, LYD_DIFF_OP_NONE), cleanup);
+
+    /* validate new nodes of the changed siblings, autodelete, and add defaults */
+    ret = lyd_val_incr_new_r(NULL, tree, diff, LYD_DIFF_OP_NONE, impl_opts, &node_when, &node_types, &vdiff);
+    LY_CHECK_GOTO(ret, cleanup);
+    if (vdiff) {
+        LY_CHECK_GOTO(ret = lyd_val_incr_changes_r(&incr, vdiff, LYD_DIFF_OP_NONE), cleanup);
+    }
+
+    /* collect the changed subtrees and the nodes depending on the changes, the added defaults may be among them */
+    ret = lyd_val_incr_subtrees_r(&incr, *tree, diff, LYD_DIFF_OP_NONE, impl_opts, &node_when, &node_types, &meta_types,
+            &ext_val, &vdiff);
+    LY_CHECK_GOTO(ret, cleanup);
+    LY_CHECK_GOTO(ret = lyd_val_incr_deps_r(&incr, *tree, NULL, &node_when, &node_types, val_opts), cleanup);
+    LY_CHECK_GOTO(ret = lyd_val_set_dedup(ctx, &node_when), cleanup);
+    LY_CHECK_GOTO(ret = lyd_val_set_dedup(ctx, &node_types), cleanup);
+
+    /* finish incompletely validated terminal values/attributes and when conditions */
+    ret = lyd_validate_unres(tree, NULL, LYD_TYPE_DATA_YANG, &node_when, 0, &node_types, &meta_types, &ext_val,
+            val_opts, &vdiff);
+    LY_CHECK_GOTO(ret, cleanup);
+
+    /* the autodeleted nodes are changes, too */
+    dep_count = incr.dep_count;
+    if (vdiff) {
+        LY_CHECK_GOTO(ret = lyd_val_incr_changes_r(&incr, vdiff, LYD_DIFF_OP_NONE), cleanup);
+    }
+    if (dep_count < incr.dep_count) {
+        /* resolve the values referencing them again */
+        LY_CHECK_GOTO(ret = lyd_val_incr_deps_r(&incr, *tree, NULL, NULL, &node_types, val_opts), cleanup);
+        ret = lyd_validate_unres(tree, NULL, LYD_TYPE_DATA_YANG, NULL, 0, &node_types, NULL, NULL, val_opts, &vdiff);
+        LY_CHECK_GOTO(ret, cleanup);
+    }
+
+    /* the fully validated subtrees are collected again */
+    lyht_free(incr.subtrees);
+    incr.subtrees = lyht_new(LYHT_MIN_SIZE, sizeof(void *), lyd_val_ptr_equal_cb, NULL, 1);
+    LY_CHECK_ERR_GOTO(!incr.subtrees, LOGMEM(ctx); ret = LY_EMEM, cleanup);
+
+    /* final validation of the changed data and of the nodes depending on the changes */
+    prev_lref_cache = lyplg_type_leafref_cache_start();
+    ret = lyd_val_incr_final_r(&incr, NULL, *tree, diff, LYD_DIFF_OP_NONE, val_opts);
+    if (!ret && vdiff) {
+        ret = lyd_val_incr_final_r(&incr, NULL, *tree, vdiff, LYD_DIFF_OP_NONE, val_opts);
+    }
+    if (!ret) {
+        ret = lyd_val_incr_deps_r(&incr, *tree, NULL, NULL, NULL, val_opts);
+    }
+    lyplg_type_leafref_cache_stop(prev_lref_cache);
+    LY_CHECK_GOTO(ret, cleanup);
+
+    if (val_diff) {
+        *val_diff = vdiff;
+        vdiff = NULL;
+    }
+
+cleanup:
+    lyd_val_stats_thread_stop(prev_val_stats);
+    lyd_val_incr_erase(&incr);
+    ly_set_erase(&node_when, NULL);
+    ly_set_erase(&node_types, NULL);
+    ly_set_erase(&meta_types, NULL);
+    ly_set_erase(&ext_val, free);
+    lyd_free_all(vdiff);
+    return ret;
+}
+
 /**
  * @brief Find nodes for merging an operation into data tree for validation.
  *
@@ -1739,6 +3773,8 @@ _lyd_validate_op(struct lyd_node *op_tree, struct lyd_node *op_node, const struc
     LY_ERR rc = LY_SUCCESS;
     struct lyd_node *tree_sibling, *tree_parent, *op_subtree, *op_parent, *op_sibling_before, *op_sibling_after, *child;
     struct ly_set node_types = {0}, meta_types = {0}, node_when = {0}, ext_val = {0};
+    struct lyxp_result_cache *prev_result_cache;
+    struct lyd_val_stats *prev_val_stats;
 
     assert(op_tree && op_node);
     assert((node_when_p && node_types_p && meta_types_p && ext_val_p) ||
@@ -1750,6 +3786,7 @@ _lyd_validate_op(struct lyd_node *op_tree, struct lyd_node *op_node, const struc
         meta_types_p = &meta_types;
         ext_val_p = &ext_val;
     }
+    prev_val_stats = lyd_val_stats_thread_start(LYD_CTX(op_node));
 
     /* merge op_tree into dep_tree */
     lyd_val_op_merge_find(op_tree, op_node, dep_tree, &op_subtree, &tree_sibling, &tree_parent);
@@ -1796,7 +3833,9 @@ _lyd_validate_op(struct lyd_node *op_tree, struct lyd_node *op_node, const struc
     LY_CHECK_GOTO(rc = lyd_validate_must(op_node, int_opts, LYXP_IGNORE_WHEN), cleanup);
 
     /* final validation of all the descendants */
+    prev_result_cache = lyxp_result_cache_start();
     rc = lyd_validate_final_r(lyd_child(op_node), op_node, op_node->schema, NULL, 0, int_opts, LYXP_IGNORE_WHEN);
+    lyxp_result_cache_stop(prev_result_cache);
     LY_CHECK_GOTO(rc, cleanup);
 
 cleanup:
@@ -1812,6 +3851,7 @@ cleanup:
         lyd_insert_node(op_parent, NULL, op_subtree, 0);
     }
 
+    lyd_val_stats_thread_stop(prev_val_stats);
     ly_set_erase(&node_when, NULL);
     ly_set_erase(&node_types, NULL);
     ly_set_erase(&meta_types, NULL);
@@ -37,6 +37,39 @@ struct lysc_node;
  */
 LY_ERR lyd_val_diff_add(const struct lyd_node *node, enum lyd_diff_op op, struct lyd_node **diff);
 
+/**
+ * @brief Start measuring a validation constraint for the validation statistics.
+ *
+ * @param[in] ctx Context with the statistics.
+ * @return Start time, 0 if the statistics are not being collected.
+ */
+uint64_t lyd_val_stats_start(const struct ly_ctx *ctx);
+
+/**
+ * @brief Record a measured evaluation of a validation constraint into the validation statistics.
+ *
+ * @param[in] ctx Context with the statistics.
+ * @param[in] schema Schema node with the constraint.
+ * @param[in] kind Kind of the constraint.
+ * @param[in] start Start time returned by ::lyd_val_stats_start(), nothing is recorded if 0.
+ */
+void lyd_val_stats_record(const struct ly_ctx *ctx, const struct lysc_node *schema, enum lyd_val_stat_kind kind,
+        uint64_t start);
+
+/**
+ * @brief Free the cached schema dependency graph of the incremental validation, the schema nodes may change.
+ *
+ * @param[in] ctx Context with the graph.
+ */
+void lyd_val_incr_graph_free(struct ly_ctx *ctx);
+
+/**
+ * @brief Discard the collected validation statistics, the measured schema nodes may change.
+ *
+ * @param[in] ctx Context with the statistics.
+ */
+void lyd_val_stats_clear(struct ly_ctx *ctx);
+
 /**
  * @brief Finish validation of nodes and attributes. Specifically, when (is processed first) and type validation.
  *
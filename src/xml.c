@@ -25,6 +25,8 @@
 
 #include "common.h"
 #include "compat.h"
+#include "dict.h"
+#include "hash_table.h"
 #include "in_internal.h"
 #include "out_internal.h"
 #include "tree.h"
@@ -136,13 +138,278 @@ lyxml_parse_identifier(struct lyxml_ctx *xmlctx, const char **start, const char
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Callback for checking equality of namespace prefixes in ::lyxml_ns_scope.prefix_ht.
+ *
+ * Implementation of ::lyht_value_equal_cb. When searching, @p cb_data is the length of the searched prefix.
+ */
+static ly_bool
+lyxml_ns_prefix_equal_cb(void *val1_p, void *val2_p, ly_bool mod, void *cb_data)
+{
+    const struct lyxml_ns *ns1 = *(struct lyxml_ns **)val1_p, *ns2 = *(struct lyxml_ns **)val2_p;
+
+    if (mod) {
+        /* the specific record */
+        return ns1 == ns2;
+    }
+
+    if (!ns1->prefix || !ns2->prefix) {
+        /* default namespace */
+        return !ns1->prefix && !ns2->prefix;
+    }
+
+    return !ly_strncmp(ns2->prefix, ns1->prefix, *(size_t *)cb_data);
+}
+
+/**
+ * @brief Callback for checking equality of namespace URIs in ::lyxml_ns_scope.uri_ht.
+ *
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyxml_ns_uri_equal_cb(void *val1_p, void *val2_p, ly_bool mod, void *UNUSED(cb_data))
+{
+    const struct lyxml_ns *ns1 = *(struct lyxml_ns **)val1_p, *ns2 = *(struct lyxml_ns **)val2_p;
+
+    if (mod) {
+        /* the specific record */
+        return ns1 == ns2;
+    }
+
+    return !strcmp(ns1->uri, ns2->uri);
+}
+
+/**
+ * @brief Find the hash table record of a namespace definition prefix.
+ *
+ * @param[in] scope Namespace scope.
+ * @param[in] ns Namespace record with the prefix to find, may not be terminated.
+ * @param[in] prefix_len Length of the prefix.
+ * @param[out] hash Hash of the prefix.
+ * @return Hash table record with the visible definition, NULL if there is none.
+ */
+static struct lyxml_ns **
+lyxml_ns_scope_find_prefix(const struct lyxml_ns_scope *scope, const struct lyxml_ns *ns, size_t prefix_len, uint32_t *hash)
+{
+    struct lyxml_ns **match;
+
+    *hash = dict_hash(ns->prefix ? ns->prefix : "", prefix_len);
+    lyht_set_cb_data(scope->prefix_ht, &prefix_len);
+    if (lyht_find(scope->prefix_ht, &ns, *hash, (void **)&match)) {
+        return NULL;
+    }
+    return match;
+}
+
+/**
+ * @brief Make a namespace definition, the most recent one in the scope, visible in the scope hash tables.
+ *
+ * @param[in] scope Namespace scope.
+ * @param[in] ns Namespace definition to add.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxml_ns_scope_hash_add(struct lyxml_ns_scope *scope, struct lyxml_ns *ns)
+{
+    struct lyxml_ns **match;
+    uint32_t hash;
+
+    /* the definition shadows any previous one of the prefix */
+    match = lyxml_ns_scope_find_prefix(scope, ns, ns->prefix ? strlen(ns->prefix) : 0, &hash);
+    if (match) {
+        ns->prev_prefix = *match;
+        *match = ns;
+    } else {
+        ns->prev_prefix = NULL;
+        LY_CHECK_RET(lyht_insert(scope->prefix_ht, &ns, hash, NULL));
+    }
+
+    ns->prev_uri = NULL;
+    if (!ns->prefix) {
+        /* default namespace is never used for finding a prefix */
+        return LY_SUCCESS;
+    }
+
+    hash = dict_hash(ns->uri, strlen(ns->uri));
+    if (!lyht_find(scope->uri_ht, &ns, hash, (void **)&match)) {
+        ns->prev_uri = *match;
+        *match = ns;
+    } else {
+        LY_CHECK_RET(lyht_insert(scope->uri_ht, &ns, hash, NULL));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create the hash tables of a namespace scope and add all its definitions.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in] scope Namespace scope with no hash tables.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxml_ns_scope_hash(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope)
+{
+    uint32_t i;
+
+    scope->prefix_ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyxml_ns *), lyxml_ns_prefix_equal_cb, NULL, 1);
+    LY_CHECK_ERR_RET(!scope->prefix_ht, LOGMEM(ctx), LY_EMEM);
+    scope->uri_ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyxml_ns *), lyxml_ns_uri_equal_cb, NULL, 1);
+    LY_CHECK_ERR_RET(!scope->uri_ht, LOGMEM(ctx), LY_EMEM);
+
+    for (i = 0; i < scope->ns.count; ++i) {
+        LY_CHECK_RET(lyxml_ns_scope_hash_add(scope, scope->ns.objs[i]));
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free a namespace record of a namespace scope.
+ *
+ * @param[in] ctx libyang context with the dictionary.
+ * @param[in] ns Namespace record to free.
+ */
+static void
+lyxml_ns_free(const struct ly_ctx *ctx, struct lyxml_ns *ns)
+{
+    lydict_remove(ctx, ns->prefix);
+    lydict_remove(ctx, ns->uri);
+    free(ns);
+}
+
+LY_ERR
+lyxml_ns_scope_push(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope, const char *prefix, size_t prefix_len,
+        const char *uri, size_t uri_len, ly_bool *dynamic, uint32_t depth)
+{
+    LY_ERR ret;
+    struct lyxml_ns *ns;
+
+    ns = calloc(1, sizeof *ns);
+    LY_CHECK_ERR_RET(!ns, LOGMEM(ctx), LY_EMEM);
+
+    ns->depth = depth;
+    ns->scoped = 1;
+    if (dynamic && *dynamic) {
+        ret = lydict_insert_zc(ctx, (char *)uri, (const char **)&ns->uri);
+        *dynamic = 0;
+    } else {
+        /* mind an empty URI undeclaring the default namespace, the length 0 would mean a terminated string */
+        ret = lydict_insert(ctx, uri_len ? uri : "", uri_len, (const char **)&ns->uri);
+    }
+    LY_CHECK_ERR_RET(ret, free(ns), ret);
+    if (prefix) {
+        LY_CHECK_ERR_RET(ret = lydict_insert(ctx, prefix, prefix_len, (const char **)&ns->prefix),
+                lyxml_ns_free(ctx, ns), ret);
+    }
+
+    if (!scope->prefix_ht) {
+        /* first definition, the hash tables are then kept and updated until the scope is erased */
+        LY_CHECK_ERR_RET(ret = lyxml_ns_scope_hash(ctx, scope), lyxml_ns_free(ctx, ns), ret);
+    }
+
+    LY_CHECK_ERR_RET(ret = ly_set_add(&scope->ns, ns, 1, NULL), lyxml_ns_free(ctx, ns), ret);
+    LY_CHECK_ERR_RET(ret = lyxml_ns_scope_hash_add(scope, ns), lyxml_ns_scope_pop(ctx, scope), ret);
+
+    return LY_SUCCESS;
+}
+
+void
+lyxml_ns_scope_pop(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope)
+{
+    struct lyxml_ns *ns, **match;
+    uint32_t hash;
+
+    assert(scope->ns.count);
+    ns = scope->ns.objs[scope->ns.count - 1];
+    --scope->ns.count;
+
+    /* it is the most recent definition, so it is visible */
+    match = lyxml_ns_scope_find_prefix(scope, ns, ns->prefix ? strlen(ns->prefix) : 0, &hash);
+    if (match && (*match == ns)) {
+        if (ns->prev_prefix) {
+            *match = ns->prev_prefix;
+        } else {
+            lyht_remove(scope->prefix_ht, &ns, hash);
+        }
+    }
+
+    if (ns->prefix) {
+        hash = dict_hash(ns->uri, strlen(ns->uri));
+        if (!lyht_find(scope->uri_ht, &ns, hash, (void **)&match) && (*match == ns)) {
+            if (ns->prev_uri) {
+                *match = ns->prev_uri;
+            } else {
+                lyht_remove(scope->uri_ht, &ns, hash);
+            }
+        }
+    }
+
+    lyxml_ns_free(ctx, ns);
+}
+
+const struct lyxml_ns *
+lyxml_ns_scope_get(const struct lyxml_ns_scope *scope, const char *prefix, size_t prefix_len)
+{
+    struct lyxml_ns ns = {0}, **match;
+    uint32_t hash;
+
+    if (!scope->prefix_ht) {
+        /* no namespaces */
+        return NULL;
+    }
+
+    if (prefix && prefix_len) {
+        ns.prefix = (char *)prefix;
+    } else {
+        prefix_len = 0;
+    }
+
+    match = lyxml_ns_scope_find_prefix(scope, &ns, prefix_len, &hash);
+    return match ? *match : NULL;
+}
+
+const struct lyxml_ns *
+lyxml_ns_scope_get_uri(const struct lyxml_ns_scope *scope, const char *uri)
+{
+    struct lyxml_ns ns = {0}, *ns_p = &ns, **match;
+
+    if (!scope->uri_ht) {
+        /* no namespaces */
+        return NULL;
+    }
+
+    ns.uri = (char *)uri;
+    if (lyht_find(scope->uri_ht, &ns_p, dict_hash(uri, strlen(uri)), (void **)&match)) {
+        return NULL;
+    }
+    return *match;
+}
+
+void
+lyxml_ns_scope_erase(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope)
+{
+    uint32_t i;
+
+    for (i = 0; i < scope->ns.count; ++i) {
+        lyxml_ns_free(ctx, scope->ns.objs[i]);
+    }
+    ly_set_erase(&scope->ns, NULL);
+
+    lyht_free(scope->prefix_ht);
+    scope->prefix_ht = NULL;
+    lyht_free(scope->uri_ht);
+    scope->uri_ht = NULL;
+}
+
 /**
  * @brief Add namespace definition into XML context.
  *
  * Namespaces from a single element are supposed to be added sequentially together (not interleaved by a namespace from other
  * element). This mimic namespace visibility, since the namespace defined in element E is not visible from its parents or
  * siblings. On the other hand, namespace from a parent element can be redefined in a child element. This is also reflected
- * by lyxml_ns_get() which returns the most recent namespace definition for the given prefix.
+ * by lyxml_ns_scope_get() which returns the most recent namespace definition for the given prefix.
  *
  * When leaving processing of a subtree of some element (after it is removed from xmlctx->elements), caller is supposed to call
  * lyxml_ns_rm() to remove all the namespaces defined in such an element from the context.
@@ -150,55 +417,35 @@ lyxml_parse_identifier(struct lyxml_ctx *xmlctx, const char **start, const char
  * @param[in] xmlctx XML context to work with.
  * @param[in] prefix Pointer to the namespace prefix. Can be NULL for default namespace.
  * @param[in] prefix_len Length of the prefix.
- * @param[in] uri Namespace URI (value) to store directly. Value is always spent.
+ * @param[in] uri Namespace URI (value).
+ * @param[in] uri_len Length of @p uri.
+ * @param[in,out] dynamic Whether @p uri is dynamically allocated, set to 0 if it was spent.
  * @return LY_ERR values.
  */
 LY_ERR
-lyxml_ns_add(struct lyxml_ctx *xmlctx, const char *prefix, size_t prefix_len, char *uri)
+lyxml_ns_add(struct lyxml_ctx *xmlctx, const char *prefix, size_t prefix_len, const char *uri, size_t uri_len,
+        ly_bool *dynamic)
 {
-    LY_ERR ret = LY_SUCCESS;
-    struct lyxml_ns *ns;
-
-    ns = malloc(sizeof *ns);
-    LY_CHECK_ERR_RET(!ns, LOGMEM(xmlctx->ctx), LY_EMEM);
-
     /* we need to connect the depth of the element where the namespace is defined with the
      * namespace record to be able to maintain (remove) the record when the parser leaves
      * (to its sibling or back to the parent) the element where the namespace was defined */
-    ns->depth = xmlctx->elements.count;
-
-    ns->uri = uri;
-    if (prefix) {
-        ns->prefix = strndup(prefix, prefix_len);
-        LY_CHECK_ERR_RET(!ns->prefix, LOGMEM(xmlctx->ctx); free(ns->uri); free(ns), LY_EMEM);
-    } else {
-        ns->prefix = NULL;
-    }
-
-    ret = ly_set_add(&xmlctx->ns, ns, 1, NULL);
-    LY_CHECK_ERR_RET(ret, free(ns->prefix); free(ns->uri); free(ns), ret);
-
-    return LY_SUCCESS;
+    return lyxml_ns_scope_push(xmlctx->ctx, &xmlctx->ns_scope, prefix, prefix_len, uri, uri_len, dynamic,
+            xmlctx->elements.count);
 }
 
 void
 lyxml_ns_rm(struct lyxml_ctx *xmlctx)
 {
-    for (uint32_t u = xmlctx->ns.count - 1; u + 1 > 0; --u) {
-        if (((struct lyxml_ns *)xmlctx->ns.objs[u])->depth != xmlctx->elements.count + 1) {
+    struct lyxml_ns_scope *scope = &xmlctx->ns_scope;
+
+    while (scope->ns.count) {
+        if (((struct lyxml_ns *)scope->ns.objs[scope->ns.count - 1])->depth != xmlctx->elements.count + 1) {
             /* we are done, the namespaces from a single element are supposed to be together */
             break;
         }
-        /* remove the ns structure */
-        free(((struct lyxml_ns *)xmlctx->ns.objs[u])->prefix);
-        free(((struct lyxml_ns *)xmlctx->ns.objs[u])->uri);
-        free(xmlctx->ns.objs[u]);
-        --xmlctx->ns.count;
-    }
 
-    if (!xmlctx->ns.count) {
-        /* cleanup the xmlctx's namespaces storage */
-        ly_set_erase(&xmlctx->ns, NULL);
+        /* remove the ns structure, the hash tables are kept for the next definitions */
+        lyxml_ns_scope_pop(xmlctx->ctx, scope);
     }
 }
 
@@ -207,6 +454,11 @@ lyxml_ns_get(const struct ly_set *ns_set, const char *prefix, size_t prefix_len)
 {
     struct lyxml_ns *ns;
 
+    if (ns_set->count && ((struct lyxml_ns *)ns_set->objs[0])->scoped) {
+        /* stack of a namespace scope, it is the first member */
+        return lyxml_ns_scope_get((const struct lyxml_ns_scope *)ns_set, prefix, prefix_len);
+    }
+
     for (uint32_t u = ns_set->count - 1; u + 1 > 0; --u) {
         ns = (struct lyxml_ns *)ns_set->objs[u];
         if (prefix && prefix_len) {
@@ -673,9 +925,7 @@ lyxml_open_element(struct lyxml_ctx *xmlctx, const char *prefix, size_t prefix_l
 
         /* store every namespace */
         if ((prefix && !ly_strncmp("xmlns", prefix, prefix_len)) || (!prefix && !ly_strncmp("xmlns", name, name_len))) {
-            ret = lyxml_ns_add(xmlctx, prefix ? name : NULL, prefix ? name_len : 0,
-                    dynamic ? value : strndup(value, value_len));
-            dynamic = 0;
+            ret = lyxml_ns_add(xmlctx, prefix ? name : NULL, prefix ? name_len : 0, value, value_len, &dynamic);
             LY_CHECK_GOTO(ret, cleanup);
         } else {
             /* not a namespace */
@@ -1085,27 +1335,6 @@ cleanup:
     return ret;
 }
 
-/**
- * @brief Free all namespaces in XML context.
- *
- * @param[in] xmlctx XML context to use.
- */
-static void
-lyxml_ns_rm_all(struct lyxml_ctx *xmlctx)
-{
-    struct lyxml_ns *ns;
-    uint32_t i;
-
-    for (i = 0; i < xmlctx->ns.count; ++i) {
-        ns = xmlctx->ns.objs[i];
-
-        free(ns->prefix);
-        free(ns->uri);
-        free(ns);
-    }
-    ly_set_erase(&xmlctx->ns, NULL);
-}
-
 void
 lyxml_ctx_free(struct lyxml_ctx *xmlctx)
 {
@@ -1119,7 +1348,7 @@ lyxml_ctx_free(struct lyxml_ctx *xmlctx)
         free((char *)xmlctx->value);
     }
     ly_set_erase(&xmlctx->elements, free);
-    lyxml_ns_rm_all(xmlctx);
+    lyxml_ns_scope_erase(xmlctx->ctx, &xmlctx->ns_scope);
     free(xmlctx);
 }
 
@@ -1144,29 +1373,25 @@ lyxml_elem_dup(const struct lyxml_elem *elem)
 }
 
 /**
- * @brief Duplicate an XML namespace.
+ * @brief Duplicate an XML namespace of a namespace scope.
  *
+ * @param[in] ctx libyang context with the dictionary.
  * @param[in] ns Namespace to duplicate.
  * @return Namespace duplicate.
  * @return NULL on error.
  */
 static struct lyxml_ns *
-lyxml_ns_dup(const struct lyxml_ns *ns)
+lyxml_ns_dup(const struct ly_ctx *ctx, const struct lyxml_ns *ns)
 {
     struct lyxml_ns *dup;
 
-    dup = malloc(sizeof *dup);
-    LY_CHECK_ERR_RET(!dup, LOGMEM(NULL), NULL);
+    dup = calloc(1, sizeof *dup);
+    LY_CHECK_ERR_RET(!dup, LOGMEM(ctx), NULL);
 
-    if (ns->prefix) {
-        dup->prefix = strdup(ns->prefix);
-        LY_CHECK_ERR_RET(!dup->prefix, LOGMEM(NULL); free(dup), NULL);
-    } else {
-        dup->prefix = NULL;
-    }
-    dup->uri = strdup(ns->uri);
-    LY_CHECK_ERR_RET(!dup->uri, LOGMEM(NULL); free(dup->prefix); free(dup), NULL);
+    LY_CHECK_ERR_RET(lydict_insert(ctx, ns->prefix, 0, (const char **)&dup->prefix), free(dup), NULL);
+    LY_CHECK_ERR_RET(lydict_insert(ctx, ns->uri, 0, (const char **)&dup->uri), lyxml_ns_free(ctx, dup), NULL);
     dup->depth = ns->depth;
+    dup->scoped = 1;
 
     return dup;
 }
@@ -1197,11 +1422,18 @@ lyxml_ctx_backup(struct lyxml_ctx *xmlctx, struct lyxml_ctx *backup)
     }
 
     /* duplicate ns */
-    backup->ns.objs = malloc(xmlctx->ns.size * sizeof(struct lyxml_ns));
-    LY_CHECK_ERR_RET(!backup->ns.objs, LOGMEM(xmlctx->ctx), LY_EMEM);
-    for (i = 0; i < xmlctx->ns.count; ++i) {
-        backup->ns.objs[i] = lyxml_ns_dup(xmlctx->ns.objs[i]);
-        LY_CHECK_RET(!backup->ns.objs[i], LY_EMEM);
+    backup->ns_scope.ns.objs = malloc(xmlctx->ns_scope.ns.size * sizeof(struct lyxml_ns));
+    LY_CHECK_ERR_RET(!backup->ns_scope.ns.objs, LOGMEM(xmlctx->ctx), LY_EMEM);
+    for (i = 0; i < xmlctx->ns_scope.ns.count; ++i) {
+        backup->ns_scope.ns.objs[i] = lyxml_ns_dup(xmlctx->ctx, xmlctx->ns_scope.ns.objs[i]);
+        LY_CHECK_RET(!backup->ns_scope.ns.objs[i], LY_EMEM);
+    }
+
+    /* hash the duplicated ns */
+    backup->ns_scope.prefix_ht = NULL;
+    backup->ns_scope.uri_ht = NULL;
+    if (backup->ns_scope.ns.count) {
+        LY_CHECK_RET(lyxml_ns_scope_hash(xmlctx->ctx, &backup->ns_scope));
     }
 
     return LY_SUCCESS;
@@ -1219,7 +1451,7 @@ lyxml_ctx_restore(struct lyxml_ctx *xmlctx, struct lyxml_ctx *backup)
     ly_set_erase(&xmlctx->elements, free);
 
     /* free ns */
-    lyxml_ns_rm_all(xmlctx);
+    lyxml_ns_scope_erase(xmlctx->ctx, &xmlctx->ns_scope);
 
     /* restore in */
     xmlctx->in->current = backup->b_current;
@@ -22,6 +22,7 @@
 #include "log.h"
 #include "set.h"
 
+struct hash_table;
 struct ly_ctx;
 struct ly_in;
 struct ly_out;
@@ -51,9 +52,28 @@ struct ly_out;
         (c >= 0x10000 && c <= 0xeffff))
 
 struct lyxml_ns {
-    char *prefix;         /* prefix of the namespace, NULL for the default namespace */
-    char *uri;            /* namespace URI */
+    char *prefix;         /* prefix of the namespace, NULL for the default namespace (in dictionary in a scope) */
+    char *uri;            /* namespace URI (in dictionary in a scope) */
     uint32_t depth;       /* depth level of the element to maintain the list of accessible namespace definitions */
+    ly_bool scoped;       /* set for the records of a namespace scope, their set is then ::lyxml_ns_scope.ns */
+
+    struct lyxml_ns *prev_prefix; /* namespace scope only - shadowed definition of the same prefix */
+    struct lyxml_ns *prev_uri;    /* namespace scope only - previous prefixed definition of the same URI */
+};
+
+/**
+ * @brief Stack of in-scope XML namespace definitions shared by the XML parser and printer.
+ *
+ * Definitions are stored in a set in the order they were made so that leaving an element means just removing
+ * the last records. Besides that, the visible definition of every prefix and the most recent prefixed definition
+ * of every namespace URI are kept in hash tables so that resolving a prefix or finding a prefix for a namespace
+ * does not require searching all the definitions. Shadowed definitions are linked from the visible ones.
+ * The hash tables are updated incrementally and kept even when the scope becomes empty.
+ */
+struct lyxml_ns_scope {
+    struct ly_set ns;               /* stack of struct lyxml_ns, usable as LY_VALUE_XML prefix data (must be first) */
+    struct hash_table *prefix_ht;   /* visible definition of each prefix ("" for the default namespace) */
+    struct hash_table *uri_ht;      /* the most recent prefixed definition of each namespace URI */
 };
 
 /* element tag identifier for matching opening and closing tags */
@@ -100,7 +120,7 @@ struct lyxml_ctx {
     };
 
     struct ly_set elements; /* list of not-yet-closed elements */
-    struct ly_set ns;       /* handled with LY_SET_OPT_USEASLIST */
+    struct lyxml_ns_scope ns_scope; /* namespaces defined in the not-yet-closed elements */
 
     /* backup in members */
     const char *b_current;
@@ -145,15 +165,74 @@ LY_ERR lyxml_ctx_peek(struct lyxml_ctx *xmlctx, enum LYXML_PARSER_STATUS *next);
 void lyxml_ns_rm(struct lyxml_ctx *xmlctx);
 
 /**
- * @brief Get a namespace record for the given prefix in the current context.
+ * @brief Get a namespace record for the given prefix in a set of namespaces.
+ *
+ * If @p ns_set is the stack of a namespace scope, its hash tables are used (see ::lyxml_ns_scope_get()), otherwise
+ * all the records are searched.
  *
- * @param[in] ns_set Set with namespaces from the XML context.
+ * @param[in] ns_set Set with namespaces, for example stored prefix data.
  * @param[in] prefix Pointer to the namespace prefix. Can be NULL for default namespace.
  * @param[in] prefix_len Length of the prefix string (since it might not be NULL-terminated).
  * @return The namespace record or NULL if the record for the specified prefix not found.
  */
 const struct lyxml_ns *lyxml_ns_get(const struct ly_set *ns_set, const char *prefix, size_t prefix_len);
 
+/**
+ * @brief Add a namespace definition into a namespace scope.
+ *
+ * The new definition shadows any previous definition of the same prefix until it is removed.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in] scope Namespace scope to add to.
+ * @param[in] prefix Pointer to the namespace prefix. Can be NULL for default namespace.
+ * @param[in] prefix_len Length of the prefix string (since it might not be NULL-terminated).
+ * @param[in] uri Namespace URI.
+ * @param[in] uri_len Length of @p uri.
+ * @param[in,out] dynamic Optional flag whether @p uri is dynamically allocated, set to 0 if it was spent.
+ * @param[in] depth Depth of the element defining the namespace.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxml_ns_scope_push(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope, const char *prefix, size_t prefix_len,
+        const char *uri, size_t uri_len, ly_bool *dynamic, uint32_t depth);
+
+/**
+ * @brief Remove the most recent namespace definition from a namespace scope, making visible any shadowed one.
+ *
+ * @param[in] ctx libyang context with the dictionary.
+ * @param[in] scope Namespace scope to remove from, must not be empty.
+ */
+void lyxml_ns_scope_pop(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope);
+
+/**
+ * @brief Get the visible namespace definition of a prefix in a namespace scope.
+ *
+ * @param[in] scope Namespace scope to search in.
+ * @param[in] prefix Pointer to the namespace prefix. Can be NULL for default namespace.
+ * @param[in] prefix_len Length of the prefix string (since it might not be NULL-terminated).
+ * @return The namespace record or NULL if the prefix is not defined.
+ */
+const struct lyxml_ns *lyxml_ns_scope_get(const struct lyxml_ns_scope *scope, const char *prefix, size_t prefix_len);
+
+/**
+ * @brief Get the most recent prefixed definition of a namespace in a namespace scope.
+ *
+ * Older definitions of the namespace are available in ::lyxml_ns.prev_uri of the returned record. Note that
+ * the prefix of any of these records may have been redefined since.
+ *
+ * @param[in] scope Namespace scope to search in.
+ * @param[in] uri Namespace URI.
+ * @return The namespace record or NULL if the namespace is not defined with any prefix.
+ */
+const struct lyxml_ns *lyxml_ns_scope_get_uri(const struct lyxml_ns_scope *scope, const char *uri);
+
+/**
+ * @brief Free all the namespace definitions and the hash tables of a namespace scope.
+ *
+ * @param[in] ctx libyang context with the dictionary.
+ * @param[in] scope Namespace scope to erase, the structure itself is not freed.
+ */
+void lyxml_ns_scope_erase(const struct ly_ctx *ctx, struct lyxml_ns_scope *scope);
+
 /**
  * @brief Print the given @p text as XML string which replaces some of the characters which cannot appear in XML data.
  *
@@ -18,11 +18,13 @@
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "common.h"
 #include "compat.h"
@@ -271,35 +273,35 @@ print_set_debug(struct lyxp_set *set)
 
             switch (item->type) {
             case LYXP_NODE_NONE:
-                LOGDBG(LY_LDGXPATH, "\t%d (pos %u): NONE", i + 1, item->pos);
+                LOGDBG(LY_LDGXPATH, "\t%d: NONE", i + 1);
                 break;
             case LYXP_NODE_ROOT:
-                LOGDBG(LY_LDGXPATH, "\t%d (pos %u): ROOT", i + 1, item->pos);
+                LOGDBG(LY_LDGXPATH, "\t%d: ROOT", i + 1);
                 break;
             case LYXP_NODE_ROOT_CONFIG:
-                LOGDBG(LY_LDGXPATH, "\t%d (pos %u): ROOT CONFIG", i + 1, item->pos);
+                LOGDBG(LY_LDGXPATH, "\t%d: ROOT CONFIG", i + 1);
                 break;
             case LYXP_NODE_ELEM:
                 if ((item->node->schema->nodetype == LYS_LIST) && (lyd_child(item->node)->schema->nodetype == LYS_LEAF)) {
-                    LOGDBG(LY_LDGXPATH, "\t%d (pos %u): ELEM %s (1st child val: %s)", i + 1, item->pos,
+                    LOGDBG(LY_LDGXPATH, "\t%d: ELEM %s (1st child val: %s)", i + 1,
                             item->node->schema->name, lyd_get_value(lyd_child(item->node)));
                 } else if (item->node->schema->nodetype == LYS_LEAFLIST) {
-                    LOGDBG(LY_LDGXPATH, "\t%d (pos %u): ELEM %s (val: %s)", i + 1, item->pos,
+                    LOGDBG(LY_LDGXPATH, "\t%d: ELEM %s (val: %s)", i + 1,
                             item->node->schema->name, lyd_get_value(item->node));
                 } else {
-                    LOGDBG(LY_LDGXPATH, "\t%d (pos %u): ELEM %s", i + 1, item->pos, item->node->schema->name);
+                    LOGDBG(LY_LDGXPATH, "\t%d: ELEM %s", i + 1, item->node->schema->name);
                 }
                 break;
             case LYXP_NODE_TEXT:
                 if (item->node->schema->nodetype & LYS_ANYDATA) {
-                    LOGDBG(LY_LDGXPATH, "\t%d (pos %u): TEXT <%s>", i + 1, item->pos,
+                    LOGDBG(LY_LDGXPATH, "\t%d: TEXT <%s>", i + 1,
                             item->node->schema->nodetype == LYS_ANYXML ? "anyxml" : "anydata");
                 } else {
-                    LOGDBG(LY_LDGXPATH, "\t%d (pos %u): TEXT %s", i + 1, item->pos, lyd_get_value(item->node));
+                    LOGDBG(LY_LDGXPATH, "\t%d: TEXT %s", i + 1, lyd_get_value(item->node));
                 }
                 break;
             case LYXP_NODE_META:
-                LOGDBG(LY_LDGXPATH, "\t%d (pos %u): META %s = %s", i + 1, item->pos, set->val.meta[i].meta->name,
+                LOGDBG(LY_LDGXPATH, "\t%d: META %s = %s", i + 1, set->val.meta[i].meta->name,
                         set->val.meta[i].meta->value);
                 break;
             }
@@ -854,6 +856,50 @@ set_init(struct lyxp_set *new, const struct lyxp_set *set)
         new->format = set->format;
         new->prefix_data = set->prefix_data;
         new->vars = set->vars;
+        new->prof = set->prof;
+    }
+}
+
+/**
+ * @brief Get the current time for profiling.
+ *
+ * @return Monotonic time in nanoseconds, 0 if not supported.
+ */
+static uint64_t
+prof_time(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (!clock_gettime(CLOCK_MONOTONIC, &ts)) {
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Record evaluations of a token into the profile of a set.
+ *
+ * @param[in] set Set with the profile and the result of the evaluations.
+ * @param[in] tok_idx Index of the evaluated token.
+ * @param[in] start Time the evaluations started.
+ * @param[in] nodes_in Size of the input node-set.
+ * @param[in] evals Number of the evaluations.
+ */
+static void
+prof_record(struct lyxp_set *set, uint16_t tok_idx, uint64_t start, uint32_t nodes_in, uint32_t evals)
+{
+    struct lyxp_profile_tok *tok = &set->prof->toks[tok_idx];
+
+    tok->evals += evals;
+    tok->time_ns += prof_time() - start;
+    tok->nodes_in += nodes_in;
+    if (set->type == LYXP_SET_NODE_SET) {
+        tok->nodes_out += set->used;
+    } else if (set->type == LYXP_SET_NUMBER) {
+        /* counted node-set */
+        tok->nodes_out += (uint64_t)set->val.num;
     }
 }
 
@@ -1254,12 +1300,11 @@ lyxp_set_scnode_merge(struct lyxp_set *set1, struct lyxp_set *set2)
  *
  * @param[in] set Set to use.
  * @param[in] node Node to insert to @p set.
- * @param[in] pos Sort position of @p node. If left 0, it is filled just before sorting.
  * @param[in] node_type Node type of @p node.
  * @param[in] idx Index in @p set to insert into.
  */
 static void
-set_insert_node(struct lyxp_set *set, const struct lyd_node *node, uint32_t pos, enum lyxp_node_type node_type, uint32_t idx)
+set_insert_node(struct lyxp_set *set, const struct lyd_node *node, enum lyxp_node_type node_type, uint32_t idx)
 {
     assert(set && (set->type == LYXP_SET_NODE_SET));
 
@@ -1302,7 +1347,6 @@ set_insert_node(struct lyxp_set *set, const struct lyd_node *node, uint32_t pos,
     /* finally assign the value */
     set->val.nodes[idx].node = (struct lyd_node *)node;
     set->val.nodes[idx].type = node_type;
-    set->val.nodes[idx].pos = pos;
     ++set->used;
 
     /* add into hash table */
@@ -1383,133 +1427,6 @@ retry:
     return ret_ctx;
 }
 
-/**
- * @brief Get unique @p node position in the data.
- *
- * @param[in] node Node to find.
- * @param[in] node_type Node type of @p node.
- * @param[in] root Root node.
- * @param[in] root_type Type of the XPath @p root node.
- * @param[in] prev Node that we think is before @p node in DFS from @p root. Can optionally
- * be used to increase efficiency and start the DFS from this node.
- * @param[in] prev_pos Node @p prev position. Optional, but must be set if @p prev is set.
- * @return Node position.
- */
-static uint32_t
-get_node_pos(const struct lyd_node *node, enum lyxp_node_type node_type, const struct lyd_node *root,
-        enum lyxp_node_type root_type, const struct lyd_node **prev, uint32_t *prev_pos)
-{
-    const struct lyd_node *elem = NULL, *top_sibling;
-    uint32_t pos = 1;
-    ly_bool found = 0;
-
-    assert(prev && prev_pos && !root->prev->next);
-
-    if ((node_type == LYXP_NODE_ROOT) || (node_type == LYXP_NODE_ROOT_CONFIG)) {
-        return 0;
-    }
-
-    if (*prev) {
-        /* start from the previous element instead from the root */
-        pos = *prev_pos;
-        for (top_sibling = *prev; top_sibling->parent; top_sibling = lyd_parent(top_sibling)) {}
-        goto dfs_search;
-    }
-
-    LY_LIST_FOR(root, top_sibling) {
-        LYD_TREE_DFS_BEGIN(top_sibling, elem) {
-dfs_search:
-            LYD_TREE_DFS_continue = 0;
-
-            if (*prev && !elem) {
-                /* resume previous DFS */
-                elem = LYD_TREE_DFS_next = (struct lyd_node *)*prev;
-                LYD_TREE_DFS_continue = 0;
-            }
-
-            if (!elem->schema || ((root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R))) {
-                /* skip */
-                LYD_TREE_DFS_continue = 1;
-            } else {
-                if (elem == node) {
-                    found = 1;
-                    break;
-                }
-                ++pos;
-            }
-
-            LYD_TREE_DFS_END(top_sibling, elem);
-        }
-
-        /* node found */
-        if (found) {
-            break;
-        }
-    }
-
-    if (!found) {
-        if (!(*prev)) {
-            /* we went from root and failed to find it, cannot be */
-            LOGINT(LYD_CTX(node));
-            return 0;
-        } else {
-            /* start the search again from the beginning */
-            *prev = root;
-
-            top_sibling = root;
-            pos = 1;
-            goto dfs_search;
-        }
-    }
-
-    /* remember the last found node for next time */
-    *prev = node;
-    *prev_pos = pos;
-
-    return pos;
-}
-
-/**
- * @brief Assign (fill) missing node positions.
- *
- * @param[in] set Set to fill positions in.
- * @param[in] root Context root node.
- * @param[in] root_type Context root type.
- * @return LY_ERR
- */
-static LY_ERR
-set_assign_pos(struct lyxp_set *set, const struct lyd_node *root, enum lyxp_node_type root_type)
-{
-    const struct lyd_node *prev = NULL, *tmp_node;
-    uint32_t i, tmp_pos = 0;
-
-    for (i = 0; i < set->used; ++i) {
-        if (!set->val.nodes[i].pos) {
-            tmp_node = NULL;
-            switch (set->val.nodes[i].type) {
-            case LYXP_NODE_META:
-                tmp_node = set->val.meta[i].meta->parent;
-                if (!tmp_node) {
-                    LOGINT_RET(root->schema->module->ctx);
-                }
-            /* fall through */
-            case LYXP_NODE_ELEM:
-            case LYXP_NODE_TEXT:
-                if (!tmp_node) {
-                    tmp_node = set->val.nodes[i].node;
-                }
-                set->val.nodes[i].pos = get_node_pos(tmp_node, set->val.nodes[i].type, root, root_type, &prev, &tmp_pos);
-                break;
-            default:
-                /* all roots have position 0 */
-                break;
-            }
-        }
-    }
-
-    return LY_SUCCESS;
-}
-
 /**
  * @brief Get unique @p meta position in the parent metadata.
  *
@@ -1541,13 +1458,18 @@ static int
 set_sort_compare(struct lyxp_set_node *item1, struct lyxp_set_node *item2)
 {
     uint32_t meta_pos1 = 0, meta_pos2 = 0;
+    const struct lyd_node *node1, *node2;
 
-    if (item1->pos < item2->pos) {
-        return -1;
-    }
-
-    if (item1->pos > item2->pos) {
-        return 1;
+    /* learn the data nodes, roots are before any node */
+    node1 = (item1->type == LYXP_NODE_META) ? ((struct lyd_meta *)item1->node)->parent : item1->node;
+    node2 = (item2->type == LYXP_NODE_META) ? ((struct lyd_meta *)item2->node)->parent : item2->node;
+    if (node1 != node2) {
+        if (!node1) {
+            return -1;
+        } else if (!node2) {
+            return 1;
+        }
+        return lyd_order_cmp(node1, node2);
     }
 
     /* node positions are equal, the fun case */
@@ -1618,7 +1540,7 @@ set_comp_cast(struct lyxp_set *trg, struct lyxp_set *src, enum lyxp_set_type typ
     set_init(trg, src);
 
     /* insert node into target set */
-    set_insert_node(trg, src->val.nodes[src_idx].node, src->val.nodes[src_idx].pos, src->val.nodes[src_idx].type, 0);
+    set_insert_node(trg, src->val.nodes[src_idx].node, src->val.nodes[src_idx].type, 0);
 
     /* cast target set appropriately */
     return lyxp_set_cast(trg, type);
@@ -1706,7 +1628,6 @@ set_sort(struct lyxp_set *set)
     uint32_t i, j;
     int ret = 0, cmp;
     ly_bool inverted, change;
-    const struct lyd_node *root;
     struct lyxp_set_node item;
     struct lyxp_set_hash_node hnode;
     uint64_t hash;
@@ -1715,15 +1636,6 @@ set_sort(struct lyxp_set *set)
         return 0;
     }
 
-    /* find first top-level node to be used as anchor for positions */
-    for (root = set->tree; root->parent; root = lyd_parent(root)) {}
-    for ( ; root->prev->next; root = root->prev) {}
-
-    /* fill positions */
-    if (set_assign_pos(set, root, set->root_type)) {
-        return -1;
-    }
-
 #ifndef NDEBUG
     LOGDBG(LY_LDGXPATH, "SORT BEGIN");
     print_set_debug(set);
@@ -1796,7 +1708,6 @@ set_sorted_merge(struct lyxp_set *trg, struct lyxp_set *src)
 {
     uint32_t i, j, k, count, dup_count;
     int cmp;
-    const struct lyd_node *root;
 
     if ((trg->type != LYXP_SET_NODE_SET) || (src->type != LYXP_SET_NODE_SET)) {
         return LY_EINVAL;
@@ -1810,15 +1721,6 @@ set_sorted_merge(struct lyxp_set *trg, struct lyxp_set *src)
         return LY_SUCCESS;
     }
 
-    /* find first top-level node to be used as anchor for positions */
-    for (root = trg->tree; root->parent; root = lyd_parent(root)) {}
-    for ( ; root->prev->next; root = root->prev) {}
-
-    /* fill positions */
-    if (set_assign_pos(trg, root, trg->root_type) || set_assign_pos(src, root, src->root_type)) {
-        return LY_EINT;
-    }
-
 #ifndef NDEBUG
     LOGDBG(LY_LDGXPATH, "MERGE target");
     print_set_debug(trg);
@@ -3233,6 +3135,283 @@ cleanup:
     return ret;
 }
 
+/**
+ * @brief Record of the context cache of parsed XPath expressions.
+ */
+struct lyxp_cache_rec {
+    struct lyxp_expr *exp;          /**< cached expression, the cache holds one of its references */
+    struct lyxp_cache_rec *prev;    /**< more recently used record */
+    struct lyxp_cache_rec *next;    /**< less recently used record */
+};
+
+/**
+ * @brief Bounded LRU cache of parsed XPath expressions, see ::ly_ctx_set_xpath_cache().
+ */
+struct lyxp_cache {
+    struct hash_table *ht;          /**< records (struct lyxp_cache_rec *) hashed by the expression string */
+    struct lyxp_cache_rec *mru;     /**< most recently used record */
+    struct lyxp_cache_rec *lru;     /**< least recently used record, evicted first */
+    uint32_t max;                   /**< maximum number of records */
+};
+
+/**
+ * @brief Hash table equal callback for cache records, compares the expression strings.
+ */
+static ly_bool
+lyxp_cache_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyxp_cache_rec *rec1 = *(struct lyxp_cache_rec **)val1_p, *rec2 = *(struct lyxp_cache_rec **)val2_p;
+
+    return !strcmp(rec1->exp->expr, rec2->exp->expr);
+}
+
+/**
+ * @brief Drop a reference of a cached expression, free it if it was the last one.
+ *
+ * Cache lock must be held.
+ *
+ * @param[in] ctx Context of the expression.
+ * @param[in] exp Expression to release.
+ * @return Whether the expression was freed.
+ */
+static ly_bool
+lyxp_cache_unref(const struct ly_ctx *ctx, struct lyxp_expr *exp)
+{
+    assert(exp->refs);
+
+    if (--exp->refs) {
+        return 0;
+    }
+
+    lyxp_expr_free(ctx, exp);
+    return 1;
+}
+
+/**
+ * @brief Unlink a record from the LRU list of the cache.
+ *
+ * @param[in] cache Cache to use.
+ * @param[in] rec Record to unlink.
+ */
+static void
+lyxp_cache_unlink(struct lyxp_cache *cache, struct lyxp_cache_rec *rec)
+{
+    if (rec->prev) {
+        rec->prev->next = rec->next;
+    } else {
+        cache->mru = rec->next;
+    }
+    if (rec->next) {
+        rec->next->prev = rec->prev;
+    } else {
+        cache->lru = rec->prev;
+    }
+    rec->prev = NULL;
+    rec->next = NULL;
+}
+
+/**
+ * @brief Link a record as the most recently used one in the cache.
+ *
+ * @param[in] cache Cache to use.
+ * @param[in] rec Record to link.
+ */
+static void
+lyxp_cache_link_mru(struct lyxp_cache *cache, struct lyxp_cache_rec *rec)
+{
+    rec->prev = NULL;
+    rec->next = cache->mru;
+    if (cache->mru) {
+        cache->mru->prev = rec;
+    } else {
+        cache->lru = rec;
+    }
+    cache->mru = rec;
+}
+
+/**
+ * @brief Evict the least recently used records until there are at most @p count left.
+ *
+ * Cache lock must be held.
+ *
+ * @param[in] ctx Context of the cache.
+ * @param[in] cache Cache to use.
+ * @param[in] count Number of records to keep.
+ */
+static void
+lyxp_cache_evict(const struct ly_ctx *ctx, struct lyxp_cache *cache, uint32_t count)
+{
+    struct lyxp_cache_rec *rec;
+    LY_ERR r;
+
+    while (cache->ht->used > count) {
+        rec = cache->lru;
+        r = lyht_remove(cache->ht, &rec, dict_hash(rec->exp->expr, strlen(rec->exp->expr)));
+        assert(!r);
+        (void)r;
+
+        lyxp_cache_unlink(cache, rec);
+        lyxp_cache_unref(ctx, rec->exp);
+        free(rec);
+    }
+}
+
+/**
+ * @brief Find an expression in the cache and mark it as the most recently used one.
+ *
+ * Cache lock must be held.
+ *
+ * @param[in] cache Cache to use.
+ * @param[in] expr_str Expression string.
+ * @param[in] hash Hash of @p expr_str.
+ * @return Found record, NULL if there is none.
+ */
+static struct lyxp_cache_rec *
+lyxp_cache_find(struct lyxp_cache *cache, const char *expr_str, uint32_t hash)
+{
+    struct lyxp_expr exp_key = {0};
+    struct lyxp_cache_rec rec_key = {0}, *rec = &rec_key, **match_p;
+
+    exp_key.expr = expr_str;
+    rec_key.exp = &exp_key;
+    if (lyht_find(cache->ht, &rec, hash, (void **)&match_p)) {
+        return NULL;
+    }
+
+    if (cache->mru != *match_p) {
+        lyxp_cache_unlink(cache, *match_p);
+        lyxp_cache_link_mru(cache, *match_p);
+    }
+    return *match_p;
+}
+
+LY_ERR
+lyxp_expr_cache_get(const struct ly_ctx *ctx, const char *expr_str, struct lyxp_expr **expr_p)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_ctx *mctx = (struct ly_ctx *)ctx;
+    struct lyxp_cache_rec *rec;
+    struct lyxp_expr *exp = NULL;
+    uint32_t hash;
+
+    assert(expr_str && expr_p);
+
+    *expr_p = NULL;
+
+    if (!ctx->xp_cache) {
+        /* no cache */
+        return lyxp_expr_parse(ctx, expr_str, 0, 1, expr_p);
+    }
+
+    hash = dict_hash(expr_str, strlen(expr_str));
+
+    /* cache hit */
+    pthread_mutex_lock(&mctx->xp_cache_lock);
+    if (ctx->xp_cache && (rec = lyxp_cache_find(ctx->xp_cache, expr_str, hash))) {
+        ++rec->exp->refs;
+        *expr_p = rec->exp;
+    }
+    pthread_mutex_unlock(&mctx->xp_cache_lock);
+    if (*expr_p) {
+        return LY_SUCCESS;
+    }
+
+    /* cache miss, parse outside the lock */
+    LY_CHECK_RET(lyxp_expr_parse(ctx, expr_str, 0, 1, &exp));
+
+    pthread_mutex_lock(&mctx->xp_cache_lock);
+    if (!ctx->xp_cache) {
+        /* cache disabled meanwhile, use the expression uncached */
+        *expr_p = exp;
+        goto cleanup;
+    }
+
+    if ((rec = lyxp_cache_find(ctx->xp_cache, expr_str, hash))) {
+        /* parsed by someone else meanwhile */
+        lyxp_expr_free(ctx, exp);
+        ++rec->exp->refs;
+        *expr_p = rec->exp;
+        goto cleanup;
+    }
+
+    /* new record, referenced by the cache and the caller */
+    rec = calloc(1, sizeof *rec);
+    LY_CHECK_ERR_GOTO(!rec, LOGMEM(ctx); lyxp_expr_free(ctx, exp); ret = LY_EMEM, cleanup);
+    rec->exp = exp;
+    exp->refs = 2;
+    ret = lyht_insert(ctx->xp_cache->ht, &rec, hash, NULL);
+    LY_CHECK_ERR_GOTO(ret, free(rec); lyxp_expr_free(ctx, exp), cleanup);
+    lyxp_cache_link_mru(ctx->xp_cache, rec);
+    *expr_p = exp;
+
+    /* keep the cache bounded */
+    lyxp_cache_evict(ctx, ctx->xp_cache, ctx->xp_cache->max);
+
+cleanup:
+    pthread_mutex_unlock(&mctx->xp_cache_lock);
+    return ret;
+}
+
+void
+lyxp_expr_cache_put(const struct ly_ctx *ctx, struct lyxp_expr *expr)
+{
+    struct ly_ctx *mctx = (struct ly_ctx *)ctx;
+
+    if (!expr) {
+        return;
+    }
+
+    /* refs are changed by other threads under the lock, so they must be read under it, too */
+    pthread_mutex_lock(&mctx->xp_cache_lock);
+    if (expr->refs) {
+        lyxp_cache_unref(ctx, expr);
+        expr = NULL;
+    }
+    pthread_mutex_unlock(&mctx->xp_cache_lock);
+
+    if (expr) {
+        /* not cached */
+        lyxp_expr_free(ctx, expr);
+    }
+}
+
+LY_ERR
+lyxp_expr_cache_set_size(struct ly_ctx *ctx, uint32_t size)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyxp_cache *cache;
+
+    pthread_mutex_lock(&ctx->xp_cache_lock);
+
+    cache = ctx->xp_cache;
+    if (!size) {
+        /* disable the cache */
+        if (cache) {
+            lyxp_cache_evict(ctx, cache, 0);
+            lyht_free(cache->ht);
+            free(cache);
+            ctx->xp_cache = NULL;
+        }
+        goto cleanup;
+    }
+
+    if (!cache) {
+        /* enable the cache */
+        cache = calloc(1, sizeof *cache);
+        LY_CHECK_ERR_GOTO(!cache, LOGMEM(ctx); ret = LY_EMEM, cleanup);
+        cache->ht = lyht_new(8, sizeof(struct lyxp_cache_rec *), lyxp_cache_equal_cb, NULL, 1);
+        LY_CHECK_ERR_GOTO(!cache->ht, LOGMEM(ctx); free(cache); ret = LY_EMEM, cleanup);
+        ctx->xp_cache = cache;
+    }
+
+    cache->max = size;
+    lyxp_cache_evict(ctx, cache, size);
+
+cleanup:
+    pthread_mutex_unlock(&ctx->xp_cache_lock);
+    return ret;
+}
+
 /**
  * @brief Get the last-added schema node that is currently in the context.
  *
@@ -3872,6 +4051,12 @@ xpath_count(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyxp_set
         return rc;
     }
 
+    if ((options & LYXP_EVAL_COUNT) && (args[0]->type == LYXP_SET_NUMBER)) {
+        /* the location path nodes were only counted */
+        set_fill_number(set, args[0]->val.num);
+        return LY_SUCCESS;
+    }
+
     if (args[0]->type != LYXP_SET_NODE_SET) {
         LOGVAL(set->ctx, LY_VCODE_XP_INARGTYPE, 1, print_set_type(args[0]), "count(node-set)");
         return LY_EVALID;
@@ -3912,11 +4097,10 @@ xpath_current(struct lyxp_set **args, uint16_t arg_count, struct lyxp_set *set,
         lyxp_set_free_content(set);
 
         if (set->cur_node) {
-            /* position is filled later */
-            set_insert_node(set, set->cur_node, 0, LYXP_NODE_ELEM, 0);
+            set_insert_node(set, set->cur_node, LYXP_NODE_ELEM, 0);
         } else {
             /* root node */
-            set_insert_node(set, NULL, 0, set->root_type, 0);
+            set_insert_node(set, NULL, set->root_type, 0);
         }
     }
 
@@ -4007,7 +4191,7 @@ xpath_deref(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyxp_set
             }
 
             /* insert it */
-            set_insert_node(set, node, 0, LYXP_NODE_ELEM, 0);
+            set_insert_node(set, node, LYXP_NODE_ELEM, 0);
         }
     }
 
@@ -5613,7 +5797,7 @@ moveto_root(struct lyxp_set *set, uint32_t options)
     } else {
         set->type = LYXP_SET_NODE_SET;
         set->used = 0;
-        set_insert_node(set, NULL, 0, set->root_type, 0);
+        set_insert_node(set, NULL, set->root_type, 0);
         set->non_child_axis = 0;
     }
 
@@ -5990,7 +6174,8 @@ moveto_node(struct lyxp_set *set, const struct lys_module *moveto_mod, const cha
     const struct lyd_node *iter;
     enum lyxp_node_type iter_type;
     struct lyxp_set result;
-    uint32_t i;
+    uint32_t i, count = 0;
+    ly_bool count_only;
 
     if (options & LYXP_SKIP_EXPR) {
         return LY_SUCCESS;
@@ -6001,6 +6186,9 @@ moveto_node(struct lyxp_set *set, const struct lys_module *moveto_mod, const cha
         return LY_EVALID;
     }
 
+    /* there can be no duplicates on these axes, so the nodes can be just counted */
+    count_only = (options & LYXP_EVAL_COUNT) && ((axis == LYXP_AXIS_CHILD) || (axis == LYXP_AXIS_SELF));
+
     /* init result set */
     set_init(&result, set);
 
@@ -6044,10 +6232,24 @@ moveto_node(struct lyxp_set *set, const struct lys_module *moveto_mod, const cha
             }
 
             /* matching node */
-            set_insert_node(&result, iter, 0, iter_type, result.used);
+            if (count_only) {
+                ++count;
+                continue;
+            }
+            set_insert_node(&result, iter, iter_type, result.used);
+            if (options & LYXP_EVAL_EXISTS) {
+                /* the first node is enough */
+                goto finish;
+            }
         }
     }
 
+finish:
+    if (count_only) {
+        set_fill_number(set, count);
+        goto cleanup;
+    }
+
     /* move result to the set */
     lyxp_set_free_content(set);
     *set = result;
@@ -6071,20 +6273,23 @@ cleanup:
  * @param[in,out] set Set to use.
  * @param[in] scnode Matching node schema.
  * @param[in] predicates If @p scnode is ::LYS_LIST or ::LYS_LEAFLIST, the predicates specifying a single instance.
+ * @param[in] index_leaf If @p scnode is ::LYS_LIST and @p predicates are not set, indexed leaf with the value
+ * of the instances to find.
  * @param[in] options XPath options.
  * @return LY_ERR (LY_EINCOMPLETE on unresolved when)
  */
 static LY_ERR
 moveto_node_hash_child(struct lyxp_set *set, const struct lysc_node *scnode, const struct ly_path_predicate *predicates,
-        uint32_t options)
+        const struct lyd_node *index_leaf, uint32_t options)
 {
     LY_ERR ret = LY_SUCCESS, r;
-    uint32_t i;
+    uint32_t i, j, count = 0;
     const struct lyd_node *siblings;
     struct lyxp_set result;
     struct lyd_node *sub, *inst = NULL;
+    struct ly_set found = {0};
 
-    assert(scnode && (!(scnode->nodetype & (LYS_LIST | LYS_LEAFLIST)) || predicates));
+    assert(scnode && (!(scnode->nodetype & (LYS_LIST | LYS_LEAFLIST)) || predicates || index_leaf));
 
     /* init result set */
     set_init(&result, set);
@@ -6110,7 +6315,9 @@ moveto_node_hash_child(struct lyxp_set *set, const struct lysc_node *scnode, con
     }
 
     /* create specific data instance if needed */
-    if (scnode->nodetype == LYS_LIST) {
+    if (index_leaf) {
+        /* instances found by the index */
+    } else if (scnode->nodetype == LYS_LIST) {
         LY_CHECK_GOTO(ret = lyd_create_list(scnode, predicates, &inst), cleanup);
     } else if (scnode->nodetype == LYS_LEAFLIST) {
         LY_CHECK_GOTO(ret = lyd_create_term2(scnode, &predicates[0].value, &inst), cleanup);
@@ -6129,6 +6336,33 @@ moveto_node_hash_child(struct lyxp_set *set, const struct lysc_node *scnode, con
             siblings = lyd_child(set->val.nodes[i].node);
         }
 
+        if (index_leaf) {
+            /* find all the instances using the index */
+            found.count = 0;
+            r = lyd_find_index(siblings, index_leaf, 0, &found);
+            LY_CHECK_ERR_GOTO(r && (r != LY_ENOTFOUND), ret = r, cleanup);
+
+            for (j = 0; j < found.count; ++j) {
+                /* when check */
+                sub = found.dnodes[j];
+                if (!(options & LYXP_IGNORE_WHEN) && lysc_has_when(sub->schema) && !(sub->flags & LYD_WHEN_TRUE)) {
+                    ret = LY_EINCOMPLETE;
+                    goto cleanup;
+                }
+
+                if (options & LYXP_EVAL_COUNT) {
+                    ++count;
+                    continue;
+                }
+                set_insert_node(&result, sub, LYXP_NODE_ELEM, result.used);
+                if (options & LYXP_EVAL_EXISTS) {
+                    /* the first node is enough */
+                    goto finish;
+                }
+            }
+            continue;
+        }
+
         /* find the node using hashes */
         if (inst) {
             r = lyd_find_sibling_first(siblings, inst, &sub);
@@ -6143,12 +6377,24 @@ moveto_node_hash_child(struct lyxp_set *set, const struct lysc_node *scnode, con
             goto cleanup;
         }
 
-        if (sub) {
-            /* pos filled later */
-            set_insert_node(&result, sub, 0, LYXP_NODE_ELEM, result.used);
+        if (sub && (options & LYXP_EVAL_COUNT)) {
+            ++count;
+        } else if (sub) {
+            set_insert_node(&result, sub, LYXP_NODE_ELEM, result.used);
+            if (options & LYXP_EVAL_EXISTS) {
+                /* the first node is enough */
+                break;
+            }
         }
     }
 
+finish:
+    if (options & LYXP_EVAL_COUNT) {
+        /* children are never duplicate, the nodes were just counted */
+        set_fill_number(set, count);
+        goto cleanup;
+    }
+
     /* move result to the set */
     lyxp_set_free_content(set);
     *set = result;
@@ -6158,6 +6404,7 @@ moveto_node_hash_child(struct lyxp_set *set, const struct lysc_node *scnode, con
 cleanup:
     lyxp_set_free_content(&result);
     lyd_free_tree(inst);
+    ly_set_erase(&found, NULL);
     return ret;
 }
 
@@ -6708,7 +6955,7 @@ moveto_node_alldesc_child(struct lyxp_set *set, const struct lys_module *moveto_
     }
 
     /* replace the original nodes (and throws away all text and meta nodes, root is replaced by a child) */
-    rc = xpath_pi_node(set, LYXP_AXIS_CHILD, options);
+    rc = xpath_pi_node(set, LYXP_AXIS_CHILD, options & ~(LYXP_EVAL_EXISTS | LYXP_EVAL_COUNT));
     LY_CHECK_RET(rc);
 
     /* this loop traverses all the nodes in the set and adds/keeps only those that match qname */
@@ -6721,7 +6968,11 @@ moveto_node_alldesc_child(struct lyxp_set *set, const struct lys_module *moveto_
             rc = moveto_node_check(elem, LYXP_NODE_ELEM, set, ncname, moveto_mod, options);
             if (!rc) {
                 /* add matching node into result set */
-                set_insert_node(&ret_set, elem, 0, LYXP_NODE_ELEM, ret_set.used);
+                set_insert_node(&ret_set, elem, LYXP_NODE_ELEM, ret_set.used);
+                if (options & LYXP_EVAL_EXISTS) {
+                    /* the first node is enough */
+                    goto finish;
+                }
                 if (set_dup_node_check(set, elem, LYXP_NODE_ELEM, i)) {
                     /* the node is a duplicate, we'll process it later in the set */
                     goto skip_children;
@@ -6758,6 +7009,7 @@ skip_children:
         }
     }
 
+finish:
     /* make the temporary set the current one */
     ret_set.ctx_pos = set->ctx_pos;
     ret_set.ctx_size = set->ctx_size;
@@ -6952,7 +7204,7 @@ moveto_attr(struct lyxp_set *set, const struct lys_module *mod, const char *ncna
                         /* pos does not change */
                         replaced = 1;
                     } else {
-                        set_insert_node(set, (struct lyd_node *)sub, set->val.nodes[i].pos, LYXP_NODE_META, i + 1);
+                        set_insert_node(set, (struct lyd_node *)sub, LYXP_NODE_META, i + 1);
                     }
                     ++i;
                 }
@@ -7078,7 +7330,7 @@ moveto_attr_alldesc(struct lyxp_set *set, const struct lys_module *mod, const ch
                         /* pos does not change */
                         replaced = 1;
                     } else {
-                        set_insert_node(set, (struct lyd_node *)sub, set->val.meta[i].pos, LYXP_NODE_META, i + 1);
+                        set_insert_node(set, (struct lyd_node *)sub, LYXP_NODE_META, i + 1);
                     }
                     ++i;
                 }
@@ -7365,6 +7617,10 @@ eval_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
     int32_t pred_in_ctx;
     ly_bool reverse_axis = 0;
     struct lyxp_set set2 = {0};
+    uint64_t prof_start = 0;
+
+    /* the predicate result is converted to boolean unless it is a number, which a node-set never is */
+    options = (options & ~LYXP_EVAL_COUNT) | LYXP_EVAL_EXISTS;
 
     /* '[' */
     LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (options & LYXP_SKIP_EXPR ? "skipped" : "parsed"),
@@ -7404,12 +7660,16 @@ only_parse:
             break;
         }
 
-        orig_exp = *tok_idx;
+        if (set->prof) {
+            prof_start = prof_time();
+        }
+
+        orig_exp = *tok_idx;
         orig_pos = reverse_axis ? set->used + 1 : 0;
         orig_size = set->used;
         for (i = 0; i < set->used; ++i) {
             set_init(&set2, set);
-            set_insert_node(&set2, set->val.nodes[i].node, set->val.nodes[i].pos, set->val.nodes[i].type, 0);
+            set_insert_node(&set2, set->val.nodes[i].node, set->val.nodes[i].type, 0);
 
             /* remember the node context position for position() and context size for last() */
             orig_pos += reverse_axis ? -1 : 1;
@@ -7441,6 +7701,11 @@ only_parse:
         }
         set_remove_nodes_none(set);
 
+        if (set->prof) {
+            /* record the predicate evaluated for every node */
+            prof_record(set, orig_exp - 1, prof_start, orig_size, orig_size);
+        }
+
     } else if (set->type == LYXP_SET_SCNODE_SET) {
         for (i = 0; i < set->used; ++i) {
             if (set->val.scnodes[i].in_ctx == LYXP_SET_SCNODE_ATOM_CTX) {
@@ -7636,6 +7901,103 @@ cleanup:
     return ret;
 }
 
+LY_ERR
+lyxp_index_predicate(const struct ly_ctx *ctx, const struct lyxp_expr *exp, uint16_t *tok_idx,
+        const struct lysc_node *list, LY_VALUE_FORMAT format, void *prefix_data, struct lyd_node **leaf)
+{
+    LY_ERR rc = LY_ENOT;
+    const char *name, *value, *ptr;
+    uint16_t name_len, value_len;
+    const struct lys_module *mod;
+    const struct lysc_node *schema;
+    struct lyd_node *node = NULL;
+    ly_bool incomplete;
+    uint32_t prev_lo;
+
+    assert(list->nodetype == LYS_LIST);
+
+    *leaf = NULL;
+
+    if (!(list->flags & LYS_INDEXED)) {
+        /* no indexed leafs */
+        return LY_ENOT;
+    }
+
+    /* '[' NameTest '=' Literal/Number ']' */
+    if (lyxp_check_token(NULL, exp, *tok_idx, LYXP_TOKEN_BRACK1) ||
+            lyxp_check_token(NULL, exp, *tok_idx + 1, LYXP_TOKEN_NAMETEST) ||
+            lyxp_check_token(NULL, exp, *tok_idx + 2, LYXP_TOKEN_OPER_EQUAL) ||
+            lyxp_check_token(NULL, exp, *tok_idx + 4, LYXP_TOKEN_BRACK2)) {
+        return LY_ENOT;
+    }
+    if ((exp->tokens[*tok_idx + 3] != LYXP_TOKEN_LITERAL) && (exp->tokens[*tok_idx + 3] != LYXP_TOKEN_NUMBER)) {
+        return LY_ENOT;
+    }
+
+    /* resolve the leaf, it must be a direct child of the list from the same module in case of no prefix */
+    name = &exp->expr[exp->tok_pos[*tok_idx + 1]];
+    name_len = exp->tok_len[*tok_idx + 1];
+    if ((ptr = ly_strnchr(name, ':', name_len))) {
+        mod = ly_resolve_prefix(ctx, name, ptr - name, format, prefix_data);
+        name_len -= ptr - name + 1;
+        name = ptr + 1;
+    } else if (format == LY_VALUE_JSON) {
+        mod = list->module;
+    } else {
+        mod = NULL;
+    }
+    schema = mod ? lys_find_child(list, mod, name, name_len, LYS_LEAF, 0) : NULL;
+    if (!schema || !(schema->flags & LYS_INDEXED) || lysc_has_when(schema)) {
+        /* not indexed or the leaf existence would need to be checked */
+        return LY_ENOT;
+    }
+
+    /* get the value, compared the same as the canonized literal (string) or numerically (number) */
+    if (exp->tokens[*tok_idx + 3] == LYXP_TOKEN_LITERAL) {
+        if (((struct lysc_node_leaf *)schema)->type->basetype == LY_TYPE_UNION) {
+            /* the literal is canonized by the actual type of each instance */
+            return LY_ENOT;
+        }
+        value = &exp->expr[exp->tok_pos[*tok_idx + 3] + 1];
+        value_len = exp->tok_len[*tok_idx + 3] - 2;
+    } else {
+        switch (((struct lysc_node_leaf *)schema)->type->basetype) {
+        case LY_TYPE_UINT8:
+        case LY_TYPE_UINT16:
+        case LY_TYPE_UINT32:
+        case LY_TYPE_UINT64:
+        case LY_TYPE_INT8:
+        case LY_TYPE_INT16:
+        case LY_TYPE_INT32:
+        case LY_TYPE_INT64:
+            break;
+        default:
+            /* numeric equality matches more canonical values */
+            return LY_ENOT;
+        }
+        value = &exp->expr[exp->tok_pos[*tok_idx + 3]];
+        value_len = exp->tok_len[*tok_idx + 3];
+    }
+
+    /* create the leaf with the value, an invalid value is compared as a string */
+    prev_lo = ly_log_options(0);
+    if (lyd_create_term(schema, value, value_len, NULL, format, prefix_data, LYD_HINT_DATA, &incomplete, &node) ||
+            incomplete) {
+        goto cleanup;
+    }
+
+    /* success */
+    *leaf = node;
+    node = NULL;
+    *tok_idx += 5;
+    rc = LY_SUCCESS;
+
+cleanup:
+    ly_log_options(prev_lo);
+    lyd_free_tree(node);
+    return rc;
+}
+
 /**
  * @brief Search for/check the next schema node that could be the only matching schema node meaning the
  * data node(s) could be found using a single hash-based search.
@@ -7794,12 +8156,21 @@ eval_name_test_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, en
     const struct lysc_node *scnode = NULL;
     struct ly_path_predicate *predicates = NULL;
     enum ly_path_pred_type pred_type = 0;
+    struct lyd_node *index_leaf = NULL;
     int scnode_skip_pred = 0;
+    uint16_t step_idx = *tok_idx;
+    uint32_t prof_in = 0;
+    uint64_t prof_start = 0;
 
     LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (options & LYXP_SKIP_EXPR ? "skipped" : "parsed"),
             lyxp_token2str(exp->tokens[*tok_idx]), exp->tok_pos[*tok_idx]);
     ++(*tok_idx);
 
+    if (set->prof && !(options & LYXP_SKIP_EXPR)) {
+        prof_start = prof_time();
+        prof_in = (set->type == LYXP_SET_NODE_SET) ? set->used : 0;
+    }
+
     if (options & LYXP_SKIP_EXPR) {
         goto moveto;
     }
@@ -7837,8 +8208,11 @@ eval_name_test_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, en
             /* try to create the predicates */
             if (eval_name_test_try_compile_predicates(exp, tok_idx, scnode, set->cur_mod, set->cur_node ?
                     set->cur_node->schema : NULL, set->format, set->prefix_data, &predicates, &pred_type)) {
-                /* hashes cannot be used */
-                scnode = NULL;
+                /* hashes cannot be used, try an index */
+                if ((scnode->nodetype != LYS_LIST) || lyxp_index_predicate(set->ctx, exp, tok_idx, scnode, set->format,
+                        set->prefix_data, &index_leaf)) {
+                    scnode = NULL;
+                }
             }
         }
     }
@@ -7919,11 +8293,18 @@ moveto:
                 rc = moveto_node_alldesc_child(set, moveto_mod, ncname_dict, options);
             } else if (scnode && (axis == LYXP_AXIS_CHILD)) {
                 /* we can find the child nodes using hashes */
-                rc = moveto_node_hash_child(set, scnode, predicates, options);
+                if (set->prof) {
+                    if (index_leaf) {
+                        ++set->prof->toks[step_idx].index_evals;
+                    } else {
+                        ++set->prof->toks[step_idx].hash_evals;
+                    }
+                }
+                rc = moveto_node_hash_child(set, scnode, predicates, index_leaf, options);
             } else {
                 if (all_desc) {
                     /* "//" == "/descendant-or-self::node()/" */
-                    rc = xpath_pi_node(set, LYXP_AXIS_DESCENDANT_OR_SELF, options);
+                    rc = xpath_pi_node(set, LYXP_AXIS_DESCENDANT_OR_SELF, options & ~(LYXP_EVAL_EXISTS | LYXP_EVAL_COUNT));
                     LY_CHECK_GOTO(rc, cleanup);
                 }
                 rc = moveto_node(set, moveto_mod, ncname_dict, axis, options);
@@ -7951,6 +8332,10 @@ cleanup:
     if (!(options & LYXP_SKIP_EXPR)) {
         lydict_remove(set->ctx, ncname_dict);
         ly_path_predicates_free(set->ctx, pred_type, predicates);
+        lyd_free_tree(index_leaf);
+        if (set->prof && !rc) {
+            prof_record(set, step_idx, prof_start, prof_in, 1);
+        }
     }
     return rc;
 }
@@ -7975,9 +8360,17 @@ eval_node_type_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, en
         struct lyxp_set *set, uint32_t options)
 {
     LY_ERR rc;
+    uint16_t step_idx = *tok_idx;
+    uint32_t prof_in = 0;
+    uint64_t prof_start = 0;
 
     (void)all_desc;
 
+    if (set->prof && !(options & LYXP_SKIP_EXPR)) {
+        prof_start = prof_time();
+        prof_in = (set->type == LYXP_SET_NODE_SET) ? set->used : 0;
+    }
+
     if (!(options & LYXP_SKIP_EXPR)) {
         assert(exp->tok_len[*tok_idx] == 4);
         if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "node", 4)) {
@@ -8010,6 +8403,9 @@ eval_node_type_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, en
         LY_CHECK_RET(rc);
     }
 
+    if (set->prof && !(options & LYXP_SKIP_EXPR)) {
+        prof_record(set, step_idx, prof_start, prof_in, 1);
+    }
     return LY_SUCCESS;
 }
 
@@ -8034,6 +8430,7 @@ eval_relative_location_path(const struct lyxp_expr *exp, uint16_t *tok_idx, ly_b
     LY_ERR rc = LY_SUCCESS;
     enum lyxp_axis axis;
     int scnode_skip_path = 0;
+    uint32_t step_options;
 
     goto step;
     do {
@@ -8072,6 +8469,14 @@ step:
             axis = LYXP_AXIS_CHILD;
         }
 
+        /* only the last NameTest without predicates can be evaluated partially */
+        step_options = options;
+        if ((exp->tokens[*tok_idx] != LYXP_TOKEN_NAMETEST) ||
+                !lyxp_check_token(NULL, exp, *tok_idx + 1, LYXP_TOKEN_BRACK1) ||
+                !exp_check_token2(NULL, exp, *tok_idx + 1, LYXP_TOKEN_OPER_PATH, LYXP_TOKEN_OPER_RPATH)) {
+            step_options &= ~(LYXP_EVAL_EXISTS | LYXP_EVAL_COUNT);
+        }
+
         /* NodeTest Predicate* */
         switch (exp->tokens[*tok_idx]) {
         case LYXP_TOKEN_DOT:
@@ -8085,10 +8490,10 @@ step:
                 }
 
                 if (all_desc) {
-                    rc = xpath_pi_node(set, LYXP_AXIS_DESCENDANT_OR_SELF, options);
+                    rc = xpath_pi_node(set, LYXP_AXIS_DESCENDANT_OR_SELF, step_options);
                     LY_CHECK_GOTO(rc, cleanup);
                 }
-                rc = xpath_pi_node(set, LYXP_AXIS_SELF, options);
+                rc = xpath_pi_node(set, LYXP_AXIS_SELF, step_options);
                 LY_CHECK_GOTO(rc, cleanup);
             }
             LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (set ? "parsed" : "skipped"),
@@ -8107,10 +8512,10 @@ step:
                 }
 
                 if (all_desc) {
-                    rc = xpath_pi_node(set, LYXP_AXIS_DESCENDANT_OR_SELF, options);
+                    rc = xpath_pi_node(set, LYXP_AXIS_DESCENDANT_OR_SELF, step_options);
                     LY_CHECK_GOTO(rc, cleanup);
                 }
-                rc = xpath_pi_node(set, LYXP_AXIS_PARENT, options);
+                rc = xpath_pi_node(set, LYXP_AXIS_PARENT, step_options);
                 LY_CHECK_GOTO(rc, cleanup);
             }
             LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (options & LYXP_SKIP_EXPR ? "skipped" : "parsed"),
@@ -8120,7 +8525,7 @@ step:
 
         case LYXP_TOKEN_NAMETEST:
             /* evaluate NameTest Predicate* */
-            rc = eval_name_test_with_predicate(exp, tok_idx, axis, all_desc, set, options);
+            rc = eval_name_test_with_predicate(exp, tok_idx, axis, all_desc, set, step_options);
             if (rc == LY_ENOT) {
                 assert(options & LYXP_SCNODE_ALL);
                 /* skip the rest of this path */
@@ -8133,7 +8538,7 @@ step:
 
         case LYXP_TOKEN_NODETYPE:
             /* evaluate NodeType Predicate* */
-            rc = eval_node_type_with_predicate(exp, tok_idx, axis, all_desc, set, options);
+            rc = eval_node_type_with_predicate(exp, tok_idx, axis, all_desc, set, step_options);
             LY_CHECK_GOTO(rc, cleanup);
             break;
 
@@ -8229,6 +8634,7 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
     LY_ERR (*xpath_func)(struct lyxp_set **, uint16_t, struct lyxp_set *, uint32_t) = NULL;
     uint16_t arg_count = 0, i;
     struct lyxp_set **args = NULL, **args_aux;
+    uint32_t arg_options = options;
 
     if (!(options & LYXP_SKIP_EXPR)) {
         /* FunctionName */
@@ -8359,6 +8765,16 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
             lyxp_token2str(exp->tokens[*tok_idx]), exp->tok_pos[*tok_idx]);
     ++(*tok_idx);
 
+    if ((xpath_func == &xpath_boolean) || (xpath_func == &xpath_not)) {
+        /* only the boolean value of the argument is needed */
+        arg_options |= LYXP_EVAL_EXISTS;
+    } else if ((xpath_func == &xpath_count) && !exp->repeat[*tok_idx] && ((exp->tokens[*tok_idx] == LYXP_TOKEN_NAMETEST) ||
+            (exp->tokens[*tok_idx] == LYXP_TOKEN_DOT) || (exp->tokens[*tok_idx] == LYXP_TOKEN_DDOT) ||
+            (exp->tokens[*tok_idx] == LYXP_TOKEN_OPER_PATH) || (exp->tokens[*tok_idx] == LYXP_TOKEN_OPER_RPATH))) {
+        /* only the size of the location path result is needed */
+        arg_options |= LYXP_EVAL_COUNT;
+    }
+
     /* ( Expr ( ',' Expr )* )? */
     if (exp->tokens[*tok_idx] != LYXP_TOKEN_PAR2) {
         if (!(options & LYXP_SKIP_EXPR)) {
@@ -8371,7 +8787,7 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
                 goto cleanup;
             }
 
-            rc = eval_expr_select(exp, tok_idx, 0, args[0], options);
+            rc = eval_expr_select(exp, tok_idx, 0, args[0], arg_options);
             LY_CHECK_GOTO(rc, cleanup);
         } else {
             rc = eval_expr_select(exp, tok_idx, 0, set, options | LYXP_SKIP_EXPR);
@@ -8410,7 +8826,7 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
 
     if (!(options & LYXP_SKIP_EXPR)) {
         /* evaluate function */
-        rc = xpath_func(args, arg_count, set, options);
+        rc = xpath_func(args, arg_count, set, arg_options);
 
         if (options & LYXP_SCNODE_ALL) {
             /* merge all nodes from arg evaluations */
@@ -8557,6 +8973,10 @@ eval_path_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
 {
     ly_bool all_desc;
     LY_ERR rc;
+    uint32_t primary_options;
+
+    /* only a location path can be evaluated partially, not a primary expression */
+    primary_options = options & ~(LYXP_EVAL_EXISTS | LYXP_EVAL_COUNT);
 
     switch (exp->tokens[*tok_idx]) {
     case LYXP_TOKEN_PAR1:
@@ -8568,7 +8988,7 @@ eval_path_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
         ++(*tok_idx);
 
         /* Expr */
-        rc = eval_expr_select(exp, tok_idx, 0, set, options);
+        rc = eval_expr_select(exp, tok_idx, 0, set, primary_options);
         LY_CHECK_RET(rc);
 
         /* ')' */
@@ -8592,7 +9012,7 @@ eval_path_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
 
     case LYXP_TOKEN_VARREF:
         /* VariableReference */
-        rc = eval_variable_reference(exp, tok_idx, set, options);
+        rc = eval_variable_reference(exp, tok_idx, set, primary_options);
         LY_CHECK_RET(rc);
         ++(*tok_idx);
 
@@ -8600,7 +9020,7 @@ eval_path_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
 
     case LYXP_TOKEN_FUNCNAME:
         /* FunctionCall */
-        rc = eval_function_call(exp, tok_idx, set, options);
+        rc = eval_function_call(exp, tok_idx, set, primary_options);
         LY_CHECK_RET(rc);
 
         goto predicate;
@@ -8649,7 +9069,7 @@ eval_path_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
 predicate:
     /* Predicate* */
     while (!lyxp_check_token(NULL, exp, *tok_idx, LYXP_TOKEN_BRACK1)) {
-        rc = eval_predicate(exp, tok_idx, set, options, LYXP_AXIS_CHILD);
+        rc = eval_predicate(exp, tok_idx, set, primary_options, LYXP_AXIS_CHILD);
         LY_CHECK_RET(rc);
     }
 
@@ -9083,6 +9503,9 @@ eval_and_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t repeat, s
 
     set_fill_set(&orig_set, set);
 
+    /* all the operands are converted to boolean */
+    options |= LYXP_EVAL_EXISTS;
+
     rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_AND, set, options);
     LY_CHECK_GOTO(rc, cleanup);
 
@@ -9153,6 +9576,9 @@ eval_or_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t repeat, st
 
     set_fill_set(&orig_set, set);
 
+    /* all the operands are converted to boolean */
+    options |= LYXP_EVAL_EXISTS;
+
     rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_OR, set, options);
     LY_CHECK_GOTO(rc, cleanup);
 
@@ -9200,7 +9626,7 @@ cleanup:
 }
 
 /**
- * @brief Decide what expression is at the pointer @p tok_idx and evaluate it accordingly.
+ * @brief Decide what expression is at the pointer @p tok_idx and evaluate it accordingly, without the cache.
  *
  * @param[in] exp Parsed XPath expression.
  * @param[in] tok_idx Position in the expression @p exp.
@@ -9210,7 +9636,7 @@ cleanup:
  * @return LY_ERR (LY_EINCOMPLETE on unresolved when)
  */
 static LY_ERR
-eval_expr_select(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_type etype, struct lyxp_set *set,
+eval_expr_select_op(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_type etype, struct lyxp_set *set,
         uint32_t options)
 {
     uint16_t i, count;
@@ -9234,6 +9660,11 @@ eval_expr_select(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_
         }
     }
 
+    if (next_etype != LYXP_EXPR_NONE) {
+        /* the result of an operator is never a node-set */
+        options &= ~(LYXP_EVAL_EXISTS | LYXP_EVAL_COUNT);
+    }
+
     /* decide what expression are we parsing based on the repeat */
     switch (next_etype) {
     case LYXP_EXPR_OR:
@@ -9270,6 +9701,310 @@ eval_expr_select(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_
     return rc;
 }
 
+/**
+ * @brief Result of a sub-expression evaluation.
+ */
+struct lyxp_result_rec {
+    const struct lyxp_expr *exp;        /**< evaluated expression */
+    uint16_t tok_idx;                   /**< first token of the sub-expression */
+    uint16_t end_idx;                   /**< first token following the sub-expression */
+    enum lyxp_expr_type etype;          /**< expression type the sub-expression was evaluated as */
+    uint32_t options;                   /**< XPath options of the evaluation */
+    const struct lyd_node *tree;        /**< data tree of the evaluation */
+    enum lyxp_node_type root_type;      /**< root type of the evaluation */
+    const struct lysc_node *context_op; /**< operation of the evaluation */
+    const struct lys_module *cur_mod;   /**< current module of the evaluation */
+    LY_VALUE_FORMAT format;             /**< format of the prefixes in the expression */
+    void *prefix_data;                  /**< prefix data of the expression */
+
+    ly_bool ctx_dep;                    /**< whether the result depends on the context and is not cached */
+    struct lyxp_set set;                /**< cached result */
+};
+
+struct lyxp_result_cache {
+    struct hash_table *ht;              /**< hash table of the evaluated sub-expressions (struct lyxp_result_rec *) */
+    struct ly_set recs;                 /**< set of all the records (struct lyxp_result_rec *) */
+};
+
+/**
+ * @brief Sub-expression result cache of the thread, used only if set.
+ */
+static THREAD_LOCAL struct lyxp_result_cache *result_cache;
+
+/**
+ * @brief Hash table value equal callback for sub-expression results.
+ */
+static ly_bool
+lyxp_result_rec_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyxp_result_rec *rec1 = *(struct lyxp_result_rec **)val1_p, *rec2 = *(struct lyxp_result_rec **)val2_p;
+
+    return (rec1->exp == rec2->exp) && (rec1->tok_idx == rec2->tok_idx) && (rec1->etype == rec2->etype) &&
+           (rec1->options == rec2->options) && (rec1->tree == rec2->tree) && (rec1->root_type == rec2->root_type) &&
+           (rec1->context_op == rec2->context_op) && (rec1->cur_mod == rec2->cur_mod) &&
+           (rec1->format == rec2->format) && (rec1->prefix_data == rec2->prefix_data);
+}
+
+struct lyxp_result_cache *
+lyxp_result_cache_start(void)
+{
+    struct lyxp_result_cache *prev = result_cache;
+
+    /* no caching if the allocation fails */
+    result_cache = calloc(1, sizeof *result_cache);
+    if (result_cache) {
+        result_cache->ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyxp_result_rec *), lyxp_result_rec_equal_cb, NULL, 1);
+        if (!result_cache->ht) {
+            free(result_cache);
+            result_cache = NULL;
+        }
+    }
+    return prev;
+}
+
+void
+lyxp_result_cache_clear(void)
+{
+    struct lyxp_result_rec *rec;
+    uint32_t i;
+
+    if (!result_cache || !result_cache->recs.count) {
+        return;
+    }
+
+    for (i = 0; i < result_cache->recs.count; ++i) {
+        rec = result_cache->recs.objs[i];
+        lyxp_set_free_content(&rec->set);
+        free(rec);
+    }
+    ly_set_clean(&result_cache->recs, NULL);
+
+    lyht_free(result_cache->ht);
+    result_cache->ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyxp_result_rec *), lyxp_result_rec_equal_cb, NULL, 1);
+    if (!result_cache->ht) {
+        /* stop caching */
+        ly_set_erase(&result_cache->recs, NULL);
+        free(result_cache);
+        result_cache = NULL;
+    }
+}
+
+struct lyxp_result_cache *
+lyxp_result_cache_suspend(void)
+{
+    struct lyxp_result_cache *cache = result_cache;
+
+    result_cache = NULL;
+    return cache;
+}
+
+void
+lyxp_result_cache_resume(struct lyxp_result_cache *cache)
+{
+    assert(!result_cache);
+    result_cache = cache;
+}
+
+void
+lyxp_result_cache_stop(struct lyxp_result_cache *prev)
+{
+    lyxp_result_cache_clear();
+    if (result_cache) {
+        lyht_free(result_cache->ht);
+        ly_set_erase(&result_cache->recs, NULL);
+        free(result_cache);
+    }
+    result_cache = prev;
+}
+
+/**
+ * @brief Check whether a sub-expression evaluates to the same result for any context node.
+ *
+ * It is so if it uses only absolute location paths, literals, and functions, but no relative location paths
+ * (except in predicates), current(), variables, or functions with the context node as an implicit argument.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] start First token of the sub-expression.
+ * @param[in] end First token following the sub-expression.
+ * @return Whether the sub-expression is independent of the context node.
+ */
+static ly_bool
+exp_ctx_independent(const struct lyxp_expr *exp, uint16_t start, uint16_t end)
+{
+    uint16_t i;
+    uint32_t depth = 0;
+    const char *name;
+    uint16_t len;
+
+    for (i = start; i < end; ++i) {
+        switch (exp->tokens[i]) {
+        case LYXP_TOKEN_BRACK1:
+            ++depth;
+            break;
+        case LYXP_TOKEN_BRACK2:
+            --depth;
+            break;
+        case LYXP_TOKEN_VARREF:
+            return 0;
+        case LYXP_TOKEN_FUNCNAME:
+            name = exp->expr + exp->tok_pos[i];
+            len = exp->tok_len[i];
+            if (((len == 7) && !strncmp(name, "current", 7)) || ((len == 4) && !strncmp(name, "lang", 4))) {
+                /* always the context node */
+                return 0;
+            }
+            if (!depth && (i + 2 < end) && (exp->tokens[i + 2] == LYXP_TOKEN_PAR2) &&
+                    !((len == 4) && !strncmp(name, "true", 4)) && !((len == 5) && !strncmp(name, "false", 5))) {
+                /* the context node, position, or size as the implicit argument */
+                return 0;
+            }
+            break;
+        case LYXP_TOKEN_NAMETEST:
+        case LYXP_TOKEN_NODETYPE:
+            if ((i > start) && ((exp->tokens[i - 1] == LYXP_TOKEN_AT) || (exp->tokens[i - 1] == LYXP_TOKEN_DCOLON))) {
+                /* step already checked */
+                break;
+            }
+        /* fallthrough */
+        case LYXP_TOKEN_DOT:
+        case LYXP_TOKEN_DDOT:
+        case LYXP_TOKEN_AT:
+        case LYXP_TOKEN_AXISNAME:
+            if (!depth && ((i == start) || ((exp->tokens[i - 1] != LYXP_TOKEN_OPER_PATH) &&
+                    (exp->tokens[i - 1] != LYXP_TOKEN_OPER_RPATH)))) {
+                /* relative location path */
+                return 0;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Evaluate a sub-expression using the cached result, if possible.
+ *
+ * The result is cached if the sub-expression does not depend on the context node, so that it is evaluated
+ * only once for the same data tree, which must not change while the cache is used.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] tok_idx Position in the expression @p exp.
+ * @param[in] etype Expression type to evaluate.
+ * @param[in,out] set Context and result set.
+ * @param[in] options XPath options.
+ * @return LY_ERR (LY_EINCOMPLETE on unresolved when)
+ */
+static LY_ERR
+eval_expr_result_cached(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_type etype, struct lyxp_set *set,
+        uint32_t options)
+{
+    LY_ERR rc;
+    struct lyxp_result_rec key = {0}, *rec = &key, **match_p;
+    const struct lyd_node *cur_node;
+    const struct lyxp_var *vars;
+    uint32_t hash;
+
+    key.exp = exp;
+    key.tok_idx = *tok_idx;
+    key.etype = etype;
+    key.options = options;
+    key.tree = set->tree;
+    key.root_type = set->root_type;
+    key.context_op = set->context_op;
+    key.cur_mod = set->cur_mod;
+    key.format = set->format;
+    key.prefix_data = set->prefix_data;
+
+    hash = dict_hash_multi(0, (const char *)&exp, sizeof exp);
+    hash = dict_hash_multi(hash, (const char *)&key.tok_idx, sizeof key.tok_idx);
+    hash = dict_hash_multi(hash, (const char *)&key.tree, sizeof key.tree);
+    hash = dict_hash_multi(hash, NULL, 0);
+
+    if (!lyht_find(result_cache->ht, &rec, hash, (void **)&match_p)) {
+        rec = *match_p;
+        if (rec->ctx_dep) {
+            /* not cached */
+            return eval_expr_select_op(exp, tok_idx, etype, set, options);
+        }
+
+        /* use the cached result, keep the context of this evaluation */
+        cur_node = set->cur_node;
+        vars = set->vars;
+        lyxp_set_free_content(set);
+        set_fill_set(set, &rec->set);
+        set->cur_node = cur_node;
+        set->vars = vars;
+
+        *tok_idx = rec->end_idx;
+        return LY_SUCCESS;
+    }
+
+    rc = eval_expr_select_op(exp, tok_idx, etype, set, options);
+    if (rc || !result_cache) {
+        return rc;
+    }
+
+    /* remember the result, no caching if it fails */
+    rec = malloc(sizeof *rec);
+    if (!rec) {
+        return LY_SUCCESS;
+    }
+    *rec = key;
+    rec->end_idx = *tok_idx;
+    rec->ctx_dep = !exp_ctx_independent(exp, key.tok_idx, *tok_idx);
+    set_init(&rec->set, set);
+    if (!rec->ctx_dep) {
+        set_fill_set(&rec->set, set);
+        if ((set->type == LYXP_SET_NODE_SET) && set->used && !rec->set.val.nodes) {
+            free(rec);
+            return LY_SUCCESS;
+        }
+    }
+    if (ly_set_add(&result_cache->recs, rec, 1, NULL)) {
+        lyxp_set_free_content(&rec->set);
+        free(rec);
+    } else if (lyht_insert(result_cache->ht, &rec, hash, NULL)) {
+        ly_set_rm_index(&result_cache->recs, result_cache->recs.count - 1, NULL);
+        lyxp_set_free_content(&rec->set);
+        free(rec);
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Decide what expression is at the pointer @p tok_idx and evaluate it accordingly.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] tok_idx Position in the expression @p exp.
+ * @param[in] etype Expression type to evaluate.
+ * @param[in,out] set Context and result set.
+ * @param[in] options XPath options.
+ * @return LY_ERR (LY_EINCOMPLETE on unresolved when)
+ */
+static LY_ERR
+eval_expr_select(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_type etype, struct lyxp_set *set,
+        uint32_t options)
+{
+    if (result_cache && !(options & (LYXP_SKIP_EXPR | LYXP_SCNODE_ALL)) && !set->prof) {
+        switch (exp->tokens[*tok_idx]) {
+        case LYXP_TOKEN_OPER_PATH:
+        case LYXP_TOKEN_OPER_RPATH:
+        case LYXP_TOKEN_FUNCNAME:
+        case LYXP_TOKEN_PAR1:
+            /* only sub-expressions that can be independent of the context node and worth caching */
+            return eval_expr_result_cached(exp, tok_idx, etype, set, options);
+        default:
+            break;
+        }
+    }
+
+    return eval_expr_select_op(exp, tok_idx, etype, set, options);
+}
+
 /**
  * @brief Get root type.
  *
@@ -9318,10 +10053,26 @@ lyxp_get_root_type(const struct lyd_node *ctx_node, const struct lysc_node *ctx_
     return LYXP_NODE_ROOT;
 }
 
-LY_ERR
-lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct lys_module *cur_mod,
+/**
+ * @brief Evaluate an XPath expression on data, optionally profiling the evaluation.
+ *
+ * @param[in] ctx libyang context to use.
+ * @param[in] exp Parsed XPath expression to be evaluated.
+ * @param[in] cur_mod Current module for the expression (where it was "instantiated").
+ * @param[in] format Format of the XPath expression (more specifically, of any used prefixes).
+ * @param[in] prefix_data Format-specific prefix data (see ::ly_resolve_prefix).
+ * @param[in] ctx_node Current (context) data node, NULL in case of the root node.
+ * @param[in] tree Data tree on which to perform the evaluation.
+ * @param[in] vars Sized array of XPath variables.
+ * @param[out] set Result set.
+ * @param[in] options Whether to apply some evaluation restrictions.
+ * @param[in] prof Optional profile to fill.
+ * @return LY_ERR (same as ::lyxp_eval()).
+ */
+static LY_ERR
+lyxp_eval_prof(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct lys_module *cur_mod,
         LY_VALUE_FORMAT format, void *prefix_data, const struct lyd_node *ctx_node, const struct lyd_node *tree,
-        const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options)
+        const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options, struct lyxp_profile *prof)
 {
     uint16_t tok_idx = 0;
     const struct lysc_node *snode;
@@ -9353,7 +10104,7 @@ lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct ly
     memset(set, 0, sizeof *set);
     set->type = LYXP_SET_NODE_SET;
     set->root_type = lyxp_get_root_type(ctx_node, NULL, options);
-    set_insert_node(set, (struct lyd_node *)ctx_node, 0, ctx_node ? LYXP_NODE_ELEM : set->root_type, 0);
+    set_insert_node(set, (struct lyd_node *)ctx_node, ctx_node ? LYXP_NODE_ELEM : set->root_type, 0);
 
     set->ctx = (struct ly_ctx *)ctx;
     set->cur_node = ctx_node;
@@ -9365,6 +10116,7 @@ lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct ly
     set->format = format;
     set->prefix_data = prefix_data;
     set->vars = vars;
+    set->prof = prof;
 
     LOG_LOCSET(NULL, set->cur_node, NULL, NULL);
 
@@ -9377,6 +10129,627 @@ lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct ly
     if (set->cur_node) {
         LOG_LOCBACK(0, 1, 0, 0);
     }
+    set->prof = NULL;
+    return rc;
+}
+
+/**
+ * @brief Summed profile of all the evaluations of an expression on a schema node.
+ */
+struct lyxp_profiles_rec {
+    struct lyxp_expr *exp;          /**< copy of the evaluated expression */
+    const struct lysc_node *ctx_scnode; /**< schema node of the context node, NULL for the root */
+    char *path;                     /**< path of the context schema node */
+    uint32_t evals;                 /**< number of the evaluations of the whole expression */
+    struct lyxp_profile prof;       /**< summed profile of the evaluations */
+};
+
+/**
+ * @brief Profiles of all the expressions evaluated by a thread.
+ */
+struct lyxp_profiles {
+    const struct ly_ctx *ctx;       /**< context of the profiled expressions */
+    struct hash_table *ht;          /**< hash table of the records (struct lyxp_profiles_rec *) */
+    struct ly_set recs;             /**< set of all the records (struct lyxp_profiles_rec *) */
+    struct lyxp_profiles *parent;   /**< profiles of the thread to merge into, set for worker threads */
+    pthread_mutex_t lock;           /**< lock for adding into the profiles, also from worker threads */
+};
+
+/**
+ * @brief Profiles of the expressions evaluated by the thread, collected only if set.
+ */
+static THREAD_LOCAL struct lyxp_profiles *profiles;
+
+/**
+ * @brief Hash table value equal callback for expression profiles.
+ */
+static ly_bool
+lyxp_profiles_rec_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyxp_profiles_rec *rec1 = *(struct lyxp_profiles_rec **)val1_p;
+    struct lyxp_profiles_rec *rec2 = *(struct lyxp_profiles_rec **)val2_p;
+
+    /* expression strings are stored in the dictionary */
+    return (rec1->exp->expr == rec2->exp->expr) && (rec1->ctx_scnode == rec2->ctx_scnode);
+}
+
+/**
+ * @brief Create new empty expression profiles.
+ *
+ * @param[in] ctx Context of the profiled expressions.
+ * @param[in] parent Optional profiles to merge into when the new profiles are stopped.
+ * @param[out] profs_p Created profiles.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxp_profiles_new(const struct ly_ctx *ctx, struct lyxp_profiles *parent, struct lyxp_profiles **profs_p)
+{
+    struct lyxp_profiles *profs;
+
+    profs = calloc(1, sizeof *profs);
+    LY_CHECK_ERR_RET(!profs, LOGMEM(ctx), LY_EMEM);
+    profs->ht = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyxp_profiles_rec *), lyxp_profiles_rec_equal_cb, NULL, 1);
+    LY_CHECK_ERR_RET(!profs->ht, LOGMEM(ctx); free(profs), LY_EMEM);
+    profs->ctx = ctx;
+    profs->parent = parent;
+    pthread_mutex_init(&profs->lock, NULL);
+
+    *profs_p = profs;
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Free a profile record.
+ *
+ * @param[in] ctx Context of the profiled expression.
+ * @param[in] rec Record to free.
+ */
+static void
+lyxp_profiles_rec_free(const struct ly_ctx *ctx, struct lyxp_profiles_rec *rec)
+{
+    lyxp_expr_free(ctx, rec->exp);
+    free(rec->path);
+    free(rec->prof.toks);
+    free(rec);
+}
+
+/**
+ * @brief Free expression profiles.
+ *
+ * @param[in] profs Profiles to free.
+ */
+static void
+lyxp_profiles_free(struct lyxp_profiles *profs)
+{
+    uint32_t i;
+
+    if (!profs) {
+        return;
+    }
+
+    for (i = 0; i < profs->recs.count; ++i) {
+        lyxp_profiles_rec_free(profs->ctx, profs->recs.objs[i]);
+    }
+    ly_set_erase(&profs->recs, NULL);
+    lyht_free(profs->ht);
+    pthread_mutex_destroy(&profs->lock);
+    free(profs);
+}
+
+/**
+ * @brief Add the profile of evaluations of an expression into expression profiles.
+ *
+ * Evaluations of the same expression on context nodes of different schema nodes are profiled separately.
+ *
+ * @param[in] profs Profiles to add to.
+ * @param[in] exp Evaluated expression from the context of @p profs.
+ * @param[in] ctx_scnode Schema node of the context node, NULL for the root.
+ * @param[in] evals Number of the evaluations of @p exp.
+ * @param[in] prof Profile of the evaluations.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxp_profiles_add(struct lyxp_profiles *profs, const struct lyxp_expr *exp, const struct lysc_node *ctx_scnode,
+        uint32_t evals, const struct lyxp_profile *prof)
+{
+    struct lyxp_profiles_rec key = {0}, *rec = &key, **match_p;
+    struct lyxp_profile_tok *tok;
+    uint32_t hash;
+    uint16_t i;
+
+    key.exp = (struct lyxp_expr *)exp;
+    key.ctx_scnode = ctx_scnode;
+    hash = dict_hash_multi(0, (const char *)&exp->expr, sizeof exp->expr);
+    hash = dict_hash_multi(hash, (const char *)&ctx_scnode, sizeof ctx_scnode);
+    hash = dict_hash_multi(hash, NULL, 0);
+    if (!lyht_find(profs->ht, &rec, hash, (void **)&match_p)) {
+        rec = *match_p;
+    } else {
+        /* new record */
+        rec = calloc(1, sizeof *rec);
+        LY_CHECK_ERR_RET(!rec, LOGMEM(profs->ctx), LY_EMEM);
+        rec->prof.toks = calloc(exp->used, sizeof *rec->prof.toks);
+        LY_CHECK_ERR_RET(!rec->prof.toks, LOGMEM(profs->ctx); free(rec), LY_EMEM);
+        LY_CHECK_ERR_RET(lyxp_expr_dup(profs->ctx, exp, &rec->exp), lyxp_profiles_rec_free(profs->ctx, rec), LY_EMEM);
+        rec->ctx_scnode = ctx_scnode;
+        rec->path = ctx_scnode ? lysc_path(ctx_scnode, LYSC_PATH_DATA, NULL, 0) : strdup("/");
+        LY_CHECK_ERR_RET(!rec->path, LOGMEM(profs->ctx); lyxp_profiles_rec_free(profs->ctx, rec), LY_EMEM);
+        LY_CHECK_ERR_RET(lyht_insert(profs->ht, &rec, hash, NULL), LOGMEM(profs->ctx);
+                lyxp_profiles_rec_free(profs->ctx, rec), LY_EMEM);
+        LY_CHECK_ERR_RET(ly_set_add(&profs->recs, rec, 1, NULL), lyht_remove(profs->ht, &rec, hash);
+                lyxp_profiles_rec_free(profs->ctx, rec), LY_EMEM);
+    }
+
+    /* sum the profiles */
+    rec->evals += evals;
+    rec->prof.time_ns += prof->time_ns;
+    for (i = 0; i < exp->used; ++i) {
+        tok = &rec->prof.toks[i];
+        tok->evals += prof->toks[i].evals;
+        tok->time_ns += prof->toks[i].time_ns;
+        tok->nodes_in += prof->toks[i].nodes_in;
+        tok->nodes_out += prof->toks[i].nodes_out;
+        tok->hash_evals += prof->toks[i].hash_evals;
+        tok->index_evals += prof->toks[i].index_evals;
+    }
+
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct lys_module *cur_mod,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyd_node *ctx_node, const struct lyd_node *tree,
+        const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options)
+{
+    LY_ERR rc, r;
+    struct lyxp_profile prof = {0};
+    uint64_t start;
+
+    if (!profiles || (profiles->ctx != ctx) || !exp) {
+        return lyxp_eval_prof(ctx, exp, cur_mod, format, prefix_data, ctx_node, tree, vars, set, options, NULL);
+    }
+
+    /* profile the evaluation, see ::lyxp_profiles_start() */
+    prof.toks = calloc(exp->used, sizeof *prof.toks);
+    LY_CHECK_ERR_RET(!prof.toks, LOGMEM(ctx), LY_EMEM);
+    start = prof_time();
+    rc = lyxp_eval_prof(ctx, exp, cur_mod, format, prefix_data, ctx_node, tree, vars, set, options, &prof);
+    prof.time_ns = prof_time() - start;
+
+    pthread_mutex_lock(&profiles->lock);
+    r = lyxp_profiles_add(profiles, exp, (ctx_node && ctx_node->schema) ? ctx_node->schema : NULL, 1, &prof);
+    pthread_mutex_unlock(&profiles->lock);
+    free(prof.toks);
+    if (r && !rc) {
+        lyxp_set_free_content(set);
+        rc = r;
+    }
+    return rc;
+}
+
+/**
+ * @brief Get the length of a predicate in an expression.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] tok_idx Index of the predicate '[' token.
+ * @return Length of the predicate including the brackets.
+ */
+static uint16_t
+exp_predicate_len(const struct lyxp_expr *exp, uint16_t tok_idx)
+{
+    uint16_t i;
+    uint32_t depth = 0;
+
+    for (i = tok_idx; i < exp->used; ++i) {
+        if (exp->tokens[i] == LYXP_TOKEN_BRACK1) {
+            ++depth;
+        } else if ((exp->tokens[i] == LYXP_TOKEN_BRACK2) && !--depth) {
+            break;
+        }
+    }
+    assert(i < exp->used);
+
+    return exp->tok_pos[i] + 1 - exp->tok_pos[tok_idx];
+}
+
+/**
+ * @brief Print the profiles of the tokens of an XPath evaluation profile.
+ *
+ * @param[in] exp Evaluated expression.
+ * @param[in] prof Profile of the evaluation.
+ * @param[in,out] report Printed profile.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxp_profile_print_toks(const struct lyxp_expr *exp, const struct lyxp_profile *prof, char **report)
+{
+    LY_ERR rc;
+    uint16_t i, len;
+    const struct lyxp_profile_tok *tok;
+    const char *access;
+
+    rc = ly_strcat(report, "%6s %8s %12s %10s %10s  %-10s %s\n", "pos", "evals", "time [us]", "nodes in", "nodes out",
+            "access", "token");
+    LY_CHECK_RET(rc);
+    for (i = 0; i < exp->used; ++i) {
+        tok = &prof->toks[i];
+        if (!tok->evals) {
+            /* not evaluated or not profiled */
+            continue;
+        }
+
+        if (exp->tokens[i] == LYXP_TOKEN_BRACK1) {
+            access = "predicate";
+            len = exp_predicate_len(exp, i);
+        } else {
+            if (tok->hash_evals == tok->evals) {
+                access = "hash";
+            } else if (tok->index_evals == tok->evals) {
+                access = "index";
+            } else if (!tok->hash_evals && !tok->index_evals) {
+                access = "scan";
+            } else {
+                access = "mixed";
+            }
+            len = exp->tok_len[i];
+        }
+
+        rc = ly_strcat(report, "%6" PRIu16 " %8" PRIu32 " %12.3f %10" PRIu64 " %10" PRIu64 "  %-10s %.*s\n",
+                exp->tok_pos[i], tok->evals, tok->time_ns / 1000.0, tok->nodes_in, tok->nodes_out, access, (int)len,
+                &exp->expr[exp->tok_pos[i]]);
+        LY_CHECK_RET(rc);
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Print an XPath evaluation profile.
+ *
+ * @param[in] exp Evaluated expression.
+ * @param[in] prof Profile of the evaluation.
+ * @param[in] set Result of the evaluation, NULL if it failed.
+ * @param[in,out] report Printed profile.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxp_profile_print(const struct lyxp_expr *exp, const struct lyxp_profile *prof, const struct lyxp_set *set,
+        char **report)
+{
+    LY_ERR rc;
+
+    rc = ly_strcat(report, "XPath \"%s\" profile, total time %.3f us, ", exp->expr, prof->time_ns / 1000.0);
+    LY_CHECK_RET(rc);
+    if (!set) {
+        rc = ly_strcat(report, "evaluation failed\n");
+    } else if (set->type == LYXP_SET_NODE_SET) {
+        rc = ly_strcat(report, "result node-set of %" PRIu32 " nodes\n", set->used);
+    } else {
+        rc = ly_strcat(report, "result %s\n", print_set_type((struct lyxp_set *)set));
+    }
+    LY_CHECK_RET(rc);
+
+    return lyxp_profile_print_toks(exp, prof, report);
+}
+
+LY_ERR
+lyxp_eval_profile(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct lys_module *cur_mod,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyd_node *ctx_node, const struct lyd_node *tree,
+        const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options, char **report)
+{
+    LY_ERR rc, r;
+    struct lyxp_profile prof = {0};
+    uint64_t start;
+
+    LY_CHECK_ARG_RET(ctx, ctx, exp, set, report, LY_EINVAL);
+
+    *report = NULL;
+    prof.toks = calloc(exp->used, sizeof *prof.toks);
+    LY_CHECK_ERR_RET(!prof.toks, LOGMEM(ctx), LY_EMEM);
+
+    /* evaluate */
+    start = prof_time();
+    rc = lyxp_eval_prof(ctx, exp, cur_mod, format, prefix_data, ctx_node, tree, vars, set, options, &prof);
+    prof.time_ns = prof_time() - start;
+
+    /* print the profile */
+    r = lyxp_profile_print(exp, &prof, rc ? NULL : set, report);
+    free(prof.toks);
+    if (r) {
+        LOGMEM(ctx);
+        free(*report);
+        *report = NULL;
+        if (!rc) {
+            lyxp_set_free_content(set);
+            rc = r;
+        }
+    }
+    return rc;
+}
+
+LY_ERR
+lyxp_profiles_start(const struct ly_ctx *ctx)
+{
+    if (profiles) {
+        LOGERR(ctx, LY_EINVAL, "XPath profiling was already started in this thread.");
+        return LY_EINVAL;
+    }
+
+    return lyxp_profiles_new(ctx, NULL, &profiles);
+}
+
+/**
+ * @brief Sort callback for expression profiles, the most expensive first.
+ */
+static int
+lyxp_profiles_sort_cb(const void *ptr1, const void *ptr2)
+{
+    const struct lyxp_profiles_rec *rec1 = *(struct lyxp_profiles_rec **)ptr1;
+    const struct lyxp_profiles_rec *rec2 = *(struct lyxp_profiles_rec **)ptr2;
+
+    if (rec1->prof.time_ns != rec2->prof.time_ns) {
+        return (rec1->prof.time_ns < rec2->prof.time_ns) ? 1 : -1;
+    }
+    if (rec1->evals != rec2->evals) {
+        return (rec1->evals < rec2->evals) ? 1 : -1;
+    }
+
+    /* deterministic order of equal profiles */
+    if (rec1->exp->expr != rec2->exp->expr) {
+        return strcmp(rec1->exp->expr, rec2->exp->expr);
+    }
+    return strcmp(rec1->path, rec2->path);
+}
+
+/**
+ * @brief Print expression profiles.
+ *
+ * @param[in] profs Profiles to print, the records are sorted.
+ * @param[out] report Printed profiles.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyxp_profiles_print(struct lyxp_profiles *profs, char **report)
+{
+    LY_ERR rc;
+    struct lyxp_profiles_rec *rec;
+    uint64_t total = 0;
+    uint32_t i;
+
+    if (profs->recs.count) {
+        qsort(profs->recs.objs, profs->recs.count, sizeof *profs->recs.objs, lyxp_profiles_sort_cb);
+    }
+
+    for (i = 0; i < profs->recs.count; ++i) {
+        rec = profs->recs.objs[i];
+        total += rec->prof.time_ns;
+    }
+    rc = ly_strcat(report, "XPath profiles, %" PRIu32 " expressions, total time %.3f us\n", profs->recs.count,
+            total / 1000.0);
+    LY_CHECK_RET(rc);
+
+    for (i = 0; i < profs->recs.count; ++i) {
+        rec = profs->recs.objs[i];
+        rc = ly_strcat(report, "\nXPath \"%s\" on \"%s\" profile, %" PRIu32 " evaluations, total time %.3f us\n",
+                rec->exp->expr, rec->path, rec->evals, rec->prof.time_ns / 1000.0);
+        LY_CHECK_RET(rc);
+        LY_CHECK_RET(lyxp_profile_print_toks(rec->exp, &rec->prof, report));
+    }
+
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lyxp_profiles_stop(char **report)
+{
+    LY_ERR rc = LY_SUCCESS;
+
+    if (report) {
+        *report = NULL;
+    }
+    if (!profiles) {
+        LOGERR(NULL, LY_EINVAL, "XPath profiling was not started in this thread.");
+        return LY_EINVAL;
+    }
+
+    if (report) {
+        rc = lyxp_profiles_print(profiles, report);
+        if (rc) {
+            LOGMEM(profiles->ctx);
+            free(*report);
+            *report = NULL;
+        }
+    }
+
+    lyxp_profiles_free(profiles);
+    profiles = NULL;
+    return rc;
+}
+
+struct lyxp_profiles *
+lyxp_profiles_get(void)
+{
+    return profiles;
+}
+
+struct lyxp_profiles *
+lyxp_profiles_worker_start(struct lyxp_profiles *parent)
+{
+    struct lyxp_profiles *prev = profiles;
+
+    if (!parent || (parent == profiles)) {
+        /* nothing to collect or the thread of the profiles itself */
+        return prev;
+    }
+
+    if (lyxp_profiles_new(parent->ctx, parent, &profiles)) {
+        /* just not collected */
+        profiles = prev;
+    }
+    return prev;
+}
+
+void
+lyxp_profiles_worker_stop(struct lyxp_profiles *prev)
+{
+    struct lyxp_profiles *parent;
+    struct lyxp_profiles_rec *rec;
+    uint32_t i;
+
+    if (profiles == prev) {
+        return;
+    }
+
+    /* merge into the profiles of the parent thread */
+    parent = profiles->parent;
+    pthread_mutex_lock(&parent->lock);
+    for (i = 0; i < profiles->recs.count; ++i) {
+        rec = profiles->recs.objs[i];
+        if (lyxp_profiles_add(parent, rec->exp, rec->ctx_scnode, rec->evals, &rec->prof)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&parent->lock);
+
+    lyxp_profiles_free(profiles);
+    profiles = prev;
+}
+
+LY_ERR
+lyxp_explain(const struct ly_ctx *ctx, const struct lyxp_expr *exp, char **plan)
+{
+    LY_ERR rc;
+    uint16_t i, len, axis_len = 0;
+    uint32_t indent = 1;
+    const char *str, *axis = NULL, *access;
+    ly_bool desc = 0;
+
+    *plan = NULL;
+
+    rc = ly_strcat(plan, "XPath \"%s\" plan:\n", exp->expr);
+    for (i = 0; !rc && (i < exp->used); ++i) {
+        str = &exp->expr[exp->tok_pos[i]];
+        len = exp->tok_len[i];
+
+        switch (exp->tokens[i]) {
+        case LYXP_TOKEN_OPER_PATH:
+        case LYXP_TOKEN_OPER_RPATH:
+            /* an absolute path unless it follows a step or a filter expression */
+            if (!i || ((exp->tokens[i - 1] != LYXP_TOKEN_NAMETEST) && (exp->tokens[i - 1] != LYXP_TOKEN_DOT) &&
+                    (exp->tokens[i - 1] != LYXP_TOKEN_DDOT) && (exp->tokens[i - 1] != LYXP_TOKEN_BRACK2) &&
+                    (exp->tokens[i - 1] != LYXP_TOKEN_PAR2) && (exp->tokens[i - 1] != LYXP_TOKEN_VARREF))) {
+                rc = ly_strcat(plan, "%*sroot\n", indent * 2, "");
+            }
+            desc = (exp->tokens[i] == LYXP_TOKEN_OPER_RPATH) ? 1 : 0;
+            break;
+        case LYXP_TOKEN_AXISNAME:
+            axis = str;
+            axis_len = len;
+            break;
+        case LYXP_TOKEN_AT:
+            axis = "attribute";
+            axis_len = strlen(axis);
+            break;
+        case LYXP_TOKEN_DCOLON:
+        case LYXP_TOKEN_COMMA:
+            break;
+        case LYXP_TOKEN_NAMETEST:
+            if (!axis) {
+                axis = desc ? "descendant" : "child";
+                axis_len = strlen(axis);
+            } else if (desc) {
+                rc = ly_strcat(plan, "%*sstep descendant-or-self::node() (descendant scan)\n", indent * 2, "");
+                if (rc) {
+                    break;
+                }
+                desc = 0;
+            }
+
+            /* the actual access depends on the data, see the evaluation profile */
+            if (desc) {
+                access = "descendant scan";
+            } else if ((axis_len != 5) || strncmp(axis, "child", 5)) {
+                access = "axis scan";
+            } else if (str[len - 1] == '*') {
+                access = "child scan";
+            } else {
+                access = "hash lookup";
+            }
+            rc = ly_strcat(plan, "%*sstep %.*s::%.*s (%s)\n", indent * 2, "", (int)axis_len, axis, (int)len, str,
+                    access);
+            axis = NULL;
+            desc = 0;
+            break;
+        case LYXP_TOKEN_NODETYPE:
+            if (!axis) {
+                axis = desc ? "descendant" : "child";
+                axis_len = strlen(axis);
+            }
+            rc = ly_strcat(plan, "%*sstep %.*s::%.*s() (axis scan)\n", indent * 2, "", (int)axis_len, axis, (int)len, str);
+            axis = NULL;
+            desc = 0;
+
+            /* skip '(' ')' */
+            i += 2;
+            break;
+        case LYXP_TOKEN_DOT:
+            rc = ly_strcat(plan, "%*sstep self::node()\n", indent * 2, "");
+            desc = 0;
+            break;
+        case LYXP_TOKEN_DDOT:
+            rc = ly_strcat(plan, "%*sstep parent::node()\n", indent * 2, "");
+            desc = 0;
+            break;
+        case LYXP_TOKEN_BRACK1:
+            rc = ly_strcat(plan, "%*spredicate %.*s\n", indent * 2, "", (int)exp_predicate_len(exp, i), str);
+            ++indent;
+            break;
+        case LYXP_TOKEN_FUNCNAME:
+            rc = ly_strcat(plan, "%*sfunction %.*s()\n", indent * 2, "", (int)len, str);
+            ++indent;
+
+            /* skip '(' */
+            ++i;
+            break;
+        case LYXP_TOKEN_PAR1:
+            rc = ly_strcat(plan, "%*sgroup\n", indent * 2, "");
+            ++indent;
+            break;
+        case LYXP_TOKEN_BRACK2:
+        case LYXP_TOKEN_PAR2:
+            --indent;
+            break;
+        case LYXP_TOKEN_OPER_LOG:
+        case LYXP_TOKEN_OPER_EQUAL:
+        case LYXP_TOKEN_OPER_NEQUAL:
+        case LYXP_TOKEN_OPER_COMP:
+        case LYXP_TOKEN_OPER_MATH:
+        case LYXP_TOKEN_OPER_UNI:
+            rc = ly_strcat(plan, "%*soperator %.*s\n", indent * 2, "", (int)len, str);
+            break;
+        case LYXP_TOKEN_VARREF:
+            rc = ly_strcat(plan, "%*svariable %.*s\n", indent * 2, "", (int)len, str);
+            break;
+        case LYXP_TOKEN_LITERAL:
+            rc = ly_strcat(plan, "%*sliteral %.*s\n", indent * 2, "", (int)len, str);
+            break;
+        case LYXP_TOKEN_NUMBER:
+            rc = ly_strcat(plan, "%*snumber %.*s\n", indent * 2, "", (int)len, str);
+            break;
+        case LYXP_TOKEN_NONE:
+            LOGINT(ctx);
+            rc = LY_EINT;
+            break;
+        }
+    }
+
+    if (rc) {
+        if (rc == LY_EMEM) {
+            LOGMEM(ctx);
+        }
+        free(*plan);
+        *plan = NULL;
+    }
     return rc;
 }
 
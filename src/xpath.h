@@ -187,6 +187,7 @@ struct lyxp_expr {
     uint16_t size;           /**< Allocated array items. */
 
     const char *expr;        /**< The original XPath expression. */
+    uint32_t refs;           /**< Number of references of an expression in the context XPath cache, 0 if not cached. */
 };
 
 /*
@@ -257,7 +258,6 @@ struct lyxp_set {
         struct lyxp_set_node {
             struct lyd_node *node;       /**< Data node. */
             enum lyxp_node_type type;    /**< Type of the node. */
-            uint32_t pos;                /**< Unique node position in the data. */
         } *nodes;                        /**< Set of data nodes. */
         struct lyxp_set_scnode {
             struct lysc_node *scnode;    /**< Compiled YANG node. */
@@ -278,8 +278,6 @@ struct lyxp_set {
         struct lyxp_set_meta {
             struct lyd_meta *meta;      /**< Node that provides information about metadata of a data element. */
             enum lyxp_node_type type;   /**< Type of the node. */
-            uint32_t pos;               /**< Unique node position in the data. if node_type is LYXP_SET_NODE_META,
-                                             it is the parent node position */
         } *meta;                        /**< Set of YANG metadata objects. */
         char *str;                      /**< String object. */
         long double num;                /**< Object of the floating-point number. */
@@ -310,6 +308,27 @@ struct lyxp_set {
     void *prefix_data;                      /**< Format-specific prefix data (see ::ly_resolve_prefix). */
     const struct lyxp_var *vars;            /**< XPath variables. [Sized array](@ref sizedarrays).
                                                  Set of variable bindings. */
+    struct lyxp_profile *prof;              /**< Optional profile of the evaluation to fill. */
+};
+
+/**
+ * @brief Evaluation profile of a single XPath expression token, location steps and predicates are profiled.
+ */
+struct lyxp_profile_tok {
+    uint32_t evals;         /**< Number of step evaluations or number of nodes a predicate was evaluated for. */
+    uint64_t time_ns;       /**< Wall time of all the evaluations including any nested steps and predicates. */
+    uint64_t nodes_in;      /**< Sum of the sizes of all the input node-sets. */
+    uint64_t nodes_out;     /**< Sum of the sizes of all the result node-sets. */
+    uint32_t hash_evals;    /**< Number of step evaluations that found the nodes using the children hashes. */
+    uint32_t index_evals;   /**< Number of step evaluations that found the nodes using a leaf index. */
+};
+
+/**
+ * @brief Evaluation profile of an XPath expression.
+ */
+struct lyxp_profile {
+    struct lyxp_profile_tok *toks;  /**< Profile of every expression token, indexed the same as the tokens. */
+    uint64_t time_ns;               /**< Wall time of the whole evaluation. */
 };
 
 /**
@@ -343,6 +362,117 @@ LY_ERR lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const st
         LY_VALUE_FORMAT format, void *prefix_data, const struct lyd_node *ctx_node, const struct lyd_node *tree,
         const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options);
 
+/**
+ * @brief Evaluate an XPath expression on data and profile the evaluation, see ::lyxp_eval().
+ *
+ * @param[in] ctx libyang context to use.
+ * @param[in] exp Parsed XPath expression to be evaluated.
+ * @param[in] cur_mod Current module for the expression (where it was "instantiated").
+ * @param[in] format Format of the XPath expression (more specifically, of any used prefixes).
+ * @param[in] prefix_data Format-specific prefix data (see ::ly_resolve_prefix).
+ * @param[in] ctx_node Current (context) data node, NULL in case of the root node.
+ * @param[in] tree Data tree on which to perform the evaluation.
+ * @param[in] vars [Sized array](@ref sizedarrays) of XPath variables.
+ * @param[out] set Result set.
+ * @param[in] options Whether to apply some evaluation restrictions.
+ * @param[out] report Printed profile of the evaluation, even if it failed.
+ * @return LY_ERR (same as ::lyxp_eval()).
+ */
+LY_ERR lyxp_eval_profile(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct lys_module *cur_mod,
+        LY_VALUE_FORMAT format, void *prefix_data, const struct lyd_node *ctx_node, const struct lyd_node *tree,
+        const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options, char **report);
+
+/**
+ * @brief Print the evaluation plan of a parsed XPath expression.
+ *
+ * @param[in] ctx libyang context for logging.
+ * @param[in] exp Parsed XPath expression.
+ * @param[out] plan Printed plan.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_explain(const struct ly_ctx *ctx, const struct lyxp_expr *exp, char **plan);
+
+struct lyxp_profiles;
+
+/**
+ * @brief Start profiling all the expressions evaluated by ::lyxp_eval() in this thread.
+ *
+ * The profiles of all the evaluations of the same expression are summed.
+ *
+ * @param[in] ctx Context of the expressions to profile, expressions of other contexts are not profiled.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_profiles_start(const struct ly_ctx *ctx);
+
+/**
+ * @brief Stop profiling the expressions evaluated in this thread.
+ *
+ * @param[out] report Optional printed profiles of all the evaluated expressions.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_profiles_stop(char **report);
+
+/**
+ * @brief Get the expression profiles collected by this thread.
+ *
+ * @return Profiles to pass to ::lyxp_profiles_worker_start(), NULL if not profiling.
+ */
+struct lyxp_profiles *lyxp_profiles_get(void);
+
+/**
+ * @brief Start profiling the expressions evaluated by a worker thread, they are added to the profiles
+ * of the thread that started the worker when stopped.
+ *
+ * @param[in] parent Profiles of the thread that started the worker, nothing is done if NULL.
+ * @return Previous profiles of this thread to pass to ::lyxp_profiles_worker_stop().
+ */
+struct lyxp_profiles *lyxp_profiles_worker_start(struct lyxp_profiles *parent);
+
+/**
+ * @brief Stop profiling the expressions evaluated by a worker thread, add the collected profiles to its parent.
+ *
+ * @param[in] prev Previous profiles returned by ::lyxp_profiles_worker_start().
+ */
+void lyxp_profiles_worker_stop(struct lyxp_profiles *prev);
+
+struct lyxp_result_cache;
+
+/**
+ * @brief Start caching the results of sub-expressions that do not depend on the context node in this thread.
+ *
+ * Such sub-expressions (absolute location paths and the functions and operators using only them) are then
+ * evaluated only once for a data tree, which must not be modified until the cache is cleared or stopped.
+ *
+ * @return Previous cache to restore by ::lyxp_result_cache_stop().
+ */
+struct lyxp_result_cache *lyxp_result_cache_start(void);
+
+/**
+ * @brief Discard all the cached results, if caching, because the data tree was modified.
+ */
+void lyxp_result_cache_clear(void);
+
+/**
+ * @brief Temporarily stop using the cache, while the data tree is temporarily modified.
+ *
+ * @return Suspended cache to pass to ::lyxp_result_cache_resume().
+ */
+struct lyxp_result_cache *lyxp_result_cache_suspend(void);
+
+/**
+ * @brief Resume using a suspended cache.
+ *
+ * @param[in] cache Cache returned by ::lyxp_result_cache_suspend().
+ */
+void lyxp_result_cache_resume(struct lyxp_result_cache *cache);
+
+/**
+ * @brief Stop caching the results of sub-expressions, free the cache.
+ *
+ * @param[in] prev Previous cache returned by ::lyxp_result_cache_start().
+ */
+void lyxp_result_cache_stop(struct lyxp_result_cache *prev);
+
 /**
  * @brief Get all the partial XPath nodes (atoms) that are required for @p exp to be evaluated.
  *
@@ -372,6 +502,10 @@ LY_ERR lyxp_atomize(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const
                                                              warning is printed. */
 #define LYXP_ACCESS_TREE_ALL 0x80   /**< Explicit accessible tree of all the nodes. */
 #define LYXP_ACCESS_TREE_CONFIG 0x0100  /**< Explicit accessible tree of only configuration data. */
+#define LYXP_EVAL_EXISTS     0x0200 /**< Only the boolean value of the result is needed so a node-set result may
+                                         include only its first node. */
+#define LYXP_EVAL_COUNT      0x0400 /**< Only the size of a node-set result is needed so it may be returned as
+                                         a number, used only internally for count(). */
 
 /**
  * @brief Cast XPath set to another type.
@@ -453,6 +587,53 @@ LY_ERR lyxp_expr_parse(const struct ly_ctx *ctx, const char *expr_str, size_t ex
  */
 LY_ERR lyxp_expr_dup(const struct ly_ctx *ctx, const struct lyxp_expr *exp, struct lyxp_expr **dup);
 
+/**
+ * @brief Get a parsed XPath expression from the context cache, it is parsed and cached if not there yet.
+ *
+ * If the cache is disabled, the expression is simply parsed. In any case, the expression must
+ * be released using ::lyxp_expr_cache_put() and must not be modified.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] expr_str XPath expression to parse.
+ * @param[out] expr_p Parsed expression.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_expr_cache_get(const struct ly_ctx *ctx, const char *expr_str, struct lyxp_expr **expr_p);
+
+/**
+ * @brief Release an expression returned by ::lyxp_expr_cache_get().
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] expr Expression to release, freed if not referenced by the cache anymore.
+ */
+void lyxp_expr_cache_put(const struct ly_ctx *ctx, struct lyxp_expr *expr);
+
+/**
+ * @brief Set the maximum number of expressions in the context XPath cache.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] size Maximum number of cached expressions, 0 to disable and free the cache.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_expr_cache_set_size(struct ly_ctx *ctx, uint32_t size);
+
+/**
+ * @brief Try to parse an equality predicate on an indexed list leaf (`[leaf='val']`) to be used for
+ * an index-based instance search.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] exp Parsed expression.
+ * @param[in,out] tok_idx Index in @p exp at the beginning of the predicate, is moved after it on success.
+ * @param[in] list List schema node the predicate is for.
+ * @param[in] format Format of any prefixes in @p exp.
+ * @param[in] prefix_data Format-specific prefix data.
+ * @param[out] leaf Created indexed leaf with the value from the predicate.
+ * @return LY_SUCCESS on success.
+ * @return LY_ENOT if the predicate cannot be used for an index search.
+ */
+LY_ERR lyxp_index_predicate(const struct ly_ctx *ctx, const struct lyxp_expr *exp, uint16_t *tok_idx,
+        const struct lysc_node *list, LY_VALUE_FORMAT format, void *prefix_data, struct lyd_node **leaf);
+
 /**
  * @brief Look at the next token and check its kind.
  *
@@ -22,7 +22,8 @@
 #include "in_internal.h"
 #include "xml.h"
 
-LY_ERR lyxml_ns_add(struct lyxml_ctx *xmlctx, const char *prefix, size_t prefix_len, char *uri);
+LY_ERR lyxml_ns_add(struct lyxml_ctx *xmlctx, const char *prefix, size_t prefix_len, const char *uri, size_t uri_len,
+        ly_bool *dynamic);
 
 static void
 test_element(void **state)
@@ -148,7 +149,7 @@ test_element(void **state)
     assert_true(!strncmp("element", xmlctx->name, xmlctx->name_len));
     assert_null(xmlctx->prefix);
     assert_int_equal(1, xmlctx->elements.count);
-    assert_int_equal(1, xmlctx->ns.count);
+    assert_int_equal(1, xmlctx->ns_scope.ns.count);
 
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
     assert_int_equal(LYXML_ELEM_CONTENT, xmlctx->status);
@@ -156,7 +157,7 @@ test_element(void **state)
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
     assert_int_equal(LYXML_ELEM_CLOSE, xmlctx->status);
     assert_int_equal(0, xmlctx->elements.count);
-    assert_int_equal(0, xmlctx->ns.count);
+    assert_int_equal(0, xmlctx->ns_scope.ns.count);
 
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
     assert_int_equal(LYXML_END, xmlctx->status);
@@ -190,7 +191,7 @@ test_element(void **state)
     assert_true(!strncmp("element", xmlctx->name, xmlctx->name_len));
     assert_true(!strncmp("yin", xmlctx->prefix, xmlctx->prefix_len));
     assert_int_equal(1, xmlctx->elements.count);
-    assert_int_equal(1, xmlctx->ns.count);
+    assert_int_equal(1, xmlctx->ns_scope.ns.count);
 
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
     assert_int_equal(LYXML_ELEM_CONTENT, xmlctx->status);
@@ -343,8 +344,8 @@ test_attribute(void **state)
     assert_int_equal(LY_SUCCESS, ly_in_new_memory(str, &in));
     assert_int_equal(LY_SUCCESS, lyxml_ctx_new(UTEST_LYCTX, in, &xmlctx));
     assert_int_equal(LYXML_ELEMENT, xmlctx->status);
-    assert_int_equal(1, xmlctx->ns.count);
-    ns = (struct lyxml_ns *)xmlctx->ns.objs[0];
+    assert_int_equal(1, xmlctx->ns_scope.ns.count);
+    ns = (struct lyxml_ns *)xmlctx->ns_scope.ns.objs[0];
     assert_string_equal(ns->prefix, "nc");
     assert_string_equal(ns->uri, "urn");
     lyxml_ctx_free(xmlctx);
@@ -529,31 +530,36 @@ test_ns(void **state)
     assert_int_equal(LY_SUCCESS, lyxml_ctx_new(UTEST_LYCTX, in, &xmlctx));
 
     /* processing namespace definitions */
-    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, NULL, 0, strdup("urn:default")));
-    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, "nc", 2, strdup("urn:nc1")));
+    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, NULL, 0, "urn:default", 11, NULL));
+    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, "nc", 2, "urn:nc1", 7, NULL));
     /* simulate adding open element2 into context */
     xmlctx->elements.count++;
     /* processing namespace definitions */
-    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, "nc", 2, strdup("urn:nc2")));
-    assert_int_equal(3, xmlctx->ns.count);
-    assert_int_not_equal(0, xmlctx->ns.size);
+    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, "nc", 2, "urn:nc2", 7, NULL));
+    assert_int_equal(3, xmlctx->ns_scope.ns.count);
+    assert_int_not_equal(0, xmlctx->ns_scope.ns.size);
 
-    ns = lyxml_ns_get(&xmlctx->ns, NULL, 0);
+    ns = lyxml_ns_scope_get(&xmlctx->ns_scope, NULL, 0);
     assert_non_null(ns);
     assert_null(ns->prefix);
     assert_string_equal("urn:default", ns->uri);
 
-    ns = lyxml_ns_get(&xmlctx->ns, "nc", 2);
+    ns = lyxml_ns_scope_get(&xmlctx->ns_scope, "nc", 2);
     assert_non_null(ns);
     assert_string_equal("nc", ns->prefix);
     assert_string_equal("urn:nc2", ns->uri);
 
+    /* the definitions are stored in the dictionary */
+    assert_int_equal(LY_SUCCESS, lydict_insert(UTEST_LYCTX, "urn:nc2", 0, &str));
+    assert_ptr_equal(str, ns->uri);
+    lydict_remove(UTEST_LYCTX, str);
+
     /* simulate closing element2 */
     xmlctx->elements.count--;
     lyxml_ns_rm(xmlctx);
-    assert_int_equal(2, xmlctx->ns.count);
+    assert_int_equal(2, xmlctx->ns_scope.ns.count);
 
-    ns = lyxml_ns_get(&xmlctx->ns, "nc", 2);
+    ns = lyxml_ns_scope_get(&xmlctx->ns_scope, "nc", 2);
     assert_non_null(ns);
     assert_string_equal("nc", ns->prefix);
     assert_string_equal("urn:nc1", ns->uri);
@@ -561,13 +567,89 @@ test_ns(void **state)
     /* close element1 */
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
-    assert_int_equal(0, xmlctx->ns.count);
+    assert_int_equal(0, xmlctx->ns_scope.ns.count);
+
+    assert_null(lyxml_ns_scope_get(&xmlctx->ns_scope, "nc", 2));
+    assert_null(lyxml_ns_scope_get(&xmlctx->ns_scope, NULL, 0));
 
-    assert_null(lyxml_ns_get(&xmlctx->ns, "nc", 2));
-    assert_null(lyxml_ns_get(&xmlctx->ns, NULL, 0));
+    /* the hash tables are kept for the next definitions */
+    assert_non_null(xmlctx->ns_scope.prefix_ht);
+    assert_non_null(xmlctx->ns_scope.uri_ht);
 
     lyxml_ctx_free(xmlctx);
     ly_in_free(in, 0);
+
+    /* empty namespace undeclaring the default namespace */
+    str = "<a xmlns=\"urn:a\"><b xmlns=\"\"/></a>";
+    assert_int_equal(LY_SUCCESS, ly_in_new_memory(str, &in));
+    assert_int_equal(LY_SUCCESS, lyxml_ctx_new(UTEST_LYCTX, in, &xmlctx));
+    assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
+    assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
+    assert_int_equal(LYXML_ELEMENT, xmlctx->status);
+    ns = lyxml_ns_scope_get(&xmlctx->ns_scope, NULL, 0);
+    assert_non_null(ns);
+    assert_string_equal("", ns->uri);
+    lyxml_ctx_free(xmlctx);
+    ly_in_free(in, 0);
+}
+
+static void
+test_ns_scope(void **state)
+{
+    struct lyxml_ns_scope scope = {0};
+    const struct lyxml_ns *ns;
+
+    assert_null(lyxml_ns_scope_get(&scope, NULL, 0));
+    assert_null(lyxml_ns_scope_get_uri(&scope, "urn:a"));
+
+    assert_int_equal(LY_SUCCESS, lyxml_ns_scope_push(UTEST_LYCTX, &scope, NULL, 0, "urn:a", 5, NULL, 0));
+    assert_int_equal(LY_SUCCESS, lyxml_ns_scope_push(UTEST_LYCTX, &scope, "a", 1, "urn:a", 5, NULL, 0));
+    assert_int_equal(LY_SUCCESS, lyxml_ns_scope_push(UTEST_LYCTX, &scope, "b", 1, "urn:b", 5, NULL, 1));
+    assert_int_equal(LY_SUCCESS, lyxml_ns_scope_push(UTEST_LYCTX, &scope, "aa", 2, "urn:a", 5, NULL, 1));
+    assert_int_equal(LY_SUCCESS, lyxml_ns_scope_push(UTEST_LYCTX, &scope, "b", 1, "urn:c", 5, NULL, 2));
+
+    /* prefixes */
+    ns = lyxml_ns_scope_get(&scope, NULL, 0);
+    assert_non_null(ns);
+    assert_string_equal("urn:a", ns->uri);
+    ns = lyxml_ns_scope_get(&scope, "b:node", 1);
+    assert_non_null(ns);
+    assert_string_equal("urn:c", ns->uri);
+    assert_non_null(ns->prev_prefix);
+    assert_string_equal("urn:b", ns->prev_prefix->uri);
+    assert_null(lyxml_ns_scope_get(&scope, "c", 1));
+
+    /* the stack as prefix data */
+    assert_ptr_equal(ns, lyxml_ns_get(&scope.ns, "b:node", 1));
+    assert_ptr_equal(lyxml_ns_scope_get(&scope, "aa", 2), lyxml_ns_get(&scope.ns, "aa", 2));
+    assert_ptr_equal(lyxml_ns_scope_get(&scope, NULL, 0), lyxml_ns_get(&scope.ns, NULL, 0));
+    assert_null(lyxml_ns_get(&scope.ns, "c", 1));
+
+    /* URIs, only with a prefix */
+    ns = lyxml_ns_scope_get_uri(&scope, "urn:a");
+    assert_non_null(ns);
+    assert_string_equal("aa", ns->prefix);
+    assert_non_null(ns->prev_uri);
+    assert_string_equal("a", ns->prev_uri->prefix);
+    assert_null(ns->prev_uri->prev_uri);
+
+    /* leave the elements */
+    lyxml_ns_scope_pop(UTEST_LYCTX, &scope);
+    ns = lyxml_ns_scope_get(&scope, "b", 1);
+    assert_non_null(ns);
+    assert_string_equal("urn:b", ns->uri);
+    assert_null(lyxml_ns_scope_get_uri(&scope, "urn:c"));
+
+    lyxml_ns_scope_pop(UTEST_LYCTX, &scope);
+    lyxml_ns_scope_pop(UTEST_LYCTX, &scope);
+    assert_null(lyxml_ns_scope_get(&scope, "b", 1));
+    ns = lyxml_ns_scope_get_uri(&scope, "urn:a");
+    assert_non_null(ns);
+    assert_string_equal("a", ns->prefix);
+
+    lyxml_ns_scope_erase(UTEST_LYCTX, &scope);
+    assert_int_equal(0, scope.ns.count);
+    assert_null(lyxml_ns_scope_get(&scope, NULL, 0));
 }
 
 static void
@@ -583,20 +665,20 @@ test_ns2(void **state)
     assert_int_equal(LY_SUCCESS, lyxml_ctx_new(UTEST_LYCTX, in, &xmlctx));
 
     /* default namespace defined in parent element1 */
-    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, NULL, 0, strdup("urn:default")));
-    assert_int_equal(1, xmlctx->ns.count);
+    assert_int_equal(LY_SUCCESS, lyxml_ns_add(xmlctx, NULL, 0, "urn:default", 11, NULL));
+    assert_int_equal(1, xmlctx->ns_scope.ns.count);
     /* going into child element1 */
     /* simulate adding open element1 into context */
     xmlctx->elements.count++;
     /* no namespace defined, going out (first, simulate closing of so far open element) */
     xmlctx->elements.count--;
     lyxml_ns_rm(xmlctx);
-    assert_int_equal(1, xmlctx->ns.count);
+    assert_int_equal(1, xmlctx->ns_scope.ns.count);
 
     /* nothing else, going out of the parent element1 */
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
     assert_int_equal(LY_SUCCESS, lyxml_ctx_next(xmlctx));
-    assert_int_equal(0, xmlctx->ns.count);
+    assert_int_equal(0, xmlctx->ns_scope.ns.count);
 
     lyxml_ctx_free(xmlctx);
     ly_in_free(in, 0);
@@ -666,6 +748,7 @@ main(void)
         UTEST(test_attribute),
         UTEST(test_text),
         UTEST(test_ns),
+        UTEST(test_ns_scope),
         UTEST(test_ns2),
         UTEST(test_simple_xml),
     };
@@ -14,6 +14,7 @@
 #define _UTEST_MAIN_
 #include "utests.h"
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "context.h"
@@ -972,6 +973,497 @@ test_axes(void **state)
     lyd_free_all(tree);
 }
 
+static void
+test_compiled(void **state)
+{
+    const char *data;
+    struct lyd_node *tree;
+    struct ly_set *set;
+    struct lyxp_expr *exp, *exp2;
+    struct lyxp_var *vars = NULL;
+    ly_bool result;
+    char buf[32];
+    int i;
+
+    data =
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a1</a>\n"
+            "    <b>b1</b>\n"
+            "    <c>c1</c>\n"
+            "</l1>"
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a2</a>\n"
+            "    <b>b2</b>\n"
+            "    <c>c2</c>\n"
+            "</l1>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+    /* compiled once, evaluated with different variable values */
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "/a:l1[a = $var]/c", &exp));
+    assert_string_equal(lyxp_get_expr(exp), "/a:l1[a = $var]/c");
+
+    assert_int_equal(LY_SUCCESS, lyxp_vars_set(&vars, "var", "'a1'"));
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath_compiled(NULL, tree, exp, LY_VALUE_JSON, NULL, vars, &set));
+    assert_int_equal(1, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[0]), "c1");
+    ly_set_free(set, NULL);
+
+    assert_int_equal(LY_SUCCESS, lyxp_vars_set(&vars, "var", "'a2'"));
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath_compiled(NULL, tree, exp, LY_VALUE_JSON, NULL, vars, &set));
+    assert_int_equal(1, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[0]), "c2");
+    ly_set_free(set, NULL);
+
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath_compiled(NULL, tree, exp, LY_VALUE_JSON, NULL, vars, &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyxp_vars_set(&vars, "var", "'a3'"));
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath_compiled(NULL, tree, exp, LY_VALUE_JSON, NULL, vars, &result));
+    assert_false(result);
+    lyd_xpath_free(UTEST_LYCTX, exp);
+
+    /* invalid expression */
+    assert_int_equal(LY_EVALID, lyd_xpath_compile(UTEST_LYCTX, "/a:l1[", &exp));
+    CHECK_LOG_CTX("Unexpected XPath expression end.", NULL);
+
+    /* enable the cache, compiled expressions are shared */
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_xpath_cache(UTEST_LYCTX, 4));
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "/a:l1/b", &exp));
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "/a:l1/b", &exp2));
+    assert_ptr_equal(exp, exp2);
+    lyd_xpath_free(UTEST_LYCTX, exp2);
+
+    /* evicted while still in use */
+    for (i = 0; i < 8; ++i) {
+        sprintf(buf, "/a:l1[%d]/a", i + 1);
+        assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, buf, &set));
+        assert_int_equal(i < 2 ? 1 : 0, set->count);
+        ly_set_free(set, NULL);
+    }
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath_compiled(NULL, tree, exp, LY_VALUE_JSON, NULL, NULL, &set));
+    assert_int_equal(2, set->count);
+    ly_set_free(set, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "/a:l1/b", &exp2));
+    assert_ptr_not_equal(exp, exp2);
+    lyd_xpath_free(UTEST_LYCTX, exp);
+    lyd_xpath_free(UTEST_LYCTX, exp2);
+
+    /* string APIs use the cache */
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath2(tree, "/a:l1[a = $var]", vars, &result));
+    assert_false(result);
+    assert_int_equal(LY_SUCCESS, lyxp_vars_set(&vars, "var", "'a1'"));
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath2(tree, "/a:l1[a = $var]", vars, &result));
+    assert_true(result);
+
+    /* disable the cache, held expressions stay valid */
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "/a:l1/c", &exp));
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_xpath_cache(UTEST_LYCTX, 0));
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath_compiled(NULL, tree, exp, LY_VALUE_JSON, NULL, NULL, &result));
+    assert_true(result);
+    lyd_xpath_free(UTEST_LYCTX, exp);
+
+    lyxp_vars_free(vars);
+    lyd_free_all(tree);
+}
+
+static void
+test_index(void **state)
+{
+    const char *data, *schema_b;
+    const struct lysc_node *snode;
+    struct lyd_node *tree, *node, *match;
+    struct ly_set *set;
+
+    /* invalid nodes */
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/a:l1/c", 0);
+    assert_int_equal(LY_EINVAL, lysc_node_set_index(snode));
+    CHECK_LOG_CTX("Leafs of top-level lists cannot be indexed (\"c\").", NULL);
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/a:c/ll/ll/a", 0);
+    assert_int_equal(LY_EINVAL, lysc_node_set_index(snode));
+    CHECK_LOG_CTX("Only non-key leafs of lists can be indexed (\"a\").", NULL);
+
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/a:c/ll/ll/b", 0);
+    assert_int_equal(LY_SUCCESS, lysc_node_set_index(snode));
+
+    data =
+            "<c xmlns=\"urn:tests:a\">"
+            "  <ll>"
+            "    <a>key1</a>"
+            "    <ll>"
+            "      <a>key11</a>"
+            "      <b>val1</b>"
+            "    </ll>"
+            "    <ll>"
+            "      <a>key12</a>"
+            "      <b>val2</b>"
+            "    </ll>"
+            "    <ll>"
+            "      <a>key13</a>"
+            "      <b>val1</b>"
+            "    </ll>"
+            "    <ll>"
+            "      <a>key14</a>"
+            "    </ll>"
+            "  </ll>"
+            "</c>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+    /* XPath, results in document order */
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll/ll[b='val1']/a", &set));
+    assert_int_equal(2, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[0]), "key11");
+    assert_string_equal(lyd_get_value(set->dnodes[1]), "key13");
+    ly_set_free(set, NULL);
+
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll/ll[b='val3']", &set));
+    assert_int_equal(0, set->count);
+    ly_set_free(set, NULL);
+
+    /* value lookup */
+    node = lyd_child(lyd_child(tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(node, snode->parent, "[b='val2']", 0, &match));
+    assert_string_equal(lyd_get_value(lyd_child(match)), "key12");
+    assert_int_equal(LY_ENOTFOUND, lyd_find_sibling_val(node, snode->parent, "[b='val3']", 0, NULL));
+
+    /* value change */
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(lyd_child(match), snode, NULL, 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "val1"));
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll/ll[b='val1']/a", &set));
+    assert_int_equal(3, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[1]), "key12");
+    ly_set_free(set, NULL);
+
+    /* new leaf */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/a:c/ll[a='key1']/ll[a='key14']/b", "val2", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll/ll[b='val2']/a", &set));
+    assert_int_equal(1, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[0]), "key14");
+    ly_set_free(set, NULL);
+
+    /* freed instance */
+    lyd_free_tree(match);
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll/ll[b='val1']/a", &set));
+    assert_int_equal(2, set->count);
+    ly_set_free(set, NULL);
+    lyd_free_all(tree);
+
+    /* leafref */
+    schema_b =
+            "module b {\n"
+            "    namespace urn:tests:b;\n"
+            "    prefix b;\n"
+            "    container c {\n"
+            "        list l {\n"
+            "            key \"k\";\n"
+            "            leaf k {\n"
+            "                type string;\n"
+            "            }\n"
+            "            leaf v {\n"
+            "                type string;\n"
+            "            }\n"
+            "            leaf w {\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "    leaf ref {\n"
+            "        type leafref {\n"
+            "            path \"/c/l/v\";\n"
+            "        }\n"
+            "    }\n"
+            "}";
+    UTEST_ADD_MODULE(schema_b, LYS_IN_YANG, NULL, NULL);
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/b:c/l/v", 0);
+    assert_int_equal(LY_SUCCESS, lysc_node_set_index(snode));
+
+    data =
+            "<c xmlns=\"urn:tests:b\">"
+            "  <l><k>1</k><v>one</v></l>"
+            "  <l><k>2</k><v>two</v></l>"
+            "</c>"
+            "<ref xmlns=\"urn:tests:b\">two</ref>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    lyd_free_all(tree);
+
+    data =
+            "<c xmlns=\"urn:tests:b\">"
+            "  <l><k>1</k><v>one</v></l>"
+            "</c>"
+            "<ref xmlns=\"urn:tests:b\">two</ref>";
+    assert_int_equal(LY_EVALID, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    CHECK_LOG_CTX("Invalid leafref value \"two\" - no target instance \"/c/l/v\" with the same value.",
+            "Schema location \"/b:ref\", data location \"/b:ref\".");
+
+    /* index declared for existing data */
+    data =
+            "<c xmlns=\"urn:tests:b\">"
+            "  <l><k>1</k><v>one</v><w>x</w></l>"
+            "  <l><k>2</k><v>two</v><w>y</w></l>"
+            "</c>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/b:c/l/w", 0);
+    assert_int_equal(LY_SUCCESS, lysc_node_set_index(snode));
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/b:c/l[w='y']/k", &set));
+    assert_int_equal(1, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[0]), "2");
+    ly_set_free(set, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(lyd_child(tree), snode->parent, "[w='x']", 0, &match));
+    assert_string_equal(lyd_get_value(lyd_child(match)), "1");
+
+    /* the index is built for all the instances when a new one is created */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/b:c/l[k='3']/w", "y", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/b:c/l[w='y']/k", &set));
+    assert_int_equal(2, set->count);
+    assert_string_equal(lyd_get_value(set->dnodes[0]), "2");
+    assert_string_equal(lyd_get_value(set->dnodes[1]), "3");
+    ly_set_free(set, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/b:c/l[v='one']/k", &set));
+    assert_int_equal(1, set->count);
+    ly_set_free(set, NULL);
+    lyd_free_all(tree);
+}
+
+static void
+test_count_exists(void **state)
+{
+    const char *data;
+    struct lyd_node *tree;
+    struct ly_set *set;
+    ly_bool result;
+
+    data =
+            "<l1 xmlns=\"urn:tests:a\"><a>a1</a><b>b1</b></l1>"
+            "<l1 xmlns=\"urn:tests:a\"><a>a2</a><b>b2</b><c>c2</c></l1>"
+            "<c xmlns=\"urn:tests:a\">"
+            "  <x>val</x>"
+            "  <ll>"
+            "    <a>key1</a>"
+            "    <ll><a>key11</a><b>val11</b></ll>"
+            "    <ll><a>key12</a></ll>"
+            "    <ll><a>key13</a><b>val13</b></ll>"
+            "  </ll>"
+            "  <ll>"
+            "    <a>key2</a>"
+            "  </ll>"
+            "  <ll2>one</ll2>"
+            "  <ll2>two</ll2>"
+            "</c>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+    /* count */
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:l1) = 2", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:c/ll/ll) = 3", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:c/ll/ll/b) = 2", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:c/ll2) = 2", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:c/ll[a = 'key1']/ll) = 3", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(//a:ll) = 5", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:c/ll/ll/../a) = 1", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:l1 | /a:c) = 3", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:c/ll/ll[b]) = 2", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "count(/a:foo) = 0", &result));
+    assert_true(result);
+    assert_int_equal(LY_EVALID, lyd_eval_xpath(tree, "count(5)", &result));
+    CHECK_LOG_CTX("Wrong type of argument #1 (number) for the XPath function count(node-set).", "Data location \"/a:l1[a='a1'][b='b1']\".");
+
+    /* existence and boolean */
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:c/ll/ll/b", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:c/ll/ll/c", &result));
+    assert_false(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "boolean(/a:l1/c)", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "not(/a:l1/c)", &result));
+    assert_false(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:l1/b = 'b2'", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:foo or /a:c/ll[ll/b = 'val13']", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:c/x and /a:c/ll/ll[b = 'val12']", &result));
+    assert_false(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:c/ll[ll/b]/a = 'key1'", &result));
+    assert_true(result);
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, "/a:c/ll[ll][2]", &result));
+    assert_false(result);
+
+    /* full node-sets are still returned */
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll/ll/b", &set));
+    assert_int_equal(2, set->count);
+    ly_set_free(set, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/a:c/ll[ll/b]", &set));
+    assert_int_equal(1, set->count);
+    ly_set_free(set, NULL);
+
+    lyd_free_all(tree);
+}
+
+/**
+ * @brief Find the values of a token in an XPath profile report.
+ */
+static void
+profile_tok(const char *report, uint32_t pos, uint32_t *evals, uint32_t *nodes_in, uint32_t *nodes_out, char *access)
+{
+    const char *line;
+    uint32_t p;
+
+    for (line = strchr(report, '\n') + 1; line && *line; line = strchr(line, '\n') + 1) {
+        if ((sscanf(line, "%" SCNu32, &p) == 1) && (p == pos)) {
+            assert_int_equal(4, sscanf(line, "%*u %" SCNu32 " %*f %" SCNu32 " %" SCNu32 " %15s", evals, nodes_in,
+                    nodes_out, access));
+            return;
+        }
+    }
+    fail();
+}
+
+static void
+test_profile(void **state)
+{
+    const char *data;
+    struct lyd_node *tree;
+    struct lyxp_expr *exp;
+    struct ly_set *set;
+    char *str, access[16];
+    uint32_t evals, nodes_in, nodes_out;
+
+    data =
+            "<l1 xmlns=\"urn:tests:a\"><a>a1</a><b>b1</b></l1>"
+            "<l1 xmlns=\"urn:tests:a\"><a>a2</a><b>b2</b><c>c2</c></l1>"
+            "<c xmlns=\"urn:tests:a\">"
+            "  <x>val</x>"
+            "  <ll><a>key1</a></ll>"
+            "  <ll><a>key2</a></ll>"
+            "  <ll><a>key3</a></ll>"
+            "</c>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "/a:c/ll[a != 'key2']/a | //a:x[. = 'val']", &exp));
+
+    /* plan */
+    assert_int_equal(LY_SUCCESS, lyd_xpath_explain(UTEST_LYCTX, exp, &str));
+    assert_non_null(strstr(str, "\n  root\n  step child::a:c (hash lookup)\n  step child::ll (hash lookup)\n"
+            "  predicate [a != 'key2']\n    step child::a (hash lookup)\n    operator !=\n    literal 'key2'\n"
+            "  step child::a (hash lookup)\n  operator |\n"));
+    assert_non_null(strstr(str, "  step descendant::a:x (descendant scan)\n  predicate [. = 'val']\n"
+            "    step self::node()\n"));
+    free(str);
+
+    /* profile */
+    assert_int_equal(LY_SUCCESS, lyd_xpath_profile(tree, tree, exp, LY_VALUE_JSON, NULL, NULL, &set, &str));
+    assert_int_equal(3, set->count);
+    ly_set_free(set, NULL);
+    assert_non_null(strstr(str, "result node-set of 3 nodes\n"));
+
+    profile_tok(str, 1, &evals, &nodes_in, &nodes_out, access);
+    assert_int_equal(1, evals);
+    assert_int_equal(1, nodes_out);
+    assert_string_equal("hash", access);
+
+    /* list without keys in the predicate */
+    profile_tok(str, 5, &evals, &nodes_in, &nodes_out, access);
+    assert_int_equal(1, evals);
+    assert_int_equal(1, nodes_in);
+    assert_int_equal(2, nodes_out);
+    assert_string_equal("scan", access);
+
+    /* predicate evaluated for every instance */
+    profile_tok(str, 7, &evals, &nodes_in, &nodes_out, access);
+    assert_int_equal(3, evals);
+    assert_int_equal(3, nodes_in);
+    assert_int_equal(2, nodes_out);
+    assert_string_equal("predicate", access);
+
+    profile_tok(str, 27, &evals, &nodes_in, &nodes_out, access);
+    assert_int_equal(1, evals);
+    assert_int_equal(1, nodes_out);
+    assert_string_equal("scan", access);
+    free(str);
+
+    /* failed evaluation still reported */
+    lyd_xpath_free(UTEST_LYCTX, exp);
+    assert_int_equal(LY_SUCCESS, lyd_xpath_compile(UTEST_LYCTX, "count(/a:c/x) + count(5)", &exp));
+    assert_int_equal(LY_EVALID, lyd_xpath_profile(tree, tree, exp, LY_VALUE_JSON, NULL, NULL, &set, &str));
+    CHECK_LOG_CTX("Wrong type of argument #1 (number) for the XPath function count(node-set).",
+            "Data location \"/a:l1[a='a1'][b='b1']\".");
+    assert_non_null(strstr(str, "evaluation failed\n"));
+    free(str);
+
+    lyd_xpath_free(UTEST_LYCTX, exp);
+    lyd_free_all(tree);
+}
+
+static void
+test_profile_validation(void **state)
+{
+    const char *schema, *data;
+    struct lyd_node *tree;
+    char *str;
+
+    schema =
+            "module p {\n"
+            "  namespace urn:tests:p;\n"
+            "  prefix p;\n"
+            "  container c {\n"
+            "    list l {\n"
+            "      key k;\n"
+            "      leaf k {type string;}\n"
+            "      leaf v {type uint8; must \". < 10\";}\n"
+            "    }\n"
+            "    leaf x {type uint8; must \". < 10\";}\n"
+            "    leaf w {type string; when \"../l/v = 1\";}\n"
+            "  }\n"
+            "}";
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    data =
+            "<c xmlns=\"urn:tests:p\">"
+            "  <l><k>a</k><v>1</v></l>"
+            "  <l><k>b</k><v>2</v></l>"
+            "  <l><k>c</k><v>3</v></l>"
+            "  <w>x</w>"
+            "  <x>5</x>"
+            "</c>";
+
+    /* must and when evaluated by the parser validation */
+    assert_int_equal(LY_SUCCESS, lyd_xpath_profile_start(UTEST_LYCTX));
+    assert_int_equal(LY_EINVAL, lyd_xpath_profile_start(UTEST_LYCTX));
+    CHECK_LOG_CTX("XPath profiling was already started in this thread.", NULL);
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT,
+            LYD_VALIDATE_PRESENT, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_xpath_profile_stop(&str));
+    assert_non_null(strstr(str, "XPath profiles, 3 expressions, "));
+    assert_non_null(strstr(str, "XPath \". < 10\" on \"/p:c/l/v\" profile, 3 evaluations, "));
+    assert_non_null(strstr(str, "XPath \". < 10\" on \"/p:c/x\" profile, 1 evaluations, "));
+    assert_non_null(strstr(str, "XPath \"../l/v = 1\" on \"/p:c/w\" profile, 1 evaluations, "));
+    free(str);
+
+    /* evaluated by worker threads */
+    assert_int_equal(LY_SUCCESS, lyd_xpath_profile_start(UTEST_LYCTX));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT | LYD_VALIDATE_MULTI_THREADED,
+            NULL));
+    assert_int_equal(LY_SUCCESS, lyd_xpath_profile_stop(&str));
+    assert_non_null(strstr(str, "XPath \". < 10\" on \"/p:c/l/v\" profile, 3 evaluations, "));
+    assert_non_null(strstr(str, "XPath \". < 10\" on \"/p:c/x\" profile, 1 evaluations, "));
+    free(str);
+
+    /* not profiled anymore */
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    assert_int_equal(LY_EINVAL, lyd_xpath_profile_stop(NULL));
+
+    lyd_free_all(tree);
+}
+
 int
 main(void)
 {
@@ -987,6 +1479,11 @@ main(void)
         UTEST(test_augment, setup),
         UTEST(test_variables, setup),
         UTEST(test_axes, setup),
+        UTEST(test_compiled, setup),
+        UTEST(test_index, setup),
+        UTEST(test_count_exists, setup),
+        UTEST(test_profile, setup),
+        UTEST(test_profile_validation, setup),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
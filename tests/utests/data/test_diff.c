@@ -117,6 +117,11 @@ const char *schema1 =
         "            leaf l2 {\n"
         "                type int32;\n"
         "            }\n"
+        ""
+        "            leaf-list ull {\n"
+        "                type string;\n"
+        "                ordered-by user;\n"
+        "            }\n"
         "        }\n"
         ""
         "        leaf-list dllist {\n"
@@ -844,7 +849,7 @@ test_userord_list(void **state)
             "</df>\n";
     const char *out_merge =
             "<df xmlns=\"urn:libyang:tests:defaults\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"none\">\n"
-            "  <ul yang:operation=\"delete\">\n"
+            "  <ul yang:orig-key=\"\" yang:operation=\"delete\">\n"
             "    <l1>a</l1>\n"
             "    <l2 yang:operation=\"delete\">1</l2>\n"
             "  </ul>\n"
@@ -939,6 +944,194 @@ test_userord_list2(void **state)
     TEST_DIFF_3(xml1, xml2, xml3, out_diff_1, out_diff_2, out_merge);
 }
 
+static void
+test_userord_large(void **state)
+{
+    (void) state;
+    struct lyd_node *model_1, *model_2, *diff;
+    char buf[16];
+    uint32_t i;
+
+    /* 1000 ordered values and a permutation of half of them mixed with new values */
+    assert_int_equal(lyd_new_path(NULL, UTEST_LYCTX, "/defaults:df", NULL, 0, &model_1), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(NULL, UTEST_LYCTX, "/defaults:df", NULL, 0, &model_2), LY_SUCCESS);
+    for (i = 0; i < 1000; ++i) {
+        sprintf(buf, "%" PRIu32, i);
+        assert_int_equal(lyd_new_term(model_1, NULL, "llist", buf, 0, NULL), LY_SUCCESS);
+
+        sprintf(buf, "%" PRIu32, (i * 7) % 1000);
+        if (i % 2) {
+            assert_int_equal(lyd_new_term(model_2, NULL, "llist", buf, 0, NULL), LY_SUCCESS);
+        } else if (!(i % 10)) {
+            sprintf(buf, "%" PRIu32, 1000 + i);
+            assert_int_equal(lyd_new_term(model_2, NULL, "llist", buf, 0, NULL), LY_SUCCESS);
+        }
+    }
+
+    assert_int_equal(lyd_diff_siblings(model_1, model_2, 0, &diff), LY_SUCCESS);
+    assert_non_null(diff);
+    assert_int_equal(lyd_diff_apply_all(&model_1, diff), LY_SUCCESS);
+    CHECK_LYD(model_1, model_2);
+
+    lyd_free_all(model_1);
+    lyd_free_all(model_2);
+    lyd_free_all(diff);
+}
+
+static void
+test_subtree_hash(void **state)
+{
+    (void) state;
+    struct lyd_node *data1, *data2, *dup, *diff, *node;
+    const char *xml =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <list>\n"
+            "    <name>a</name>\n"
+            "    <value>1</value>\n"
+            "    <list2>\n"
+            "      <name2>x</name2>\n"
+            "      <value2>10</value2>\n"
+            "    </list2>\n"
+            "  </list>\n"
+            "  <list>\n"
+            "    <name>b</name>\n"
+            "    <value>2</value>\n"
+            "  </list>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml, data1);
+    CHECK_PARSE_LYD(xml, data2);
+
+    /* equal trees, the hashes are generated */
+    assert_int_equal(lyd_diff_siblings(data1, data2, LYD_DIFF_SUBTREE_HASH, &diff), LY_SUCCESS);
+    assert_null(diff);
+
+    /* nested change invalidates the hashes */
+    assert_int_equal(lyd_find_path(data2, "/defaults:df/list[name='a']/list2[name2='x']/value2", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_term(node, "11"), LY_SUCCESS);
+    assert_int_equal(lyd_diff_siblings(data1, data2, LYD_DIFF_SUBTREE_HASH, &diff), LY_SUCCESS);
+    CHECK_LYD_STRING(diff,
+            "<df xmlns=\"urn:libyang:tests:defaults\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"none\">\n"
+            "  <list>\n"
+            "    <name>a</name>\n"
+            "    <list2>\n"
+            "      <name2>x</name2>\n"
+            "      <value2 yang:operation=\"replace\" yang:orig-default=\"false\" yang:orig-value=\"10\">11</value2>\n"
+            "    </list2>\n"
+            "  </list>\n"
+            "</df>\n");
+    lyd_free_all(diff);
+
+    /* different subtrees are recognized without comparing them */
+    assert_int_equal(lyd_compare_single(data1, data2, LYD_COMPARE_FULL_RECURSION), LY_ENOT);
+
+    /* duplicate keeps the hashes, new node invalidates them */
+    assert_int_equal(lyd_dup_siblings(data2, NULL, LYD_DUP_RECURSIVE, &dup), LY_SUCCESS);
+    assert_int_equal(lyd_compare_single(data2, dup, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(dup, NULL, "/defaults:df/list[name='b']/list2[name2='y']", NULL, 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_diff_siblings(data2, dup, LYD_DIFF_SUBTREE_HASH, &diff), LY_SUCCESS);
+    CHECK_LYD_STRING(diff,
+            "<df xmlns=\"urn:libyang:tests:defaults\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"none\">\n"
+            "  <list>\n"
+            "    <name>b</name>\n"
+            "    <list2 yang:operation=\"create\">\n"
+            "      <name2>y</name2>\n"
+            "    </list2>\n"
+            "  </list>\n"
+            "</df>\n");
+    lyd_free_all(diff);
+    lyd_free_all(data1);
+    lyd_free_all(data2);
+    lyd_free_all(dup);
+
+    /* explicit and implicit default values are equal unless compared with the default flags */
+    CHECK_PARSE_LYD_PARAM("<df xmlns=\"urn:libyang:tests:defaults\"><foo>42</foo><llist>1</llist></df>", LYD_XML, 0,
+            LYD_VALIDATE_PRESENT, LY_SUCCESS, data1);
+    CHECK_PARSE_LYD_PARAM("<df xmlns=\"urn:libyang:tests:defaults\"><llist>1</llist></df>", LYD_XML, 0,
+            LYD_VALIDATE_PRESENT, LY_SUCCESS, data2);
+    assert_int_equal(lyd_compare_single(data1, data2, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    assert_int_equal(lyd_diff_siblings(data1, data2, LYD_DIFF_SUBTREE_HASH, &diff), LY_SUCCESS);
+    lyd_free_all(diff);
+    assert_int_equal(lyd_compare_single(data1, data2, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    assert_int_equal(lyd_compare_single(data1, data2, LYD_COMPARE_FULL_RECURSION | LYD_COMPARE_DEFAULTS), LY_ENOT);
+
+    lyd_free_all(data1);
+    lyd_free_all(data2);
+}
+
+static LY_ERR
+diff_change_cb(enum lyd_diff_op op, const struct lyd_node *first, const struct lyd_node *second,
+        const struct lyd_node *anchor, void *cb_data)
+{
+    const char *ops[] = {"create", "delete", "replace", "none"};
+    char *changes = cb_data;
+    const struct lyd_node *node = second ? second : first;
+
+    sprintf(changes + strlen(changes), "%s %s", ops[op], LYD_NAME(node));
+    if (node->schema->nodetype & LYD_NODE_TERM) {
+        sprintf(changes + strlen(changes), " %s", lyd_get_value(node));
+    }
+    if (anchor) {
+        sprintf(changes + strlen(changes), " after %s", lyd_get_value(anchor));
+    }
+    strcat(changes, "\n");
+
+    return LY_SUCCESS;
+}
+
+static void
+test_diff_cb(void **state)
+{
+    (void) state;
+    struct lyd_node *data1, *data2;
+    char changes[1024] = {0};
+    const char *xml1 =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>41</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>3</llist>\n"
+            "  <llist>4</llist>\n"
+            "  <llist>5</llist>\n"
+            "  <list>\n"
+            "    <name>a</name>\n"
+            "    <value>1</value>\n"
+            "  </list>\n"
+            "</df>\n";
+    const char *xml2 =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>42</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <llist>4</llist>\n"
+            "  <llist>3</llist>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>6</llist>\n"
+            "  <list>\n"
+            "    <name>a</name>\n"
+            "    <value>2</value>\n"
+            "  </list>\n"
+            "  <list>\n"
+            "    <name>b</name>\n"
+            "  </list>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml1, data1);
+    CHECK_PARSE_LYD(xml2, data2);
+
+    assert_int_equal(lyd_diff_siblings_cb(data1, data2, 0, diff_change_cb, changes), LY_SUCCESS);
+    assert_string_equal(changes,
+            "replace foo 42\n"
+            "delete llist 5\n"
+            "replace value 2\n"
+            "replace llist 4 after 1\n"
+            "replace llist 3 after 4\n"
+            "create llist 6 after 2\n"
+            "create list\n");
+
+    lyd_free_all(data1);
+    lyd_free_all(data2);
+}
+
 static void
 test_keyless_list(void **state)
 {
@@ -1195,6 +1388,479 @@ test_wd(void **state)
     lyd_free_all(diff2);
 }
 
+static void
+test_journal(void **state)
+{
+    (void) state;
+    struct lyd_node *data, *orig, *diff, *diff2, *node, *sibling;
+    struct lyd_journal *journal;
+    const char *xml =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>41</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>3</llist>\n"
+            "  <list>\n"
+            "    <name>a</name>\n"
+            "    <value>1</value>\n"
+            "  </list>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml, data);
+    CHECK_PARSE_LYD(xml, orig);
+    assert_int_equal(lyd_journal_new(&data, &journal), LY_SUCCESS);
+
+    /* nothing changed yet */
+    assert_int_equal(lyd_journal_diff(journal, &diff), LY_SUCCESS);
+    assert_null(diff);
+
+    /* change the data */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_term(node, "42"), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='2']", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='1']", 0, &sibling), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='3']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/llist", "4", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/list[name='b']/value", "2", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/list[name='a']", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+
+    assert_int_equal(lyd_journal_diff(journal, &diff), LY_SUCCESS);
+    CHECK_LYD_STRING(diff,
+            "<df xmlns=\"urn:libyang:tests:defaults\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"none\">\n"
+            "  <foo yang:operation=\"replace\" yang:orig-default=\"false\" yang:orig-value=\"41\">42</foo>\n"
+            "  <llist yang:orig-value=\"1\" yang:operation=\"replace\" yang:value=\"\" yang:orig-default=\"false\">3</llist>\n"
+            "  <llist yang:value=\"1\" yang:operation=\"create\">4</llist>\n"
+            "  <llist yang:orig-value=\"1\" yang:operation=\"delete\">2</llist>\n"
+            "  <list yang:operation=\"create\">\n"
+            "    <name>b</name>\n"
+            "    <value yang:operation=\"create\">2</value>\n"
+            "  </list>\n"
+            "  <list yang:operation=\"delete\">\n"
+            "    <name>a</name>\n"
+            "    <value>1</value>\n"
+            "  </list>\n"
+            "</df>\n");
+
+    /* the diff changes the original data into the current ones */
+    assert_int_equal(lyd_diff_apply_all(&orig, diff), LY_SUCCESS);
+    assert_int_equal(lyd_compare_siblings(orig, data, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    lyd_free_all(diff);
+
+    /* changes of other trees are not recorded */
+    assert_int_equal(lyd_journal_diff(journal, &diff), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(orig, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_term(node, "43"), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(orig, NULL, "/defaults:df/llist", "5", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_journal_diff(journal, &diff2), LY_SUCCESS);
+    assert_int_equal(lyd_compare_siblings(diff, diff2, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    lyd_free_all(diff);
+    lyd_free_all(diff2);
+
+    /* changes are recorded from the reset on */
+    lyd_journal_reset(journal);
+    assert_int_equal(lyd_journal_diff(journal, &diff), LY_SUCCESS);
+    assert_null(diff);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/list[name='b']/value", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_term(node, "3"), LY_SUCCESS);
+    assert_int_equal(lyd_journal_diff(journal, &diff), LY_SUCCESS);
+    CHECK_LYD_STRING(diff,
+            "<df xmlns=\"urn:libyang:tests:defaults\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"none\">\n"
+            "  <list>\n"
+            "    <name>b</name>\n"
+            "    <value yang:operation=\"replace\" yang:orig-default=\"false\" yang:orig-value=\"2\">3</value>\n"
+            "  </list>\n"
+            "</df>\n");
+    lyd_free_all(diff);
+
+    lyd_journal_free(journal);
+    lyd_free_all(data);
+    lyd_free_all(orig);
+}
+
+static void
+test_journal_rollback(void **state)
+{
+    (void) state;
+    struct lyd_node *data, *orig, *diff, *node, *sibling;
+    struct lyd_journal *journal;
+    const char *xml =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>41</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>3</llist>\n"
+            "  <ul>\n"
+            "    <l1>a</l1>\n"
+            "    <l2>1</l2>\n"
+            "  </ul>\n"
+            "  <ul>\n"
+            "    <l1>b</l1>\n"
+            "    <l2>2</l2>\n"
+            "  </ul>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml, data);
+    CHECK_PARSE_LYD(xml, orig);
+    assert_int_equal(lyd_journal_new(&data, &journal), LY_SUCCESS);
+
+    /* change the data, validation adds and removes some nodes as well */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='1']", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='2']", 0, &sibling), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='3']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/llist", "1", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='a']", 0, &sibling), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='b']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/ul[l1='c']/l2", "3", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='a']/l2", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_term(node, "11"), LY_SUCCESS);
+    assert_int_equal(lyd_validate_all(&data, NULL, LYD_VALIDATE_PRESENT, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_compare_siblings(data, orig, LYD_COMPARE_FULL_RECURSION), LY_ENOT);
+
+    /* back to the original data, including the order and the default nodes */
+    assert_int_equal(lyd_journal_rollback(journal), LY_SUCCESS);
+    CHECK_LYD_STRING(data, xml);
+    assert_int_equal(lyd_compare_siblings(data, orig, LYD_COMPARE_FULL_RECURSION | LYD_COMPARE_DEFAULTS), LY_SUCCESS);
+    assert_int_equal(lyd_journal_diff(journal, &diff), LY_SUCCESS);
+    assert_null(diff);
+
+    /* nothing to roll back */
+    assert_int_equal(lyd_journal_rollback(journal), LY_SUCCESS);
+    CHECK_LYD_STRING(data, xml);
+
+    lyd_journal_free(journal);
+    lyd_free_all(data);
+    lyd_free_all(orig);
+}
+
+static void
+test_journal_rollback_meta(void **state)
+{
+    (void) state;
+    struct lyd_node *data, *node;
+    struct lyd_meta *meta;
+    struct lyd_journal *journal;
+    char *orig_str;
+    const char *xml =
+            "<df xmlns=\"urn:libyang:tests:defaults\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\">\n"
+            "  <foo yang:operation=\"none\">41</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <ul yang:operation=\"replace\">\n"
+            "    <l1>a</l1>\n"
+            "    <l2 yang:operation=\"none\">1</l2>\n"
+            "  </ul>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml, data);
+    assert_int_equal(lyd_print_mem(&orig_str, data, LYD_XML, LYD_PRINT_WITHSIBLINGS), LY_SUCCESS);
+    assert_int_equal(lyd_journal_new(&data, &journal), LY_SUCCESS);
+
+    /* delete a node with metadata, change, create, and delete metadata */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='1']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_new_meta(NULL, node, NULL, "yang:operation", "create", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='a']/l2", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_meta(node->meta, "delete"), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='a']", 0, &node), LY_SUCCESS);
+    lyd_free_meta_siblings(node->meta);
+
+    /* create a node with metadata */
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/ul[l1='b']/l2", "2", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_new_meta(NULL, node, NULL, "yang:operation", "create", 0, &meta), LY_SUCCESS);
+
+    /* back to the original data including the metadata */
+    assert_int_equal(lyd_journal_rollback(journal), LY_SUCCESS);
+    CHECK_LYD_STRING(data, orig_str);
+
+    /* metadata of a node deleted and created again */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/foo", "41", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_new_meta(NULL, node, NULL, "yang:operation", "replace", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_journal_rollback(journal), LY_SUCCESS);
+    CHECK_LYD_STRING(data, orig_str);
+
+    free(orig_str);
+    lyd_journal_free(journal);
+    lyd_free_all(data);
+}
+
+static void
+test_journal_rollback_userord(void **state)
+{
+    (void) state;
+    struct lyd_node *data, *orig, *node, *sibling;
+    struct lyd_journal *journal;
+    const char *xml =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <llist>1</llist>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>3</llist>\n"
+            "  <ul>\n"
+            "    <l1>a</l1>\n"
+            "    <l2>1</l2>\n"
+            "    <ull>x</ull>\n"
+            "    <ull>y</ull>\n"
+            "  </ul>\n"
+            "  <ul>\n"
+            "    <l1>b</l1>\n"
+            "    <l2>2</l2>\n"
+            "  </ul>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml, data);
+    CHECK_PARSE_LYD(xml, orig);
+    assert_int_equal(lyd_journal_new(&data, &journal), LY_SUCCESS);
+
+    /* move and create user-ordered instances, the nested ones of the moved list instances are not changed */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='a']", 0, &sibling), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='b']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/ul[l1='c']/ull", "z", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/ul[l1='b']", 0, &sibling), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='1']", 0, &sibling), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='3']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_new_term(lyd_parent(sibling), NULL, "llist", "4", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_before(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='2']", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_insert_after(sibling, node), LY_SUCCESS);
+    assert_int_equal(lyd_compare_siblings(data, orig, LYD_COMPARE_FULL_RECURSION), LY_ENOT);
+
+    /* restoring the order moves the list instances with nested user-ordered instances */
+    assert_int_equal(lyd_journal_rollback(journal), LY_SUCCESS);
+    CHECK_LYD_STRING(data, xml);
+    assert_int_equal(lyd_compare_siblings(data, orig, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+
+    lyd_journal_free(journal);
+    lyd_free_all(data);
+    lyd_free_all(orig);
+}
+
+static void
+test_snapshots(void **state)
+{
+    (void) state;
+    struct lyd_node *data, *node;
+    const struct lyd_node *snap1, *snap2, *snap3;
+    struct lyd_snapshots *snapshots;
+    const char *xml =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>41</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <llist>2</llist>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml, data);
+    assert_int_equal(lyd_snapshots_new(&data, &snapshots), LY_SUCCESS);
+
+    /* unchanged tree, the snapshots share the copy */
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap1), LY_SUCCESS);
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap2), LY_SUCCESS);
+    assert_ptr_equal(snap1, snap2);
+    assert_ptr_not_equal(snap1, data);
+    assert_int_equal(lyd_compare_siblings(snap1, data, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+
+    /* changed tree, the snapshots in use are kept */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_change_term(node, "42"), LY_SUCCESS);
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap3), LY_SUCCESS);
+    assert_ptr_not_equal(snap1, snap3);
+    CHECK_LYD_STRING(snap1, xml);
+    assert_int_equal(lyd_compare_siblings(snap3, data, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    lyd_snapshot_release(snapshots, snap1);
+    lyd_snapshot_release(snapshots, snap2);
+    lyd_snapshot_release(snapshots, snap3);
+
+    /* changed tree without snapshots in use, the copy is updated */
+    assert_int_equal(lyd_new_path(data, NULL, "/defaults:df/llist", "3", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_find_path(data, "/defaults:df/llist[.='1']", 0, &node), LY_SUCCESS);
+    lyd_free_tree(node);
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap1), LY_SUCCESS);
+    assert_ptr_equal(snap1, snap3);
+    CHECK_LYD_STRING(snap1,
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>42</foo>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>3</llist>\n"
+            "</df>\n");
+    lyd_snapshot_release(snapshots, snap1);
+
+    /* changed metadata, not in the journal diff */
+    assert_int_equal(lyd_find_path(data, "/defaults:df/foo", 0, &node), LY_SUCCESS);
+    assert_int_equal(lyd_new_meta(NULL, node, NULL, "yang:operation", "none", 0, NULL), LY_SUCCESS);
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap1), LY_SUCCESS);
+    CHECK_LYD_STRING(snap1,
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"none\">42</foo>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>3</llist>\n"
+            "</df>\n");
+    lyd_snapshot_release(snapshots, snap1);
+
+    /* empty tree */
+    lyd_free_tree(data);
+    assert_null(data);
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap1), LY_SUCCESS);
+    assert_null(snap1);
+    lyd_snapshot_release(snapshots, snap1);
+
+    /* new tree */
+    assert_int_equal(lyd_new_path(NULL, UTEST_LYCTX, "/defaults:df/foo", "43", 0, &data), LY_SUCCESS);
+    assert_int_equal(lyd_snapshot_get(snapshots, &snap1), LY_SUCCESS);
+    assert_non_null(snap1);
+    assert_int_equal(lyd_compare_siblings(snap1, data, LYD_COMPARE_FULL_RECURSION), LY_SUCCESS);
+    lyd_snapshot_release(snapshots, snap1);
+
+    lyd_snapshots_free(snapshots);
+    lyd_free_all(data);
+}
+
+static void
+test_multi_threaded(void **state)
+{
+    (void) state;
+    struct lyd_node *data1, *data2, *diff, *mt_diff;
+    char *str, *mt_str, path[64], buf[16];
+    uint32_t i;
+    const char *xml1 =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>42</foo>\n"
+            "  <llist>1</llist>\n"
+            "  <llist>2</llist>\n"
+            "  <kl>\n"
+            "    <l1>a</l1>\n"
+            "    <l2>1</l2>\n"
+            "  </kl>\n"
+            "  <kl>\n"
+            "    <l1>a</l1>\n"
+            "    <l2>1</l2>\n"
+            "  </kl>\n"
+            "</df>\n";
+    const char *xml2 =
+            "<df xmlns=\"urn:libyang:tests:defaults\">\n"
+            "  <foo>43</foo>\n"
+            "  <llist>2</llist>\n"
+            "  <llist>1</llist>\n"
+            "  <kl>\n"
+            "    <l1>a</l1>\n"
+            "    <l2>1</l2>\n"
+            "  </kl>\n"
+            "  <kl>\n"
+            "    <l1>b</l1>\n"
+            "    <l2>1</l2>\n"
+            "  </kl>\n"
+            "</df>\n";
+
+    CHECK_PARSE_LYD(xml1, data1);
+    CHECK_PARSE_LYD(xml2, data2);
+
+    /* list instances with nested changes, each compared by a worker thread */
+    for (i = 0; i < 200; ++i) {
+        sprintf(path, "/defaults:df/list[name='n%" PRIu32 "']/value", i);
+        sprintf(buf, "%" PRIu32, i);
+        if (i % 5) {
+            assert_int_equal(lyd_new_path(data1, NULL, path, buf, 0, NULL), LY_SUCCESS);
+        }
+        if (i % 7) {
+            sprintf(buf, "%" PRIu32, (i % 3) ? i : i + 1);
+            assert_int_equal(lyd_new_path(data2, NULL, path, buf, 0, NULL), LY_SUCCESS);
+        }
+        if (!(i % 4)) {
+            sprintf(path, "/defaults:df/list[name='n%" PRIu32 "']/list2[name2='x']/value2", i);
+            assert_int_equal(lyd_new_path(data2, NULL, path, buf, 0, NULL), LY_SUCCESS);
+        }
+    }
+
+    /* the diff is the same as the serial one */
+    assert_int_equal(lyd_diff_siblings(data1, data2, 0, &diff), LY_SUCCESS);
+    assert_int_equal(lyd_diff_siblings(data1, data2, LYD_DIFF_MULTI_THREADED, &mt_diff), LY_SUCCESS);
+    assert_int_equal(lyd_print_mem(&str, diff, LYD_XML, LYD_PRINT_WITHSIBLINGS), LY_SUCCESS);
+    assert_int_equal(lyd_print_mem(&mt_str, mt_diff, LYD_XML, LYD_PRINT_WITHSIBLINGS), LY_SUCCESS);
+    assert_string_equal(str, mt_str);
+    free(str);
+    free(mt_str);
+
+    /* and it can be applied */
+    assert_int_equal(lyd_diff_apply_all(&data1, mt_diff), LY_SUCCESS);
+    lyd_free_all(diff);
+    lyd_free_all(mt_diff);
+    assert_int_equal(lyd_diff_siblings(data1, data2, LYD_DIFF_MULTI_THREADED, &diff), LY_SUCCESS);
+    assert_null(diff);
+
+    lyd_free_all(data1);
+    lyd_free_all(data2);
+}
+
+static LY_ERR
+apply_batch_cb(const struct lyd_node *diff_node, struct lyd_node *data_node, void *user_data)
+{
+    uint32_t *count = user_data;
+
+    assert_ptr_equal(diff_node->schema, data_node->schema);
+    ++(*count);
+    return LY_SUCCESS;
+}
+
+static void
+test_apply_batch(void **state)
+{
+    (void) state;
+    struct lyd_node *data1, *data2, *diff;
+    char path[64], buf[16];
+    uint32_t i, cb_count = 0;
+
+    assert_int_equal(lyd_new_path(NULL, UTEST_LYCTX, "/defaults:df/foo", "1", 0, &data1), LY_SUCCESS);
+    assert_int_equal(lyd_new_path(NULL, UTEST_LYCTX, "/defaults:df/foo", "1", 0, &data2), LY_SUCCESS);
+
+    for (i = 0; i < 300; ++i) {
+        /* system-ordered list instances are created in runs */
+        sprintf(path, "/defaults:df/list[name='n%" PRIu32 "']/list2[name2='x']/value2", i);
+        sprintf(buf, "%" PRIu32, i);
+        if (!(i % 10)) {
+            assert_int_equal(lyd_new_path(data1, NULL, path, buf, 0, NULL), LY_SUCCESS);
+        }
+        assert_int_equal(lyd_new_path(data2, NULL, path, buf, 0, NULL), LY_SUCCESS);
+
+        /* user-ordered instances are created and moved relative to each other, in reverse order */
+        sprintf(path, "/defaults:df/ul[l1='u%" PRIu32 "']/l2", 299 - i);
+        if (!(i % 7)) {
+            assert_int_equal(lyd_new_path(data1, NULL, path, buf, 0, NULL), LY_SUCCESS);
+        }
+        assert_int_equal(lyd_new_path(data2, NULL, path, buf, 0, NULL), LY_SUCCESS);
+        sprintf(buf, "%" PRIu32, 299 - i);
+        if (!(i % 11)) {
+            assert_int_equal(lyd_new_path(data1, NULL, "/defaults:df/llist", buf, 0, NULL), LY_SUCCESS);
+        }
+        assert_int_equal(lyd_new_path(data2, NULL, "/defaults:df/llist", buf, 0, NULL), LY_SUCCESS);
+    }
+    assert_int_equal(lyd_new_path(data1, NULL, "/defaults:df/ul[l1='u299']/l2", "0", LYD_NEW_PATH_UPDATE, NULL),
+            LY_SUCCESS);
+
+    /* apply the diff with every node passed to the callback */
+    assert_int_equal(lyd_diff_siblings(data1, data2, 0, &diff), LY_SUCCESS);
+    assert_non_null(diff);
+    assert_int_equal(lyd_diff_apply_module(&data1, diff, NULL, apply_batch_cb, &cb_count), LY_SUCCESS);
+    assert_true(cb_count > 300 + 300 + 300);
+    lyd_free_all(diff);
+
+    /* the data including the order of user-ordered instances are the same */
+    assert_int_equal(lyd_diff_siblings(data1, data2, 0, &diff), LY_SUCCESS);
+    assert_null(diff);
+
+    lyd_free_all(data1);
+    lyd_free_all(data2);
+}
+
 int
 main(void)
 {
@@ -1212,6 +1878,16 @@ main(void)
         UTEST(test_userord_mix, setup),
         UTEST(test_userord_list, setup),
         UTEST(test_userord_list2, setup),
+        UTEST(test_userord_large, setup),
+        UTEST(test_subtree_hash, setup),
+        UTEST(test_diff_cb, setup),
+        UTEST(test_journal, setup),
+        UTEST(test_journal_rollback, setup),
+        UTEST(test_journal_rollback_meta, setup),
+        UTEST(test_journal_rollback_userord, setup),
+        UTEST(test_snapshots, setup),
+        UTEST(test_multi_threaded, setup),
+        UTEST(test_apply_batch, setup),
         UTEST(test_keyless_list, setup),
         UTEST(test_state_llist, setup),
         UTEST(test_wd, setup),
@@ -409,6 +409,92 @@ test_path_ext(void **state)
     lyd_free_tree(root);
 }
 
+static void
+test_path_handle(void **state)
+{
+    LY_ERR ret;
+    struct lyd_node *root, *node, *parent, *cont;
+    struct lyd_path_handle *handle, *handle2;
+    struct lys_module *mod;
+    const char *keys[2];
+
+    UTEST_ADD_MODULE(schema_a, LYS_IN_YANG, NULL, &mod);
+
+    /* keys of the list are bound */
+    assert_int_equal(LY_SUCCESS, lyd_path_handle_new(UTEST_LYCTX, NULL, "/a:l1/c", 0, &handle));
+    assert_int_equal(2, lyd_path_handle_bind_count(handle));
+
+    keys[0] = "x";
+    keys[1] = "y";
+    ret = lyd_new_path_handle(NULL, handle, keys, "val", 0, 0, 0, &root, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_string_equal(root->schema->name, "l1");
+    assert_string_equal(node->schema->name, "c");
+    assert_string_equal("val", lyd_get_value(node));
+
+    keys[1] = "z";
+    ret = lyd_new_path_handle(root, handle, keys, "val2", 0, 0, 0, &parent, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_ptr_equal(root->next, parent);
+    CHECK_LYD_STRING_PARAM(root, "<l1 xmlns=\"urn:tests:a\"><a>x</a><b>y</b><c>val</c></l1>"
+            "<l1 xmlns=\"urn:tests:a\"><a>x</a><b>z</b><c>val2</c></l1>", LYD_XML,
+            LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS);
+
+    /* existing node */
+    keys[1] = "y";
+    ret = lyd_new_path_handle(root, handle, keys, "val3", 0, 0, 0, NULL, NULL);
+    assert_int_equal(ret, LY_EEXIST);
+    CHECK_LOG_CTX("Path \"/a:l1/c\" already exists", "Data location \"/a:l1[a='x'][b='y']/c\".");
+    ret = lyd_new_path_handle(root, handle, keys, "val3", 0, 0, LYD_NEW_PATH_UPDATE, NULL, &node);
+    assert_int_equal(ret, LY_SUCCESS);
+    assert_string_equal("val3", lyd_get_value(node));
+
+    /* find */
+    assert_int_equal(LY_SUCCESS, lyd_find_path_handle(root, handle, keys, &node));
+    assert_string_equal("val3", lyd_get_value(node));
+    keys[1] = "z";
+    assert_int_equal(LY_SUCCESS, lyd_find_path_handle(root, handle, keys, &node));
+    assert_string_equal("val2", lyd_get_value(node));
+    keys[0] = "q";
+    assert_int_equal(LY_ENOTFOUND, lyd_find_path_handle(root, handle, keys, &node));
+    lyd_path_handle_free(handle);
+    lyd_free_siblings(root);
+
+    /* fixed predicate and an invalid bound key value */
+    assert_int_equal(LY_SUCCESS, lyd_path_handle_new(UTEST_LYCTX, NULL, "/a:l11[a='5']/b", 0, &handle));
+    assert_int_equal(0, lyd_path_handle_bind_count(handle));
+    assert_int_equal(LY_SUCCESS, lyd_new_path_handle(NULL, handle, NULL, "6", 0, 0, 0, &root, NULL));
+    CHECK_LYD_STRING_PARAM(root, "<l11 xmlns=\"urn:tests:a\"><a>5</a><b>6</b></l11>", LYD_XML, LYD_PRINT_SHRINK);
+    lyd_path_handle_free(handle);
+
+    assert_int_equal(LY_SUCCESS, lyd_path_handle_new(UTEST_LYCTX, NULL, "/a:l11/b", 0, &handle));
+    keys[0] = "5";
+    assert_int_equal(LY_SUCCESS, lyd_find_path_handle(root, handle, keys, &node));
+    assert_string_equal("6", lyd_get_value(node));
+    keys[0] = "abc";
+    assert_int_equal(LY_EVALID, lyd_new_path_handle(root, handle, keys, "6", 0, 0, 0, NULL, NULL));
+    CHECK_LOG_CTX("Invalid type uint32 value \"abc\".", "Schema location \"/a:l11/a\".");
+    lyd_path_handle_free(handle);
+    lyd_free_tree(root);
+
+    /* relative path */
+    assert_int_equal(LY_SUCCESS, lyd_new_inner(NULL, mod, "c", 0, &cont));
+    assert_int_equal(LY_SUCCESS, lyd_path_handle_new(NULL, cont->schema, "x", 0, &handle));
+    assert_int_equal(LY_SUCCESS, lyd_path_handle_new(NULL, cont->schema, "x[.='b']", 0, &handle2));
+    assert_int_equal(LY_SUCCESS, lyd_new_path_handle(cont, handle, NULL, "a", 0, 0, 0, NULL, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_path_handle(cont, handle2, NULL, NULL, 0, 0, 0, NULL, NULL));
+    CHECK_LYD_STRING_PARAM(cont, "<c xmlns=\"urn:tests:a\"><x>a</x><x>b</x></c>", LYD_XML, LYD_PRINT_SHRINK);
+    assert_int_equal(LY_SUCCESS, lyd_find_path_handle(cont, handle2, NULL, &node));
+    assert_string_equal("b", lyd_get_value(node));
+    assert_int_equal(LY_EVALID, lyd_find_path_handle(cont, handle, NULL, &node));
+    CHECK_LOG_CTX("Predicate missing for leaf-list \"x\" in path \"x\".", NULL);
+    assert_int_equal(LY_EINVAL, lyd_new_path_handle(NULL, handle, NULL, "c", 0, 0, 0, NULL, NULL));
+    CHECK_LOG_CTX("Invalid argument !handle->ctx_node || parent (lyd_new_path_handle()).", NULL);
+    lyd_path_handle_free(handle);
+    lyd_path_handle_free(handle2);
+    lyd_free_tree(cont);
+}
+
 int
 main(void)
 {
@@ -417,6 +503,7 @@ main(void)
         UTEST(test_opaq),
         UTEST(test_path),
         UTEST(test_path_ext),
+        UTEST(test_path_handle),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -246,6 +246,52 @@ test_defaults(void **state)
     lyd_free_all(tree);
 }
 
+static void
+test_print_size(void **state)
+{
+    struct lyd_node *tree;
+    const char *data;
+    char *printed, *buf;
+    size_t size;
+    struct ly_out *out;
+
+    data = "<list xmlns=\"urn:tests:types\"><id>a</id><value>x</value><targets>1</targets><targets>2</targets></list>"
+            "<list xmlns=\"urn:tests:types\"><id>b</id></list>"
+            "<int8 xmlns=\"urn:tests:types\">15</int8>";
+    CHECK_PARSE_LYD(data, 0, LYD_VALIDATE_PRESENT, tree);
+
+    /* XML */
+    assert_int_equal(LY_SUCCESS, lyd_print_size(tree, LYD_XML, LYD_PRINT_WITHSIBLINGS, &size));
+    assert_int_equal(LY_SUCCESS, lyd_print_mem(&printed, tree, LYD_XML, LYD_PRINT_WITHSIBLINGS));
+    assert_int_equal(size, strlen(printed));
+    free(printed);
+
+    assert_int_equal(LY_SUCCESS, lyd_print_size(tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_WD_ALL, &size));
+    assert_int_equal(LY_SUCCESS, lyd_print_mem(&printed, tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_WD_ALL));
+    assert_int_equal(size, strlen(printed));
+    free(printed);
+
+    /* JSON */
+    assert_int_equal(LY_SUCCESS, lyd_print_size(tree, LYD_JSON, LYD_PRINT_WITHSIBLINGS, &size));
+    assert_int_equal(LY_SUCCESS, lyd_print_mem(&printed, tree, LYD_JSON, LYD_PRINT_WITHSIBLINGS));
+    assert_int_equal(size, strlen(printed));
+    free(printed);
+
+    /* print into a buffer of the exact size */
+    assert_int_equal(LY_SUCCESS, lyd_print_size(tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK, &size));
+    buf = malloc(size + 1);
+    assert_non_null(buf);
+    printed = buf;
+    assert_int_equal(LY_SUCCESS, ly_out_new_memory(&printed, size + 1, &out));
+    assert_int_equal(LY_SUCCESS, lyd_print_all(out, tree, LYD_XML, LYD_PRINT_SHRINK));
+    assert_int_equal(size, ly_out_printed(out));
+    assert_ptr_equal(buf, printed);
+    assert_string_equal(printed, data);
+    ly_out_free(out, NULL, 1);
+
+    lyd_free_all(tree);
+}
+
 #if 0
 
 static void
@@ -337,6 +383,7 @@ main(void)
     const struct CMUnitTest tests[] = {
         UTEST(test_anydata, setup),
         UTEST(test_defaults, setup),
+        UTEST(test_print_size, setup),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -409,7 +409,8 @@ static void
 test_list_pos(void **state)
 {
     const char *data;
-    struct lyd_node *tree;
+    struct lyd_node *tree, *parent, *node, *iter;
+    uint32_t order;
 
     data = "<bar xmlns=\"urn:tests:a\">test</bar>"
             "<l1 xmlns=\"urn:tests:a\"><a>one</a><b>one</b></l1>"
@@ -447,6 +448,61 @@ test_list_pos(void **state)
     assert_int_equal(2, lyd_list_pos(tree->next->next->next->next));
     assert_int_equal(3, lyd_list_pos(tree->next->next->next->next->next));
     lyd_free_all(tree);
+
+    data = "<c xmlns=\"urn:tests:a\"><x>a</x><x>b</x><x>c</x><x>d</x><x>e</x></c>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, 0, LYD_VALIDATE_PRESENT, &tree));
+    node = lyd_child(tree);
+    assert_int_equal(5, lyd_list_pos(node->prev));
+
+    /* unlink from the middle */
+    lyd_free_tree(node->next);
+    assert_string_equal("c", lyd_get_value(node->next));
+    assert_int_equal(2, lyd_list_pos(node->next));
+    assert_int_equal(4, lyd_list_pos(node->prev));
+
+    /* unlink the first and the last */
+    node = node->next;
+    lyd_free_tree(node->prev);
+    lyd_free_tree(node->prev);
+    assert_int_equal(1, lyd_list_pos(node));
+    assert_int_equal(2, lyd_list_pos(node->next));
+
+    /* append */
+    assert_int_equal(LY_SUCCESS, lyd_new_term(tree, NULL, "x", "f", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_term(tree, NULL, "x", "g", 0, NULL));
+    assert_string_equal("g", lyd_get_value(node->prev));
+    assert_int_equal(4, lyd_list_pos(node->prev));
+
+    lyd_free_all(tree);
+
+    /* move into the middle, both halves, and to the beginning, the positions stay consecutive without reading */
+    data = "<l2 xmlns=\"urn:tests:a\"><c><d>a</d><d>b</d><d>c</d><d>d</d><d>e</d></c></l2>";
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, 0, LYD_VALIDATE_PRESENT, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/a:l2[1]/c", 0, &parent));
+    node = lyd_child(parent);
+    assert_int_equal(LY_SUCCESS, lyd_insert_after(node, node->next->next->next));
+    assert_int_equal(LY_SUCCESS, lyd_insert_before(node->prev, node));
+    node = lyd_child(parent);
+    assert_int_equal(LY_SUCCESS, lyd_insert_before(node, node->next->next));
+    node = lyd_child(parent);
+    assert_string_equal("c", lyd_get_value(node));
+    assert_string_equal("d", lyd_get_value(node->next));
+    assert_string_equal("b", lyd_get_value(node->next->next));
+    assert_string_equal("a", lyd_get_value(node->next->next->next));
+    LY_LIST_FOR(node->next, iter) {
+        assert_int_equal(iter->prev->order + 1, iter->order);
+    }
+    order = node->order;
+    assert_int_equal(5, lyd_list_pos(node->prev));
+    assert_int_equal(order, node->order);
+
+    /* unlink from the first half */
+    lyd_free_tree(node->next);
+    LY_LIST_FOR(node->next, iter) {
+        assert_int_equal(iter->prev->order + 1, iter->order);
+    }
+    assert_int_equal(4, lyd_list_pos(node->prev));
+    lyd_free_all(tree);
 }
 
 static void
@@ -528,6 +584,105 @@ test_data_hash(void **state)
     lyd_free_all(tree);
 }
 
+static void
+test_insert_bulk(void **state)
+{
+    struct lyd_node *cont, *nodes[200], *node, *first;
+    char buf[32];
+    uint32_t i;
+
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, UTEST_LYCTX, "/c:cont/nexthop[gateway='gw']", NULL, 0, &cont));
+
+    /* interleaved leaf-list and list instances */
+    for (i = 0; i < 100; ++i) {
+        sprintf(buf, "fc00:%" PRIx32 "::/64", i);
+        assert_int_equal(LY_SUCCESS, lyd_new_term(cont, NULL, "pref", buf, 0, &nodes[2 * i]));
+        sprintf(buf, "gw%" PRIu32, i);
+        assert_int_equal(LY_SUCCESS, lyd_new_list(cont, NULL, "nexthop", 0, &nodes[2 * i + 1], buf));
+    }
+    for (i = 0; i < 200; ++i) {
+        lyd_unlink_tree(nodes[i]);
+    }
+    assert_int_equal(LY_SUCCESS, lyd_insert_child_bulk(cont, nodes, 200));
+
+    /* ordered by schema, instances in the original order after the existing ones */
+    node = lyd_child(cont);
+    assert_string_equal(lyd_get_value(lyd_child(node)), "gw");
+    for (i = 0; i < 100; ++i) {
+        node = node->next;
+        assert_ptr_equal(node, nodes[2 * i + 1]);
+    }
+    for (i = 0; i < 100; ++i) {
+        node = node->next;
+        assert_ptr_equal(node, nodes[2 * i]);
+    }
+    assert_null(node->next);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(cont, "/c:cont/nexthop[gateway='gw57']", 0, &node));
+    assert_ptr_equal(node, nodes[115]);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(cont, "/c:cont/pref[.='fc00:3::/64']", 0, &node));
+    assert_ptr_equal(node, nodes[6]);
+
+    /* duplicate instance, nothing is inserted */
+    assert_int_equal(LY_SUCCESS, lyd_new_list(cont, NULL, "nexthop", 0, &nodes[0], "gw200"));
+    lyd_unlink_tree(nodes[0]);
+    assert_int_equal(LY_SUCCESS, lyd_dup_single(nodes[11], NULL, LYD_DUP_RECURSIVE, &nodes[1]));
+    assert_int_equal(LY_EEXIST, lyd_insert_child_bulk(cont, nodes, 2));
+    CHECK_LOG_CTX("Duplicate instance of \"nexthop\".", NULL);
+    assert_null(nodes[0]->parent);
+    assert_int_equal(LY_ENOTFOUND, lyd_find_sibling_first(lyd_child(cont), nodes[0], NULL));
+    lyd_free_tree(nodes[1]);
+    assert_int_equal(LY_SUCCESS, lyd_dup_single(nodes[0], NULL, LYD_DUP_RECURSIVE, &nodes[1]));
+    assert_int_equal(LY_EEXIST, lyd_insert_child_bulk(cont, nodes, 2));
+    CHECK_LOG_CTX("Duplicate instance of \"nexthop\".", NULL);
+    lyd_free_tree(nodes[0]);
+    lyd_free_tree(nodes[1]);
+
+    /* failed insert of nodes from another tree, which is left unchanged */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, UTEST_LYCTX, "/c:cont/nexthop[gateway='gw300']", NULL, 0, &first));
+    assert_int_equal(LY_SUCCESS, lyd_new_list(first, NULL, "nexthop", 0, &nodes[1], "gw11"));
+    assert_int_equal(LY_SUCCESS, lyd_new_term(first, NULL, "pref", "fc00:300::/64", 0, &nodes[2]));
+    nodes[0] = lyd_child(first);
+    assert_int_equal(LY_EEXIST, lyd_insert_child_bulk(cont, nodes, 3));
+    CHECK_LOG_CTX("Duplicate instance of \"nexthop\".", NULL);
+    nodes[1] = first;
+    assert_int_equal(LY_EINVAL, lyd_insert_child_bulk(cont, nodes, 2));
+    CHECK_LOG_CTX("Cannot insert, parent of \"cont\" is not \"cont\".", NULL);
+    CHECK_LYD_STRING_PARAM(first,
+            "<cont xmlns=\"http://example.com/main\">\n"
+            "  <nexthop>\n"
+            "    <gateway>gw300</gateway>\n"
+            "  </nexthop>\n"
+            "  <nexthop>\n"
+            "    <gateway>gw11</gateway>\n"
+            "  </nexthop>\n"
+            "  <pref>fc00:300::/64</pref>\n"
+            "</cont>\n",
+            LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    assert_ptr_equal(lyd_parent(nodes[0]), first);
+    assert_ptr_equal(lyd_parent(nodes[2]), first);
+    assert_int_equal(LY_ENOTFOUND, lyd_find_sibling_first(lyd_child(cont), nodes[2], NULL));
+    lyd_free_tree(first);
+
+    /* node list inserted by lyd_insert_child() */
+    lyd_free_tree(cont);
+    assert_int_equal(LY_SUCCESS, lyd_new_path(NULL, UTEST_LYCTX, "/c:cont/pref", "fc00::/64", 0, &cont));
+    assert_int_equal(LY_SUCCESS, lyd_new_list(cont, NULL, "nexthop", 0, NULL, "gw"));
+    assert_int_equal(LY_SUCCESS, lyd_new_term(cont, NULL, "pref", "fc00:1::/64", 0, NULL));
+    first = lyd_child(cont);
+    lyd_unlink_siblings(first);
+    assert_int_equal(LY_SUCCESS, lyd_insert_child(cont, first));
+    CHECK_LYD_STRING_PARAM(cont,
+            "<cont xmlns=\"http://example.com/main\">\n"
+            "  <nexthop>\n"
+            "    <gateway>gw</gateway>\n"
+            "  </nexthop>\n"
+            "  <pref>fc00::/64</pref>\n"
+            "  <pref>fc00:1::/64</pref>\n"
+            "</cont>\n",
+            LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    lyd_free_all(cont);
+}
+
 static void
 test_lyxp_vars(void **UNUSED(state))
 {
@@ -590,6 +745,7 @@ main(void)
         UTEST(test_first_sibling, setup),
         UTEST(test_find_path, setup),
         UTEST(test_data_hash, setup),
+        UTEST(test_insert_bulk, setup),
         UTEST(test_lyxp_vars),
     };
 
@@ -1393,6 +1393,482 @@ test_case(void **state)
             "Schema location \"/k:ch/a0\", data location \"/k:ch\", line number 5.");
 }
 
+/**
+ * @brief Validate changes of a tree incrementally, using a diff from its valid base.
+ */
+static LY_ERR
+validate_changes(const struct lyd_node *base, struct lyd_node **tree, struct lyd_node **val_diff)
+{
+    LY_ERR ret;
+    struct lyd_node *diff;
+
+    assert_int_equal(LY_SUCCESS, lyd_diff_siblings(base, *tree, 0, &diff));
+    ret = lyd_validate_diff(tree, diff, 0, val_diff);
+    lyd_free_all(diff);
+    return ret;
+}
+
+static void
+test_diff(void **state)
+{
+    struct lyd_node *base, *tree, *node, *val_diff;
+    const char *schema =
+            "module l {\n"
+            "  namespace urn:tests:l;\n"
+            "  prefix l;\n"
+            "  yang-version 1.1;\n"
+            "\n"
+            "  list item {\n"
+            "    key name;\n"
+            "    unique size;\n"
+            "    unique \"c/x\";\n"
+            "    leaf name {type string;}\n"
+            "    leaf size {type uint32;}\n"
+            "    leaf ref {type leafref {path /l:target;}}\n"
+            "    container c {leaf x {type string;}}\n"
+            "  }\n"
+            "  leaf-list target {type string;}\n"
+            "  leaf limit {\n"
+            "    type uint32;\n"
+            "    must \". >= count(/l:item)\";\n"
+            "  }\n"
+            "  leaf enable {type boolean;}\n"
+            "  container opt {\n"
+            "    presence \"\";\n"
+            "    when \"/l:enable = 'true'\";\n"
+            "    leaf x {type string;}\n"
+            "  }\n"
+            "  leaf mand {type string; mandatory true;}\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    LYD_TREE_CREATE("<item xmlns=\"urn:tests:l\"><name>a</name><size>1</size><ref>t1</ref></item>"
+            "<target xmlns=\"urn:tests:l\">t1</target><target xmlns=\"urn:tests:l\">t2</target>"
+            "<limit xmlns=\"urn:tests:l\">2</limit><enable xmlns=\"urn:tests:l\">true</enable>"
+            "<opt xmlns=\"urn:tests:l\"><x>val</x></opt><mand xmlns=\"urn:tests:l\">m</mand>", base);
+
+    /* no changes */
+    tree = base;
+    assert_int_equal(LY_SUCCESS, lyd_validate_diff(&tree, NULL, 0, NULL));
+
+    /* valid change */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/l:item[name='b']/ref", "t2", 0, NULL));
+    assert_int_equal(LY_SUCCESS, validate_changes(base, &tree, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    lyd_free_all(tree);
+
+    /* deleted leafref target */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/l:target[.='t1']", 0, &node));
+    lyd_free_tree(node);
+    assert_int_equal(LY_EVALID, validate_changes(base, &tree, NULL));
+    CHECK_LOG_CTX_APPTAG("Invalid leafref value \"t1\" - no target instance \"/l:target\" with the same value.",
+            "Schema location \"/l:item/ref\", data location \"/l:item[name='a']/ref\".", "instance-required");
+    lyd_free_all(tree);
+
+    /* unique violated by a new instance */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/l:item[name='b']/size", "1", 0, NULL));
+    assert_int_equal(LY_EVALID, validate_changes(base, &tree, NULL));
+    CHECK_LOG_CTX_APPTAG("Unique data leaf(s) \"size\" not satisfied in \"/l:item[name='a']\" and "
+            "\"/l:item[name='b']\".",
+            "Schema location \"/l:item\", data location \"/l:item[name='b']\".", "data-not-unique");
+    lyd_free_all(tree);
+
+    /* unique violated by a changed descendant of an existing instance */
+    assert_int_equal(LY_SUCCESS, lyd_new_path(base, NULL, "/l:item[name='a']/c/x", "x1", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(base, NULL, "/l:item[name='b']/c/x", "x2", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/l:item[name='b']/c/x", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "x1"));
+    assert_int_equal(LY_EVALID, validate_changes(base, &tree, NULL));
+    CHECK_LOG_CTX_APPTAG("Unique data leaf(s) \"c/x\" not satisfied in \"/l:item[name='a']\" and "
+            "\"/l:item[name='b']\".",
+            "Schema location \"/l:item\", data location \"/l:item[name='b']\".", "data-not-unique");
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LOG_CTX_APPTAG("Unique data leaf(s) \"c/x\" not satisfied in \"/l:item[name='a']\" and "
+            "\"/l:item[name='b']\".",
+            "Schema location \"/l:item\", data location \"/l:item[name='b']\".", "data-not-unique");
+    lyd_free_all(tree);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(base, "/l:item[name='a']/c", 0, &node));
+    lyd_free_tree(node);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(base, "/l:item[name='b']", 0, &node));
+    lyd_free_tree(node);
+
+    /* must of an unchanged node referencing the changed nodes */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/l:item[name='b']", NULL, 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/l:item[name='c']", NULL, 0, NULL));
+    assert_int_equal(LY_EVALID, validate_changes(base, &tree, NULL));
+    CHECK_LOG_CTX_APPTAG("Must condition \". >= count(/l:item)\" not satisfied.",
+            "Schema location \"/l:limit\", data location \"/l:limit\".", "must-violation");
+    lyd_free_all(tree);
+
+    /* deleted mandatory node */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/l:mand", 0, &node));
+    lyd_free_tree(node);
+    assert_int_equal(LY_EVALID, validate_changes(base, &tree, NULL));
+    CHECK_LOG_CTX("Mandatory node \"mand\" instance does not exist.", "Schema location \"/l:mand\".");
+    lyd_free_all(tree);
+
+    /* when of an unchanged node becomes false */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/l:enable", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "false"));
+    assert_int_equal(LY_SUCCESS, validate_changes(base, &tree, &val_diff));
+    assert_int_equal(LY_ENOTFOUND, lyd_find_path(tree, "/l:opt", 0, NULL));
+    CHECK_LYD_STRING_PARAM(val_diff,
+            "<opt xmlns=\"urn:tests:l\" xmlns:yang=\"urn:ietf:params:xml:ns:yang:1\" yang:operation=\"delete\">\n"
+            "  <x>val</x>\n"
+            "</opt>\n", LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    lyd_free_all(val_diff);
+    lyd_free_all(tree);
+    lyd_free_all(base);
+
+    /* constraints not affected by the changes are not evaluated */
+    CHECK_PARSE_LYD_PARAM("<item xmlns=\"urn:tests:l\"><name>a</name></item>"
+            "<item xmlns=\"urn:tests:l\"><name>b</name></item><limit xmlns=\"urn:tests:l\">1</limit>"
+            "<mand xmlns=\"urn:tests:l\">m</mand>", LYD_XML, LYD_PARSE_ONLY, 0,
+            LY_SUCCESS, base);
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/l:mand", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "n"));
+    assert_int_equal(LY_SUCCESS, validate_changes(base, &tree, NULL));
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LOG_CTX_APPTAG("Must condition \". >= count(/l:item)\" not satisfied.",
+            "Schema location \"/l:limit\", data location \"/l:limit\".", "must-violation");
+    lyd_free_all(tree);
+    lyd_free_all(base);
+
+    /* dependencies of a newly compiled module */
+    UTEST_ADD_MODULE("module l2 {namespace urn:tests:l2; prefix l2; import l {prefix l;}"
+            "leaf max {type uint32; must \". >= count(/l:item)\";}}", LYS_IN_YANG, NULL, NULL);
+    CHECK_PARSE_LYD_PARAM("<item xmlns=\"urn:tests:l\"><name>a</name></item><mand xmlns=\"urn:tests:l\">m</mand>"
+            "<max xmlns=\"urn:tests:l2\">1</max>", LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, base);
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &tree));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "/l:item[name='b']", NULL, 0, NULL));
+    assert_int_equal(LY_EVALID, validate_changes(base, &tree, NULL));
+    CHECK_LOG_CTX_APPTAG("Must condition \". >= count(/l:item)\" not satisfied.",
+            "Schema location \"/l2:max\", data location \"/l2:max\".", "must-violation");
+    lyd_free_all(tree);
+    lyd_free_all(base);
+}
+
+/**
+ * @brief Validate a copy of a tree both serially and by worker threads and check the results are the same.
+ */
+static LY_ERR
+validate_threaded(const struct lyd_node *data)
+{
+    LY_ERR ret, ret_mt;
+    struct lyd_node *tree, *tree_mt;
+    struct ly_err_item *err;
+    char *msg = NULL, *path = NULL, *str, *str_mt;
+
+    /* serial */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(data, NULL, LYD_DUP_RECURSIVE, &tree));
+    ret = lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL);
+    if (ret) {
+        err = ly_err_last(LYD_CTX(data));
+        msg = strdup(err->msg);
+        path = strdup(err->path);
+    }
+
+    /* multi-threaded */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(data, NULL, LYD_DUP_RECURSIVE, &tree_mt));
+    ret_mt = lyd_validate_all(&tree_mt, NULL, LYD_VALIDATE_PRESENT | LYD_VALIDATE_MULTI_THREADED, NULL);
+    assert_int_equal(ret, ret_mt);
+    if (ret) {
+        err = ly_err_last(LYD_CTX(data));
+        assert_string_equal(msg, err->msg);
+        assert_string_equal(path, err->path);
+    } else {
+        assert_int_equal(LY_SUCCESS, lyd_print_mem(&str, tree, LYD_XML, LYD_PRINT_WITHSIBLINGS | LYD_PRINT_WD_ALL_TAG));
+        assert_int_equal(LY_SUCCESS, lyd_print_mem(&str_mt, tree_mt, LYD_XML,
+                LYD_PRINT_WITHSIBLINGS | LYD_PRINT_WD_ALL_TAG));
+        assert_string_equal(str, str_mt);
+        free(str);
+        free(str_mt);
+    }
+
+    free(msg);
+    free(path);
+    lyd_free_all(tree);
+    lyd_free_all(tree_mt);
+    return ret_mt;
+}
+
+static void
+test_multi_threaded(void **state)
+{
+    struct lyd_node *data, *node;
+    char *xml;
+    uint32_t i, len;
+    const char *schema =
+            "module mt {\n"
+            "  namespace urn:tests:mt;\n"
+            "  prefix mt;\n"
+            "  yang-version 1.1;\n"
+            "\n"
+            "  container top {\n"
+            "    list item {\n"
+            "      key name;\n"
+            "      unique size;\n"
+            "      must \"size < 1000\";\n"
+            "      leaf name {type string;}\n"
+            "      leaf size {type uint32;}\n"
+            "      leaf ref {type leafref {path /mt:target;}}\n"
+            "      leaf bin {type binary;}\n"
+            "      leaf mand {type string; mandatory true; when \"../size > 5000\";}\n"
+            "      container sub {\n"
+            "        leaf d {type string; default x;}\n"
+            "      }\n"
+            "    }\n"
+            "    leaf-list small {type string; min-elements 1;}\n"
+            "  }\n"
+            "  leaf-list target {type string;}\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* enough items for several work units */
+    xml = malloc(32768);
+    len = sprintf(xml, "<top xmlns=\"urn:tests:mt\"><small>s</small>");
+    for (i = 0; i < 300; ++i) {
+        len += sprintf(xml + len, "<item><name>i%u</name><size>%u</size><ref>t%u</ref><bin>AAE=</bin></item>",
+                i, i, i % 10);
+    }
+    len += sprintf(xml + len, "</top>");
+    for (i = 0; i < 10; ++i) {
+        len += sprintf(xml + len, "<target xmlns=\"urn:tests:mt\">t%u</target>", i);
+    }
+
+    /* valid data */
+    CHECK_PARSE_LYD_PARAM(xml, LYD_XML, LYD_PARSE_ONLY, 0, LY_SUCCESS, data);
+    assert_int_equal(LY_SUCCESS, validate_threaded(data));
+
+    /* the first of several must and unique errors */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i250']/size", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "2000"));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i200']/size", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "5"));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i20']/size", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "1500"));
+    assert_int_equal(LY_EVALID, validate_threaded(data));
+    CHECK_LOG_CTX_APPTAG("Must condition \"size < 1000\" not satisfied.",
+            "Schema location \"/mt:top/item\", data location \"/mt:top/item[name='i20']\".", "must-violation");
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "20"));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i250']/size", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "250"));
+    assert_int_equal(LY_EVALID, validate_threaded(data));
+    CHECK_LOG_CTX_APPTAG("Unique data leaf(s) \"size\" not satisfied in \"/mt:top/item[name='i200']\" and "
+            "\"/mt:top/item[name='i5']\".",
+            "Schema location \"/mt:top/item\", data location \"/mt:top/item[name='i5']\".", "data-not-unique");
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i200']/size", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "200"));
+
+    /* the first of several leafref errors */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i30']/ref", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "none"));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(data, "/mt:top/item[name='i280']/ref", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "none"));
+    assert_int_equal(LY_EVALID, validate_threaded(data));
+    CHECK_LOG_CTX_APPTAG("Invalid leafref value \"none\" - no target instance \"/mt:target\" with the same value.",
+            "Schema location \"/mt:top/item/ref\", data location \"/mt:top/item[name='i280']/ref\".",
+            "instance-required");
+
+    lyd_free_all(data);
+    free(xml);
+}
+
+static void
+test_stats(void **state)
+{
+    struct lyd_node *tree;
+    struct lyd_val_stat *stats;
+    uint32_t count, i, found = 0;
+    char *report;
+    const char *schema =
+            "module st {\n"
+            "  namespace urn:tests:st;\n"
+            "  prefix st;\n"
+            "  yang-version 1.1;\n"
+            "\n"
+            "  list item {\n"
+            "    key name;\n"
+            "    unique size;\n"
+            "    must \"size < 100\";\n"
+            "    leaf name {type string;}\n"
+            "    leaf size {type uint32;}\n"
+            "    leaf ref {type leafref {path /st:target;}}\n"
+            "    leaf extra {type string; when \"../size > 1\";}\n"
+            "  }\n"
+            "  leaf-list target {type string;}\n"
+            "}";
+    const char *data =
+            "<item xmlns=\"urn:tests:st\"><name>a</name><size>1</size><ref>t</ref></item>"
+            "<item xmlns=\"urn:tests:st\"><name>b</name><size>2</size><ref>t</ref><extra>e</extra></item>"
+            "<item xmlns=\"urn:tests:st\"><name>c</name><size>3</size><ref>t</ref><extra>e</extra></item>"
+            "<target xmlns=\"urn:tests:st\">t</target>";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* not enabled */
+    assert_int_equal(LY_EINVAL, lyd_val_stats_get(UTEST_LYCTX, &stats, &count));
+    CHECK_LOG_CTX("Validation statistics are not enabled.", NULL);
+
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_enable(UTEST_LYCTX, 1));
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_get(UTEST_LYCTX, &stats, &count));
+    assert_int_equal(4, count);
+    for (i = 0; i < count; ++i) {
+        if (i) {
+            /* sorted */
+            assert_true(stats[i - 1].time_ns >= stats[i].time_ns);
+        }
+        switch (stats[i].kind) {
+        case LYD_VAL_STAT_WHEN:
+            assert_string_equal(stats[i].schema->name, "extra");
+            assert_int_equal(stats[i].count, 2);
+            break;
+        case LYD_VAL_STAT_MUST:
+            assert_string_equal(stats[i].schema->name, "item");
+            assert_int_equal(stats[i].count, 3);
+            break;
+        case LYD_VAL_STAT_UNIQUE:
+            assert_string_equal(stats[i].schema->name, "item");
+            assert_int_equal(stats[i].count, 1);
+            break;
+        case LYD_VAL_STAT_LEAFREF:
+            assert_string_equal(stats[i].schema->name, "ref");
+            assert_int_equal(stats[i].count, 3);
+            break;
+        case LYD_VAL_STAT_TYPE:
+            fail();
+        }
+        found |= 1 << stats[i].kind;
+    }
+    assert_int_equal(found, 0xF);
+    free(stats);
+
+    /* printed report, the statistics accumulate */
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_print(UTEST_LYCTX, &report));
+    assert_non_null(strstr(report, "/st:item/extra"));
+    assert_non_null(strstr(report, "leafref"));
+    free(report);
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_get(UTEST_LYCTX, &stats, &count));
+    assert_int_equal(4, count);
+    for (i = 0; i < count; ++i) {
+        if (stats[i].kind == LYD_VAL_STAT_MUST) {
+            assert_int_equal(stats[i].count, 6);
+        }
+    }
+    free(stats);
+
+    /* restarting discards the statistics */
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_enable(UTEST_LYCTX, 1));
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_get(UTEST_LYCTX, &stats, &count));
+    assert_int_equal(0, count);
+    assert_null(stats);
+
+    /* collected by the worker threads the same */
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT | LYD_VALIDATE_MULTI_THREADED,
+            NULL));
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_get(UTEST_LYCTX, &stats, &count));
+    assert_int_equal(4, count);
+    for (i = 0; i < count; ++i) {
+        if ((stats[i].kind == LYD_VAL_STAT_MUST) || (stats[i].kind == LYD_VAL_STAT_LEAFREF)) {
+            assert_int_equal(stats[i].count, 3);
+        }
+    }
+    free(stats);
+
+    /* compiling a module discards the statistics */
+    UTEST_ADD_MODULE("module st2 {namespace urn:tests:st2; prefix st2; leaf l {type string;}}", LYS_IN_YANG, NULL, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_get(UTEST_LYCTX, &stats, &count));
+    assert_int_equal(0, count);
+    assert_null(stats);
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_print(UTEST_LYCTX, &report));
+    free(report);
+
+    assert_int_equal(LY_SUCCESS, lyd_val_stats_enable(UTEST_LYCTX, 0));
+    lyd_free_all(tree);
+}
+
+static void
+test_when_cached(void **state)
+{
+    struct lyd_node *tree;
+    char *xml;
+    uint32_t i, len;
+    const char *schema =
+            "module wc {\n"
+            "  namespace urn:tests:wc;\n"
+            "  prefix wc;\n"
+            "  yang-version 1.1;\n"
+            "\n"
+            "  leaf enabled {type boolean;}\n"
+            "  list item {\n"
+            "    key name;\n"
+            "    must \"count(/wc:item) < 60\";\n"
+            "    leaf name {type string;}\n"
+            "    leaf b {type string; when \"/wc:enabled = 'true' and ../name != 'i0'\";}\n"
+            "    leaf c {type string; when \"count(/wc:item/wc:d) = 3\";}\n"
+            "    leaf d {type string; when \"/wc:enabled = 'true' or ../name != 'i1'\";}\n"
+            "  }\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* the context-dependent part of a when is evaluated for every instance */
+    xml = malloc(8192);
+    len = sprintf(xml, "<enabled xmlns=\"urn:tests:wc\">true</enabled>");
+    for (i = 0; i < 50; ++i) {
+        len += sprintf(xml + len, "<item xmlns=\"urn:tests:wc\"><name>i%u</name><b>b</b></item>", i);
+    }
+    CHECK_PARSE_LYD_PARAM(xml, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX("When condition \"/wc:enabled = 'true' and ../name != 'i0'\" not satisfied.",
+            "Schema location \"/wc:item/b\", data location \"/wc:item[name='i0']/b\".");
+
+    /* the whole must is evaluated once */
+    len = sprintf(xml, "<enabled xmlns=\"urn:tests:wc\">true</enabled>");
+    for (i = 1; i < 61; ++i) {
+        len += sprintf(xml + len, "<item xmlns=\"urn:tests:wc\"><name>i%u</name><b>b</b></item>", i);
+    }
+    CHECK_PARSE_LYD_PARAM(xml, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX_APPTAG("Must condition \"count(/wc:item) < 60\" not satisfied.",
+            "Schema location \"/wc:item\", data location \"/wc:item[name='i1']\".", "must-violation");
+    free(xml);
+
+    /* the results cached before a node is auto-deleted are not used after it */
+    CHECK_PARSE_LYD_PARAM("<enabled xmlns=\"urn:tests:wc\">true</enabled>"
+            "<item xmlns=\"urn:tests:wc\"><name>i0</name><c>c</c><d>d</d></item>"
+            "<item xmlns=\"urn:tests:wc\"><name>i1</name><c>c</c><d>d</d></item>"
+            "<item xmlns=\"urn:tests:wc\"><name>i2</name><c>c</c><d>d</d></item>",
+            LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    assert_int_equal(LY_SUCCESS, lyd_change_term(tree, "false"));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LYD_STRING_PARAM(tree, "<enabled xmlns=\"urn:tests:wc\">false</enabled>\n"
+            "<item xmlns=\"urn:tests:wc\">\n"
+            "  <name>i0</name>\n"
+            "  <d>d</d>\n"
+            "</item>\n"
+            "<item xmlns=\"urn:tests:wc\">\n"
+            "  <name>i1</name>\n"
+            "</item>\n"
+            "<item xmlns=\"urn:tests:wc\">\n"
+            "  <name>i2</name>\n"
+            "  <c>c</c>\n"
+            "  <d>d</d>\n"
+            "</item>\n", LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    lyd_free_all(tree);
+}
+
 int
 main(void)
 {
@@ -1411,6 +1887,10 @@ main(void)
         UTEST(test_rpc),
         UTEST(test_reply),
         UTEST(test_case),
+        UTEST(test_diff),
+        UTEST(test_multi_threaded),
+        UTEST(test_stats),
+        UTEST(test_when_cached),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
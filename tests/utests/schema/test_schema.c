@@ -41,6 +41,8 @@ test_imp_clb(const char *UNUSED(mod_name), const char *UNUSED(mod_rev), const ch
  */
 /* test_schema_common.c */
 void test_getnext(void **state);
+void test_find_child(void **state);
+void test_children_flat(void **state);
 void test_date(void **state);
 void test_revisions(void **state);
 void test_collision_typedef(void **state);
@@ -66,6 +68,8 @@ main(void)
     const struct CMUnitTest tests[] = {
         /** test_schema_common.c */
         UTEST(test_getnext),
+        UTEST(test_find_child),
+        UTEST(test_children_flat),
         UTEST(test_date),
         UTEST(test_revisions),
         UTEST(test_collision_typedef),
@@ -156,6 +156,151 @@ test_getnext(void **state)
     assert_string_equal("a", node->name);
 }
 
+void
+test_find_child(void **state)
+{
+    struct lys_module *mod, *mod2;
+    const struct lysc_node *cont, *rpc, *node;
+
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module a {yang-version 1.1; namespace urn:a;prefix a;"
+            "feature f;"
+            "container c {leaf l0 {type string;} leaf l1 {type string;} leaf l2 {type string;} leaf l3 {type string;}"
+            "  leaf l4 {type string;} leaf l5 {if-feature f; type string;}"
+            "  leaf l6 {type string;} leaf l7 {type string;}"
+            "  choice ch {case ca {leaf in-case {type string;}}} container np;"
+            "  action act {input {leaf i0 {type string;} leaf i1 {type string;} leaf i2 {type string;}"
+            "    leaf i3 {type string;} leaf i4 {type string;} leaf i5 {type string;} leaf i6 {type string;}"
+            "    leaf i7 {type string;}}"
+            "    output {leaf i0 {type int8;}}}"
+            "  notification n;}"
+            "leaf t0 {type string;} leaf t1 {type string;} leaf t2 {type string;} leaf t3 {type string;}"
+            "leaf t4 {type string;} leaf t5 {type string;} leaf t6 {type string;} rpc r;}", LYS_IN_YANG, &mod));
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module b {namespace urn:b;prefix b;import a {prefix a;}"
+            "augment /a:c {leaf l0 {type int8;}}}", LYS_IN_YANG, &mod2));
+
+    /* top-level nodes */
+    assert_non_null(mod->compiled->children_ht);
+    assert_non_null(node = lys_find_child(NULL, mod, "t3", 0, 0, 0));
+    assert_string_equal("t3", node->name);
+    assert_non_null(node = lys_find_child(NULL, mod, "r", 0, LYS_RPC, 0));
+    assert_null(lys_find_child(NULL, mod2, "t3", 0, 0, 0));
+
+    /* children of a container, including augments */
+    cont = lys_find_child(NULL, mod, "c", 0, LYS_CONTAINER, 0);
+    assert_non_null(((struct lysc_node_container *)cont)->children_ht);
+    assert_non_null(node = lys_find_child(cont, mod, "l0", 0, 0, 0));
+    assert_ptr_equal(node->module, mod);
+    assert_non_null(node = lys_find_child(cont, mod2, "l0", 0, 0, 0));
+    assert_ptr_equal(node->module, mod2);
+    assert_non_null(node = lys_find_child(cont, mod, "l3xyz", 2, 0, 0));
+    assert_string_equal("l3", node->name);
+    assert_non_null(node = lys_find_child(cont, mod, "in-case", 0, 0, 0));
+    assert_string_equal("ca", node->parent->name);
+    assert_non_null(lys_find_child(cont, mod, "n", 0, LYS_NOTIF, 0));
+    assert_null(lys_find_child(cont, mod, "l1", 0, LYS_CONTAINER, 0));
+    assert_null(lys_find_child(cont, mod, "l5", 0, 0, 0));
+    assert_null(lys_find_child(cont, mod, "ch", 0, 0, 0));
+
+    /* options not supported by the hash table */
+    assert_non_null(node = lys_find_child(cont, mod, "ca", 0, LYS_CASE, LYS_GETNEXT_WITHCASE));
+    assert_int_equal(LYS_CASE, node->nodetype);
+
+    /* input and output */
+    assert_non_null(rpc = lys_find_child(cont, mod, "act", 0, LYS_ACTION, 0));
+    assert_non_null(((struct lysc_node_action *)rpc)->input.children_ht);
+    assert_null(((struct lysc_node_action *)rpc)->output.children_ht);
+    assert_non_null(node = lys_find_child(rpc, mod, "i7", 0, 0, 0));
+    assert_int_equal(LYS_INPUT, node->parent->nodetype);
+    assert_non_null(node = lys_find_child(rpc, mod, "i0", 0, 0, LYS_GETNEXT_OUTPUT));
+    assert_int_equal(LYS_OUTPUT, node->parent->nodetype);
+    assert_null(lys_find_child(rpc, mod, "i7", 0, 0, LYS_GETNEXT_OUTPUT));
+}
+
+/**
+ * @brief Check that iterating the precomputed children returns the same nodes as lys_getnext().
+ */
+static void
+check_children_flat(const struct lysc_node *parent, const struct lysc_module *module, uint32_t options,
+        LY_ARRAY_COUNT_TYPE count)
+{
+    const struct lysc_node *iter = NULL, *node = NULL;
+    LY_ARRAY_COUNT_TYPE idx = 0, i = 0, u;
+
+    while ((iter = lys_getnext(iter, parent, module, options))) {
+        node = lys_getnext_idx(node, parent, module, options, &idx);
+        assert_ptr_equal(iter, node);
+        assert_int_equal(i, idx);
+        assert_int_equal(LY_SUCCESS, lysc_node_child_idx(parent, module, iter, options, &u));
+        assert_int_equal(i, u);
+        ++i;
+    }
+    assert_null(lys_getnext_idx(node, parent, module, options, &idx));
+    assert_int_equal(count, i);
+}
+
+void
+test_children_flat(void **state)
+{
+    struct lys_module *mod;
+    const struct lysc_node *cont, *ch, *cs, *act, *node;
+    LY_ARRAY_COUNT_TYPE idx;
+
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module a {yang-version 1.1; namespace urn:a;prefix a;"
+            "feature f;"
+            "container c {leaf l0 {type string;} leaf l1 {if-feature f; type string;}"
+            "  choice ch {case ca {leaf a0 {type string;} choice ch2 {leaf b0 {type string;}}} leaf c0 {type string;}}"
+            "  container np; leaf l2 {type string;}"
+            "  action act {input {leaf i0 {type string;}} output {leaf o0 {type string;} leaf o1 {type string;}}}"
+            "  notification n;}"
+            "leaf t0 {type string;} choice tch {leaf t1 {type string;}} rpc r; notification tn;}", LYS_IN_YANG, &mod));
+
+    /* top-level nodes */
+    assert_int_equal(5, LY_ARRAY_COUNT(mod->compiled->children_flat));
+    assert_int_equal(5, LY_ARRAY_COUNT(mod->compiled->children_choice));
+    check_children_flat(NULL, mod->compiled, 0, 5);
+    check_children_flat(NULL, mod->compiled, LYS_GETNEXT_WITHCHOICE, 5);
+
+    /* container, disabled nodes are skipped, choices and cases are flattened */
+    cont = lys_find_child(NULL, mod, "c", 0, LYS_CONTAINER, 0);
+    assert_int_equal(8, LY_ARRAY_COUNT(((struct lysc_node_container *)cont)->children_flat));
+    assert_int_equal(6, LY_ARRAY_COUNT(((struct lysc_node_container *)cont)->children_choice));
+    check_children_flat(cont, NULL, 0, 8);
+    check_children_flat(cont, NULL, LYS_GETNEXT_WITHCHOICE, 6);
+    assert_non_null(node = lys_find_child(cont, mod, "l2", 0, 0, 0));
+    assert_int_equal(LY_SUCCESS, lysc_node_child_idx(cont, NULL, node, 0, &idx));
+    assert_int_equal(5, idx);
+
+    /* choice and case */
+    ch = ((struct lysc_node_container *)cont)->children_choice[1];
+    assert_int_equal(LYS_CHOICE, ch->nodetype);
+    assert_int_equal(3, LY_ARRAY_COUNT(((struct lysc_node_choice *)ch)->children_flat));
+    check_children_flat(ch, NULL, 0, 3);
+    cs = lysc_node_child(ch);
+    assert_int_equal(2, LY_ARRAY_COUNT(((struct lysc_node_case *)cs)->children_flat));
+    assert_int_equal(2, LY_ARRAY_COUNT(((struct lysc_node_case *)cs)->children_choice));
+    check_children_flat(cs, NULL, 0, 2);
+    check_children_flat(cs, NULL, LYS_GETNEXT_WITHCHOICE, 2);
+
+    /* input and output */
+    act = lys_find_child(cont, mod, "act", 0, LYS_ACTION, 0);
+    check_children_flat(act, NULL, 0, 1);
+    check_children_flat(act, NULL, LYS_GETNEXT_OUTPUT, 2);
+    assert_non_null(node = lys_find_child(act, mod, "o1", 0, 0, LYS_GETNEXT_OUTPUT));
+    assert_int_equal(LY_ENOT, lysc_node_child_idx(act, NULL, node, 0, &idx));
+    assert_int_equal(LY_SUCCESS, lysc_node_child_idx(act, NULL, node, LYS_GETNEXT_OUTPUT, &idx));
+    assert_int_equal(1, idx);
+
+    /* wrong index hint */
+    idx = 1;
+    node = lys_find_child(act, mod, "o0", 0, 0, LYS_GETNEXT_OUTPUT);
+    assert_non_null(node = lys_getnext_idx(node, act, NULL, LYS_GETNEXT_OUTPUT, &idx));
+    assert_string_equal("o1", node->name);
+    assert_int_equal(1, idx);
+
+    /* options not precomputed */
+    assert_int_equal(LY_ENOT, lysc_node_child_idx(cont, NULL, node, LYS_GETNEXT_WITHCASE, &idx));
+}
+
 void
 test_date(void **state)
 {
@@ -1685,6 +1685,80 @@ test_identity(void **state)
 #undef RESET_CTX
 }
 
+static ly_bool
+identity_isderived_walk(const struct lysc_ident *base, const struct lysc_ident *der)
+{
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_ARRAY_FOR(base->derived, u) {
+        if ((base->derived[u] == der) || identity_isderived_walk(base->derived[u], der)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void
+check_identity_closure(const struct ly_ctx *ctx)
+{
+    uint32_t i, j;
+    LY_ARRAY_COUNT_TYPE u, v;
+    const struct lys_module *mod1, *mod2;
+
+    /* the precomputed closure must match walking the derived identities */
+    i = 0;
+    while ((mod1 = ly_ctx_get_module_iter(ctx, &i))) {
+        LY_ARRAY_FOR(mod1->identities, u) {
+            j = 0;
+            while ((mod2 = ly_ctx_get_module_iter(ctx, &j))) {
+                LY_ARRAY_FOR(mod2->identities, v) {
+                    assert_int_equal(identity_isderived_walk(&mod1->identities[u], &mod2->identities[v]),
+                            !lyplg_type_identity_isderived(&mod1->identities[u], &mod2->identities[v]));
+                }
+            }
+        }
+    }
+}
+
+static void
+test_identity_closure(void **state)
+{
+    const char *str;
+    struct lys_module *mod_a, *mod;
+
+    /* bases defined after the derived identities, multiple bases */
+    str = "module a {yang-version 1.1; namespace urn:a; prefix a;"
+            "identity d {base b; base c;}"
+            "identity b {base a;}"
+            "identity c {base a;}"
+            "identity a;"
+            "identity e {base d;}"
+            "identity f;"
+            "}";
+    UTEST_ADD_MODULE(str, LYS_IN_YANG, NULL, &mod_a);
+    check_identity_closure(UTEST_LYCTX);
+
+    /* identities derived from the existing ones */
+    str = "module b {yang-version 1.1; namespace urn:b; prefix b; import a {prefix a;}"
+            "identity g {base a:e; base a:f;}"
+            "identity h {base g;}"
+            "}";
+    UTEST_ADD_MODULE(str, LYS_IN_YANG, NULL, &mod);
+    check_identity_closure(UTEST_LYCTX);
+    /* h is derived from a through g, e, and d */
+    assert_int_equal(LY_SUCCESS, lyplg_type_identity_isderived(&mod_a->identities[3], &mod->identities[1]));
+    assert_int_equal(LY_ENOTFOUND, lyplg_type_identity_isderived(&mod->identities[1], &mod->identities[1]));
+
+    /* failed module does not affect the others */
+    str = "module c {namespace urn:c; prefix c; import b {prefix b;}"
+            "identity i {base b:h;}"
+            "identity j {base k;}"
+            "}";
+    assert_int_equal(LY_EVALID, lys_parse_mem(UTEST_LYCTX, str, LYS_IN_YANG, NULL));
+    CHECK_LOG_CTX("Unable to find base (k) of identity \"j\".", "/c:{identity='j'}");
+    check_identity_closure(UTEST_LYCTX);
+}
+
 static void
 test_type_identityref(void **state)
 {
@@ -3811,6 +3885,7 @@ main(void)
         UTEST(test_type_dec64, setup),
         UTEST(test_type_instanceid, setup),
         UTEST(test_identity, setup),
+        UTEST(test_identity_closure, setup),
         UTEST(test_type_identityref, setup),
         UTEST(test_type_leafref, setup),
         UTEST(test_type_empty, setup),
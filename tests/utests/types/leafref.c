@@ -157,6 +157,50 @@ test_data_xml(void **state)
             "Schema location \"/defs:lref\", data location \"/defs:lref\".", "instance-required");
 }
 
+static void
+test_data_cached(void **state)
+{
+    const char *schema, *data;
+    struct lyd_node *tree;
+
+    /* leafrefs with the same targets for all the instances are resolved using cached targets */
+    schema = MODULE_CREATE_YANG("cached",
+            "list target {key id; leaf id {type string;} leaf val {type uint8;} leaf ok {type boolean;}}"
+            "container c {list refs {key name; leaf name {type string;}"
+            "  leaf abs {type leafref {path \"/pref:target/pref:val\";} must \"deref(.)/../ok = 'true'\";}"
+            "  leaf rel {type leafref {path \"../../../target/id\";}}}}");
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    data = "<target xmlns=\"urn:tests:cached\"><id>a</id><val>1</val><ok>true</ok></target>"
+            "<target xmlns=\"urn:tests:cached\"><id>b</id><val>2</val><ok>false</ok></target>"
+            "<target xmlns=\"urn:tests:cached\"><id>c</id><val>1</val><ok>false</ok></target>"
+            "<c xmlns=\"urn:tests:cached\"><refs><name>x</name><abs>1</abs><rel>a</rel></refs>"
+            "<refs><name>y</name><abs>1</abs><rel>b</rel></refs>"
+            "<refs><name>z</name><rel>c</rel></refs></c>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    lyd_free_all(tree);
+
+    data = "<target xmlns=\"urn:tests:cached\"><id>a</id><val>1</val><ok>true</ok></target>"
+            "<c xmlns=\"urn:tests:cached\"><refs><name>x</name><abs>1</abs><rel>a</rel></refs>"
+            "<refs><name>y</name><rel>b</rel></refs></c>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX_APPTAG("Invalid leafref value \"b\" - no target instance \"../../../target/id\" with the same value.",
+            "Schema location \"/cached:c/refs/rel\", data location \"/cached:c/refs[name='y']/rel\".", "instance-required");
+
+    data = "<c xmlns=\"urn:tests:cached\"><refs><name>x</name><abs>1</abs></refs></c>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX_APPTAG("Invalid leafref value \"1\" - no existing target instance \"/pref:target/pref:val\".",
+            "Schema location \"/cached:c/refs/abs\", data location \"/cached:c/refs[name='x']/abs\".", "instance-required");
+
+    /* deref() finds the first target instance with the value */
+    data = "<target xmlns=\"urn:tests:cached\"><id>a</id><val>1</val><ok>false</ok></target>"
+            "<target xmlns=\"urn:tests:cached\"><id>b</id><val>1</val><ok>true</ok></target>"
+            "<c xmlns=\"urn:tests:cached\"><refs><name>x</name><abs>1</abs></refs></c>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX("Must condition \"deref(.)/../ok = 'true'\" not satisfied.",
+            "Schema location \"/cached:c/refs/abs\", data location \"/cached:c/refs[name='x']/abs\".");
+}
+
 static void
 test_plugin_lyb(void **state)
 {
@@ -174,6 +218,7 @@ main(void)
 {
     const struct CMUnitTest tests[] = {
         UTEST(test_data_xml),
+        UTEST(test_data_cached),
         UTEST(test_plugin_lyb),
     };
 
@@ -31,11 +31,11 @@
 void
 cmd_data_help(void)
 {
-    printf("Usage: data [-emn] [-t TYPE]\n"
+    printf("Usage: data [-emnPS] [-t TYPE]\n"
             "            [-F FORMAT] [-f FORMAT] [-d DEFAULTS] [-o OUTFILE] <data1> ...\n"
             "       data [-n] -t (rpc | notif | reply) [-O FILE]\n"
             "            [-F FORMAT] [-f FORMAT] [-d DEFAULTS] [-o OUTFILE] <data1> ...\n"
-            "       data [-en] [-t TYPE] [-F FORMAT] -x XPATH [-o OUTFILE] <data1> ...\n"
+            "       data [-enP] [-t TYPE] [-F FORMAT] -x XPATH [-o OUTFILE] <data1> ...\n"
             "                  Parse, validate and optionally print data instances\n\n"
 
             "  -t TYPE, --type=TYPE\n"
@@ -69,9 +69,9 @@ cmd_data_help(void)
             "                Provide optional data to extend validation of the 'rpc',\n"
             "                'reply' or 'notif' TYPEs. The FILE is supposed to contain\n"
             "                the :running configuration datastore and state data\n"
-            "                (operational datastore) referenced from the RPC/Notification.\n\n"
+            "                (operational datastore) referenced from the RPC/Notification.\n\n");
 
-            "  -f FORMAT, --format=FORMAT\n"
+    printf("  -f FORMAT, --format=FORMAT\n"
             "                Print the data in one of the following formats:\n"
             "                xml, json, lyb\n"
             "                Note that the LYB format requires the -o option specified.\n"
@@ -96,7 +96,19 @@ cmd_data_help(void)
             "                expression. The output format is specific and the option cannot\n"
             "                be combined with the -f and -d options. Also all the data\n"
             "                inputs are merged into a single data tree where the expression\n"
-            "                is evaluated, so the -m option is always set implicitly.\n\n");
+            "                is evaluated, so the -m option is always set implicitly.\n\n"
+
+            "  -P, --profile\n"
+            "                Print the time and node-set sizes of all the evaluated steps\n"
+            "                and predicates, including whether the nodes were found by\n"
+            "                hashes, of all the must and when conditions evaluated by the\n"
+            "                validation. Print also the evaluation plan and profile of every\n"
+            "                XPATH expression.\n\n"
+
+            "  -S, --stats\n"
+            "                Print the number and time of evaluations of all the when and\n"
+            "                must conditions, unique checks, leafref resolutions, and type\n"
+            "                validations performed by the validation, the slowest first.\n\n");
 
 }
 
@@ -116,12 +128,16 @@ cmd_data(struct ly_ctx **ctx, const char *cmdline)
         {"output",      required_argument, NULL, 'o'},
         {"operational", required_argument, NULL, 'O'},
         {"not-strict",  no_argument,       NULL, 'n'},
+        {"profile",     no_argument,       NULL, 'P'},
+        {"stats",       no_argument,       NULL, 'S'},
         {"type",        required_argument, NULL, 't'},
         {"xpath",       required_argument, NULL, 'x'},
         {NULL, 0, NULL, 0}
     };
 
     uint8_t data_merge = 0;
+    uint8_t xpath_profile = 0;
+    uint8_t val_stats = 0;
     uint32_t options_print = 0;
     uint32_t options_parse = YL_DEFAULT_DATA_PARSE_OPTIONS;
     uint32_t options_validate = 0;
@@ -138,7 +154,7 @@ cmd_data(struct ly_ctx **ctx, const char *cmdline)
         goto cleanup;
     }
 
-    while ((opt = getopt_long(argc, argv, "d:ef:F:hmo:O:r:nt:x:", options, &opt_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "d:ef:F:hmo:O:r:nPSt:x:", options, &opt_index)) != -1) {
         switch (opt) {
         case 'd': /* --default */
             if (!strcasecmp(optarg, "all")) {
@@ -216,6 +232,12 @@ cmd_data(struct ly_ctx **ctx, const char *cmdline)
         case 'n': /* --not-strict */
             options_parse &= ~LYD_PARSE_STRICT;
             break;
+        case 'P': /* --profile */
+            xpath_profile = 1;
+            break;
+        case 'S': /* --stats */
+            val_stats = 1;
+            break;
         case 't': /* --type */
             if (data_type_set) {
                 YLMSG_E("The data type (-t) cannot be set multiple times.\n");
@@ -315,7 +337,7 @@ cmd_data(struct ly_ctx **ctx, const char *cmdline)
 
     /* parse, validate and print data */
     if (process_data(*ctx, data_type, data_merge, outformat, out, options_parse, options_validate, options_print,
-            operational, NULL, &inputs, &xpaths)) {
+            operational, NULL, &inputs, &xpaths, xpath_profile, val_stats)) {
         goto cleanup;
     }
 
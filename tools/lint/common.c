@@ -419,12 +419,38 @@ print_list(struct ly_out *out, struct ly_ctx *ctx, LYD_FORMAT outformat)
 }
 
 int
-evaluate_xpath(const struct lyd_node *tree, const char *xpath)
+evaluate_xpath(const struct lyd_node *tree, const char *xpath, uint8_t profile)
 {
     struct ly_set *set = NULL;
+    struct lyxp_expr *exp = NULL;
+    char *plan = NULL, *report = NULL;
+    LY_ERR ret;
 
-    if (lyd_find_xpath(tree, xpath, &set)) {
-        return -1;
+    if (!profile) {
+        if (lyd_find_xpath(tree, xpath, &set)) {
+            return -1;
+        }
+    } else {
+        /* print the plan and evaluate with profiling */
+        if (lyd_xpath_compile(LYD_CTX(tree), xpath, &exp)) {
+            return -1;
+        }
+        if (lyd_xpath_explain(LYD_CTX(tree), exp, &plan)) {
+            lyd_xpath_free(LYD_CTX(tree), exp);
+            return -1;
+        }
+        printf("%s", plan);
+        free(plan);
+
+        ret = lyd_xpath_profile(tree, tree, exp, LY_VALUE_JSON, NULL, NULL, &set, &report);
+        lyd_xpath_free(LYD_CTX(tree), exp);
+        if (report) {
+            printf("%s", report);
+            free(report);
+        }
+        if (ret) {
+            return -1;
+        }
     }
 
     /* print result */
@@ -455,13 +481,24 @@ evaluate_xpath(const struct lyd_node *tree, const char *xpath)
 LY_ERR
 process_data(struct ly_ctx *ctx, enum lyd_type data_type, uint8_t merge, LYD_FORMAT format, struct ly_out *out,
         uint32_t options_parse, uint32_t options_validate, uint32_t options_print, struct cmdline_file *operational_f,
-        struct cmdline_file *rpc_f, struct ly_set *inputs, struct ly_set *xpaths)
+        struct cmdline_file *rpc_f, struct ly_set *inputs, struct ly_set *xpaths, uint8_t xpath_profile,
+        uint8_t val_stats)
 {
     LY_ERR ret = LY_SUCCESS;
     struct lyd_node *tree = NULL, *op = NULL, *envp = NULL, *merged_tree = NULL, *oper_tree = NULL;
-    char *path = NULL;
+    char *path = NULL, *report = NULL;
     struct ly_set *set = NULL;
 
+    if (val_stats && lyd_val_stats_enable(ctx, 1)) {
+        return LY_EMEM;
+    }
+    if (xpath_profile && lyd_xpath_profile_start(ctx)) {
+        if (val_stats) {
+            lyd_val_stats_enable(ctx, 0);
+        }
+        return LY_EMEM;
+    }
+
     /* additional operational datastore */
     if (operational_f && operational_f->in) {
         ret = lyd_parse_data(ctx, NULL, operational_f->in, operational_f->format, LYD_PARSE_ONLY, 0, &oper_tree);
@@ -622,13 +659,29 @@ process_data(struct ly_ctx *ctx, enum lyd_type data_type, uint8_t merge, LYD_FOR
         }
 
         for (uint32_t u = 0; xpaths && (u < xpaths->count); ++u) {
-            if (evaluate_xpath(merged_tree, (const char *)xpaths->objs[u])) {
+            if (evaluate_xpath(merged_tree, (const char *)xpaths->objs[u], xpath_profile)) {
                 goto cleanup;
             }
         }
     }
 
 cleanup:
+    if (xpath_profile) {
+        /* print the profiles of all the expressions evaluated by the validations */
+        if (!lyd_xpath_profile_stop(&report)) {
+            printf("%s", report);
+            free(report);
+            report = NULL;
+        }
+    }
+    if (val_stats) {
+        /* print the statistics of all the validations */
+        if (!lyd_val_stats_print(ctx, &report)) {
+            printf("%s", report);
+            free(report);
+        }
+        lyd_val_stats_enable(ctx, 0);
+    }
     lyd_free_all(tree);
     lyd_free_all(envp);
     lyd_free_all(merged_tree);
@@ -191,10 +191,14 @@ int print_list(struct ly_out *out, struct ly_ctx *ctx, LYD_FORMAT outformat);
  * @param[in] inputs Set of file informations of input data files.
  * @param[in] xpath The set of XPaths to be evaluated on the processed data tree, basic information about the resulting set
  * is printed. Alternative to data printing.
+ * @param[in] xpath_profile Flag to print the profiles of the XPaths evaluated by the validation and also
+ * the evaluation plan and profile of every XPath in @p xpaths.
+ * @param[in] val_stats Flag to print the validation statistics of all the processed data.
  * @return LY_ERR value.
  */
 LY_ERR process_data(struct ly_ctx *ctx, enum lyd_type data_type, uint8_t merge, LYD_FORMAT format, struct ly_out *out,
         uint32_t options_parse, uint32_t options_validate, uint32_t options_print, struct cmdline_file *operational_f,
-        struct cmdline_file *rpc_f, struct ly_set *inputs, struct ly_set *xpaths);
+        struct cmdline_file *rpc_f, struct ly_set *inputs, struct ly_set *xpaths, uint8_t xpath_profile,
+        uint8_t val_stats);
 
 #endif /* COMMON_H_ */
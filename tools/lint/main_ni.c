@@ -82,6 +82,9 @@ struct context {
     /* flag for --merge option */
     uint8_t data_merge;
 
+    /* flag for --stats option */
+    uint8_t data_val_stats;
+
     /* value of --format in case of data format */
     LYD_FORMAT data_out_format;
 
@@ -258,6 +261,10 @@ help(int shortout)
     printf("  -m, --merge   Merge input data files into a single tree and validate at\n"
             "                once. The option has effect only for 'data' and 'config' TYPEs.\n\n");
 
+    printf("  -S, --stats   Print the number and time of evaluations of all the when and\n"
+            "                must conditions, unique checks, leafref resolutions, and type\n"
+            "                validations performed by the data validation, the slowest first.\n\n");
+
     printf("  -y, --yang-library\n"
             "                Load and implement internal \"ietf-yang-library\" YANG module.\n"
             "                Note that this module includes definitions of mandatory state\n"
@@ -503,6 +510,7 @@ fill_context(int argc, char *argv[], struct context *c)
         {"operational",       required_argument, NULL, 'O'},
         {"reply-rpc",         required_argument, NULL, 'R'},
         {"merge",             no_argument,       NULL, 'm'},
+        {"stats",             no_argument,       NULL, 'S'},
         {"yang-library",      no_argument,       NULL, 'y'},
         {"yang-library-file", required_argument, NULL, 'Y'},
 #ifndef NDEBUG
@@ -518,9 +526,9 @@ fill_context(int argc, char *argv[], struct context *c)
 
     opterr = 0;
 #ifndef NDEBUG
-    while ((opt = getopt_long(argc, argv, "hvVQf:p:DF:iP:qs:net:d:lL:o:O:R:myY:G:", options, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "hvVQf:p:DF:iP:qs:net:d:lL:o:O:R:mSyY:G:", options, &opt_index)) != -1)
 #else
-    while ((opt = getopt_long(argc, argv, "hvVQf:p:DF:iP:qs:net:d:lL:o:O:R:myY:", options, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "hvVQf:p:DF:iP:qs:net:d:lL:o:O:R:mSyY:", options, &opt_index)) != -1)
 #endif
     {
         switch (opt) {
@@ -743,6 +751,10 @@ fill_context(int argc, char *argv[], struct context *c)
             c->data_merge = 1;
             break;
 
+        case 'S': /* --stats */
+            c->data_val_stats = 1;
+            break;
+
         case 'y': /* --yang-library */
             c->ctx_options &= ~LY_CTX_NO_YANGLIBRARY;
             break;
@@ -932,7 +944,8 @@ main_ni(int argc, char *argv[])
         /* do the data validation despite the schema was printed */
         if (c.data_inputs.size) {
             ret = process_data(c.ctx, c.data_type, c.data_merge, c.data_out_format, c.out, c.data_parse_options,
-                    c.data_validate_options, c.data_print_options, &c.data_operational, &c.reply_rpc, &c.data_inputs, NULL);
+                    c.data_validate_options, c.data_print_options, &c.data_operational, &c.reply_rpc, &c.data_inputs,
+                    NULL, 0, c.data_val_stats);
             if (ret) {
                 goto cleanup;
             }